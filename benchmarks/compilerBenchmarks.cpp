@@ -0,0 +1,171 @@
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+
+#include "engine.h"
+#include "incrementalDocument.h"
+#include "interpreterVisitor.h"
+#include "lexer.h"
+#include "nodeCounter.h"
+#include "parser.h"
+#include "semanticVisitor.h"
+
+// *********************************************************************************************************************
+//                  Input programs
+// *********************************************************************************************************************
+
+static std::string manyFunctions(int count) {
+    std::string source;
+    for (int i = 0; i < count; i++) {
+        source += "fun int::f" + std::to_string(i) + "(int::a, int::b)[\n"
+                  "    mut int::sum = a * 2 + b;\n"
+                  "    if (sum > 10 and a != b)[ sum = sum - 1; ] else [ sum = sum + 1; ]\n"
+                  "    str::name = \"function\";\n"
+                  "    return sum;\n"
+                  "]\n";
+    }
+    source += "fun int::main()[ return 0; ]\n";
+    return source;
+}
+
+static std::string nestedBlocks(int depth) {
+    std::string source = "fun int::main()[\n    mut int::x = 0;\n";
+    for (int i = 0; i < depth; i++)
+        source += "if (x < " + std::to_string(depth) + ")[ int::v" + std::to_string(i) + " = x + 1;\n";
+    source += "x = x + 1;\n";
+    for (int i = 0; i < depth; i++)
+        source += "]\n";
+    source += "return x;\n]\n";
+    return source;
+}
+
+static const std::string callHeavy =
+        "fun int::fib(int::n)[ if (n < 2)[ return n; ] int::a = fib(n - 1); int::b = fib(n - 2); return a + b; ]"
+        "fun int::main()[ int::result = fib(15); return 0; ]";
+
+static const std::string loopHeavy =
+        "fun int::main()[ mut int::i = 0; mut int::sum = 0; while(i < 20000)[ sum = sum + i * 2; i = i + 1; ] return 0; ]";
+
+static const std::string stringHeavy =
+        "fun int::main()[ mut int::i = 0; mut str::text = \"\"; while(i < 2000)[ text = text + \"abc\"; i = i + 1; ] return 0; ]";
+
+static std::unique_ptr<Nodes::Program> parse(const std::string& source) {
+    std::istringstream strStream(source);
+    Parser parser(strStream);
+    return parser.parseProgram();
+}
+
+// *********************************************************************************************************************
+//                  Benchmarks
+// *********************************************************************************************************************
+
+static void BM_LexerTokens(benchmark::State& state) {
+    std::string source = manyFunctions(static_cast<int>(state.range(0)));
+    std::size_t tokens = 0;
+    for (auto _ : state) {
+        std::istringstream strStream(source);
+        Lexer lexer(strStream);
+        while (lexer.getNextToken().getType() != TokenTypes::EOF_TOKEN)
+            tokens++;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(tokens));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(BM_LexerTokens)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_ParseProgram(benchmark::State& state) {
+    std::string source = manyFunctions(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        auto program = parse(source);
+        benchmark::DoNotOptimize(program.get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(BM_ParseProgram)->Arg(10)->Arg(100)->Arg(1000);
+
+// lexer w osobnym wątku, paczki tokenów przez kolejkę SPSC
+static void BM_ParseProgramPipelined(benchmark::State& state) {
+    std::string source = manyFunctions(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        std::istringstream strStream(source);
+        Parser parser(strStream, Parser::Pipelined{});
+        auto program = parser.parseProgram();
+        benchmark::DoNotOptimize(program.get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(BM_ParseProgramPipelined)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_SemanticNested(benchmark::State& state) {
+    auto program = parse(nestedBlocks(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+        program->accept(semanticVisitor);
+    }
+}
+BENCHMARK(BM_SemanticNested)->Arg(8)->Arg(64)->Arg(256);
+
+// ciała funkcji sprawdzane przez Arg wątków (0 = liczba rdzeni)
+static void BM_SemanticManyFunctions(benchmark::State& state) {
+    auto program = parse(manyFunctions(4000));
+    for (auto _ : state) {
+        SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+        semanticVisitor.setThreads(static_cast<std::size_t>(state.range(0)));
+        program->accept(semanticVisitor);
+    }
+}
+BENCHMARK(BM_SemanticManyFunctions)->Arg(1)->Arg(2)->Arg(4)->Arg(0)->Unit(benchmark::kMillisecond);
+
+// przejście całego drzewa; metoda wizytatora wybierana switchem po rodzaju węzła
+static void BM_CountNodes(benchmark::State& state) {
+    auto program = parse(manyFunctions(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        NodeCounter nodeCounter;
+        program->accept(nodeCounter);
+        benchmark::DoNotOptimize(nodeCounter.getCounts().size());
+    }
+}
+BENCHMARK(BM_CountNodes)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void runInterpreter(benchmark::State& state, const std::string& source) {
+    auto program = parse(source);
+    for (auto _ : state) {
+        InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+        program->accept(interpreterVisitor);
+    }
+}
+
+static void BM_InterpretCallHeavy(benchmark::State& state) { runInterpreter(state, callHeavy); }
+BENCHMARK(BM_InterpretCallHeavy)->Unit(benchmark::kMillisecond);
+
+static void BM_InterpretLoopHeavy(benchmark::State& state) { runInterpreter(state, loopHeavy); }
+BENCHMARK(BM_InterpretLoopHeavy)->Unit(benchmark::kMillisecond);
+
+static void BM_InterpretStringHeavy(benchmark::State& state) { runInterpreter(state, stringHeavy); }
+BENCHMARK(BM_InterpretStringHeavy)->Unit(benchmark::kMillisecond);
+
+// edycja ciała jednej funkcji w dokumencie serwera LSP (8500 funkcji ~ 51 tys. linii)
+static void BM_IncrementalBodyEdit(benchmark::State& state) {
+    IncrementalDocument document(manyFunctions(static_cast<int>(state.range(0))));
+    auto offset = document.getText().find("sum - 1", document.getText().size() / 2);
+    bool edited = false;
+    for (auto _ : state) {
+        document.applyEdit(offset, 7, edited ? "sum - 1" : "sum - 2");
+        edited = !edited;
+        benchmark::DoNotOptimize(document.getDiagnostics());
+    }
+}
+BENCHMARK(BM_IncrementalBodyEdit)->Arg(1000)->Arg(8500)->Unit(benchmark::kMillisecond);
+
+// start programu, który wywołuje tylko main: z leniwymi ciałami (Arg 1) koszt nie rośnie z liczbą funkcji
+static void BM_CompileAndRunManyFunctions(benchmark::State& state) {
+    auto source = manyFunctions(2000);
+    bool lazyBodies = state.range(0) != 0;
+    for (auto _ : state) {
+        std::ostringstream output;
+        benchmark::DoNotOptimize(Engine::compile(source, lazyBodies)->run({}, output));
+    }
+}
+BENCHMARK(BM_CompileAndRunManyFunctions)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
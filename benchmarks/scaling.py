@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Runs the interpreter on synthetic programs of growing size and reports time and memory per phase.
+
+Programs come from the tkom_generate target, measurements from `tkom_projekt --stats=json`.
+Results are written as CSV; when matplotlib is available a plot of wall time and peak RSS
+against input size is saved next to it.
+
+    python3 benchmarks/scaling.py --build-dir build --parameter functions --sizes 10 50 100 500
+"""
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+PARAMETERS = {
+    "functions": "--functions",
+    "statements": "--statements",
+    "depth": "--depth",
+    "expression": "--expression",
+    "structs": "--structs",
+    "variants": "--variants",
+    "fan-out": "--fan-out",
+}
+PHASES = ["parse", "semantic", "interpret"]
+
+
+def run_size(build_dir, parameter, size, seed, fixed):
+    generator = os.path.join(build_dir, "tkom_generate")
+    interpreter = os.path.join(build_dir, "tkom_projekt")
+    with tempfile.NamedTemporaryFile(suffix=".tkom", delete=False) as source:
+        path = source.name
+    try:
+        subprocess.run([generator, PARAMETERS[parameter], str(size), "--seed", str(seed), "-o", path] + fixed,
+                       check=True)
+        result = subprocess.run([interpreter, "--stats=json", "-f", path], capture_output=True, text=True)
+        report = json.loads(result.stderr.strip().splitlines()[-1])
+        row = {"size": size, "bytes": os.path.getsize(path),
+               "ast_nodes": sum(report["ast_nodes"].values())}
+        for phase in report["phases"]:
+            row[phase["name"] + "_ms"] = phase["wall_ms"]
+            row[phase["name"] + "_rss_kb"] = phase["peak_rss_kb"]
+        return row
+    finally:
+        os.unlink(path)
+
+
+def plot(rows, parameter, output):
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("matplotlib not available, skipping plot", file=sys.stderr)
+        return
+
+    sizes = [row["size"] for row in rows]
+    figure, (time_axis, memory_axis) = plt.subplots(1, 2, figsize=(12, 5))
+    for phase in PHASES:
+        time_axis.plot(sizes, [row.get(phase + "_ms", 0) for row in rows], marker="o", label=phase)
+    time_axis.set_xlabel(parameter)
+    time_axis.set_ylabel("wall time [ms]")
+    time_axis.legend()
+    memory_axis.plot(sizes, [row.get("interpret_rss_kb", 0) / 1024 for row in rows], marker="o")
+    memory_axis.set_xlabel(parameter)
+    memory_axis.set_ylabel("peak RSS [MiB]")
+    figure.tight_layout()
+    figure.savefig(output)
+    print("plot written to " + output, file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--build-dir", default="build")
+    parser.add_argument("--parameter", choices=sorted(PARAMETERS), default="functions")
+    parser.add_argument("--sizes", type=int, nargs="+", default=[10, 50, 100, 250, 500, 1000])
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--output", default="scaling.csv")
+    parser.add_argument("generator_args", nargs=argparse.REMAINDER,
+                        help="options passed unchanged to tkom_generate (after --)")
+    args = parser.parse_args()
+    fixed = [arg for arg in args.generator_args if arg != "--"]
+
+    rows = []
+    for size in args.sizes:
+        row = run_size(args.build_dir, args.parameter, size, args.seed, fixed)
+        print(", ".join("%s=%s" % item for item in row.items()), file=sys.stderr)
+        rows.append(row)
+
+    with open(args.output, "w", newline="") as output:
+        writer = csv.DictWriter(output, fieldnames=list(rows[0].keys()))
+        writer.writeheader()
+        writer.writerows(rows)
+    plot(rows, args.parameter, os.path.splitext(args.output)[0] + ".png")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,21 @@
+# Uruchamiany przy każdym buildzie (cel tkom_build_stamp). Znacznik = kompilator + commit + skrót
+# niezatwierdzonych zmian w źródłach, więc zmiana parsera czy analizy semantycznej unieważnia
+# wpisy ProgramCache. Plik nadpisywany tylko przy zmianie, żeby nie wymuszać rekompilacji.
+execute_process(COMMAND git describe --always --dirty
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE describe
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        ERROR_QUIET)
+execute_process(COMMAND git diff HEAD -- include src
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE diff
+        ERROR_QUIET)
+string(SHA1 diffHash "${diff}")
+set(content "#define TKOM_BUILD_STAMP \"${COMPILER}-${describe}-${diffHash}\"\n")
+
+if (EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} previous)
+endif()
+if (NOT "${previous}" STREQUAL "${content}")
+    file(WRITE ${OUTPUT} "${content}")
+endif()
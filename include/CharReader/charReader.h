@@ -2,8 +2,12 @@
 #ifndef TKOM_PROJEKT_CHARREADER_H
 #define TKOM_PROJEKT_CHARREADER_H
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 const auto TAB_WIDTH = 4;
 
@@ -12,6 +16,47 @@ struct Position{
     unsigned int column;
 };
 
+// Początki linii i tabulatory zapisane raz przy czytaniu; linia i kolumna danego offsetu
+// liczone są dopiero na żądanie. Offset 0 to pozycja przed pierwszym znakiem, pierwszy znak ma 1.
+// Tablicę uzupełnia wątek czytający, a odczytywać może inny (np. parser za TokenPipeline), stąd mutex.
+class LineTable {
+public:
+    void addLine(std::uint32_t start);
+    void addTab(std::uint32_t offset);
+    Position resolve(std::uint32_t offset) const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::uint32_t> lineStarts{1};
+    std::vector<std::uint32_t> tabs;
+};
+
+// Miejsce w źródle zapisywane w tokenach i węzłach: offset i identyfikator pliku zamiast linii i kolumny,
+// które liczy resolve() dopiero gdy są potrzebne (komunikat błędu, diagnostyka). Pozycja bez pliku
+// (z cache AST, węzły tworzone ręcznie) trzymana jest wprost - linia w offset, kolumna w file.
+class SourceLocation {
+public:
+    SourceLocation() = default;
+    SourceLocation(unsigned int line, unsigned int column) : offset(line), file(EXPLICIT | column) {}
+    SourceLocation(Position pos) : SourceLocation(pos.line, pos.column) {}
+    static SourceLocation inFile(std::uint32_t file, std::uint32_t offset);
+
+    [[nodiscard]] Position resolve() const;
+    operator Position() const { return resolve(); }
+
+private:
+    static constexpr std::uint32_t EXPLICIT = 1u << 31;
+    std::uint32_t offset = 0;
+    std::uint32_t file = EXPLICIT;
+};
+
+// Tablice linii wszystkich czytanych źródeł, indeksowane identyfikatorem pliku z SourceLocation.
+// Żyją do końca programu, bo węzły drzewa mogą przeżyć CharReader, który je wypełniał.
+namespace SourceFiles {
+    std::uint32_t add(std::shared_ptr<const LineTable> lines);
+    [[nodiscard]] Position resolve(std::uint32_t file, std::uint32_t offset);
+}
+
 class CharReader {
 public:
     CharReader();
@@ -20,8 +65,11 @@ public:
     ~CharReader();
 
     Position getPos() const;
+    SourceLocation getLocation() const;
     unsigned int getLine() const;
     unsigned int getColumn() const;
+    std::uint32_t getOffset() const;
+    const LineTable& getLineTable() const;
     char getCurrChar() const;
     bool nextChar();
     void movePos();
@@ -30,7 +78,9 @@ public:
 private:
     std::istream* stream=nullptr;
     std::ifstream file_stream;
-    Position position{};
+    std::uint32_t offset=0;
+    std::shared_ptr<LineTable> lines = std::make_shared<LineTable>();
+    std::uint32_t file = SourceFiles::add(lines);
     char currChar=' ';
 
 };
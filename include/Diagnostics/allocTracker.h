@@ -0,0 +1,64 @@
+#ifndef TKOM_PROJEKT_ALLOCTRACKER_H
+#define TKOM_PROJEKT_ALLOCTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Śledzenie alokacji per faza kompilacji. Z opcją CMake TKOM_ALLOC_TRACKING biblioteka podmienia
+// globalne operator new/delete i zlicza alokacje, bajty i miejsca wywołań w bieżącej fazie wątku.
+// Bez opcji operatory zostają standardowe, a TKOM_ALLOC_PHASE rozwija się do niczego.
+namespace AllocTracker {
+    enum class Phase {
+        NONE,
+        LEX,
+        PARSE,
+        SEMANTIC,
+        INTERPRET,
+        COUNT
+    };
+
+    struct PhaseTotals
+    {
+        std::uint64_t allocations;
+        std::uint64_t bytes;
+        std::uint64_t frees;
+    };
+
+    [[nodiscard]] bool enabled();
+    [[nodiscard]] const char* phaseName(Phase phase);
+
+    // faza jest per wątek (zadania WorkStealingPool i producent TokenPipeline przejmują fazę wątku,
+    // który je uruchomił) - zwraca poprzednią, żeby dało się ją przywrócić
+    Phase setPhase(Phase phase);
+    [[nodiscard]] Phase currentPhase();
+
+    [[nodiscard]] PhaseTotals totals(Phase phase);
+    void reset();
+
+    // tyle najczęstszych miejsc alokacji wypisuje raport dla każdej fazy
+    constexpr std::size_t TOP_SITES = 10;
+
+    // podsumowanie faz i TOP_SITES miejsc alokacji w każdej fazie (pierwsza ramka spoza std::)
+    void writeReport(std::ostream& output);
+
+    class PhaseScope
+    {
+    private:
+        Phase previous;
+
+    public:
+        explicit PhaseScope(Phase phase) : previous(setPhase(phase)) {}
+        ~PhaseScope() { setPhase(previous); }
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+    };
+}
+
+#ifdef TKOM_ALLOC_TRACKING
+#define TKOM_ALLOC_PHASE(PHASE) AllocTracker::PhaseScope allocPhaseScope(AllocTracker::Phase::PHASE)
+#else
+#define TKOM_ALLOC_PHASE(PHASE)
+#endif
+
+#endif //TKOM_PROJEKT_ALLOCTRACKER_H
@@ -0,0 +1,92 @@
+#ifndef TKOM_PROJEKT_PROFILER_H
+#define TKOM_PROJEKT_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include "charReader.h"
+
+namespace Nodes {
+    class FunctionDeclaration;
+}
+
+// Profiler próbkujący na poziomie skryptu: interpreter utrzymuje stos cieni (funkcja + aktualna linia),
+// a SIGPROF co zadany interwał kopiuje go do wcześniej zaalokowanego bufora. Agregacja i zapis
+// w formacie "folded stacks" (flamegraph.pl, speedscope, inferno) odbywają się dopiero po zakończeniu.
+// Próbki wskazują na węzły FunctionDeclaration, więc drzewo programu musi żyć do writeFoldedStacks().
+// ITIMER_PROF i SIGPROF dotyczą całego procesu: sygnał trafia do dowolnego wątku, który akurat zużywa
+// CPU, a handler i tak kopiuje stos cieni tego jednego interpretera. Przy --batch albo zadaniach
+// WorkStealingPool próbki mogą więc pochodzić z przerwania innego wątku niż profilowany. Zegar działa
+// z rozdzielczością tyknięcia planisty - interwał krótszy od niego nie daje częstszych próbek.
+class Profiler
+{
+public:
+    static constexpr std::size_t MAX_DEPTH = 256;
+    static constexpr std::size_t DEFAULT_SAMPLE_FRAMES = 1 << 20;
+
+    // miejsce zamieniane na numer linii dopiero przy zapisie wyników, żeby nie spowalniać wykonania
+    struct Frame
+    {
+        const Nodes::FunctionDeclaration* function;
+        SourceLocation location;
+    };
+
+    explicit Profiler(unsigned int intervalMicros = 1000, std::size_t sampleFrameCapacity = DEFAULT_SAMPLE_FRAMES);
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void start();
+    void stop();
+
+    // wywoływane przez interpreter - tylko zapisy do stałej tablicy, bez alokacji
+    void enterFunction(const Nodes::FunctionDeclaration* function, SourceLocation location) {
+        auto depth = shadowDepth.load(std::memory_order_relaxed);
+        if (depth < MAX_DEPTH)
+            shadowStack[depth] = Frame{function, location};
+        std::atomic_signal_fence(std::memory_order_release);
+        shadowDepth.store(depth + 1, std::memory_order_relaxed);
+    }
+
+    void leaveFunction() {
+        auto depth = shadowDepth.load(std::memory_order_relaxed);
+        if (depth > 0)
+            shadowDepth.store(depth - 1, std::memory_order_relaxed);
+    }
+
+    void setLine(SourceLocation location) {
+        auto depth = shadowDepth.load(std::memory_order_relaxed);
+        if (depth > 0 && depth <= MAX_DEPTH)
+            shadowStack[depth - 1].location = location;
+    }
+
+    [[nodiscard]] std::size_t getSampleCount() const { return sampleCount; }
+    [[nodiscard]] std::size_t getDroppedSamples() const { return droppedSamples; }
+
+    // próbka wykonywana synchronicznie (testy, wywołania spoza handlera)
+    void takeSample();
+    void writeFoldedStacks(std::ostream& output) const;
+
+private:
+    unsigned int intervalMicros;
+    std::array<Frame, MAX_DEPTH> shadowStack{};
+    std::atomic<std::size_t> shadowDepth{0};
+
+    // bufor próbek: dla każdej próbki najpierw liczba ramek, potem ramki od najstarszej
+    std::unique_ptr<Frame[]> sampleFrames;
+    std::size_t sampleFrameCapacity;
+    std::size_t sampleFramesUsed = 0;
+    std::size_t sampleCount = 0;
+    std::size_t droppedSamples = 0;
+
+    bool running = false;
+    struct sigaction previousAction{};
+
+    static void handleSignal(int);
+};
+
+#endif //TKOM_PROJEKT_PROFILER_H
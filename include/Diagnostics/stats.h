@@ -0,0 +1,110 @@
+#ifndef TKOM_PROJEKT_STATS_H
+#define TKOM_PROJEKT_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Liczniki zdarzeń dla --stats. Bez definicji TKOM_STATS (opcja CMake, domyślnie wyłączona) makro
+// TKOM_STATS_INC rozwija się do niczego, więc zwykły build nie ponosi żadnego kosztu.
+namespace Stats {
+    enum class Counter {
+        TOKENS,
+        SYMBOL_LOOKUPS,
+        FUNCTION_CALLS,
+        STATEMENTS,
+        COUNT
+    };
+
+    using CounterValues = std::array<std::uint64_t, static_cast<std::size_t>(Counter::COUNT)>;
+
+    // Liczniki jednego wątku. Pisze do nich tylko właściciel (load + store bez instrukcji
+    // atomowej read-modify-write), snapshot() czyta je z innego wątku i sumuje. Przy końcu wątku
+    // wartości przechodzą do wspólnej puli, żeby nie zginęły z sumy.
+    struct ThreadCounters
+    {
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(Counter::COUNT)> values{};
+
+        ThreadCounters();
+        ~ThreadCounters();
+        ThreadCounters(const ThreadCounters&) = delete;
+        ThreadCounters& operator=(const ThreadCounters&) = delete;
+    };
+
+    inline thread_local ThreadCounters threadCounters;
+
+    inline void increment(Counter counter) {
+        auto& value = threadCounters.values[static_cast<std::size_t>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool countersEnabled();
+    // suma liczników wszystkich wątków - żywych i zakończonych
+    [[nodiscard]] CounterValues snapshot();
+    void reset();
+    [[nodiscard]] std::string counterName(Counter counter);
+
+    // szczytowe RSS procesu w KiB (getrusage) - wartość rośnie monotonicznie między fazami
+    [[nodiscard]] long peakRssKb();
+
+    struct Phase
+    {
+        std::string name;
+        double wallMs;
+        long peakRssKb;
+        CounterValues counters;
+    };
+
+    class Report
+    {
+    private:
+        std::vector<Phase> phases;
+        std::map<std::string, std::size_t> astNodes;
+        std::chrono::steady_clock::time_point phaseStart;
+        CounterValues countersAtStart{};
+        std::string currentPhase;
+
+    public:
+        void beginPhase(const std::string& name);
+        void endPhase();
+        void setAstNodeCounts(std::map<std::string, std::size_t> counts) { astNodes = std::move(counts); }
+
+        [[nodiscard]] const std::vector<Phase>& getPhases() const { return phases; }
+        [[nodiscard]] const std::map<std::string, std::size_t>& getAstNodeCounts() const { return astNodes; }
+
+        void writeText(std::ostream& output) const;
+        void writeJson(std::ostream& output) const;
+    };
+
+    // faza raportu na czas zasięgu - kończona też przy wyjątku; bez raportu (nullptr) nic nie mierzy
+    class PhaseScope
+    {
+    private:
+        Report* report;
+
+    public:
+        PhaseScope(Report* report, const std::string& name) : report(report) {
+            if (report)
+                report->beginPhase(name);
+        }
+        ~PhaseScope() {
+            if (report)
+                report->endPhase();
+        }
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+    };
+}
+
+#ifdef TKOM_STATS
+#define TKOM_STATS_INC(counter) ::Stats::increment(::Stats::Counter::counter)
+#else
+#define TKOM_STATS_INC(counter) ((void)0)
+#endif
+
+#endif //TKOM_PROJEKT_STATS_H
@@ -0,0 +1,197 @@
+#ifndef TKOM_PROJEKT_ASTSERIALIZER_H
+#define TKOM_PROJEKT_ASTSERIALIZER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "syntaxTree.h"
+#include "syntaxTreeVisitor.h"
+
+// Binarny zapis sprawdzonego drzewa razem z adnotacjami analizy (sloty ramek, rozmiary ramek,
+// indeksy pól), więc wczytany program nie przechodzi ponownie przez parser ani SemanticVisitor.
+// Wersję formatu trzeba podbić przy każdej zmianie węzłów, adnotacji lub znaczenia drzewa
+// (np. łączności operatorów - ten sam zapis dawałby inny wynik).
+// Rekord węzła to znacznik, pozycja i wszystkie pola, a po nim rekordy dzieci w kolejności ze źródła
+// (pre-order) - zapis i odczyt idą po jawnym stosie, bez rekurencji zależnej od głębokości drzewa.
+namespace AstFormat {
+    constexpr std::uint32_t MAGIC = 0x434b4154; // "TAKC"
+    constexpr std::uint32_t VERSION = 7;
+
+    // FNV-1a 64 - suma kontrolna treści zapisywana w nagłówku
+    std::uint64_t checksum(const char* data, std::size_t size);
+
+    enum class Tag : std::uint8_t {
+        NONE,
+        REL_OP,
+        ARTM_OP,
+        FACTOR_OP,
+        UNARY_OP,
+        CAST_OP,
+        CASTING_EXPR,
+        UNARY_EXPR,
+        MUL_EXPR,
+        ARTM_EXPR,
+        REL_EXPR,
+        AND_EXPR,
+        OR_EXPR,
+        EXPRESSION,
+        BOOL_LITERAL,
+        INT_LITERAL,
+        FLOAT_LITERAL,
+        STRING_LITERAL,
+        IDENTIFIER,
+        FUN_CALL,
+        VAR_REFERENCE,
+        STRUCT_FIELD_REFERENCE,
+        VARIANT_HOLDING,
+        TYPE,
+        TYPE_DECL,
+        VARIABLE_DECLARATION,
+        STRUCT_TYPE_DEFINITION,
+        STRUCT_VAR_DECLARATION,
+        VARIANT_TYPE_DEFINITION,
+        VARIANT_VAR_DECLARATION,
+        ASSIGNMENT,
+        STRUCT_FIELD_ASSIGNMENT,
+        RETURN_STATEMENT,
+        BLOCK,
+        IF_STATEMENT,
+        WHILE_STATEMENT,
+        FUNCTION_CALL_STATEMENT,
+        FUNCTION_DECLARATION,
+        PROGRAM
+    };
+}
+
+class AstWriter : public SyntaxTreeVisitor
+{
+private:
+    std::string buffer;
+    // dzieci odłożone przez visit* bieżącego węzła
+    std::vector<const Node*> queued;
+
+    template<typename T>
+    void writeScalar(T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void writeString(const std::string& value);
+    void writeHeader(AstFormat::Tag tag, const Node* node);
+    void writeTree(const Node* root);
+    void writeChild(const Node* child);
+    void writeSlot(std::optional<std::size_t> slot);
+
+public:
+    // nagłówek (magic, wersja, dodatkowy znacznik, suma kontrolna treści) + całe drzewo
+    static std::string serialize(const Nodes::Program& program, const std::string& stamp = "");
+
+    void visitBoolLiteral(Nodes::BooleanLiteral *) override;
+    void visitIntLiteral(Nodes::IntLiteral *) override;
+    void visitFloatLiteral(Nodes::FloatLiteral *) override;
+    void visitStringLiteral(Nodes::StringLiteral *) override;
+    void visitIdentifier(Nodes::Identifier *) override;
+    void visitRelOp(Nodes::RelOp *) override;
+    void visitArtmOp(Nodes::ArtmOp *) override;
+    void visitFactorOp(Nodes::FactorOp *) override;
+    void visitUnaryOp(Nodes::UnaryOp *) override;
+    void visitCastOp(Nodes::CastOp *) override;
+    void visitCastingExpr(Nodes::CastingExpr *) override;
+    void visitUnaryExpr(Nodes::UnaryExpr *) override;
+    void visitMulExpr(Nodes::MulExpr *) override;
+    void visitArtmExpr(Nodes::ArtmExpr *) override;
+    void visitRelExpr(Nodes::RelExpr *) override;
+    void visitAndExpr(Nodes::AndExpr *) override;
+    void visitOrExpr(Nodes::OrExpr *) override;
+    void visitExpr(Nodes::Expression *) override;
+    void visitFuncCall(Nodes::FunCall *) override;
+    void visitVariableRef(Nodes::VarReference *) override;
+    void visitStructFieldRef(Nodes::StructFieldReference *) override;
+    void visitVariantHolding(Nodes::VariantHolding *) override;
+    void visitDeclaration(Nodes::Declaration *) override;
+    void visitType(Nodes::Type *) override;
+    void visitTypeDecl(Nodes::TypeDecl *) override;
+    void visitVariableDeclaration(Nodes::VariableDeclaration *) override;
+    void visitStructTypeDefinition(Nodes::StructTypeDefinition *) override;
+    void visitStructVarDeclaration(Nodes::StructVarDeclaration *) override;
+    void visitVariantTypeDefinition(Nodes::VariantTypeDefinition *) override;
+    void visitVariantVarDeclaration(Nodes::VariantVarDeclaration *) override;
+    void visitAssignment(Nodes::Assignment *) override;
+    void visitStructFieldAssignment(Nodes::StructFieldAssignment *) override;
+    void visitReturnStatement(Nodes::ReturnStatement *) override;
+    void visitBlock(Nodes::Block *) override;
+    void visitIfStatement(Nodes::IfStatement *) override;
+    void visitWhileStatement(Nodes::WhileStatement *) override;
+    void visitFunctionCallStatement(Nodes::FunctionCallStatement *) override;
+    void visitFunctionDeclaration(Nodes::FunctionDeclaration *) override;
+    void visitProgram(Nodes::Program *) override;
+};
+
+// Odtwarza drzewo z bufora (np. zmapowanego pliku). Uszkodzone lub niezgodne dane zgłaszane jako MyException.
+class AstReader
+{
+private:
+    const char* data;
+    std::size_t size;
+    std::size_t offset = 0;
+
+    // Odwołania sprawdzane po wczytaniu całego programu - definicje typów i funkcji są w drzewie
+    // za ciałami funkcji. Interpreter ufa adnotacjom, więc nic spoza tych tabel nie może przejść.
+    struct Arity
+    {
+        std::string name;
+        std::size_t count;
+        Position pos;
+    };
+    // typ strukturalny musi istnieć i mieć co najmniej count pól
+    std::vector<Arity> structUses;
+    // jak wyżej, dla zmiennej globalnej o podanej nazwie
+    std::vector<Arity> globalStructUses;
+    std::vector<Arity> variantUses;
+    // funkcja musi istnieć i mieć dokładnie count parametrów
+    std::vector<Arity> calls;
+    // bez rozwiązanych zasięgów ramki liczy na nowo ScopeResolver
+    bool scopesResolved = false;
+    // stan bieżącej funkcji: czy jesteśmy w ciele, najwyższy użyty slot + 1, typ strukturalny w slocie
+    bool inFunction = false;
+    std::size_t usedSlots = 0;
+    std::vector<std::string> slotStructs;
+
+    template<typename T>
+    T readScalar() {
+        T value;
+        need(sizeof(T));
+        std::copy(data + offset, data + offset + sizeof(T), reinterpret_cast<char*>(&value));
+        offset += sizeof(T);
+        return value;
+    }
+    void need(std::size_t bytes) const;
+    std::string readString();
+    Position readPosition();
+    std::uint8_t readEnum(std::uint8_t last);
+    std::optional<std::size_t> readIndex();
+    std::optional<std::size_t> readSlot();
+    struct Frame;
+    std::unique_ptr<Node> readTree();
+    std::unique_ptr<Node> readRecord(Frame& frame);
+    void prepareChild(Frame& frame);
+    std::unique_ptr<Node> build(Frame& frame);
+    void declareSlot(std::optional<std::size_t> slot, const std::string& structName);
+    void useField(std::optional<std::size_t> slot, const std::string& identifier,
+                  std::optional<std::size_t> fieldIndex, const Position& pos);
+    void checkReferences(const Nodes::Program& program) const;
+
+    template<typename T>
+    std::unique_ptr<T> take(std::unique_ptr<Node> node);
+    template<typename T>
+    std::unique_ptr<T> takeRequired(std::unique_ptr<Node> node);
+
+public:
+    AstReader(const char* data, std::size_t size) : data(data), size(size) {}
+
+    static std::unique_ptr<Nodes::Program> deserialize(const char* data, std::size_t size, const std::string& stamp = "");
+};
+
+#endif //TKOM_PROJEKT_ASTSERIALIZER_H
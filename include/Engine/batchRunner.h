@@ -0,0 +1,59 @@
+#ifndef TKOM_PROJEKT_BATCHRUNNER_H
+#define TKOM_PROJEKT_BATCHRUNNER_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "engine.h"
+
+class ProgramCache;
+
+struct BatchResult
+{
+    std::string path;
+    // wyjście print skryptu
+    std::string output;
+    // wartość zwrócona przez main; brak przy błędzie
+    std::optional<CompiledProgram::Value> result;
+    std::string error;
+    double compileMs = 0;
+    double runMs = 0;
+};
+
+// Kompiluje i wykonuje wiele skryptów na puli wątków z kradzieżą zadań. Wyjście każdego skryptu
+// zbierane jest osobno i wypisywane w kolejności wejścia, gdy tylko wszystkie wcześniejsze skrypty
+// są gotowe, więc wynik nie zależy od liczby wątków.
+class BatchRunner
+{
+private:
+    std::size_t threads;
+    std::optional<std::uint64_t> fuel;
+    std::optional<std::chrono::milliseconds> timeLimit;
+    const ProgramCache* cache = nullptr;
+
+    BatchResult runScript(const std::string& path) const;
+
+public:
+    // 0 = liczba rdzeni
+    explicit BatchRunner(std::size_t threads = 0);
+
+    [[nodiscard]] std::size_t getThreads() const { return threads; }
+
+    // limity dotyczą każdego skryptu osobno
+    void setFuel(std::uint64_t newFuel) { fuel = newFuel; }
+    void setTimeLimit(std::chrono::milliseconds limit) { timeLimit = limit; }
+    void setCache(const ProgramCache* newCache) { cache = newCache; }
+
+    // katalog: wszystkie zwykłe pliki posortowane po nazwie; plik: lista ścieżek, jedna na linię
+    static std::vector<std::string> collectSources(const std::string& listOrDirectory);
+
+    std::vector<BatchResult> run(const std::vector<std::string>& paths, std::ostream& output);
+
+    static void writeResult(const BatchResult& result, std::ostream& output);
+    void writeSummary(const std::vector<BatchResult>& results, double wallMs, std::ostream& output) const;
+};
+
+#endif //TKOM_PROJEKT_BATCHRUNNER_H
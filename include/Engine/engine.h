@@ -0,0 +1,83 @@
+#ifndef TKOM_PROJEKT_ENGINE_H
+#define TKOM_PROJEKT_ENGINE_H
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <variant>
+#include "syntaxTree.h"
+#include "executionBudget.h"
+#include "lazyBodyLoader.h"
+
+class ProgramCache;
+class Profiler;
+namespace Stats {
+    class Report;
+}
+
+// Sprawdzony program gotowy do wielokrotnego uruchamiania. Po kompilacji drzewo jest tylko czytane,
+// więc jedną instancję mogą współdzielić kolejne uruchomienia i wątki (patrz ExecutionContext).
+// Wyjątek to leniwe ciała funkcji, dopinane raz, pod blokadą LazyBodyLoader.
+class CompiledProgram
+{
+public:
+    using Value = std::variant<int, float, bool, std::string>;
+    // nadpisania wartości początkowych zmiennych globalnych
+    using Inputs = std::map<std::string, Value>;
+
+private:
+    std::unique_ptr<Nodes::Program> program;
+    // tylko dla programów z leniwymi ciałami funkcji; niszczony przed drzewem
+    std::unique_ptr<LazyBodyLoader> lazyBodies;
+
+    explicit CompiledProgram(std::unique_ptr<Nodes::Program> program) : program(std::move(program)) {}
+    friend class Engine;
+    friend class ProgramCache;
+    friend class ExecutionContext;
+    friend class ModuleGraph;
+
+public:
+    // zwraca wartość zwróconą przez main; wyjście print trafia do output; profiler - uruchomiony
+    // przez wołającego, musi żyć tak długo jak program
+    Value run(const Inputs& inputs = {}, std::ostream& output = std::cout, ExecutionBudget budget = ExecutionBudget(),
+              Profiler* profiler = nullptr) const;
+
+    [[nodiscard]] const Nodes::Program& getProgram() const { return *program; }
+};
+
+struct CompileOptions
+{
+    // ciała funkcji parsowane i sprawdzane przy pierwszym wywołaniu; nie dotyczy programów z pamięci
+    // podręcznej i z importami - ich drzewo zapisywane jest w całości
+    bool lazyBodies = false;
+    // lekser w osobnym wątku (TokenPipeline)
+    bool pipelined = false;
+    // wątki analizy semantycznej i grafu modułów, 0 = liczba rdzeni
+    std::size_t threads = 0;
+    // sprawdzony program czytany z tego katalogu i do niego zapisywany
+    const ProgramCache* cache = nullptr;
+    // fazy "parse" i "semantic" oraz liczba węzłów drzewa
+    Stats::Report* stats = nullptr;
+};
+
+// Front-end: parsowanie, analiza semantyczna i rozwiązanie zasięgów wykonywane raz na program.
+// Błędy zgłaszane jako MyException. Z lazyBodies ciała funkcji parsowane i sprawdzane są dopiero
+// przy pierwszym wywołaniu - błąd w ciele funkcji, która nigdy nie jest wołana, nie jest zgłaszany.
+// compileFile dla pliku z importami buduje ModuleGraph, zaczynając od już sparsowanego korzenia.
+class Engine
+{
+private:
+    // po fazie parse: trafienie z pamięci podręcznej gotowe od razu, inaczej analiza i zapis wpisu
+    static std::shared_ptr<const CompiledProgram> finish(std::unique_ptr<Nodes::Program> program, bool cached,
+                                                         const std::string& source, const CompileOptions& options);
+
+public:
+    static std::shared_ptr<const CompiledProgram> compile(const std::string& source, bool lazyBodies = false);
+    static std::shared_ptr<const CompiledProgram> compileFile(const std::string& path, bool lazyBodies = false);
+    static std::shared_ptr<const CompiledProgram> compile(const std::string& source, const CompileOptions& options);
+    static std::shared_ptr<const CompiledProgram> compileFile(const std::string& path, const CompileOptions& options);
+    static std::shared_ptr<const CompiledProgram> compile(std::unique_ptr<Nodes::Program> program, const CompileOptions& options = {});
+};
+
+#endif //TKOM_PROJEKT_ENGINE_H
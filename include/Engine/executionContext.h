@@ -0,0 +1,27 @@
+#ifndef TKOM_PROJEKT_EXECUTIONCONTEXT_H
+#define TKOM_PROJEKT_EXECUTIONCONTEXT_H
+
+#include <memory>
+#include "engine.h"
+#include "interpreterVisitor.h"
+
+// Stan wykonania należący do jednego wątku: interpreter z tablicami symboli, stosem ramek i bieżącą
+// wartością, używany ponownie przez kolejne uruchomienia. Współdzielony CompiledProgram jest tylko
+// czytany, więc wątki z własnymi kontekstami wykonują ten sam program równolegle bez blokad.
+// Sam kontekst nie jest bezpieczny wątkowo - jeden kontekst na wątek.
+class ExecutionContext
+{
+private:
+    std::shared_ptr<const CompiledProgram> program;
+    InterpreterVisitor interpreter;
+
+public:
+    explicit ExecutionContext(std::shared_ptr<const CompiledProgram> program);
+
+    CompiledProgram::Value run(const CompiledProgram::Inputs& inputs = {}, std::ostream& output = std::cout,
+                               ExecutionBudget budget = ExecutionBudget());
+
+    [[nodiscard]] const CompiledProgram& getProgram() const { return *program; }
+};
+
+#endif //TKOM_PROJEKT_EXECUTIONCONTEXT_H
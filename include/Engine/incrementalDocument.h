@@ -0,0 +1,119 @@
+#ifndef TKOM_PROJEKT_INCREMENTALDOCUMENT_H
+#define TKOM_PROJEKT_INCREMENTALDOCUMENT_H
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "syntaxTree.h"
+#include "token.h"
+
+class SemanticVisitor;
+
+// Dokument edytora z przyrostowym front-endem. Tekst dzielony jest na elementy najwyższego poziomu
+// (fun ... [ ... ], deklaracje zakończone ';'), a każdy element parsowany jest osobno i trafia do
+// wspólnego Program. Edycja skanuje leksykalnie tylko okno od końca ostatniego elementu przed edycją
+// do pierwszej granicy elementu za edycją, która pokrywa się ze starą granicą; parsowane są tylko
+// elementy z tego okna, pozostałe poddrzewa zostają bez zmian.
+//
+// Pozycje w węzłach są względne wobec początku elementu (linia 1 = linia, w której element się
+// zaczyna), więc przesunięcie elementu nie wymaga zmian w drzewie; toDocumentPosition zamienia je
+// na pozycje w dokumencie.
+class IncrementalDocument
+{
+public:
+    struct Diagnostic
+    {
+        Position pos;
+        std::string message;
+    };
+
+    struct Item
+    {
+        // zakres w tekście [begin, end)
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        Nodes::Program::ItemNames names{};
+        // tekst funkcji do pierwszego '[' bez białych znaków - zmiana oznacza zmianę sygnatury
+        std::string header{};
+        // błąd parsowania (pozycja względna) albo powtórzona nazwa
+        std::optional<Diagnostic> error{};
+        // pierwszy błąd analizy semantycznej funkcji elementu (pozycja względna)
+        std::optional<Diagnostic> semanticError{};
+        bool inProgram = false;
+        // wynik analizy ciał funkcji jest aktualny - od analizy nie zmieniło się nic, od czego zależy
+        bool bodyChecked = false;
+    };
+
+    struct ItemToken
+    {
+        Token token;
+        // offset początku tokenu w dokumencie
+        std::size_t offset;
+    };
+
+    // co zrobiła ostatnia zmiana dokumentu
+    struct EditStats
+    {
+        std::size_t relexedBytes = 0;
+        std::size_t reparsedItems = 0;
+        std::size_t reusedItems = 0;
+        bool fullSemanticCheck = false;
+        std::size_t checkedFunctionBodies = 0;
+    };
+
+private:
+    std::string text;
+    // offsety początków linii
+    std::vector<std::size_t> lineStarts;
+    std::vector<Item> items;
+    std::unique_ptr<Nodes::Program> program;
+    // kontekst globalny z ostatniej pełnej analizy; brak, gdy elementy globalne mają błąd
+    std::unique_ptr<SemanticVisitor> semanticScope;
+    std::optional<Diagnostic> globalError;
+    EditStats lastEdit;
+
+    struct Range
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    void rebuildLineStarts();
+    void updateLineStarts(std::size_t offset, std::size_t removed, const std::string& inserted);
+    std::size_t offsetOfRelative(std::size_t base, Position relative) const;
+    template<typename StopPredicate>
+    std::vector<Range> scanItems(std::size_t start, StopPredicate stop, std::size_t& scannedUntil);
+    // parsuje element i dołącza go do programu
+    Item parseItem(Range range);
+    bool retryDuplicates();
+    void check(bool bodiesOnly);
+
+public:
+    explicit IncrementalDocument(std::string text);
+    ~IncrementalDocument();
+
+    // zastępuje length znaków od offset tekstem newText
+    void applyEdit(std::size_t offset, std::size_t length, const std::string& newText);
+
+    [[nodiscard]] const std::string& getText() const { return text; }
+    [[nodiscard]] const Nodes::Program& getProgram() const { return *program; }
+    [[nodiscard]] const std::vector<Item>& getItems() const { return items; }
+    [[nodiscard]] const EditStats& getLastEdit() const { return lastEdit; }
+    // błędy parsowania wszystkich elementów, a bez nich błędy analizy semantycznej (pierwszy w każdym
+    // elemencie); pozycje w dokumencie
+    [[nodiscard]] std::vector<Diagnostic> getDiagnostics() const;
+
+    [[nodiscard]] std::size_t offsetOf(Position position) const;
+    [[nodiscard]] Position positionOf(std::size_t offset) const;
+    // element zawierający offset (nullptr w przerwie między elementami)
+    [[nodiscard]] const Item* itemAt(std::size_t offset) const;
+    // element, do którego należy węzeł najwyższego poziomu programu
+    [[nodiscard]] const Item* itemOf(const Node* topLevel) const;
+    [[nodiscard]] Position toDocumentPosition(const Item& item, Position relative) const;
+    // tokeny elementu bez komentarzy, do pierwszego błędu leksykalnego
+    [[nodiscard]] std::vector<ItemToken> tokensOf(const Item& item) const;
+};
+
+#endif //TKOM_PROJEKT_INCREMENTALDOCUMENT_H
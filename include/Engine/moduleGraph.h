@@ -0,0 +1,69 @@
+#ifndef TKOM_PROJEKT_MODULEGRAPH_H
+#define TKOM_PROJEKT_MODULEGRAPH_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "engine.h"
+
+// Program złożony z wielu plików połączonych przez import "ścieżka";. Każdy moduł ma własne drzewo;
+// moduły parsowane są równolegle, a analizowane równolegle w kolejności grafu zależności (moduł
+// widzi elementy wszystkich modułów, od których zależy). Wyniki zostają w grafie między kolejnymi
+// budowaniami: niezmieniony plik nie jest parsowany ponownie, a analizowane są tylko moduły
+// zmienione i te, które od nich zależą.
+class ModuleGraph
+{
+public:
+    // co zrobiło ostatnie budowanie (ścieżki kanoniczne)
+    struct BuildReport
+    {
+        std::vector<std::string> parsed;
+        std::vector<std::string> checked;
+    };
+
+private:
+    struct Module
+    {
+        std::uint64_t sourceHash = 0;
+        // ścieżki kanoniczne importowanych modułów
+        std::vector<std::string> imports;
+        // drzewo po parsowaniu i po analizie (tylko elementy tego modułu), w formacie AstWriter
+        std::string parsed;
+        std::string checked;
+    };
+
+    std::map<std::string, Module> modules;
+    std::size_t threads;
+    bool pipelined;
+    BuildReport lastBuild;
+    // moduły sparsowane przez ostatnie parse(), jeszcze nie sprawdzone przez check()
+    std::set<std::string> changed;
+
+    std::set<std::string> discover(const std::string& root, std::unique_ptr<Nodes::Program> rootProgram);
+    std::vector<std::string> orderModules(const std::string& root) const;
+    void checkModule(const std::string& path, const std::set<std::string>& dependencies);
+
+public:
+    // threads - wątki parsowania i analizy modułów, 0 = liczba rdzeni; pipelined - lekser każdego
+    // modułu w osobnym wątku (TokenPipeline)
+    explicit ModuleGraph(std::size_t threads = 0, bool pipelined = false) : threads(threads), pipelined(pipelined) {}
+
+    static std::string canonicalPath(const std::string& path);
+
+    // Dwa etapy link() osobno, żeby wołający mógł mierzyć je jako fazy parse i semantic.
+    // root - drzewo pliku rootPath już sparsowane przez wołającego (bez leniwych ciał); nie jest
+    // wtedy parsowane ponownie
+    void parse(const std::string& rootPath, std::unique_ptr<Nodes::Program> root = nullptr);
+    std::unique_ptr<Nodes::Program> check(const std::string& rootPath);
+
+    // połączony program gotowy do wykonania (zasięgi rozwiązane); błędy jako MyException
+    std::unique_ptr<Nodes::Program> link(const std::string& rootPath);
+    std::shared_ptr<const CompiledProgram> build(const std::string& rootPath);
+
+    [[nodiscard]] const BuildReport& getLastBuild() const { return lastBuild; }
+};
+
+#endif //TKOM_PROJEKT_MODULEGRAPH_H
@@ -0,0 +1,33 @@
+#ifndef TKOM_PROJEKT_PROGRAMCACHE_H
+#define TKOM_PROJEKT_PROGRAMCACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "engine.h"
+
+// Katalog skompilowanych programów. Wpis jest kluczowany skrótem FNV-1a źródła, wersją formatu
+// i znacznikiem buildu (kompilator, commit, niezatwierdzone zmiany - cmake/buildStamp.cmake),
+// więc zmiana źródła, formatu albo samego interpretera daje nowy wpis zamiast nieaktualnego. Trafienie to jeden mmap
+// pliku i odtworzenie drzewa bez parsera i analizy semantycznej.
+class ProgramCache
+{
+private:
+    std::string directory;
+
+public:
+    explicit ProgramCache(std::string directory);
+
+    static std::uint64_t hashSource(const std::string& source);
+    [[nodiscard]] std::string entryPath(const std::string& source) const;
+
+    // nullptr przy braku wpisu; wpis uszkodzony lub niezgodny jest przy tym usuwany
+    [[nodiscard]] std::unique_ptr<Nodes::Program> load(const std::string& source) const;
+    // program musi być już sprawdzony (SemanticVisitor + ScopeResolver); zapis atomowy przez rename
+    void store(const std::string& source, const Nodes::Program& program) const;
+
+    // Engine::compile z pominięciem front-endu przy trafieniu
+    std::shared_ptr<const CompiledProgram> compile(const std::string& source) const;
+};
+
+#endif //TKOM_PROJEKT_PROGRAMCACHE_H
@@ -0,0 +1,77 @@
+#ifndef TKOM_PROJEKT_WORKSTEALINGPOOL_H
+#define TKOM_PROJEKT_WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "allocTracker.h"
+
+// Pula wątków z kolejką na każdy wątek. Wątek bierze zadania z końca własnej kolejki (ostatnio
+// dodane, ciepłe w pamięci podręcznej), a gdy ta jest pusta - kradnie z początku kolejek innych.
+// Zadania zgłaszane spoza puli rozdzielane są po kolei między kolejki. Zadanie wykonuje się
+// w fazie AllocTracker wątku, który je zgłosił.
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Entry
+    {
+        Task task;
+        AllocTracker::Phase phase;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Entry> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> nextQueue{0};
+
+    // Liczniki bez blokady: zgłoszenie i wykonanie zadania dotykają tylko kolejki i atomów.
+    // stateMutex i zmienne warunkowe używane są dopiero, gdy ktoś musi zasnąć albo kogoś obudzić.
+    // zadania w kolejkach / zgłoszone i jeszcze niezakończone / wątki uśpione w oczekiwaniu na zadanie
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> idle{0};
+    std::mutex stateMutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    // chronione stateMutex
+    bool stopping = false;
+    std::exception_ptr firstError;
+
+    bool popLocal(std::size_t index, Entry& entry);
+    bool steal(std::size_t index, Entry& entry);
+    void run(Entry& entry);
+    void workerLoop(std::size_t index);
+
+public:
+    // 0 = liczba rdzeni
+    explicit WorkStealingPool(std::size_t threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+    // czeka na zakończenie wszystkich zgłoszonych zadań; rzuca pierwszy wyjątek zgłoszony przez zadanie.
+    // Nie jest wielowejściowe: zadanie tej samej puli czekałoby na samo siebie, więc wywołanie
+    // z wątku puli rzuca MyException zamiast zakleszczyć pulę
+    void wait();
+
+    [[nodiscard]] std::size_t size() const { return workers.size(); }
+};
+
+#endif //TKOM_PROJEKT_WORKSTEALINGPOOL_H
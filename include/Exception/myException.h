@@ -14,8 +14,11 @@ public:
     [[nodiscard]] const char * what() const noexcept override;
 
     [[nodiscard]] struct Position getPosition() const noexcept;
+    // komunikat bez dopisanej pozycji
+    [[nodiscard]] const std::string& getMessage() const noexcept { return message; }
 
 private:
+    std::string message;
     std::string errorMessage;
     struct Position pos{};
 };
@@ -0,0 +1,73 @@
+#ifndef TKOM_PROJEKT_PROGRAMGENERATOR_H
+#define TKOM_PROJEKT_PROGRAMGENERATOR_H
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Parametry syntetycznego programu do testów skalowania.
+struct GeneratorOptions
+{
+    int functions = 10;
+    int statementsPerBlock = 5;
+    // dokładna głębokość bloków w każdej funkcji: jeden łańcuch zagnieżdżonych if/while,
+    // pozostałe instrukcje bez bloków
+    int nestingDepth = 2;
+    // liczba operandów w wyrażeniu arytmetycznym
+    int expressionLength = 3;
+    int structCount = 1;
+    int variantCount = 1;
+    // ile kolejnych funkcji wywołuje każda funkcja
+    int callFanOut = 2;
+    // głębokość wywołań przekazywana z main - ogranicza czas interpretacji przy dużym fan-out
+    int callDepth = 3;
+    std::uint32_t seed = 1;
+};
+
+// Generuje poprawne programy (przechodzące SemanticVisitor). Graf wywołań jest acykliczny
+// (f_i woła tylko f_j dla j > i), pętle mają stałą liczbę obrotów, a arytmetyka używa tylko + i -,
+// więc wygenerowany program zawsze się kończy.
+class ProgramGenerator
+{
+private:
+    struct Scope
+    {
+        std::vector<std::string> ints;
+        std::vector<std::string> mutableInts;
+        std::vector<std::string> structs;
+        std::vector<std::string> mutableStructs;
+        std::vector<std::string> variants;
+    };
+
+    GeneratorOptions options;
+    std::mt19937 random;
+    std::string source;
+    std::vector<Scope> scopes;
+    int nextVariable = 0;
+
+    void generateStructTypes();
+    void generateVariantTypes();
+    void generateFunction(int index);
+    void generateMain();
+    // blok z 'chain' zawiera kolejne ogniwo łańcucha zagnieżdżeń, dopóki depth < nestingDepth
+    void generateBlock(int depth, const std::string& indent, bool chain);
+    void generateNested(int depth, const std::string& indent);
+    void generateStatement(const std::string& indent);
+    void generateCalls(int index, const std::string& indent);
+
+    std::string expression();
+    std::string operand();
+    std::string newVariable(const std::string& prefix);
+    int randomInt(int from, int to);
+    // losowa nazwa z widocznych zasięgów, bez kopiowania list
+    std::optional<std::string> pickVisible(std::vector<std::string> Scope::*member);
+
+public:
+    explicit ProgramGenerator(GeneratorOptions options);
+
+    std::string generate();
+};
+
+#endif //TKOM_PROJEKT_PROGRAMGENERATOR_H
@@ -12,8 +12,10 @@ class Lexer {
 public:
     CharReader charReader;
     char currChar = ' ';
-    Position tokenPos{};
+    SourceLocation tokenPos{};
     Token currToken = Token();
+    // znaki bieżącego literału liczbowego dla from_chars
+    std::string numberChars;
 
 public:
     Lexer();
@@ -13,18 +13,19 @@ public:
 private:
     TokenTypes tokenType;
     valueContainer tokenValue=0;
-    struct Position position{};
+    SourceLocation location{};
 
 public:
     Token();
-    Token(TokenTypes, struct Position);
-    Token(TokenTypes, std::string, struct Position);
-    Token(TokenTypes, int, struct Position);
-    Token(TokenTypes, float, struct Position);
+    Token(TokenTypes, SourceLocation);
+    Token(TokenTypes, std::string, SourceLocation);
+    Token(TokenTypes, int, SourceLocation);
+    Token(TokenTypes, float, SourceLocation);
 
     [[nodiscard]] TokenTypes getType() const;
     [[nodiscard]] valueContainer getValue() const;
     [[nodiscard]] Position getPosition() const;
+    [[nodiscard]] SourceLocation getLocation() const;
 };
 
 #endif //TKOM_PROJEKT_TOKEN_H
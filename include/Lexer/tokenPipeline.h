@@ -0,0 +1,109 @@
+#ifndef TKOM_PROJEKT_TOKENPIPELINE_H
+#define TKOM_PROJEKT_TOKENPIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "allocTracker.h"
+#include "lexer.h"
+
+// Kolejka bez blokad dla jednego producenta i jednego konsumenta. Producent zapisuje tylko tail,
+// konsument tylko head; release przy przesunięciu indeksu publikuje zawartość slotu drugiej stronie.
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+private:
+    std::array<T, Capacity> slots;
+    // osobne linie pamięci podręcznej, żeby wątki nie unieważniały sobie nawzajem indeksów
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+public:
+    // false gdy kolejka pełna; value zostaje wtedy nietknięte
+    bool tryPush(T& value) {
+        auto position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        slots[position & (Capacity - 1)] = std::move(value);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // false gdy kolejka pusta
+    bool tryPop(T& value) {
+        auto position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire))
+            return false;
+        value = std::move(slots[position & (Capacity - 1)]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // stan do sprawdzenia przed uśpieniem wątku, który czeka na drugą stronę
+    [[nodiscard]] bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool full() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire) == Capacity;
+    }
+};
+
+// Potokowy front-end: Lexer działa w osobnym wątku i oddaje paczki tokenów (bez komentarzy)
+// przez SpscQueue, parser pobiera je przez next(). Wyjątek leksera trafia do parsera dopiero,
+// gdy ten dojdzie do miejsca błędu - tak jak przy czytaniu tokenów na bieżąco.
+// Strona, która czeka na drugą (pusta albo pełna kolejka), ustępuje procesor przez SPIN_TRIES prób,
+// a potem zasypia na zmiennej warunkowej - lekser czekający na wejście nie zajmuje rdzenia parserem.
+class TokenPipeline
+{
+public:
+    static constexpr std::size_t BATCH_SIZE = 256;
+    static constexpr std::size_t QUEUE_CAPACITY = 64;
+    static constexpr std::size_t SPIN_TRIES = 64;
+
+private:
+    struct Batch
+    {
+        std::vector<Token> tokens;
+        // błąd leksera po ostatnim tokenie paczki
+        std::exception_ptr error;
+    };
+
+    Lexer lexer;
+    SpscQueue<Batch, QUEUE_CAPACITY> queue;
+    // konsument przestał czytać (np. błąd składni) - producent kończy zamiast czekać na miejsce
+    std::atomic<bool> stopping{false};
+    // uśpienie po nieudanym oczekiwaniu aktywnym; sleepers pozwala budzącemu pominąć blokadę
+    std::mutex parkMutex;
+    std::condition_variable parked;
+    std::atomic<int> sleepers{0};
+    std::thread producer;
+
+    Batch current;
+    std::size_t index = 0;
+
+    // phase - faza AllocTracker wątku, który utworzył potok
+    void produce(AllocTracker::Phase phase);
+    // false gdy konsument się wycofał
+    bool push(Batch& batch);
+    template<typename Ready>
+    void park(Ready ready);
+    void wake();
+
+public:
+    explicit TokenPipeline(std::istream& input_stream);
+    explicit TokenPipeline(const std::string& file_name);
+    ~TokenPipeline();
+
+    TokenPipeline(const TokenPipeline&) = delete;
+    TokenPipeline& operator=(const TokenPipeline&) = delete;
+
+    // następny token; po EOF_TOKEN zwraca go dalej
+    Token next();
+};
+
+#endif //TKOM_PROJEKT_TOKENPIPELINE_H
@@ -39,6 +39,7 @@ enum class TokenTypes{
     TRUE_KW,
     FALSE_KW,
     FUN_KW,
+    IMPORT_KW,
 
     // Types Keywords
     INT_KW,
@@ -107,6 +108,7 @@ constexpr std::string_view strTokenTypes[] =
     "TRUE_KW",
     "FALSE_KW",
     "FUN_KW",
+    "IMPORT_KW",
 
     // Types Keywords
     "INT_KW",
@@ -7,24 +7,48 @@
 #include "syntaxTree.h"
 #include "lexer.h"
 #include "token.h"
+#include "tokenPipeline.h"
 
 class Parser {
 private:
     Lexer lexer;
+    // tryb potokowy: tokeny z leksera w osobnym wątku zamiast z pola lexer
+    std::unique_ptr<TokenPipeline> pipeline;
     Token currToken;
+    // token za bieżącym, pobrany przez peekToken()
+    std::optional<Token> peekedToken;
 
     std::map<std::string, std::unique_ptr<Nodes::FunctionDeclaration>> functions;
     std::map<std::string, std::unique_ptr<Nodes::Declaration>> variables;
     std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>> structTypes;
     std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>> variantTypes;
 
+    std::vector<Nodes::Import> imports;
+    // fragment dokumentu: typy zmiennych globalnych mogą być zdefiniowane poza parsowanym tekstem
+    bool externalTypes = false;
+    // tryb leniwy: ciało funkcji zapisywane jako tokeny, parsowane przy pierwszym wywołaniu
+    bool lazyBodies = false;
+    // parser ciała leniwej funkcji czyta zapisane tokeny zamiast leksera
+    std::vector<Token> replayTokens;
+    std::size_t replayIndex = 0;
+    bool replaying = false;
+
     std::vector<std::string> structTypeNames;
     std::vector<std::string> variantTypeNames;
 
     // Helper functions
 public:
     bool matchToken(TokenTypes) const;
+    // wartość bieżącego tokenu; token bez wartości tego typu to błąd składni, a nie bad_variant_access
+    template<typename T>
+    T tokenValue() const {
+        auto value = currToken.getValue();
+        if (auto held = std::get_if<T>(&value))
+            return std::move(*held);
+        throw MyException("Unexpected token", currToken.getPosition());
+    }
     void getNextToken();
+    const Token& peekToken();
     void consumeToken(TokenTypes, const std::string&);
     bool isIdType(TokenTypes) const;
     bool isSimpleVarType(TokenTypes) const;
@@ -41,6 +65,11 @@ public:
 // public:
     explicit Parser(std::istream& input_stream): lexer(input_stream), currToken(lexer.getNextToken()) {};
     explicit Parser(const std::string& file_name): lexer(file_name), currToken(lexer.getNextToken()) {};
+    explicit Parser(std::vector<Token> tokens);
+    // front-end potokowy (TokenPipeline) dla dużych wejść: lexer w osobnym wątku
+    struct Pipelined {};
+    Parser(std::istream& input_stream, Pipelined);
+    Parser(const std::string& file_name, Pipelined);
 
     // Literals Parsing
     std::unique_ptr<Nodes::StringLiteral> parseStringLiteral();
@@ -57,9 +86,17 @@ public:
     std::unique_ptr<Nodes::CastOp> parseCastOp();
 
     // Expressions Parsing
+    // poziomy wiązania operatorów dwuargumentowych, od najsilniejszego; odpowiadają typom węzłów
+    // UnaryExpr, MulExpr, ArtmExpr, RelExpr, AndExpr, OrExpr
+    enum class ExprLevel { UNARY, MUL, ARTM, REL, AND, OR };
+    // jedna pętla (Pratt / shunting-yard) dla wszystkich poziomów do 'level'; wynik jest węzłem tego poziomu
+    std::unique_ptr<Nodes::Factor> parseBinaryExpression(ExprLevel level);
     std::unique_ptr<Nodes::Factor> parseFunctionCallOrVarRef();
     std::unique_ptr<Nodes::CastingExpr> parseCastingExpression();
     std::unique_ptr<Nodes::UnaryExpr> parseUnaryExpression();
+    // dokończenie operandu po wczytanym czynniku: opcjonalne 'as [typ]' i operator jednoargumentowy
+    std::unique_ptr<Nodes::CastingExpr> finishCastingExpression(std::unique_ptr<Nodes::Factor> factor);
+    std::unique_ptr<Nodes::UnaryExpr> finishUnaryExpression(std::unique_ptr<Nodes::UnaryOp> op, std::unique_ptr<Nodes::CastingExpr> expr);
     std::unique_ptr<Nodes::MulExpr> parseMulExpression();
     std::unique_ptr<Nodes::ArtmExpr> parseArtmExpression();
     std::unique_ptr<Nodes::RelExpr> parseRelExpression();
@@ -73,6 +110,7 @@ public:
     std::unique_ptr<Nodes::WhileStatement> parseWhileStatement();
     std::unique_ptr<Nodes::IfStatement> parseIfStatement();
     std::unique_ptr<Nodes::Block> parseBlock();
+    std::vector<Token> skipBlock();
     std::unique_ptr<Nodes::ReturnStatement> parseReturnStatement();
     std::unique_ptr<Nodes::Statement> parseAssignmentOrCallOrVar(std::set<std::string>&);
     std::unique_ptr<Nodes::Statement> parseStatement(std::set<std::string>&);
@@ -90,6 +128,11 @@ public:
 
     // High-Level Parsing
     std::unique_ptr<Nodes::Program> parseProgram();
+    bool parseImport();
+    void allowExternalTypes() { externalTypes = true; }
+    void enableLazyBodies() { lazyBodies = true; }
+    // parsuje ciało zapisane przez skipBlock
+    static std::unique_ptr<Nodes::Block> parseLazyBody(const std::vector<Token>& tokens);
     bool parseFunction();
     bool parseDeclaration();
     bool parseVarDeclaration();
@@ -3,41 +3,37 @@
 
 #include <optional>
 #include "syntaxTree.h"
+#include "typeLayout.h"
 
-class StructInfo;
-class StructFieldInfo;
-
+// Instancja struktury: płaska tablica wartości pól w kolejności z StructLayout
 class StructInfo
 {
 public:
-    std::map<std::string, StructFieldInfo> fields;
-    explicit StructInfo(const std::map<std::string, StructFieldInfo>& fields) : fields(fields) {}
+    std::shared_ptr<const StructLayout> layout;
+    std::vector<std::variant<int, float, bool, std::string>> values;
+    explicit StructInfo(std::shared_ptr<const StructLayout> layout);
 };
 
-class StructFieldInfo
+// Instancja wariantu: znacznik aktywnej alternatywy, sama wartość trzymana inline w SymbolInfo::value.
+// Zajmuje miejsce nazwy typu w SymbolInfo::type, więc symbole innych typów za nią nie płacą.
+class VariantInfo
 {
-private:
-    IdType fieldType;
-    std::optional<std::variant<int, float, bool, std::string>> fieldValue;
-
 public:
-    StructFieldInfo(const IdType fieldType,
-                    const std::optional<std::variant<int, float, bool, std::string>> fieldValue)
-            : fieldType(fieldType), fieldValue(fieldValue) {}
-    StructFieldInfo() : fieldType(IdType::STRUCT) {};
-    [[nodiscard]] IdType getFieldType() const { return fieldType; }
-    [[nodiscard]] std::optional<std::variant<int, float, bool, std::string>> getFieldValue() const { return fieldValue; }
+    std::shared_ptr<const VariantLayout> layout;
+    std::uint8_t tag = VariantLayout::NO_TAG;
+    explicit VariantInfo(std::shared_ptr<const VariantLayout> layout) : layout(std::move(layout)) {}
 };
 
 class SymbolInfo
 {
 private:
     std::string identifier;
-    std::variant<IdType, std::string, std::shared_ptr<StructInfo>> type;
+    std::variant<IdType, std::string, std::shared_ptr<StructInfo>, VariantInfo> type;
     bool isFunction;
     bool isMutable;
     bool isSimpleType;
     std::optional<std::variant<int,float,bool,std::string>> value;
+    // węzeł drzewa programu - wykonanie tylko go czyta, więc symbol może wskazywać na program współdzielony
     std::optional<Nodes::FunctionDeclaration*> funcPointer;
 public:
     SymbolInfo(const std::string& identifier, const std::variant<IdType,
@@ -45,6 +41,7 @@ public:
                const std::optional<std::variant<std::variant<int,float,bool,std::string>, Nodes::FunctionDeclaration*>>& value);
 
     std::optional<Nodes::FunctionDeclaration*> getFuncPointer() {return funcPointer.value();}
+    void setFuncPointer(Nodes::FunctionDeclaration* function) { funcPointer = function; }
     [[nodiscard]] std::string getIdentifier() const;
     [[nodiscard]] std::variant<IdType, std::string> getType() const;
     [[nodiscard]] std::string getTypeAsString() const;
@@ -53,7 +50,12 @@ public:
     [[nodiscard]] bool isSimple() const;
     [[nodiscard]] bool isStruct() const;
     [[nodiscard]] std::shared_ptr<StructInfo> getStructInfo() const;
-    void setValue(std::variant<int,float,bool,std::string> &val) { this->value=val;}
+    [[nodiscard]] bool isVariant() const { return std::holds_alternative<VariantInfo>(type); }
+    // nullptr gdy symbol nie jest wariantem
+    [[nodiscard]] const VariantInfo* getVariantInfo() const { return std::get_if<VariantInfo>(&type); }
+    // zastępuje nazwę typu wariantu jego układem; znacznik liczony z bieżącej wartości
+    void setVariantLayout(std::shared_ptr<const VariantLayout> layout);
+    void setValue(std::variant<int,float,bool,std::string> &val);
     [[nodiscard]] std::optional<std::variant<int,float,bool,std::string>> getValue() const;
 };
 
@@ -65,6 +67,8 @@ public:
     SymbolTable();
     bool insert(const std::string& identifier, const SymbolInfo& symbol);
     std::optional<SymbolInfo> getSymbol(const std::string& identifier);
+    // wskaźnik na symbol w tablicy (bez kopiowania) - nullptr gdy brak
+    SymbolInfo* findSymbol(const std::string& identifier);
     bool setValue(const std::string& identifier, std::variant<int,float,bool,std::string> newValue);
 };
 
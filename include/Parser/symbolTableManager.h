@@ -15,10 +15,12 @@ public:
     void enterNewContext();
     bool leaveContext();
     std::optional<SymbolInfo> getSymbol(const std::string&, bool);
+    SymbolInfo* findSymbol(const std::string&);
     bool insertSymbol(const std::string&, const SymbolInfo&);
     void setValue(const std::string& ID, const std::variant<int, float, bool, std::string>& newValue);
     bool isGlobal(const std::string&);
     bool checkIfExists(const std::string&);
+    [[nodiscard]] std::size_t getContextCount() const { return tables.size(); }
 };
 
 #endif //TKOM_PROJEKT_SYMBOLTABLEMANAGER_H
@@ -3,13 +3,19 @@
 
 #include <memory>
 #include <map>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 #include <variant>
 #include <optional>
+#include <atomic>
 #include "charReader.h"
+#include "token.h"
 
 class SyntaxTreeVisitor;
+class StructLayout;
+class VariantLayout;
 
 typedef enum UnaryOperator {
     NEGATE,
@@ -51,57 +57,77 @@ typedef enum RelationalOperator {
     LESS_EQUAL
 } RelationalOperator;
 
-typedef enum NodeType {
-    // Existing nodes
-    RELOP,
-    TERMOP,
-    FACTOROP,
-    SIMPEXPR,
-    ID_NODE,
-    FUNCCALLARGLIST,
-    FUNCCALL,
-    FACTOR,
-    TERM,
-    ARITHMETICEXPR,
-    NUMBER_NODE,
-    EXPR,
-    STMT,
-    STMTBLOCK,
-    ASSIGN,
-    IFSTMT,
-    WHILESTMT,
-    RETURNSTMT,
-    FUNCCALLSTMT,
-    TYPEDNODE,
-    DECLARATION,
-    FUNCDECLARGLIST,
-    FUNCDECL,
-    PROGRAM,
-
-    // Added nodes
-    BOOLEAN_EXPR,
-    BOOL_OP, // for boolean operators like AND, OR, NEGATE
-    LITERAL, // for handling literals like INT_VALUE, FLOAT_VALUE, STR_VALUE
-    BOOLEAN_LITERAL, // TRUE_KW, FALSE_KW
-    CONTROL_FLOW_STMT, // for IF_KW, ELSE_KW, WHILE_KW
-    TYPE_DECLARATION, // for STRUCT_KW, VARIANT_KW, MUT_KW
-    VARIABLE_DECLARATION, // specific for variable declarations
-} NodeType;
+// rodzaj węzła - jeden na każdą metodę visit* (poza abstrakcyjnym Declaration); pozwala wybrać
+// metodę wizytatora switchem zamiast wirtualnym accept (VisitorTemplate)
+enum class NodeKind {
+    BOOL_LITERAL,
+    INT_LITERAL,
+    FLOAT_LITERAL,
+    STRING_LITERAL,
+    IDENTIFIER,
+    REL_OP,
+    ARTM_OP,
+    FACTOR_OP,
+    UNARY_OP,
+    CAST_OP,
+    CASTING_EXPR,
+    UNARY_EXPR,
+    MUL_EXPR,
+    ARTM_EXPR,
+    REL_EXPR,
+    AND_EXPR,
+    OR_EXPR,
+    EXPRESSION,
+    FUN_CALL,
+    VAR_REFERENCE,
+    STRUCT_FIELD_REFERENCE,
+    VARIANT_HOLDING,
+    TYPE,
+    TYPE_DECL,
+    VARIABLE_DECLARATION,
+    STRUCT_TYPE_DEFINITION,
+    STRUCT_VAR_DECLARATION,
+    VARIANT_TYPE_DEFINITION,
+    VARIANT_VAR_DECLARATION,
+    ASSIGNMENT,
+    STRUCT_FIELD_ASSIGNMENT,
+    RETURN_STATEMENT,
+    BLOCK,
+    IF_STATEMENT,
+    WHILE_STATEMENT,
+    FUNCTION_CALL_STATEMENT,
+    FUNCTION_DECLARATION,
+    PROGRAM
+};
 
 
 class Node{
 public:
     virtual ~Node() = default;
     virtual void accept(SyntaxTreeVisitor&) = 0;
+    // przenosi do podanego wektora dzieci, które same mogą mieć dzieci - rozbiórka głębokiego drzewa bez rekurencji destruktorów
+    virtual void releaseChildren(std::vector<std::unique_ptr<Node>>&) {}
     [[nodiscard]] Position getPos() const;
+    [[nodiscard]] SourceLocation getLocation() const { return pos; }
     [[nodiscard]] std::string getNodeName() const;
+    [[nodiscard]] NodeKind getKind() const { return kind; }
 protected:
-    Position pos{};
+    SourceLocation pos{};
+    NodeKind kind{};
     std::string nodeName;
     friend std::ostream& operator<<(std::ostream& os, Node*);
 };
 
 namespace Nodes{
+    // Slot w ramce funkcji nadawany przez ScopeResolver; brak slotu oznacza zmienną globalną
+    class FrameSlot {
+    private:
+        std::optional<std::size_t> slot;
+    public:
+        [[nodiscard]] std::optional<std::size_t> getSlot() const { return slot; }
+        void setSlot(std::size_t index) { slot = index; }
+    };
+
     extern const std::vector<std::string> relationalOpToStr;
 
     extern const std::vector<std::string> factorOpToStr;
@@ -118,8 +144,9 @@ namespace Nodes{
     private:
         RelationalOperator relOp;
     public:
-        RelOp(RelationalOperator relOp, Position pos) : relOp(relOp) {
+        RelOp(RelationalOperator relOp, SourceLocation pos) : relOp(relOp) {
             this->pos = pos;
+            kind = NodeKind::REL_OP;
             nodeName = "Relation Operator: " + relationalOpToStr[relOp];
         }
         [[nodiscard]] RelationalOperator getType() const { return relOp; }
@@ -130,8 +157,9 @@ namespace Nodes{
     private:
         ArtmOperator termOp;
     public:
-        ArtmOp(ArtmOperator termOp, Position pos) : termOp(termOp) {
+        ArtmOp(ArtmOperator termOp, SourceLocation pos) : termOp(termOp) {
             this->pos = pos;
+            kind = NodeKind::ARTM_OP;
             nodeName = "Term Operator: " + termOpToStr[termOp];
         }
         [[nodiscard]] ArtmOperator getType() const { return termOp; }
@@ -142,8 +170,9 @@ namespace Nodes{
     private:
         FactorOperator factorOp;
     public:
-        FactorOp(FactorOperator factorOp, Position pos) : factorOp(factorOp) {
+        FactorOp(FactorOperator factorOp, SourceLocation pos) : factorOp(factorOp) {
             this->pos = pos;
+            kind = NodeKind::FACTOR_OP;
             nodeName = "Factor Operator: " + factorOpToStr[factorOp];
         }
         [[nodiscard]] FactorOperator getType() const { return factorOp; }
@@ -154,8 +183,9 @@ namespace Nodes{
     private:
         UnaryOperator unaryOp;
     public:
-        UnaryOp(UnaryOperator unaryOp, Position pos) : unaryOp(unaryOp) {
+        UnaryOp(UnaryOperator unaryOp, SourceLocation pos) : unaryOp(unaryOp) {
             this->pos = pos;
+            kind = NodeKind::UNARY_OP;
             nodeName = "Unary Operator: " + unaryTypeToStr[unaryOp];
         }
         [[nodiscard]] UnaryOperator getType() const { return unaryOp; }
@@ -166,8 +196,9 @@ namespace Nodes{
     private:
         IdType castOp;
     public:
-        CastOp(IdType castOp, Position pos) : castOp(castOp) {
+        CastOp(IdType castOp, SourceLocation pos) : castOp(castOp) {
             this->pos = pos;
+            kind = NodeKind::CAST_OP;
             nodeName = "Cast Operator: " + idTypesToStr[castOp];
         }
         [[nodiscard]] IdType getType() const {  return castOp; }
@@ -188,16 +219,18 @@ namespace Nodes{
         std::unique_ptr<Factor> expression;
         std::unique_ptr<CastOp> castOp;
     public:
-        CastingExpr(std::unique_ptr<Factor> expression, std::unique_ptr<CastOp> castOp, Position pos)
+        CastingExpr(std::unique_ptr<Factor> expression, std::unique_ptr<CastOp> castOp, SourceLocation pos)
                 : expression(std::move(expression)), castOp(std::move(castOp)) {
             this->pos = pos;
+            kind = NodeKind::CASTING_EXPR;
             nodeName = "CastingExpr: " + idTypesToStr[this->castOp->getType()];
         }
 
-        CastingExpr(std::unique_ptr<Factor> expression, Position pos)
+        CastingExpr(std::unique_ptr<Factor> expression, SourceLocation pos)
                 : expression(std::move(expression)) {
             this->pos = pos;
             this->castOp = nullptr;
+            kind = NodeKind::CASTING_EXPR;
             nodeName = "CastingExpr: ";
         }
 
@@ -211,6 +244,7 @@ namespace Nodes{
         void acceptExpr(SyntaxTreeVisitor &visitor) const;
         void acceptCastOperator(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class UnaryExpr: public Factor {
@@ -218,16 +252,18 @@ namespace Nodes{
         std::unique_ptr<UnaryOp> unaryOp;
         std::unique_ptr<CastingExpr> expression;
     public:
-        UnaryExpr(std::unique_ptr<UnaryOp> unaryOp, std::unique_ptr<CastingExpr> expression, Position pos)
+        UnaryExpr(std::unique_ptr<UnaryOp> unaryOp, std::unique_ptr<CastingExpr> expression, SourceLocation pos)
                 : expression(std::move(expression)), unaryOp(std::move(unaryOp)) {
             this->pos = pos;
+            kind = NodeKind::UNARY_EXPR;
             nodeName = "UnaryExpr: " + unaryTypeToStr[this->unaryOp->getType()];
         }
 
-        UnaryExpr(std::unique_ptr<CastingExpr> expression, Position pos)
+        UnaryExpr(std::unique_ptr<CastingExpr> expression, SourceLocation pos)
                 : expression(std::move(expression)){
             this->pos = pos;
             this->unaryOp = nullptr;
+            kind = NodeKind::UNARY_EXPR;
             nodeName = "UnaryExpr: ";
         }
 
@@ -241,6 +277,7 @@ namespace Nodes{
         void acceptExpr(SyntaxTreeVisitor &visitor) const;
         void acceptUnaryOperator(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class MulExpr: public Factor {
@@ -250,17 +287,19 @@ namespace Nodes{
         std::unique_ptr<MulExpr> right;
 
     public:
-        MulExpr(std::unique_ptr<UnaryExpr> left, std::unique_ptr<FactorOp> factorOp, std::unique_ptr<MulExpr> right, Position pos)
+        MulExpr(std::unique_ptr<UnaryExpr> left, std::unique_ptr<FactorOp> factorOp, std::unique_ptr<MulExpr> right, SourceLocation pos)
                 : left(std::move(left)), right(std::move(right)), factorOp(std::move(factorOp)) {
             this->pos = pos;
+            kind = NodeKind::MUL_EXPR;
             nodeName = "MulExpr";
         }
 
-        MulExpr(std::unique_ptr<UnaryExpr> left, Position pos)
+        MulExpr(std::unique_ptr<UnaryExpr> left, SourceLocation pos)
                 : left(std::move(left)){
             this->pos = pos;
             this->right = nullptr;
             this->factorOp = nullptr;
+            kind = NodeKind::MUL_EXPR;
             nodeName = "MulExpr";
         }
 
@@ -279,6 +318,7 @@ namespace Nodes{
         void acceptFactorOperator(SyntaxTreeVisitor &visitor) const;
         void acceptRight(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class ArtmExpr: public Factor {
@@ -288,17 +328,19 @@ namespace Nodes{
         std::unique_ptr<ArtmExpr> right;
 
     public:
-        ArtmExpr(std::unique_ptr<MulExpr> left, std::unique_ptr<ArtmOp> artmOp, std::unique_ptr<ArtmExpr> right, Position pos)
+        ArtmExpr(std::unique_ptr<MulExpr> left, std::unique_ptr<ArtmOp> artmOp, std::unique_ptr<ArtmExpr> right, SourceLocation pos)
                 : left(std::move(left)), right(std::move(right)), artmOp(std::move(artmOp)) {
             this->pos = pos;
+            kind = NodeKind::ARTM_EXPR;
             nodeName = "ArtmExpr";
         }
 
-        ArtmExpr(std::unique_ptr<MulExpr> left, Position pos)
+        ArtmExpr(std::unique_ptr<MulExpr> left, SourceLocation pos)
                 : left(std::move(left)) {
             this->right = nullptr;
             this->artmOp = nullptr;
             this->pos = pos;
+            kind = NodeKind::ARTM_EXPR;
             nodeName = "ArtmExpr";
         }
 
@@ -318,6 +360,7 @@ namespace Nodes{
         void acceptArtmOperator(SyntaxTreeVisitor &visitor) const;
         void acceptRight(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class RelExpr: public Factor {
@@ -327,17 +370,19 @@ namespace Nodes{
         std::unique_ptr<RelExpr> right;
 
     public:
-        RelExpr(std::unique_ptr<ArtmExpr> left, std::unique_ptr<RelOp> relOp, std::unique_ptr<RelExpr> right, Position pos)
+        RelExpr(std::unique_ptr<ArtmExpr> left, std::unique_ptr<RelOp> relOp, std::unique_ptr<RelExpr> right, SourceLocation pos)
                 : left(std::move(left)), right(std::move(right)), relOp(std::move(relOp)) {
             this->pos = pos;
+            kind = NodeKind::REL_EXPR;
             nodeName = "RelExpr";
         }
 
-        RelExpr(std::unique_ptr<ArtmExpr> left, Position pos)
+        RelExpr(std::unique_ptr<ArtmExpr> left, SourceLocation pos)
                 : left(std::move(left)) {
             this->right = nullptr;
             this->relOp = nullptr;
             this->pos = pos;
+            kind = NodeKind::REL_EXPR;
             nodeName = "RelExpr";
         }
 
@@ -357,6 +402,7 @@ namespace Nodes{
         void acceptRelOperator(SyntaxTreeVisitor &visitor) const;
         void acceptRight(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class AndExpr: public Factor {
@@ -364,16 +410,18 @@ namespace Nodes{
         std::unique_ptr<RelExpr> left;
         std::unique_ptr<AndExpr> right;
     public:
-        AndExpr(std::unique_ptr<RelExpr> left, std::unique_ptr<AndExpr> right, Position pos)
+        AndExpr(std::unique_ptr<RelExpr> left, std::unique_ptr<AndExpr> right, SourceLocation pos)
                 : left(std::move(left)), right(std::move(right)) {
             this->pos = pos;
+            kind = NodeKind::AND_EXPR;
             nodeName = "AndExpr";
         }
 
-        AndExpr(std::unique_ptr<RelExpr> left, Position pos)
+        AndExpr(std::unique_ptr<RelExpr> left, SourceLocation pos)
                 : left(std::move(left)) {
             this->right = nullptr;
             this->pos = pos;
+            kind = NodeKind::AND_EXPR;
             nodeName = "AndExpr";
         }
 
@@ -387,6 +435,7 @@ namespace Nodes{
         void acceptLeft(SyntaxTreeVisitor &visitor) const;
         void acceptRight(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class OrExpr : public Factor {
@@ -394,16 +443,18 @@ namespace Nodes{
         std::unique_ptr<AndExpr> left;
         std::unique_ptr<OrExpr> right;
     public:
-        OrExpr(std::unique_ptr<AndExpr> left, std::unique_ptr<OrExpr> right, Position pos)
+        OrExpr(std::unique_ptr<AndExpr> left, std::unique_ptr<OrExpr> right, SourceLocation pos)
                 : left(std::move(left)), right(std::move(right)) {
             this->pos = pos;
+            kind = NodeKind::OR_EXPR;
             nodeName = "(or) Expression";
         }
 
-        OrExpr(std::unique_ptr<AndExpr> left, Position pos)
+        OrExpr(std::unique_ptr<AndExpr> left, SourceLocation pos)
                 : left(std::move(left)) {
             this->right = nullptr;
             this->pos = pos;
+            kind = NodeKind::OR_EXPR;
             nodeName = "(or) Expression";
         }
 
@@ -418,22 +469,27 @@ namespace Nodes{
         void acceptLeft(SyntaxTreeVisitor &visitor) const;
         void acceptRight(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class Expression: public Factor {
     private:
         std::unique_ptr<OrExpr> expression;
     public:
-        Expression(std::unique_ptr<OrExpr> expression, Position pos)
+        Expression(std::unique_ptr<OrExpr> expression, SourceLocation pos)
                 : expression(std::move(expression)) {
             this->pos = pos;
+            kind = NodeKind::EXPRESSION;
             nodeName = "Expression";
         }
+        // nawiasy i łańcuchy operatorów zagnieżdżają się na tysiące poziomów - rozbierane na jawnym stosie
+        ~Expression() override;
         [[nodiscard]] const OrExpr* getExpression() const {
             return expression.get();
         }
         void acceptExpr(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     // Factor
@@ -441,8 +497,9 @@ namespace Nodes{
     private:
         bool value;
     public:
-        BooleanLiteral(bool value, Position pos) : value(value) {
+        BooleanLiteral(bool value, SourceLocation pos) : value(value) {
             this->pos = pos;
+            kind = NodeKind::BOOL_LITERAL;
             nodeName = "Boolean Literal: " + std::to_string(value);
         }
         [[nodiscard]] bool getValue() const { return value; }
@@ -453,8 +510,9 @@ namespace Nodes{
     private:
         int value;
     public:
-        IntLiteral(int value, Position pos) : value(value) {
+        IntLiteral(int value, SourceLocation pos) : value(value) {
             this->pos = pos;
+            kind = NodeKind::INT_LITERAL;
             nodeName = "Number Literal: " + std::to_string(value);
         }
         [[nodiscard]] int getValue() const { return value; }
@@ -465,8 +523,9 @@ namespace Nodes{
     private:
         float value;
     public:
-        FloatLiteral(float value, Position pos) : value(value) {
+        FloatLiteral(float value, SourceLocation pos) : value(value) {
             this->pos = pos;
+            kind = NodeKind::FLOAT_LITERAL;
             nodeName = "Number Literal: " + std::to_string(value);
         }
         [[nodiscard]] float getValue() const{ return value; }
@@ -477,8 +536,9 @@ namespace Nodes{
     private:
         std::string value;
     public:
-        StringLiteral(std::string value, Position pos) : value(std::move(value)) {
+        StringLiteral(std::string value, SourceLocation pos) : value(std::move(value)) {
             this->pos = pos;
+            kind = NodeKind::STRING_LITERAL;
             nodeName = "String Literal: " + this->value;
         }
         [[nodiscard]] std::string getValue() const { return value; }
@@ -489,8 +549,9 @@ namespace Nodes{
     private:
         std::string identifier;
     public:
-        Identifier(std::string name, Position pos) : identifier(std::move(name)) {
+        Identifier(std::string name, SourceLocation pos) : identifier(std::move(name)) {
             this->pos = pos;
+            kind = NodeKind::IDENTIFIER;
             nodeName = "Identifier: " + identifier;
         }
         [[nodiscard]] std::string getName() const { return identifier; }
@@ -502,9 +563,10 @@ namespace Nodes{
         std::string funName;
         std::vector<std::unique_ptr<Expression>> arguments;
     public:
-        FunCall(std::string functionName, std::vector<std::unique_ptr<Expression>> arguments, Position pos)
+        FunCall(std::string functionName, std::vector<std::unique_ptr<Expression>> arguments, SourceLocation pos)
                 : funName(std::move(functionName)), arguments(std::move(arguments)) {
             this->pos = pos;
+            kind = NodeKind::FUN_CALL;
             nodeName = "CallExpression: " + this->funName;
         }
 
@@ -517,16 +579,68 @@ namespace Nodes{
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
-    class VarReference: public Factor {
+    class VarReference: public Factor, public FrameSlot {
     private:
         std::string identifier;
+        std::optional<IdType> heldType;
     public:
-        VarReference(std::string identifier, Position pos)
+        VarReference(std::string identifier, SourceLocation pos)
                 : identifier(std::move(identifier)) {
             this->pos = pos;
+            kind = NodeKind::VAR_REFERENCE;
             nodeName = "VarReference: " + this->identifier;
         }
         [[nodiscard]] std::string getIdentifier() const { return identifier; }
+
+        // typ wariantu w gałęzi sprawdzonej przez v.holding() == T (else przy !=), ustawiany przez
+        // analizator semantyczny; interpreter sprawdza, czy alternatywa nie zmieniła się od testu
+        [[nodiscard]] std::optional<IdType> getHeldType() const { return heldType; }
+        void setHeldType(IdType type) { heldType = type; }
+        void accept(SyntaxTreeVisitor &visitor) override;
+    };
+
+    class StructFieldReference: public Factor, public FrameSlot {
+    private:
+        std::string identifier;
+        std::string fieldName;
+        std::optional<std::size_t> fieldIndex;
+    public:
+        StructFieldReference(std::string identifier, std::string fieldName, SourceLocation pos)
+                : identifier(std::move(identifier)), fieldName(std::move(fieldName)) {
+            this->pos = pos;
+            kind = NodeKind::STRUCT_FIELD_REFERENCE;
+            nodeName = "StructFieldReference: " + this->identifier + "." + this->fieldName;
+        }
+        [[nodiscard]] std::string getIdentifier() const { return identifier; }
+        [[nodiscard]] std::string getFieldName() const { return fieldName; }
+
+        // indeks pola w StructLayout, ustawiany przez analizator semantyczny
+        [[nodiscard]] std::optional<std::size_t> getFieldIndex() const { return fieldIndex; }
+        void setFieldIndex(std::size_t index) { fieldIndex = index; }
+        void accept(SyntaxTreeVisitor &visitor) override;
+    };
+
+    // e.holding() - nazwa typu aktywnej alternatywy; e.holding() == int - test znacznika (bool)
+    class VariantHolding: public Factor, public FrameSlot {
+    private:
+        std::string identifier;
+        std::optional<IdType> heldType;
+        bool negated = false;
+    public:
+        VariantHolding(std::string identifier, SourceLocation pos) : identifier(std::move(identifier)) {
+            this->pos = pos;
+            kind = NodeKind::VARIANT_HOLDING;
+            nodeName = "VariantHolding: " + this->identifier + ".holding()";
+        }
+        VariantHolding(std::string identifier, IdType heldType, bool negated, SourceLocation pos)
+                : VariantHolding(std::move(identifier), pos) {
+            this->heldType = heldType;
+            this->negated = negated;
+            nodeName += (negated ? " != " : " == ") + idTypesToStr[heldType];
+        }
+        [[nodiscard]] std::string getIdentifier() const { return identifier; }
+        [[nodiscard]] std::optional<IdType> getHeldType() const { return heldType; }
+        [[nodiscard]] bool isNegated() const { return negated; }
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
@@ -553,15 +667,17 @@ namespace Nodes{
     private:
         std::variant<IdType, std::string> type;
     public:
-        Type(IdType type, Position pos)
+        Type(IdType type, SourceLocation pos)
                 : type(type) {
             this->pos = pos;
+            kind = NodeKind::TYPE;
             nodeName = "Type: " + idTypesToStr[type];
         }
 
-        Type(std::string type, Position pos)
+        Type(std::string type, SourceLocation pos)
                 : type(type) {
             this->pos = pos;
+            kind = NodeKind::TYPE;
             nodeName = "Type: " + type;
         }
 
@@ -582,9 +698,10 @@ namespace Nodes{
         std::unique_ptr<Type> type;
         std::string identifier;
     public:
-        TypeDecl(std::unique_ptr<Type> type, std::string identifier, Position pos)
+        TypeDecl(std::unique_ptr<Type> type, std::string identifier, SourceLocation pos)
                 : type(std::move(type)), identifier(std::move(identifier)) {
             this->pos = pos;
+            kind = NodeKind::TYPE_DECL;
             nodeName = "TypeDecl: " + this->identifier + "::" + this->type->getTypeAsString();
         }
 
@@ -600,15 +717,16 @@ namespace Nodes{
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
-    class VariableDeclaration: public Declaration {
+    class VariableDeclaration: public Declaration, public FrameSlot {
     private:
         bool mut=false;
         std::unique_ptr<TypeDecl> type;
         std::unique_ptr<Expression> value;
     public:
-        VariableDeclaration(bool mut, std::unique_ptr<TypeDecl> type, std::unique_ptr<Expression> value, Position pos)
+        VariableDeclaration(bool mut, std::unique_ptr<TypeDecl> type, std::unique_ptr<Expression> value, SourceLocation pos)
                 : mut(mut), type(std::move(type)), value(std::move(value)) {
             this->pos = pos;
+            kind = NodeKind::VARIABLE_DECLARATION;
             nodeName = "VariableDeclaration: " + this->type->getIdentifier();
         }
 
@@ -641,11 +759,15 @@ namespace Nodes{
     private:
         std::string structName;
         std::vector<std::unique_ptr<TypeDecl>> fields;
+        std::shared_ptr<const StructLayout> layout;
+        void computeLayout();
     public:
-        StructTypeDefinition(std::string name, std::vector<std::unique_ptr<TypeDecl>> fieldList, Position pos)
+        StructTypeDefinition(std::string name, std::vector<std::unique_ptr<TypeDecl>> fieldList, SourceLocation pos)
                 : structName(std::move(name)), fields(std::move(fieldList)) {
             this->pos = pos;
+            kind = NodeKind::STRUCT_TYPE_DEFINITION;
             nodeName = "StructTypeDefinition: " + structName;
+            computeLayout();
         }
 
         [[nodiscard]] std::string getStructName() const {
@@ -656,18 +778,24 @@ namespace Nodes{
             return fields;
         }
 
+        // nullptr gdy któreś z pól nie jest typem prostym (błąd zgłasza analizator semantyczny)
+        [[nodiscard]] const std::shared_ptr<const StructLayout>& getLayout() const {
+            return layout;
+        }
+
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
-    class StructVarDeclaration: public Declaration {
+    class StructVarDeclaration: public Declaration, public FrameSlot {
     private:
         bool mut=false;
         std::unique_ptr<TypeDecl> type;
         std::vector<std::unique_ptr<Expression>> values;
     public:
-        StructVarDeclaration(bool mut, std::unique_ptr<TypeDecl> type, std::vector<std::unique_ptr<Expression>> values, Position pos)
+        StructVarDeclaration(bool mut, std::unique_ptr<TypeDecl> type, std::vector<std::unique_ptr<Expression>> values, SourceLocation pos)
                 : mut(mut), type(std::move(type)), values(std::move(values)) {
             this->pos = pos;
+            kind = NodeKind::STRUCT_VAR_DECLARATION;
             nodeName = "StructVarDeclaration: " + this->type->getIdentifier();
         }
 
@@ -697,11 +825,15 @@ namespace Nodes{
     private:
         std::string variantName;
         std::vector<std::unique_ptr<Type>> fields;
+        std::shared_ptr<const VariantLayout> layout;
+        void computeLayout();
     public:
-        VariantTypeDefinition(std::string name, std::vector<std::unique_ptr<Type>> fieldList, Position pos)
+        VariantTypeDefinition(std::string name, std::vector<std::unique_ptr<Type>> fieldList, SourceLocation pos)
                 : variantName(std::move(name)), fields(std::move(fieldList)) {
             this->pos = pos;
+            kind = NodeKind::VARIANT_TYPE_DEFINITION;
             nodeName = "VariantTypeDefinition: " + variantName;
+            computeLayout();
         }
 
         [[nodiscard]] std::string getVariantName() const {
@@ -712,17 +844,23 @@ namespace Nodes{
             return fields;
         }
 
+        // nullptr gdy któraś z alternatyw nie jest typem prostym (błąd zgłasza analizator semantyczny)
+        [[nodiscard]] const std::shared_ptr<const VariantLayout>& getLayout() const {
+            return layout;
+        }
+
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
-    class VariantVarDeclaration: public Declaration {
+    class VariantVarDeclaration: public Declaration, public FrameSlot {
     private:
         std::unique_ptr<TypeDecl> typeDecl;
         std::unique_ptr<Expression> value;
     public:
-        VariantVarDeclaration(std::unique_ptr<TypeDecl> typeDecl, std::unique_ptr<Expression> value, Position pos)
+        VariantVarDeclaration(std::unique_ptr<TypeDecl> typeDecl, std::unique_ptr<Expression> value, SourceLocation pos)
                 : typeDecl(std::move(typeDecl)), value(std::move(value)) {
             this->pos = pos;
+            kind = NodeKind::VARIANT_VAR_DECLARATION;
             nodeName = "VariantVarDeclaration: " + this->typeDecl->getIdentifier();
         }
 
@@ -747,14 +885,15 @@ namespace Nodes{
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
-    class Assignment: public Statement {
+    class Assignment: public Statement, public FrameSlot {
     private:
         std::string identifier;
         std::unique_ptr<Expression> expression;
     public:
-        Assignment(std::string identifier, std::unique_ptr<Expression> expression, Position pos)
+        Assignment(std::string identifier, std::unique_ptr<Expression> expression, SourceLocation pos)
                 : identifier(std::move(identifier)), expression(std::move(expression)) {
             this->pos = pos;
+            kind = NodeKind::ASSIGNMENT;
             nodeName = "Assignment: " + this->identifier;
         }
 
@@ -770,15 +909,17 @@ namespace Nodes{
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
-    class StructFieldAssignment : public Statement {
+    class StructFieldAssignment: public Statement, public FrameSlot {
     private:
         std::string identifier;
         std::string fieldName;
         std::unique_ptr<Expression> expression;
+        std::optional<std::size_t> fieldIndex;
     public:
-        StructFieldAssignment(std::string identifier, std::string fieldName, std::unique_ptr<Expression> expression, Position pos)
+        StructFieldAssignment(std::string identifier, std::string fieldName, std::unique_ptr<Expression> expression, SourceLocation pos)
                 : identifier(std::move(identifier)), fieldName(std::move(fieldName)), expression(std::move(expression)) {
             this->pos = pos;
+            kind = NodeKind::STRUCT_FIELD_ASSIGNMENT;
             nodeName = "StructFieldAssignment: " + this->identifier + "." + this->fieldName;
         }
 
@@ -794,6 +935,15 @@ namespace Nodes{
             return expression.get();
         }
 
+        // indeks pola w StructLayout, ustawiany przez analizator semantyczny
+        [[nodiscard]] std::optional<std::size_t> getFieldIndex() const {
+            return fieldIndex;
+        }
+
+        void setFieldIndex(std::size_t index) {
+            fieldIndex = index;
+        }
+
         void acceptExpr(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
     };
@@ -803,9 +953,10 @@ namespace Nodes{
     private:
         std::unique_ptr<Expression> expression;
     public:
-        ReturnStatement(std::unique_ptr<Expression> expression, Position pos)
+        ReturnStatement(std::unique_ptr<Expression> expression, SourceLocation pos)
                 : expression(std::move(expression)) {
             this->pos = pos;
+            kind = NodeKind::RETURN_STATEMENT;
             nodeName = "ReturnStatement";
         }
 
@@ -821,18 +972,23 @@ namespace Nodes{
     private:
         std::vector<std::unique_ptr<Statement>> statements;
     public:
-        Block(std::vector<std::unique_ptr<Statement>> statements, Position pos)
+        Block(std::vector<std::unique_ptr<Statement>> statements, SourceLocation pos)
                 : statements(std::move(statements)) {
             this->pos = pos;
+            kind = NodeKind::BLOCK;
             nodeName = "Block";
         }
 
+        // bloki if/while zagnieżdżają się na tysiące poziomów - rozbierane na jawnym stosie jak Expression
+        ~Block() override;
+
         [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& getStatements() const {
             return statements;
         }
 
         void acceptStatements(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class IfStatement: public Statement {
@@ -841,9 +997,10 @@ namespace Nodes{
         std::unique_ptr<Block> ifBlock;
         std::unique_ptr<Block> elseBlock;
     public:
-        IfStatement(std::unique_ptr<Expression> condition, std::unique_ptr<Block> ifBlock, std::unique_ptr<Block> elseBlock, Position pos)
+        IfStatement(std::unique_ptr<Expression> condition, std::unique_ptr<Block> ifBlock, std::unique_ptr<Block> elseBlock, SourceLocation pos)
                 : condition(std::move(condition)), ifBlock(std::move(ifBlock)), elseBlock(std::move(elseBlock)) {
             this->pos = pos;
+            kind = NodeKind::IF_STATEMENT;
             nodeName = "IfStatement";
         }
 
@@ -863,6 +1020,7 @@ namespace Nodes{
         void acceptIfBlock(SyntaxTreeVisitor &visitor) const;
         void acceptElseBlock(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class WhileStatement: public Statement {
@@ -870,9 +1028,10 @@ namespace Nodes{
         std::unique_ptr<Expression> condition;
         std::unique_ptr<Block> block;
     public:
-        WhileStatement(std::unique_ptr<Expression> condition, std::unique_ptr<Block> block, Position pos)
+        WhileStatement(std::unique_ptr<Expression> condition, std::unique_ptr<Block> block, SourceLocation pos)
                 : condition(std::move(condition)), block(std::move(block)) {
             this->pos = pos;
+            kind = NodeKind::WHILE_STATEMENT;
             nodeName = "WhileStatement";
         }
 
@@ -887,6 +1046,7 @@ namespace Nodes{
         void acceptCondition(SyntaxTreeVisitor &visitor) const;
         void acceptWhileBlock(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
+        void releaseChildren(std::vector<std::unique_ptr<Node>>& out) override;
     };
 
     class FunctionCallStatement: public Statement {
@@ -894,9 +1054,10 @@ namespace Nodes{
         std::string funName;
         std::vector<std::unique_ptr<Expression>> arguments;
     public:
-        FunctionCallStatement(std::string functionName, std::vector<std::unique_ptr<Expression>> arguments, Position pos)
+        FunctionCallStatement(std::string functionName, std::vector<std::unique_ptr<Expression>> arguments, SourceLocation pos)
                 : funName(std::move(functionName)), arguments(std::move(arguments)) {
             this->pos = pos;
+            kind = NodeKind::FUNCTION_CALL_STATEMENT;
             nodeName = "FunctionCallStatement: " + this->funName;
         }
 
@@ -916,10 +1077,15 @@ namespace Nodes{
         std::unique_ptr<TypeDecl> returnType;
         std::vector<std::unique_ptr<TypeDecl>> parameters;
         std::unique_ptr<Block> block;
+        std::size_t frameSize = 0;
+        // tryb leniwy: tokeny ciała do sparsowania przy pierwszym wywołaniu (LazyBodyLoader)
+        std::vector<Token> lazyBody;
+        std::atomic<bool> bodyParsed{true};
     public:
-        FunctionDeclaration(std::unique_ptr<TypeDecl> returnType, std::vector<std::unique_ptr<TypeDecl>> parameters, std::unique_ptr<Block> block, Position pos)
+        FunctionDeclaration(std::unique_ptr<TypeDecl> returnType, std::vector<std::unique_ptr<TypeDecl>> parameters, std::unique_ptr<Block> block, SourceLocation pos)
                 : returnType(std::move(returnType)), parameters(std::move(parameters)), block(std::move(block)) {
             this->pos = pos;
+            kind = NodeKind::FUNCTION_DECLARATION;
             nodeName = "FunctionDeclaration";
         }
 
@@ -937,25 +1103,69 @@ namespace Nodes{
             return returnType->getIdentifier();
         }
 
+        // liczba slotów ramki (parametry + maksymalnie naraz żywe zmienne lokalne), liczona przez ScopeResolver
+        [[nodiscard]] std::size_t getFrameSize() const {
+            return frameSize;
+        }
+
+        void setFrameSize(std::size_t size) {
+            frameSize = size;
+        }
+
+        // false dopóki ciało leniwej funkcji nie zostało sparsowane i sprawdzone
+        [[nodiscard]] bool isBodyParsed() const {
+            return bodyParsed.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] const std::vector<Token>& getLazyBody() const {
+            return lazyBody;
+        }
+
+        void setLazyBody(std::vector<Token> tokens);
+        // ciało podpięte, ale niewidoczne dla isBodyParsed aż do publishBody
+        void attachBody(std::unique_ptr<Block> body);
+        void publishBody();
+
         void acceptFunctionBody(SyntaxTreeVisitor &visitor) const;
         void acceptReturnType(SyntaxTreeVisitor &visitor) const;
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 
+    // import "ścieżka"; - ścieżka względem katalogu pliku, który importuje
+    struct Import
+    {
+        std::string path;
+        Position pos;
+    };
+
     class Program: public Node{
+    public:
+        // nazwy elementów programu, osobno dla każdego rodzaju
+        struct ItemNames
+        {
+            std::set<std::string> functions;
+            std::set<std::string> variables;
+            std::set<std::string> structTypes;
+            std::set<std::string> variantTypes;
+        };
+
     private:
+        std::vector<Import> imports;
         std::map<std::string, std::unique_ptr<Nodes::FunctionDeclaration>> functions;
         std::map<std::string, std::unique_ptr<Nodes::Declaration>> variables;
         std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>> structTypes;
         std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>> variantTypes;
+        // ustawiane przez ScopeResolver - po nim drzewo jest tylko czytane, więc program można wykonywać wielokrotnie
+        bool scopesResolved = false;
     public:
         Program(std::map<std::string, std::unique_ptr<Nodes::FunctionDeclaration>> functions,
                 std::map<std::string, std::unique_ptr<Nodes::Declaration>> variables,
                 std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>> structTypes,
                 std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>> variantTypes,
-                Position pos)
+                SourceLocation pos)
                 : functions(std::move(functions)), variables(std::move(variables)), structTypes(std::move(structTypes)), variantTypes(std::move(variantTypes)) {
             this->pos = pos;
+            kind = NodeKind::PROGRAM;
             nodeName = "Program";
         }
 
@@ -975,6 +1185,26 @@ namespace Nodes{
             return variantTypes;
         }
 
+        [[nodiscard]] const std::vector<Import>& getImports() const {
+            return imports;
+        }
+
+        void setImports(std::vector<Import> newImports) {
+            imports = std::move(newImports);
+        }
+
+        [[nodiscard]] bool areScopesResolved() const { return scopesResolved; }
+        void markScopesResolved() { scopesResolved = true; }
+        // czy któraś funkcja ma jeszcze niesparsowane (leniwe) ciało
+        [[nodiscard]] bool hasLazyFunctions() const;
+
+        // łączenie modułów: przenosi wszystkie elementy other; nazwa zdefiniowana w obu programach to błąd
+        void merge(Program& other);
+        [[nodiscard]] ItemNames getItemNames() const;
+        // usuwa elementy spoza names (np. kopie elementów modułów zależnych po analizie modułu)
+        void retainItems(const ItemNames& names);
+        void removeItems(const ItemNames& names);
+
         void accept(SyntaxTreeVisitor &visitor) override;
     };
 }
@@ -0,0 +1,72 @@
+#ifndef TKOM_PROJEKT_TYPELAYOUT_H
+#define TKOM_PROJEKT_TYPELAYOUT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include <map>
+#include "syntaxTree.h"
+
+struct StructFieldLayout
+{
+    std::string name;
+    IdType type;
+    std::size_t index;
+};
+
+// Układ struktury liczony raz na definicję typu - instancje są płaskimi tablicami wartości
+// indeksowanymi przez StructFieldLayout::index.
+class StructLayout
+{
+private:
+    std::string structName;
+    std::vector<StructFieldLayout> fields;
+    std::map<std::string, std::size_t> fieldIndices;
+
+public:
+    explicit StructLayout(const Nodes::StructTypeDefinition& definition);
+
+    [[nodiscard]] const std::string& getStructName() const { return structName; }
+    [[nodiscard]] const std::vector<StructFieldLayout>& getFields() const { return fields; }
+    [[nodiscard]] const StructFieldLayout& getField(std::size_t index) const { return fields[index]; }
+    [[nodiscard]] std::size_t getFieldCount() const { return fields.size(); }
+    [[nodiscard]] std::optional<std::size_t> getFieldIndex(const std::string& fieldName) const;
+};
+
+// Układ wariantu: znacznik to indeks alternatywy w kolejności deklaracji (VariantInfo::tag), wartość leży
+// w SymbolInfo. Tablice znaczników i nazw typów liczone raz, więc holding() i test znacznika to odczyt z tablicy.
+class VariantLayout
+{
+public:
+    using Value = std::variant<int, float, bool, std::string>;
+    static constexpr std::uint8_t NO_TAG = 0xFF;
+
+private:
+    std::string variantName;
+    std::vector<IdType> alternatives;
+    std::vector<std::string> alternativeNames;
+    // indeks Value::index() -> znacznik alternatywy (NO_TAG gdy typ nie należy do wariantu)
+    std::array<std::uint8_t, std::variant_size_v<Value>> tagsByValueIndex{};
+
+public:
+    explicit VariantLayout(const Nodes::VariantTypeDefinition& definition);
+
+    [[nodiscard]] const std::string& getVariantName() const { return variantName; }
+    [[nodiscard]] const std::vector<IdType>& getAlternatives() const { return alternatives; }
+    [[nodiscard]] IdType getAlternative(std::uint8_t tag) const { return alternatives[tag]; }
+    [[nodiscard]] std::size_t getAlternativeCount() const { return alternatives.size(); }
+    [[nodiscard]] const std::string& getTypeName(std::uint8_t tag) const { return alternativeNames[tag]; }
+
+    [[nodiscard]] std::uint8_t getTag(IdType type) const;
+    [[nodiscard]] std::uint8_t getTagForValue(const Value& value) const {
+        return tagsByValueIndex[value.index()];
+    }
+
+    static std::size_t valueIndexOf(IdType type);
+    static std::string keywordOf(IdType type);
+};
+
+#endif //TKOM_PROJEKT_TYPELAYOUT_H
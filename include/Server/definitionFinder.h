@@ -0,0 +1,47 @@
+#ifndef TKOM_PROJEKT_DEFINITIONFINDER_H
+#define TKOM_PROJEKT_DEFINITIONFINDER_H
+
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include "incrementalDocument.h"
+
+// Przejście do definicji w dokumencie. Globalne nazwy rozwiązywane są przez tablice nazw programu
+// (funkcje, zmienne, typy struktur i wariantów), lokalne - zakresami bloków jak w ScopeResolver.
+// Pozycje węzłów wskazują koniec konstrukcji, więc identyfikatory szukane są w tokenach elementu,
+// które mają dokładne offsety.
+class DefinitionFinder
+{
+public:
+    struct Definition
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+private:
+    const IncrementalDocument& document;
+
+    struct Symbol
+    {
+        const IncrementalDocument::Item* item;
+        std::vector<IncrementalDocument::ItemToken> tokens;
+        std::size_t index;
+    };
+
+    [[nodiscard]] static std::string identifierAt(const std::vector<IncrementalDocument::ItemToken>& tokens, std::size_t index);
+    [[nodiscard]] static bool declaresAt(const std::vector<IncrementalDocument::ItemToken>& tokens, std::size_t index);
+    [[nodiscard]] std::optional<Symbol> findGlobal(const std::string& name, std::set<std::string> Nodes::Program::ItemNames::* kind) const;
+    [[nodiscard]] std::optional<Symbol> findVariable(const std::string& name, const IncrementalDocument::Item& item,
+                                                     const std::vector<IncrementalDocument::ItemToken>& tokens, std::size_t index) const;
+    [[nodiscard]] std::optional<Symbol> findField(const Symbol& variable, const std::string& field) const;
+
+public:
+    explicit DefinitionFinder(const IncrementalDocument& document) : document(document) {}
+
+    // definicja identyfikatora pod offsetem (zakres nazwy w deklaracji)
+    [[nodiscard]] std::optional<Definition> find(std::size_t offset) const;
+};
+
+#endif //TKOM_PROJEKT_DEFINITIONFINDER_H
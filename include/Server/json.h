@@ -0,0 +1,64 @@
+#ifndef TKOM_PROJEKT_JSON_H
+#define TKOM_PROJEKT_JSON_H
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// Minimalna wartość JSON na potrzeby protokołu LSP: parsowanie wiadomości i zapis odpowiedzi.
+// Liczby trzymane są jako double (identyfikatory i pozycje LSP mieszczą się w nim dokładnie).
+class Json
+{
+public:
+    using Array = std::vector<Json>;
+    using Object = std::map<std::string, Json>;
+
+private:
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value;
+
+public:
+    Json() : value(nullptr) {}
+    Json(std::nullptr_t) : value(nullptr) {}
+    Json(bool boolean) : value(boolean) {}
+    template<typename T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    Json(T number) : value(static_cast<double>(number)) {}
+    Json(const char* string) : value(std::string(string)) {}
+    Json(std::string string) : value(std::move(string)) {}
+    Json(Array array) : value(std::move(array)) {}
+    Json(Object object) : value(std::move(object)) {}
+
+    // rzuca MyException przy niepoprawnym tekście
+    static Json parse(const std::string& text);
+
+    [[nodiscard]] bool isNull() const { return std::holds_alternative<std::nullptr_t>(value); }
+    [[nodiscard]] bool isBool() const { return std::holds_alternative<bool>(value); }
+    [[nodiscard]] bool isNumber() const { return std::holds_alternative<double>(value); }
+    [[nodiscard]] bool isString() const { return std::holds_alternative<std::string>(value); }
+    [[nodiscard]] bool isArray() const { return std::holds_alternative<Array>(value); }
+    [[nodiscard]] bool isObject() const { return std::holds_alternative<Object>(value); }
+
+    // odczyt z typem innym niż przechowywany rzuca MyException
+    [[nodiscard]] bool asBool() const;
+    [[nodiscard]] double asNumber() const;
+    [[nodiscard]] std::size_t asIndex() const;
+    [[nodiscard]] const std::string& asString() const;
+    [[nodiscard]] const Array& asArray() const;
+    [[nodiscard]] const Object& asObject() const;
+
+    [[nodiscard]] bool contains(const std::string& key) const;
+    // brakujący klucz (albo wartość niebędąca obiektem) daje null
+    const Json& operator[](const std::string& key) const;
+    // zamienia null w obiekt i dodaje brakujący klucz
+    Json& operator[](const std::string& key);
+
+    void write(std::ostream& output) const;
+    [[nodiscard]] std::string dump() const;
+
+    bool operator==(const Json& other) const { return value == other.value; }
+    bool operator!=(const Json& other) const { return value != other.value; }
+};
+
+#endif //TKOM_PROJEKT_JSON_H
@@ -0,0 +1,74 @@
+#ifndef TKOM_PROJEKT_LANGUAGESERVER_H
+#define TKOM_PROJEKT_LANGUAGESERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <string>
+#include "incrementalDocument.h"
+#include "json.h"
+
+// Serwer LSP na stdio. Wątek wywołujący run() tylko czyta i dekoduje wiadomości, osobny wątek
+// analizy trzyma otwarte dokumenty (IncrementalDocument - żywy Program dla każdego) i obsługuje
+// wiadomości po kolei. Diagnostyki publikowane są, gdy kolejka jest pusta (albo przed odpowiedzią
+// na żądanie), więc seria szybkich zmian nie czeka na wysłanie stanów pośrednich.
+//
+// Obsługiwane: initialize, shutdown, exit, textDocument/didOpen, didChange (pełna i przyrostowa
+// synchronizacja), didClose, textDocument/definition.
+class LanguageServer
+{
+private:
+    std::istream& input;
+    std::ostream& output;
+    std::mutex outputMutex;
+
+    // od wątku czytającego do wątku analizy
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<Json> queue;
+    bool inputClosed = false;
+
+    // używane tylko przez wątek analizy
+    std::map<std::string, std::unique_ptr<IncrementalDocument>> documents;
+    std::set<std::string> changedDocuments;
+    bool shutdownRequested = false;
+    bool exitRequested = false;
+
+    // treść kolejnej wiadomości (nagłówek Content-Length); brak na końcu wejścia
+    std::optional<std::string> readMessage();
+    // czyta i kolejkuje wiadomości do 'exit' albo końca wejścia
+    void readMessages();
+    // wątek analizy kończy pracę po obsłużeniu kolejki
+    void closeInput();
+    void send(const Json& message);
+    void respond(const Json& id, Json result);
+    void respondError(const Json& id, int code, const std::string& message);
+    void notify(const std::string& method, Json params);
+    void logError(const std::string& message);
+
+    void analyze();
+    void handle(const Json& message);
+    void changeDocument(const Json& params);
+    Json findDefinition(const Json& params) const;
+    void publishDiagnostics(const std::string& uri);
+    void publishChangedDocuments();
+    [[nodiscard]] const IncrementalDocument& documentOf(const Json& textDocument) const;
+
+public:
+    LanguageServer(std::istream& input, std::ostream& output) : input(input), output(output) {}
+
+    // obsługuje wiadomości do 'exit' albo końca wejścia, zwraca kod wyjścia procesu
+    int run();
+
+    // pozycje LSP: linia od 0, znak w jednostkach UTF-16
+    static std::size_t toOffset(const IncrementalDocument& document, const Json& position);
+    static Json toLspPosition(const IncrementalDocument& document, std::size_t offset);
+};
+
+#endif //TKOM_PROJEKT_LANGUAGESERVER_H
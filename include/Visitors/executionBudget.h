@@ -0,0 +1,46 @@
+#ifndef TKOM_PROJEKT_EXECUTIONBUDGET_H
+#define TKOM_PROJEKT_EXECUTIONBUDGET_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include "charReader.h"
+
+// Limit wykonania dla niezaufanych skryptów. Paliwo zużywane jest tylko w punktach kontrolnych
+// (skok wstecz pętli i wejście do funkcji): szybka ścieżka to jedna dekrementacja i jedno porównanie.
+// Licznik odlicza porcję paliwa; dopiero jej wyczerpanie wchodzi w wolną ścieżkę, która sprawdza
+// całkowity limit i termin i rzuca MyException. Ustawienie limitu zeruje porcję, więc pierwsza porcja
+// zaczyna się w pierwszym punkcie kontrolnym - dopiero wtedy liczony jest termin.
+class ExecutionBudget
+{
+public:
+    // co tyle punktów kontrolnych sprawdzany jest zegar, gdy ustawiono termin
+    static constexpr std::int64_t DEADLINE_CHECK_INTERVAL = 4096;
+
+private:
+    std::int64_t sliceRemaining;
+    std::optional<std::uint64_t> fuelLeft;
+    std::optional<std::chrono::milliseconds> timeLimit;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+
+    void refill(SourceLocation location);
+    void startSlice();
+    // oddaje niezużytą porcję do limitu; następny punkt kontrolny zacznie nową
+    void dropSlice();
+
+public:
+    ExecutionBudget() { startSlice(); }
+
+    void setFuel(std::uint64_t fuel);
+    void setTimeLimit(std::chrono::milliseconds limit);
+    [[nodiscard]] bool isLimited() const { return fuelLeft.has_value() || timeLimit.has_value(); }
+    // paliwo pozostałe do końca limitu (brak wartości gdy bez limitu)
+    [[nodiscard]] std::optional<std::uint64_t> getFuelLeft() const;
+
+    void consume(SourceLocation location) {
+        if (__builtin_expect(--sliceRemaining < 0, 0))
+            refill(location);
+    }
+};
+
+#endif //TKOM_PROJEKT_EXECUTIONBUDGET_H
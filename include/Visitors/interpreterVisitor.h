@@ -1,9 +1,15 @@
 #ifndef TKOM_PROJEKT_INTERPRETERVISITOR_H
 #define TKOM_PROJEKT_INTERPRETERVISITOR_H
 
+#include <iostream>
 #include <unordered_map>
 #include "syntaxTreeVisitor.h"
 #include "symbolTableManager.h"
+#include "executionBudget.h"
+#include "traversal.h"
+
+class Profiler;
+class LazyBodyLoader;
 
 class InterpreterVisitor : public SyntaxTreeVisitor
 {
@@ -13,11 +19,47 @@ private:
     std::variant<int, float, bool, std::string> currentValue;
     std::vector<std::variant<int, float, bool, std::string>> arguments;
     std::unordered_map<std::string, std::variant<int, float, bool, std::string>> variables;
+    // stos ramek zmiennych lokalnych; frameBase to początek ramki aktualnie wykonywanej funkcji
+    std::vector<std::optional<SymbolInfo>> frames;
+    std::size_t frameBase = 0;
+    // nullptr gdy profilowanie wyłączone
+    Profiler* profiler = nullptr;
+    // ładuje ciała leniwych funkcji przy pierwszym wywołaniu; nullptr gdy program parsowany w całości
+    LazyBodyLoader* lazyBodies = nullptr;
+    // sprawdzany przy skoku wstecz pętli i wejściu do funkcji; domyślnie bez limitu
+    ExecutionBudget budget;
+    std::ostream* output = &std::cout;
+    std::map<std::string, std::variant<int, float, bool, std::string>> inputs;
     bool returned= false;
+    // zagnieżdżenie wyrażeń liczonych rekurencyjnie; głębsze poddrzewa liczy evaluatePostOrder, a replay
+    // podaje wtedy visit* gotowe wartości dzieci
+    std::size_t expressionDepth = 0;
+    Traversal::OperandReplay<std::variant<int, float, bool, std::string>> replay;
+    // bloki if/while wykonywane w pętli zamiast rekurencji; przy ciele pętli jej instrukcja while
+    Traversal::BlockStack<Nodes::WhileStatement*> blocks;
     const std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>>& structTypes;
     const std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>>& variantTypes;
+
+    SymbolInfo* lookupVariable(const std::string& identifier, std::optional<std::size_t> slot);
+    void declareVariable(std::optional<std::size_t> slot, SymbolInfo symbol);
+    void applyInputs();
+    // true, gdy wartość węzła jest już policzona przez sterownik (trafia do currentValue)
+    bool replayed(Node* node);
+    void evaluateIteratively(Node* root);
+    // wewnątrz wykonywanego bloku odkłada blok na stos bloków, poza nim wykonuje go od razu
+    void acceptBlock(Nodes::Block* block, Nodes::WhileStatement* loop);
+    void runBlock(Nodes::Block* block, Nodes::WhileStatement* loop);
+    bool conditionHolds(Nodes::Expression* condition, SourceLocation pos);
 public:
     std::unordered_map<std::string, std::variant<int, float, bool, std::string>> getVariables() { return variables; }
+    void setProfiler(Profiler* newProfiler) { profiler = newProfiler; }
+    void setLazyBodyLoader(LazyBodyLoader* loader) { lazyBodies = loader; }
+    ExecutionBudget& getBudget() { return budget; }
+    void setOutput(std::ostream& newOutput) { output = &newOutput; }
+    void setInputs(std::map<std::string, std::variant<int, float, bool, std::string>> newInputs) { inputs = std::move(newInputs); }
+    [[nodiscard]] const std::variant<int, float, bool, std::string>& getResult() const { return currentValue; }
+    // czyści stan po poprzednim uruchomieniu, zachowując zaalokowaną pojemność stosu ramek
+    void reset();
     InterpreterVisitor(const std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>>& structTypes,
                     const std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>>& variantTypes)
             : structTypes(structTypes), variantTypes(variantTypes) {}
@@ -42,6 +84,8 @@ public:
     void visitExpr(Nodes::Expression *) override;
     void visitFuncCall(Nodes::FunCall *) override;
     void visitVariableRef(Nodes::VarReference *) override;
+    void visitStructFieldRef(Nodes::StructFieldReference *) override;
+    void visitVariantHolding(Nodes::VariantHolding *) override;
     void visitDeclaration(Nodes::Declaration *) override;
     void visitType(Nodes::Type *) override;
     void visitTypeDecl(Nodes::TypeDecl *) override;
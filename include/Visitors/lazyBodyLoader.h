@@ -0,0 +1,34 @@
+#ifndef TKOM_PROJEKT_LAZYBODYLOADER_H
+#define TKOM_PROJEKT_LAZYBODYLOADER_H
+
+#include <map>
+#include <mutex>
+#include "syntaxTree.h"
+#include "semanticVisitor.h"
+#include "myException.h"
+
+// Leniwe ciała funkcji (Parser::enableLazyBodies): przy pierwszym wywołaniu ciało jest parsowane
+// z zapisanych tokenów, sprawdzane semantycznie na kontekście globalnym programu i dostaje sloty
+// ramki. Wynik - także błąd - zostaje w drzewie/pamięci, więc każde ciało przetwarzane jest raz.
+// Jeden loader na program, współdzielony przez wątki: ładowanie pod blokadą, szybka ścieżka
+// (ciało już sparsowane) to tylko odczyt atomowej flagi w węźle funkcji.
+class LazyBodyLoader
+{
+private:
+    std::mutex mutex;
+    SemanticVisitor semanticVisitor;
+    std::map<const Nodes::FunctionDeclaration*, MyException> failures;
+
+    void loadLocked(Nodes::FunctionDeclaration* function);
+
+public:
+    // sprawdza deklaracje globalne programu; jego drzewo musi żyć dłużej niż loader
+    explicit LazyBodyLoader(Nodes::Program& program);
+
+    void load(Nodes::FunctionDeclaration* function) {
+        if (!function->isBodyParsed())
+            loadLocked(function);
+    }
+};
+
+#endif //TKOM_PROJEKT_LAZYBODYLOADER_H
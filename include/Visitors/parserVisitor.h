@@ -28,6 +28,8 @@ private:
     void visitExpr(Nodes::Expression *) override;
     void visitFuncCall(Nodes::FunCall *) override;
     void visitVariableRef(Nodes::VarReference *) override;
+    void visitStructFieldRef(Nodes::StructFieldReference *) override;
+    void visitVariantHolding(Nodes::VariantHolding *) override;
     void visitDeclaration(Nodes::Declaration *) override;
     void visitType(Nodes::Type *) override;
     void visitTypeDecl(Nodes::TypeDecl *) override;
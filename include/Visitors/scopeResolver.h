@@ -0,0 +1,71 @@
+#ifndef TKOM_PROJEKT_SCOPERESOLVER_H
+#define TKOM_PROJEKT_SCOPERESOLVER_H
+
+#include <optional>
+#include <unordered_map>
+#include "syntaxTreeVisitor.h"
+#include "traversal.h"
+
+// Statyczne rozwiązywanie zakresów: każda zmienna lokalna dostaje slot w ramce swojej funkcji,
+// sloty zwalniane po wyjściu z bloku są używane ponownie. Bloki nie istnieją już w czasie wykonania.
+class ScopeResolver : public SyntaxTreeVisitor
+{
+private:
+    std::vector<std::unordered_map<std::string, std::size_t>> scopes;
+    std::size_t nextSlot = 0;
+    std::size_t frameSize = 0;
+    // pierwszy wolny slot sprzed każdego otwartego bloku
+    std::vector<std::size_t> blockSlots;
+
+    [[nodiscard]] std::optional<std::size_t> resolve(const std::string& identifier) const;
+    std::optional<std::size_t> declare(const std::string& identifier);
+    template<typename T>
+    void resolveSlot(T* node);
+    template<typename T>
+    void declareSlot(T* node);
+    void resolveTree(Node* root);
+    void enter(Node* node);
+    void leave(Node* node);
+public:
+    void visitBoolLiteral(Nodes::BooleanLiteral *) override;
+    void visitIntLiteral(Nodes::IntLiteral *) override;
+    void visitFloatLiteral(Nodes::FloatLiteral *) override;
+    void visitStringLiteral(Nodes::StringLiteral *) override;
+    void visitIdentifier(Nodes::Identifier *) override;
+    void visitRelOp(Nodes::RelOp *) override;
+    void visitArtmOp(Nodes::ArtmOp *) override;
+    void visitFactorOp(Nodes::FactorOp *) override;
+    void visitUnaryOp(Nodes::UnaryOp *) override;
+    void visitCastOp(Nodes::CastOp *) override;
+    void visitCastingExpr(Nodes::CastingExpr *) override;
+    void visitUnaryExpr(Nodes::UnaryExpr *) override;
+    void visitMulExpr(Nodes::MulExpr *) override;
+    void visitArtmExpr(Nodes::ArtmExpr *) override;
+    void visitRelExpr(Nodes::RelExpr *) override;
+    void visitAndExpr(Nodes::AndExpr *) override;
+    void visitOrExpr(Nodes::OrExpr *) override;
+    void visitExpr(Nodes::Expression *) override;
+    void visitFuncCall(Nodes::FunCall *) override;
+    void visitVariableRef(Nodes::VarReference *) override;
+    void visitStructFieldRef(Nodes::StructFieldReference *) override;
+    void visitVariantHolding(Nodes::VariantHolding *) override;
+    void visitDeclaration(Nodes::Declaration *) override;
+    void visitType(Nodes::Type *) override;
+    void visitTypeDecl(Nodes::TypeDecl *) override;
+    void visitVariableDeclaration(Nodes::VariableDeclaration *) override;
+    void visitStructTypeDefinition(Nodes::StructTypeDefinition *) override;
+    void visitStructVarDeclaration(Nodes::StructVarDeclaration *) override;
+    void visitVariantTypeDefinition(Nodes::VariantTypeDefinition *) override;
+    void visitVariantVarDeclaration(Nodes::VariantVarDeclaration *) override;
+    void visitAssignment(Nodes::Assignment *) override;
+    void visitStructFieldAssignment(Nodes::StructFieldAssignment *) override;
+    void visitReturnStatement(Nodes::ReturnStatement *) override;
+    void visitBlock(Nodes::Block *) override;
+    void visitIfStatement(Nodes::IfStatement *) override;
+    void visitWhileStatement(Nodes::WhileStatement *) override;
+    void visitFunctionCallStatement(Nodes::FunctionCallStatement *) override;
+    void visitFunctionDeclaration(Nodes::FunctionDeclaration *) override;
+    void visitProgram(Nodes::Program *) override;
+};
+
+#endif //TKOM_PROJEKT_SCOPERESOLVER_H
@@ -1,10 +1,14 @@
 #ifndef TKOM_PROJEKT_SEMANTICVISITOR_H
 #define TKOM_PROJEKT_SEMANTICVISITOR_H
 
+#include <map>
 #include <optional>
+#include <set>
+#include <vector>
 #include "syntaxTreeVisitor.h"
 #include "MyException.h"
 #include "symbolTableManager.h"
+#include "traversal.h"
 
 class SemanticVisitor : public SyntaxTreeVisitor
 {
@@ -14,13 +18,71 @@ private:
     std::optional<IdType> lastEvaluatedType;
     const std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>>& structTypes;
     const std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>>& variantTypes;
+    // analiza pojedynczego modułu: main nie jest wymagany, a ciała funkcji z modułów zależnych
+    // (już sprawdzone) są pomijane
+    bool moduleMode = false;
+    std::set<std::string> importedFunctions;
+    // element najwyższego poziomu analizowany w chwili błędu
+    const Node* currentTopLevel = nullptr;
+    // wątki sprawdzające ciała funkcji w visitProgram; 0 = liczba rdzeni
+    std::size_t threads = 0;
+    std::vector<MyException> errors;
+    // zagnieżdżenie wyrażeń sprawdzanych rekurencyjnie; głębsze poddrzewa sprawdza evaluatePostOrder
+    std::size_t expressionDepth = 0;
+    Traversal::OperandReplay<std::optional<IdType>> replay;
+    // warianty, których alternatywę ustalił test v.holding() == T w otaczającym if/while
+    std::map<std::string, IdType> narrowedVariants;
+    // zawężenie obowiązujące w bloku i typ, który przywraca wyjście z niego
+    struct Narrowing
+    {
+        const Nodes::VariantHolding* test;
+        std::optional<IdType> previous;
+    };
+    Traversal::BlockStack<Narrowing> blocks;
 
+    // sprawdza ciało na kontekście globalnym; po błędzie przywraca stan sprzed wywołania
+    void checkBody(Nodes::FunctionDeclaration* function);
+    void checkBodies(const std::vector<Nodes::FunctionDeclaration*>& functions);
+    // true, gdy typ węzła jest już policzony przez sterownik (trafia do lastEvaluatedType)
+    bool replayed(Node* node);
+    void evaluateIteratively(Node* root);
+    // wartość wariantu bez testu holding() nie może trafić tam, gdzie potrzebny jest typ prosty
+    void requireChecked(const Node* node) const;
+    // blok sprawdzany z wariantem z testu zawężonym do testowanego typu (test może być nullptr);
+    // wewnątrz sprawdzanego bloku odkładany na stos bloków
+    void acceptNarrowed(Nodes::Block* block, const Nodes::VariantHolding* test);
+    void checkBlock(Nodes::Block* block, Narrowing narrowing);
+    void narrow(Narrowing& narrowing);
+    void restoreNarrowing(const Narrowing& narrowing);
 
 public:
     SemanticVisitor(const std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>>& structTypes,
                     const std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>>& variantTypes)
             : structTypes(structTypes), variantTypes(variantTypes) {}
 
+    // poniżej tylu funkcji ciała sprawdzane są w wątku wywołującym
+    static constexpr std::size_t PARALLEL_MIN_FUNCTIONS = 64;
+
+    [[nodiscard]] const Node* getCurrentTopLevelNode() const { return currentTopLevel; }
+
+    // visitProgram: deklaracje globalne i nagłówki zbierane są po kolei, potem ciała funkcji
+    // sprawdzane równolegle - każdy wątek na własnej kopii kontekstu globalnego
+    void setThreads(std::size_t count) { threads = count; }
+    // błędy ze wszystkich ciał funkcji z ostatniego visitProgram, w kolejności w źródle;
+    // visitProgram rzuca pierwszy z nich
+    [[nodiscard]] const std::vector<MyException>& getErrors() const { return errors; }
+
+    void checkAsModule(std::set<std::string> alreadyChecked) {
+        moduleMode = true;
+        importedFunctions = std::move(alreadyChecked);
+    }
+
+    // Analiza przyrostowa: declareGlobals sprawdza elementy globalne i zostawia ich kontekst otwarty,
+    // checkFunction sprawdza na nim pojedynczą funkcję - także nowy węzeł funkcji o tym samym nagłówku.
+    // Po błędzie w funkcji kontekst globalny zostaje, więc można sprawdzać dalej.
+    void declareGlobals(Nodes::Program* program);
+    void checkFunction(const std::string& name, Nodes::FunctionDeclaration* function);
+
     void visitBoolLiteral(Nodes::BooleanLiteral *) override;
     void visitIntLiteral(Nodes::IntLiteral *) override;
     void visitFloatLiteral(Nodes::FloatLiteral *) override;
@@ -41,6 +103,8 @@ public:
     void visitExpr(Nodes::Expression *) override;
     void visitFuncCall(Nodes::FunCall *) override;
     void visitVariableRef(Nodes::VarReference *) override;
+    void visitStructFieldRef(Nodes::StructFieldReference *) override;
+    void visitVariantHolding(Nodes::VariantHolding *) override;
     void visitDeclaration(Nodes::Declaration *) override;
     void visitType(Nodes::Type *) override;
     void visitTypeDecl(Nodes::TypeDecl *) override;
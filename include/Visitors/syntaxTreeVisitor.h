@@ -29,6 +29,8 @@ public:
 
     virtual void visitFuncCall(Nodes::FunCall*) = 0;
     virtual void visitVariableRef(Nodes::VarReference*) = 0;
+    virtual void visitStructFieldRef(Nodes::StructFieldReference*) = 0;
+    virtual void visitVariantHolding(Nodes::VariantHolding*) = 0;
     virtual void visitDeclaration(Nodes::Declaration*) = 0;
     virtual void visitType(Nodes::Type*) = 0;
     virtual void visitTypeDecl(Nodes::TypeDecl*) = 0;
@@ -0,0 +1,285 @@
+#ifndef TKOM_PROJEKT_TRAVERSAL_H
+#define TKOM_PROJEKT_TRAVERSAL_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "syntaxTree.h"
+
+// Przechodzenie drzewa na jawnym stosie (na stercie) zamiast rekurencji accept -> visit -> accept,
+// więc głębokość zagnieżdżenia programu nie jest ograniczona stosem wątku.
+namespace Traversal {
+    // zagnieżdżenie wyrażeń, do którego wizytatory liczą rekurencyjnie; głębsze poddrzewa
+    // przechodzą przez evaluatePostOrder
+    constexpr std::size_t RECURSION_LIMIT = 256;
+
+    // dopisuje bezpośrednie dzieci węzła w kolejności ze źródła (ta sama kolejność co accept*)
+    void appendChildren(Node* node, std::vector<Node*>& children);
+
+    // rodzic przed dziećmi
+    class PreOrderIterator
+    {
+    private:
+        std::vector<Node*> stack;
+        std::vector<Node*> children;
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Node*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Node* const*;
+        using reference = Node*;
+
+        PreOrderIterator() = default;
+        explicit PreOrderIterator(Node* root);
+        Node* operator*() const { return stack.back(); }
+        PreOrderIterator& operator++();
+        bool operator==(const PreOrderIterator& other) const { return stack == other.stack; }
+        bool operator!=(const PreOrderIterator& other) const { return !(*this == other); }
+    };
+
+    // dzieci przed rodzicem
+    class PostOrderIterator
+    {
+    private:
+        struct Entry
+        {
+            Node* node;
+            bool expanded;
+            bool operator==(const Entry& other) const { return node == other.node && expanded == other.expanded; }
+        };
+        std::vector<Entry> stack;
+        std::vector<Node*> children;
+        // rozwija wierzchołek stosu aż do liścia albo węzła z już odwiedzonymi dziećmi
+        void descend();
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Node*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Node* const*;
+        using reference = Node*;
+
+        PostOrderIterator() = default;
+        explicit PostOrderIterator(Node* root);
+        Node* operator*() const { return stack.back().node; }
+        PostOrderIterator& operator++();
+        bool operator==(const PostOrderIterator& other) const { return stack == other.stack; }
+        bool operator!=(const PostOrderIterator& other) const { return !(*this == other); }
+    };
+
+    // for (auto node : Traversal::PreOrder(program)) ...
+    class PreOrder
+    {
+    private:
+        Node* root;
+    public:
+        explicit PreOrder(Node* root) : root(root) {}
+        [[nodiscard]] PreOrderIterator begin() const { return PreOrderIterator(root); }
+        [[nodiscard]] PreOrderIterator end() const { return {}; }
+    };
+
+    class PostOrder
+    {
+    private:
+        Node* root;
+    public:
+        explicit PostOrder(Node* root) : root(root) {}
+        [[nodiscard]] PostOrderIterator begin() const { return PostOrderIterator(root); }
+        [[nodiscard]] PostOrderIterator end() const { return {}; }
+    };
+
+    // Przejście w głąb z wejściem do węzła i wyjściem z niego: enter(node) przed dziećmi,
+    // leave(node) po ostatnim z nich - np. zakres otwierany i zamykany przez blok.
+    template<typename Enter, typename Leave>
+    void walk(Node* root, Enter enter, Leave leave) {
+        struct Frame
+        {
+            Node* node;
+            bool expanded;
+        };
+        std::vector<Frame> frames{{root, false}};
+        std::vector<Node*> children;
+        while (!frames.empty()) {
+            if (frames.back().expanded) {
+                auto node = frames.back().node;
+                frames.pop_back();
+                leave(node);
+                continue;
+            }
+            frames.back().expanded = true;
+            auto node = frames.back().node;
+            enter(node);
+            children.clear();
+            appendChildren(node, children);
+            for (auto child = children.rbegin(); child != children.rend(); ++child)
+                frames.push_back({*child, false});
+        }
+    }
+
+    // Bloki instrukcji na jawnym stosie: if/while nie wywołuje accept swojego bloku, tylko odkłada go
+    // przez push, a run wykonuje instrukcje bloku z wierzchołka - zagnieżdżenie bloków nie zagłębia
+    // rekurencji. Extra to stan wizytatora związany z odłożonym blokiem (pętla, zawężenie wariantu).
+    template<typename Extra>
+    class BlockStack
+    {
+    private:
+        struct Frame
+        {
+            Nodes::Block* block;
+            std::size_t next;
+            bool entered;
+            Extra extra;
+        };
+        std::vector<Frame> frames;
+        // bloki odłożone przez bieżącą instrukcję, w kolejności wykonania
+        std::vector<Frame> deferred;
+        std::size_t running = 0;
+
+        void unwind(std::size_t base) {
+            deferred.clear();
+            frames.erase(frames.begin() + static_cast<std::ptrdiff_t>(base), frames.end());
+            --running;
+        }
+    public:
+        // true wewnątrz run - poza nim odłożony blok nie zostałby wykonany
+        [[nodiscard]] bool active() const { return running > 0; }
+
+        void push(Nodes::Block* block, Extra extra) { deferred.push_back({block, 0, false, std::move(extra)}); }
+
+        // Wykonuje root razem z blokami odłożonymi w trakcie. enter(block, extra) przed pierwszą instrukcją,
+        // statement(node) dla każdej instrukcji - false kończy wszystkie bloki tego wywołania (return),
+        // leave(block, extra) po ostatniej - true wykonuje blok jeszcze raz (kolejny obrót pętli).
+        // Wywołania mogą się zagnieżdżać (ciało funkcji wywołanej w wyrażeniu): każde kończy się na swoim poziomie.
+        template<typename Enter, typename Statement, typename Leave>
+        void run(Nodes::Block* root, Extra extra, Enter enter, Statement statement, Leave leave) {
+            auto base = frames.size();
+            frames.push_back({root, 0, false, std::move(extra)});
+            ++running;
+            try {
+                // indeksy zamiast referencji - callbacki odkładają bloki i mogą przenieść wektor
+                while (frames.size() > base) {
+                    auto top = frames.size() - 1;
+                    if (!frames[top].entered) {
+                        frames[top].entered = true;
+                        enter(frames[top].block, frames[top].extra);
+                    }
+                    const auto& statements = frames[top].block->getStatements();
+                    if (frames[top].next < statements.size()) {
+                        if (!statement(statements[frames[top].next++].get())) {
+                            unwind(base);
+                            return;
+                        }
+                        // pierwszy odłożony blok na wierzchołek
+                        for (auto block = deferred.rbegin(); block != deferred.rend(); ++block)
+                            frames.push_back(std::move(*block));
+                        deferred.clear();
+                        continue;
+                    }
+                    if (leave(frames[top].block, frames[top].extra)) {
+                        frames[top].next = 0;
+                        frames[top].entered = false;
+                        continue;
+                    }
+                    frames.pop_back();
+                }
+            } catch (...) {
+                unwind(base);
+                throw;
+            }
+            --running;
+        }
+
+        void clear() {
+            frames.clear();
+            deferred.clear();
+            running = 0;
+        }
+    };
+
+    // wartość policzona dla dziecka węzła
+    template<typename Value>
+    struct Operand
+    {
+        Node* node;
+        Value value;
+    };
+
+    // Obliczenie wartości drzewa bez rekursji: węzeł liczony jest po wszystkich swoich dzieciach,
+    // combine(node, first, last) dostaje ich wartości [first, last) w kolejności ze źródła i zwraca
+    // wartość węzła. Wartości czekające na rodzica leżą na stosie operandów.
+    template<typename Value, typename Combine>
+    Value evaluatePostOrder(Node* root, Combine combine) {
+        struct Frame
+        {
+            Node* node;
+            std::size_t firstOperand;
+            bool expanded;
+        };
+        std::vector<Frame> frames{{root, 0, false}};
+        std::vector<Operand<Value>> operands;
+        std::vector<Node*> children;
+        while (true) {
+            auto& top = frames.back();
+            if (!top.expanded) {
+                top.expanded = true;
+                top.firstOperand = operands.size();
+                children.clear();
+                appendChildren(top.node, children);
+                for (auto child = children.rbegin(); child != children.rend(); ++child)
+                    frames.push_back({*child, 0, false});
+                continue;
+            }
+            auto frame = top;
+            frames.pop_back();
+            auto first = operands.begin() + static_cast<std::ptrdiff_t>(frame.firstOperand);
+            Value value = combine(frame.node, operands.data() + frame.firstOperand, operands.data() + operands.size());
+            operands.erase(first, operands.end());
+            if (frames.empty())
+                return value;
+            operands.push_back({frame.node, std::move(value)});
+        }
+    }
+
+    // Krok evaluatePostOrder w wizytatorze: węzeł liczony jest zwykłą metodą visit*, a jego
+    // accept* na dzieciach zamiast schodzić niżej biorą gotowe wartości z operandów.
+    template<typename Value>
+    class OperandReplay
+    {
+    private:
+        // węzeł liczony w tym kroku; nullptr poza sterownikiem
+        Node* node = nullptr;
+        const Operand<Value>* first = nullptr;
+        const Operand<Value>* last = nullptr;
+    public:
+        OperandReplay() = default;
+        OperandReplay(Node* node, const Operand<Value>* first, const Operand<Value>* last)
+                : node(node), first(first), last(last) {}
+
+        [[nodiscard]] bool active() const { return node != nullptr; }
+
+        // policzona wartość dziecka; nullptr dla samego węzła kroku i poza sterownikiem
+        [[nodiscard]] const Value* find(const Node* visited) const {
+            if (node == nullptr || visited == node)
+                return nullptr;
+            for (auto operand = first; operand != last; ++operand)
+                if (operand->node == visited)
+                    return &operand->value;
+            return nullptr;
+        }
+    };
+
+    // licznik zagnieżdżenia rekurencyjnych wywołań visit*
+    class DepthGuard
+    {
+    private:
+        std::size_t& depth;
+    public:
+        explicit DepthGuard(std::size_t& depth) : depth(depth) { ++depth; }
+        ~DepthGuard() { --depth; }
+        DepthGuard(const DepthGuard&) = delete;
+        DepthGuard& operator=(const DepthGuard&) = delete;
+        [[nodiscard]] bool exceeded() const { return depth > RECURSION_LIMIT; }
+    };
+}
+
+#endif //TKOM_PROJEKT_TRAVERSAL_H
@@ -4,46 +4,139 @@
 #include "syntaxTree.h"
 #include "syntaxTreeVisitor.h"
 
-class VisitorTemplate: public SyntaxTreeVisitor
+// Baza wizytatora z wyborem metody w czasie kompilacji (CRTP):
+//
+//     class ConstantFolder : public VisitorTemplate<ConstantFolder> { void visitMulExpr(Nodes::MulExpr *) override; ... };
+//
+// visit(node) to switch po node->getKind() i kwalifikowane wywołanie Derived::visit* - bez wirtualnego
+// accept i wirtualnego visit*, więc kompilator może je rozwinąć w miejscu wywołania. Metody, których
+// Derived nie definiuje, nic nie robią. Wirtualny interfejs SyntaxTreeVisitor zostaje, więc ten sam
+// wizytator działa też z node->accept(visitor) i metodami accept* węzłów.
+template<typename Derived>
+class VisitorTemplate : public SyntaxTreeVisitor
 {
-    void visitBoolLiteral(Nodes::BooleanLiteral *) override;
-    void visitIntLiteral(Nodes::IntLiteral *) override;
-    void visitFloatLiteral(Nodes::FloatLiteral *) override;
-    void visitStringLiteral(Nodes::StringLiteral *) override;
-    void visitIdentifier(Nodes::Identifier *) override;
-    void visitRelOp(Nodes::RelOp *) override;
-    void visitArtmOp(Nodes::ArtmOp *) override;
-    void visitFactorOp(Nodes::FactorOp *) override;
-    void visitUnaryOp(Nodes::UnaryOp *) override;
-    void visitCastOp(Nodes::CastOp *) override;
-    void visitCastingExpr(Nodes::CastingExpr *) override;
-    void visitUnaryExpr(Nodes::UnaryExpr *) override;
-    void visitMulExpr(Nodes::MulExpr *) override;
-    void visitArtmExpr(Nodes::ArtmExpr *) override;
-    void visitRelExpr(Nodes::RelExpr *) override;
-    void visitAndExpr(Nodes::AndExpr *) override;
-    void visitOrExpr(Nodes::OrExpr *) override;
-    void visitExpr(Nodes::Expression *) override;
-    void visitFuncCall(Nodes::FunCall *) override;
-    void visitVariableRef(Nodes::VarReference *) override;
-    void visitDeclaration(Nodes::Declaration *) override;
-    void visitType(Nodes::Type *) override;
-    void visitTypeDecl(Nodes::TypeDecl *) override;
-    void visitVariableDeclaration(Nodes::VariableDeclaration *) override;
-    void visitStructTypeDefinition(Nodes::StructTypeDefinition *) override;
-    void visitStructVarDeclaration(Nodes::StructVarDeclaration *) override;
-    void visitVariantTypeDefinition(Nodes::VariantTypeDefinition *) override;
-    void visitVariantVarDeclaration(Nodes::VariantVarDeclaration *) override;
-    void visitAssignment(Nodes::Assignment *) override;
-    void visitStructFieldAssignment(Nodes::StructFieldAssignment *) override;
-    void visitReturnStatement(Nodes::ReturnStatement *) override;
-    void visitBlock(Nodes::Block *) override;
-    void visitIfStatement(Nodes::IfStatement *) override;
-    void visitWhileStatement(Nodes::WhileStatement *) override;
-    void visitFunctionCallStatement(Nodes::FunctionCallStatement *) override;
-    void visitFunctionDeclaration(Nodes::FunctionDeclaration *) override;
-    void visitProgram(Nodes::Program *) override;
-};
+public:
+    void visit(Node *node) {
+        auto self = static_cast<Derived*>(this);
+        switch (node->getKind()) {
+            case NodeKind::BOOL_LITERAL:
+                return self->Derived::visitBoolLiteral(static_cast<Nodes::BooleanLiteral*>(node));
+            case NodeKind::INT_LITERAL:
+                return self->Derived::visitIntLiteral(static_cast<Nodes::IntLiteral*>(node));
+            case NodeKind::FLOAT_LITERAL:
+                return self->Derived::visitFloatLiteral(static_cast<Nodes::FloatLiteral*>(node));
+            case NodeKind::STRING_LITERAL:
+                return self->Derived::visitStringLiteral(static_cast<Nodes::StringLiteral*>(node));
+            case NodeKind::IDENTIFIER:
+                return self->Derived::visitIdentifier(static_cast<Nodes::Identifier*>(node));
+            case NodeKind::REL_OP:
+                return self->Derived::visitRelOp(static_cast<Nodes::RelOp*>(node));
+            case NodeKind::ARTM_OP:
+                return self->Derived::visitArtmOp(static_cast<Nodes::ArtmOp*>(node));
+            case NodeKind::FACTOR_OP:
+                return self->Derived::visitFactorOp(static_cast<Nodes::FactorOp*>(node));
+            case NodeKind::UNARY_OP:
+                return self->Derived::visitUnaryOp(static_cast<Nodes::UnaryOp*>(node));
+            case NodeKind::CAST_OP:
+                return self->Derived::visitCastOp(static_cast<Nodes::CastOp*>(node));
+            case NodeKind::CASTING_EXPR:
+                return self->Derived::visitCastingExpr(static_cast<Nodes::CastingExpr*>(node));
+            case NodeKind::UNARY_EXPR:
+                return self->Derived::visitUnaryExpr(static_cast<Nodes::UnaryExpr*>(node));
+            case NodeKind::MUL_EXPR:
+                return self->Derived::visitMulExpr(static_cast<Nodes::MulExpr*>(node));
+            case NodeKind::ARTM_EXPR:
+                return self->Derived::visitArtmExpr(static_cast<Nodes::ArtmExpr*>(node));
+            case NodeKind::REL_EXPR:
+                return self->Derived::visitRelExpr(static_cast<Nodes::RelExpr*>(node));
+            case NodeKind::AND_EXPR:
+                return self->Derived::visitAndExpr(static_cast<Nodes::AndExpr*>(node));
+            case NodeKind::OR_EXPR:
+                return self->Derived::visitOrExpr(static_cast<Nodes::OrExpr*>(node));
+            case NodeKind::EXPRESSION:
+                return self->Derived::visitExpr(static_cast<Nodes::Expression*>(node));
+            case NodeKind::FUN_CALL:
+                return self->Derived::visitFuncCall(static_cast<Nodes::FunCall*>(node));
+            case NodeKind::VAR_REFERENCE:
+                return self->Derived::visitVariableRef(static_cast<Nodes::VarReference*>(node));
+            case NodeKind::STRUCT_FIELD_REFERENCE:
+                return self->Derived::visitStructFieldRef(static_cast<Nodes::StructFieldReference*>(node));
+            case NodeKind::VARIANT_HOLDING:
+                return self->Derived::visitVariantHolding(static_cast<Nodes::VariantHolding*>(node));
+            case NodeKind::TYPE:
+                return self->Derived::visitType(static_cast<Nodes::Type*>(node));
+            case NodeKind::TYPE_DECL:
+                return self->Derived::visitTypeDecl(static_cast<Nodes::TypeDecl*>(node));
+            case NodeKind::VARIABLE_DECLARATION:
+                return self->Derived::visitVariableDeclaration(static_cast<Nodes::VariableDeclaration*>(node));
+            case NodeKind::STRUCT_TYPE_DEFINITION:
+                return self->Derived::visitStructTypeDefinition(static_cast<Nodes::StructTypeDefinition*>(node));
+            case NodeKind::STRUCT_VAR_DECLARATION:
+                return self->Derived::visitStructVarDeclaration(static_cast<Nodes::StructVarDeclaration*>(node));
+            case NodeKind::VARIANT_TYPE_DEFINITION:
+                return self->Derived::visitVariantTypeDefinition(static_cast<Nodes::VariantTypeDefinition*>(node));
+            case NodeKind::VARIANT_VAR_DECLARATION:
+                return self->Derived::visitVariantVarDeclaration(static_cast<Nodes::VariantVarDeclaration*>(node));
+            case NodeKind::ASSIGNMENT:
+                return self->Derived::visitAssignment(static_cast<Nodes::Assignment*>(node));
+            case NodeKind::STRUCT_FIELD_ASSIGNMENT:
+                return self->Derived::visitStructFieldAssignment(static_cast<Nodes::StructFieldAssignment*>(node));
+            case NodeKind::RETURN_STATEMENT:
+                return self->Derived::visitReturnStatement(static_cast<Nodes::ReturnStatement*>(node));
+            case NodeKind::BLOCK:
+                return self->Derived::visitBlock(static_cast<Nodes::Block*>(node));
+            case NodeKind::IF_STATEMENT:
+                return self->Derived::visitIfStatement(static_cast<Nodes::IfStatement*>(node));
+            case NodeKind::WHILE_STATEMENT:
+                return self->Derived::visitWhileStatement(static_cast<Nodes::WhileStatement*>(node));
+            case NodeKind::FUNCTION_CALL_STATEMENT:
+                return self->Derived::visitFunctionCallStatement(static_cast<Nodes::FunctionCallStatement*>(node));
+            case NodeKind::FUNCTION_DECLARATION:
+                return self->Derived::visitFunctionDeclaration(static_cast<Nodes::FunctionDeclaration*>(node));
+            case NodeKind::PROGRAM:
+                return self->Derived::visitProgram(static_cast<Nodes::Program*>(node));
+        }
+    }
 
+    void visitBoolLiteral(Nodes::BooleanLiteral *) override {}
+    void visitIntLiteral(Nodes::IntLiteral *) override {}
+    void visitFloatLiteral(Nodes::FloatLiteral *) override {}
+    void visitStringLiteral(Nodes::StringLiteral *) override {}
+    void visitIdentifier(Nodes::Identifier *) override {}
+    void visitRelOp(Nodes::RelOp *) override {}
+    void visitArtmOp(Nodes::ArtmOp *) override {}
+    void visitFactorOp(Nodes::FactorOp *) override {}
+    void visitUnaryOp(Nodes::UnaryOp *) override {}
+    void visitCastOp(Nodes::CastOp *) override {}
+    void visitCastingExpr(Nodes::CastingExpr *) override {}
+    void visitUnaryExpr(Nodes::UnaryExpr *) override {}
+    void visitMulExpr(Nodes::MulExpr *) override {}
+    void visitArtmExpr(Nodes::ArtmExpr *) override {}
+    void visitRelExpr(Nodes::RelExpr *) override {}
+    void visitAndExpr(Nodes::AndExpr *) override {}
+    void visitOrExpr(Nodes::OrExpr *) override {}
+    void visitExpr(Nodes::Expression *) override {}
+    void visitFuncCall(Nodes::FunCall *) override {}
+    void visitVariableRef(Nodes::VarReference *) override {}
+    void visitStructFieldRef(Nodes::StructFieldReference *) override {}
+    void visitVariantHolding(Nodes::VariantHolding *) override {}
+    void visitDeclaration(Nodes::Declaration *) override {}
+    void visitType(Nodes::Type *) override {}
+    void visitTypeDecl(Nodes::TypeDecl *) override {}
+    void visitVariableDeclaration(Nodes::VariableDeclaration *) override {}
+    void visitStructTypeDefinition(Nodes::StructTypeDefinition *) override {}
+    void visitStructVarDeclaration(Nodes::StructVarDeclaration *) override {}
+    void visitVariantTypeDefinition(Nodes::VariantTypeDefinition *) override {}
+    void visitVariantVarDeclaration(Nodes::VariantVarDeclaration *) override {}
+    void visitAssignment(Nodes::Assignment *) override {}
+    void visitStructFieldAssignment(Nodes::StructFieldAssignment *) override {}
+    void visitReturnStatement(Nodes::ReturnStatement *) override {}
+    void visitBlock(Nodes::Block *) override {}
+    void visitIfStatement(Nodes::IfStatement *) override {}
+    void visitWhileStatement(Nodes::WhileStatement *) override {}
+    void visitFunctionCallStatement(Nodes::FunctionCallStatement *) override {}
+    void visitFunctionDeclaration(Nodes::FunctionDeclaration *) override {}
+    void visitProgram(Nodes::Program *) override {}
+};
 
 #endif //TKOM_PROJEKT_VISITORTEMPLATE_H
@@ -1,14 +1,72 @@
+#include <algorithm>
 #include "charReader.h"
 
+void LineTable::addLine(std::uint32_t start) {
+    std::lock_guard lock(mutex);
+    lineStarts.push_back(start);
+}
+
+void LineTable::addTab(std::uint32_t offset) {
+    std::lock_guard lock(mutex);
+    tabs.push_back(offset);
+}
+
+Position LineTable::resolve(std::uint32_t offset) const {
+    std::lock_guard lock(mutex);
+    auto line = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset) - lineStarts.begin();
+    if (line == 0)
+        return {1, 0};
+    auto from = lineStarts[line - 1];
+    unsigned int column = 1;
+    // znaki przed każdym tabulatorem w tej linii liczą się po 1, tabulator do następnego stopu
+    for (auto tab = std::lower_bound(tabs.begin(), tabs.end(), from); tab != tabs.end() && *tab < offset; ++tab) {
+        column += *tab - from;
+        column += TAB_WIDTH - (column - 1) % TAB_WIDTH;
+        from = *tab + 1;
+    }
+    return {static_cast<unsigned int>(line), column + (offset - from)};
+}
+
+SourceLocation SourceLocation::inFile(std::uint32_t file, std::uint32_t offset) {
+    SourceLocation location;
+    location.offset = offset;
+    location.file = file;
+    return location;
+}
+
+Position SourceLocation::resolve() const {
+    if (file & EXPLICIT)
+        return {offset, file & ~EXPLICIT};
+    return SourceFiles::resolve(file, offset);
+}
+
+namespace {
+    std::mutex filesMutex;
+    std::vector<std::shared_ptr<const LineTable>> files;
+}
+
+std::uint32_t SourceFiles::add(std::shared_ptr<const LineTable> lines) {
+    std::lock_guard lock(filesMutex);
+    files.push_back(std::move(lines));
+    return static_cast<std::uint32_t>(files.size() - 1);
+}
+
+Position SourceFiles::resolve(std::uint32_t file, std::uint32_t offset) {
+    std::shared_ptr<const LineTable> lines;
+    {
+        std::lock_guard lock(filesMutex);
+        lines = files.at(file);
+    }
+    return lines->resolve(offset);
+}
+
 CharReader::CharReader() = default;
 
 CharReader::CharReader(std::istream &input_stream) {
-    position={1, 0};
     stream = &input_stream;
 }
 
 CharReader::CharReader(const std::string &file_name) {
-    position={1, 0};
     try {
         file_stream.open(file_name);
     } catch (std::ifstream::failure &e) {
@@ -25,15 +83,27 @@ CharReader::~CharReader() {
 }
 
 struct Position CharReader::getPos() const {
-    return position;
+    return lines->resolve(offset);
+}
+
+SourceLocation CharReader::getLocation() const {
+    return SourceLocation::inFile(file, offset);
 }
 
 unsigned int CharReader::getLine() const {
-    return this->position.line;
+    return getPos().line;
 }
 
 unsigned int CharReader::getColumn() const {
-    return this->position.column;
+    return getPos().column;
+}
+
+std::uint32_t CharReader::getOffset() const {
+    return offset;
+}
+
+const LineTable &CharReader::getLineTable() const {
+    return *lines;
 }
 
 char CharReader::getCurrChar() const {
@@ -54,13 +124,11 @@ bool CharReader::nextChar() {
 void CharReader::movePos() {
     if(!currChar || currChar == EOF)
         return;
-    if(currChar == '\n') {
-        position.line++;
-        position.column = 1;
-    } else if (currChar == '\t')
-        position.column += TAB_WIDTH - (position.column - 1)% TAB_WIDTH;
-    else
-        position.column++;
+    offset++;
+    if(currChar == '\n')
+        lines->addLine(offset);
+    else if (currChar == '\t')
+        lines->addTab(offset - 1);
 }
 
 char CharReader::peekChar() const {
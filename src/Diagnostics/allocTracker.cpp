@@ -0,0 +1,323 @@
+#include "allocTracker.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef TKOM_ALLOC_TRACKING
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <new>
+#endif
+
+namespace AllocTracker {
+    namespace {
+        constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(Phase::COUNT);
+
+        struct AtomicTotals
+        {
+            std::atomic<std::uint64_t> allocations;
+            std::atomic<std::uint64_t> bytes;
+            std::atomic<std::uint64_t> frees;
+        };
+
+        std::array<AtomicTotals, PHASE_COUNT> phaseTotals{};
+        thread_local Phase threadPhase = Phase::NONE;
+        // blokuje rekurencję: backtrace, raport i sam tracker mogą alokować
+        thread_local bool insideTracker = false;
+
+#ifdef TKOM_ALLOC_TRACKING
+        constexpr int MAX_FRAMES = 12;
+        constexpr std::size_t SITE_SLOTS = 1 << 14;
+
+        // miejsce alokacji = faza + stos wywołań; tablica stała, żeby operator new nie alokował
+        struct Site
+        {
+            std::uint64_t key;
+            Phase phase;
+            int depth;
+            void* frames[MAX_FRAMES];
+            std::uint64_t count;
+            std::uint64_t bytes;
+        };
+
+        Site sites[SITE_SLOTS];
+        std::atomic_flag sitesLock = ATOMIC_FLAG_INIT;
+        std::atomic<std::uint64_t> droppedSites{0};
+
+        std::uint64_t hashStack(Phase phase, void* const* frames, int depth) {
+            std::uint64_t hash = 14695981039346656037ULL ^ static_cast<std::uint64_t>(phase);
+            for (int i = 0; i < depth; i++) {
+                hash ^= reinterpret_cast<std::uintptr_t>(frames[i]);
+                hash *= 1099511628211ULL;
+            }
+            return hash == 0 ? 1 : hash;
+        }
+
+        // pomija ramki recordSite i recordAllocation (noinline), stos zaczyna się od operator new
+        constexpr int SKIPPED_FRAMES = 2;
+
+        __attribute__((noinline)) void recordSite(Phase phase, std::size_t size) {
+            void* buffer[MAX_FRAMES + SKIPPED_FRAMES];
+            int depth = std::max(backtrace(buffer, MAX_FRAMES + SKIPPED_FRAMES) - SKIPPED_FRAMES, 0);
+            void** frames = buffer + SKIPPED_FRAMES;
+            std::uint64_t key = hashStack(phase, frames, depth);
+
+            while (sitesLock.test_and_set(std::memory_order_acquire)) {}
+            std::size_t slot = key & (SITE_SLOTS - 1);
+            for (std::size_t probe = 0; probe < SITE_SLOTS; probe++, slot = (slot + 1) & (SITE_SLOTS - 1)) {
+                Site& site = sites[slot];
+                if (site.key == 0) {
+                    site.key = key;
+                    site.phase = phase;
+                    site.depth = depth;
+                    std::copy(frames, frames + depth, site.frames);
+                }
+                if (site.key == key) {
+                    site.count++;
+                    site.bytes += size;
+                    sitesLock.clear(std::memory_order_release);
+                    return;
+                }
+            }
+            sitesLock.clear(std::memory_order_release);
+            droppedSites.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        __attribute__((noinline)) void recordAllocation(std::size_t size) {
+            if (insideTracker)
+                return;
+            insideTracker = true;
+            auto& totals = phaseTotals[static_cast<std::size_t>(threadPhase)];
+            totals.allocations.fetch_add(1, std::memory_order_relaxed);
+            totals.bytes.fetch_add(size, std::memory_order_relaxed);
+            recordSite(threadPhase, size);
+            insideTracker = false;
+        }
+
+        void recordFree() {
+            if (insideTracker)
+                return;
+            phaseTotals[static_cast<std::size_t>(threadPhase)].frees.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::string withoutArguments(std::string name) {
+            const std::string constSuffix = " const";
+            if (name.size() > constSuffix.size() && name.compare(name.size() - constSuffix.size(), constSuffix.size(), constSuffix) == 0)
+                name.erase(name.size() - constSuffix.size());
+            if (name.empty() || name.back() != ')')
+                return name;
+            int depth = 0;
+            for (std::size_t i = name.size(); i-- > 0;) {
+                if (name[i] == ')')
+                    depth++;
+                else if (name[i] == '(' && --depth == 0)
+                    return name.substr(0, i);
+            }
+            return name;
+        }
+
+        // "void std::vector<int>::_M_realloc_insert<int>" -> "std::vector::_M_realloc_insert"
+        std::string shortName(const std::string& name) {
+            std::string result;
+            int depth = 0;
+            for (char c : name) {
+                if (c == '<')
+                    depth++;
+                else if (c == '>' && depth > 0)
+                    depth--;
+                else if (depth == 0)
+                    result += c;
+            }
+            auto space = result.rfind(' ');
+            if (space == std::string::npos || result.find("operator") != std::string::npos)
+                return result;
+            return result.substr(space + 1);
+        }
+
+        std::string symbolName(void* address) {
+            Dl_info info;
+            if (dladdr(address, &info) == 0 || info.dli_sname == nullptr) {
+                std::ostringstream unknown;
+                unknown << (info.dli_fname ? info.dli_fname : "?") << "+" << address;
+                return unknown.str();
+            }
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+            std::free(demangled);
+            return shortName(withoutArguments(name));
+        }
+
+        bool isLibraryFrame(const std::string& name) {
+            if (name.rfind("operator new", 0) == 0 || name.find("AllocTracker::") != std::string::npos)
+                return true;
+            return name.rfind("std::", 0) == 0 || name.rfind("__gnu_cxx::", 0) == 0;
+        }
+
+        // pierwsza ramka spoza biblioteki standardowej + ostatnia ramka biblioteki, która alokowała
+        std::string describeSite(const Site& site) {
+            std::string via;
+            for (int i = 0; i < site.depth; i++) {
+                std::string name = symbolName(site.frames[i]);
+                if (!isLibraryFrame(name))
+                    return via.empty() ? name : name + "  (" + via + ")";
+                if (name.rfind("operator new", 0) != 0 && name.find("AllocTracker::") == std::string::npos)
+                    via = name;
+            }
+            return via.empty() ? "<unknown>" : via;
+        }
+#endif
+    }
+
+    bool enabled() {
+#ifdef TKOM_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const char* phaseName(Phase phase) {
+        switch (phase) {
+            case Phase::NONE:
+                return "other";
+            case Phase::LEX:
+                return "lex";
+            case Phase::PARSE:
+                return "parse";
+            case Phase::SEMANTIC:
+                return "semantic";
+            case Phase::INTERPRET:
+                return "interpret";
+            default:
+                return "unknown";
+        }
+    }
+
+    Phase setPhase(Phase phase) {
+        Phase previous = threadPhase;
+        threadPhase = phase;
+        return previous;
+    }
+
+    Phase currentPhase() {
+        return threadPhase;
+    }
+
+    PhaseTotals totals(Phase phase) {
+        const auto& totals = phaseTotals[static_cast<std::size_t>(phase)];
+        return PhaseTotals{totals.allocations.load(std::memory_order_relaxed),
+                           totals.bytes.load(std::memory_order_relaxed),
+                           totals.frees.load(std::memory_order_relaxed)};
+    }
+
+    void reset() {
+        for (auto& totals : phaseTotals) {
+            totals.allocations.store(0, std::memory_order_relaxed);
+            totals.bytes.store(0, std::memory_order_relaxed);
+            totals.frees.store(0, std::memory_order_relaxed);
+        }
+#ifdef TKOM_ALLOC_TRACKING
+        while (sitesLock.test_and_set(std::memory_order_acquire)) {}
+        std::fill(std::begin(sites), std::end(sites), Site{});
+        sitesLock.clear(std::memory_order_release);
+        droppedSites.store(0, std::memory_order_relaxed);
+#endif
+    }
+
+    void writeReport(std::ostream &output) {
+        bool wasInside = insideTracker;
+        insideTracker = true;
+        output << "Allocations by phase:\n";
+        output << std::left << std::setw(12) << "  phase" << std::right << std::setw(14) << "allocations"
+               << std::setw(16) << "bytes" << std::setw(14) << "frees" << "\n";
+        for (std::size_t p = 0; p < PHASE_COUNT; p++) {
+            auto phaseTotal = totals(static_cast<Phase>(p));
+            output << "  " << std::left << std::setw(10) << phaseName(static_cast<Phase>(p)) << std::right
+                   << std::setw(14) << phaseTotal.allocations << std::setw(16) << phaseTotal.bytes
+                   << std::setw(14) << phaseTotal.frees << "\n";
+        }
+#ifdef TKOM_ALLOC_TRACKING
+        // snapshot tablicy, żeby nie trzymać blokady podczas symbolizacji
+        std::vector<Site> snapshot;
+        while (sitesLock.test_and_set(std::memory_order_acquire)) {}
+        for (const auto& site : sites)
+            if (site.key != 0)
+                snapshot.push_back(site);
+        sitesLock.clear(std::memory_order_release);
+
+        std::array<std::map<std::string, std::pair<std::uint64_t, std::uint64_t>>, PHASE_COUNT> byName;
+        for (const auto& site : snapshot) {
+            auto& entry = byName[static_cast<std::size_t>(site.phase)][describeSite(site)];
+            entry.first += site.count;
+            entry.second += site.bytes;
+        }
+        for (std::size_t p = 0; p < PHASE_COUNT; p++) {
+            if (byName[p].empty())
+                continue;
+            std::vector<std::pair<std::string, std::pair<std::uint64_t, std::uint64_t>>> ranked(byName[p].begin(), byName[p].end());
+            std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+                return a.second.first > b.second.first;
+            });
+            output << "Top allocation sites (" << phaseName(static_cast<Phase>(p)) << "):\n";
+            for (std::size_t i = 0; i < std::min(TOP_SITES, ranked.size()); i++)
+                output << std::setw(12) << ranked[i].second.first << std::setw(14) << ranked[i].second.second
+                       << "  " << ranked[i].first << "\n";
+        }
+        if (droppedSites.load(std::memory_order_relaxed) > 0)
+            output << "(" << droppedSites.load(std::memory_order_relaxed) << " allocations without a free site slot)\n";
+#endif
+        insideTracker = wasInside;
+    }
+}
+
+#ifdef TKOM_ALLOC_TRACKING
+// Podmiana globalnych operatorów. Warianty tablicowe i nothrow z biblioteki standardowej delegują
+// do tych poniżej; rozmiarowe delete są zdefiniowane jawnie, bo kompilator może je wołać bezpośrednio.
+void* operator new(std::size_t size) {
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    AllocTracker::recordAllocation(size);
+    return pointer;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* pointer = nullptr;
+    auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    if (posix_memalign(&pointer, align, size == 0 ? 1 : size) != 0)
+        throw std::bad_alloc();
+    AllocTracker::recordAllocation(size);
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr)
+        return;
+    AllocTracker::recordFree();
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    if (pointer == nullptr)
+        return;
+    AllocTracker::recordFree();
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
+#endif
@@ -0,0 +1,95 @@
+#include "profiler.h"
+
+#include <map>
+#include <string>
+#include <sys/time.h>
+#include "syntaxTree.h"
+#include "myException.h"
+
+namespace {
+    std::atomic<Profiler*> activeProfiler{nullptr};
+}
+
+Profiler::Profiler(unsigned int intervalMicros, std::size_t sampleFrameCapacity)
+        : intervalMicros(intervalMicros == 0 ? 1 : intervalMicros),
+          sampleFrames(std::make_unique<Frame[]>(sampleFrameCapacity)),
+          sampleFrameCapacity(sampleFrameCapacity) {}
+
+Profiler::~Profiler() {
+    stop();
+}
+
+void Profiler::start() {
+    if (running)
+        return;
+    Profiler* expected = nullptr;
+    if (!activeProfiler.compare_exchange_strong(expected, this))
+        throw MyException("Another profiler is already running");
+
+    struct sigaction action{};
+    action.sa_handler = &Profiler::handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGPROF, &action, &previousAction);
+
+    itimerval timer{};
+    timer.it_interval.tv_sec = intervalMicros / 1000000;
+    timer.it_interval.tv_usec = intervalMicros % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    running = true;
+}
+
+void Profiler::stop() {
+    if (!running)
+        return;
+    itimerval timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    sigaction(SIGPROF, &previousAction, nullptr);
+    activeProfiler.store(nullptr);
+    running = false;
+}
+
+void Profiler::handleSignal(int) {
+    auto profiler = activeProfiler.load(std::memory_order_relaxed);
+    if (profiler)
+        profiler->takeSample();
+}
+
+// bezpieczne w handlerze sygnału: tylko kopiowanie do zaalokowanego wcześniej bufora
+void Profiler::takeSample() {
+    auto depth = shadowDepth.load(std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_acquire);
+    if (depth == 0)
+        return;
+    if (depth > MAX_DEPTH)
+        depth = MAX_DEPTH;
+    if (sampleFramesUsed + depth + 1 > sampleFrameCapacity) {
+        droppedSamples++;
+        return;
+    }
+    // ramka nagłówka: głębokość próbki zapisana jako jawna pozycja
+    sampleFrames[sampleFramesUsed++] = Frame{nullptr, Position{static_cast<unsigned int>(depth), 0}};
+    for (std::size_t i = 0; i < depth; i++)
+        sampleFrames[sampleFramesUsed++] = shadowStack[i];
+    sampleCount++;
+}
+
+void Profiler::writeFoldedStacks(std::ostream &output) const {
+    std::map<std::string, std::size_t> folded;
+    std::size_t position = 0;
+    while (position < sampleFramesUsed) {
+        std::size_t depth = sampleFrames[position++].location.resolve().line;
+        std::string stack;
+        for (std::size_t i = 0; i < depth; i++) {
+            const auto& frame = sampleFrames[position++];
+            if (!stack.empty())
+                stack += ';';
+            stack += frame.function ? frame.function->getFunctionName() : "<unknown>";
+            stack += ':' + std::to_string(frame.location.resolve().line);
+        }
+        folded[stack]++;
+    }
+    for (const auto& [stack, count] : folded)
+        output << stack << ' ' << count << '\n';
+}
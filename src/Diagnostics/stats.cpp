@@ -0,0 +1,159 @@
+#include "stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <sys/resource.h>
+
+namespace Stats {
+    namespace {
+        // rejestr żywych wątków i suma liczników wątków już zakończonych; mutex tylko przy
+        // starcie/końcu wątku i przy snapshot(), nigdy przy zliczaniu
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<ThreadCounters*> live;
+            CounterValues retired{};
+        };
+
+        Registry& registry() {
+            // celowo nie niszczony - wątki mogą kończyć się po destruktorach statycznych
+            static auto* instance = new Registry();
+            return *instance;
+        }
+    }
+
+    ThreadCounters::ThreadCounters() {
+        auto& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.live.push_back(this);
+    }
+
+    ThreadCounters::~ThreadCounters() {
+        auto& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (std::size_t i = 0; i < values.size(); i++)
+            shared.retired[i] += values[i].load(std::memory_order_relaxed);
+        shared.live.erase(std::find(shared.live.begin(), shared.live.end(), this));
+    }
+
+    bool countersEnabled() {
+#ifdef TKOM_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    CounterValues snapshot() {
+        auto& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto values = shared.retired;
+        for (const auto* thread : shared.live)
+            for (std::size_t i = 0; i < values.size(); i++)
+                values[i] += thread->values[i].load(std::memory_order_relaxed);
+        return values;
+    }
+
+    // zeruje także liczniki innych wątków - wywoływać, gdy żaden z nich nie liczy
+    void reset() {
+        auto& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.retired = {};
+        for (auto* thread : shared.live)
+            for (auto& value : thread->values)
+                value.store(0, std::memory_order_relaxed);
+    }
+
+    std::string counterName(Counter counter) {
+        switch (counter) {
+            case Counter::TOKENS:
+                return "tokens";
+            case Counter::SYMBOL_LOOKUPS:
+                return "symbol_lookups";
+            case Counter::FUNCTION_CALLS:
+                return "function_calls";
+            case Counter::STATEMENTS:
+                return "statements";
+            default:
+                return "unknown";
+        }
+    }
+
+    long peakRssKb() {
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+        return usage.ru_maxrss;
+    }
+
+    void Report::beginPhase(const std::string &name) {
+        currentPhase = name;
+        countersAtStart = snapshot();
+        phaseStart = std::chrono::steady_clock::now();
+    }
+
+    void Report::endPhase() {
+        auto end = std::chrono::steady_clock::now();
+        auto countersAtEnd = snapshot();
+        Phase phase{currentPhase, std::chrono::duration<double, std::milli>(end - phaseStart).count(), peakRssKb(), {}};
+        for (std::size_t i = 0; i < phase.counters.size(); i++)
+            phase.counters[i] = countersAtEnd[i] - countersAtStart[i];
+        phases.push_back(phase);
+    }
+
+    void Report::writeText(std::ostream &output) const {
+        output << "=== stats ===\n";
+        for (const auto& phase : phases) {
+            output << std::left << std::setw(10) << phase.name
+                   << " wall " << std::fixed << std::setprecision(3) << phase.wallMs << " ms"
+                   << ", peak RSS " << phase.peakRssKb << " KiB";
+            if (countersEnabled()) {
+                for (std::size_t i = 0; i < phase.counters.size(); i++)
+                    if (phase.counters[i] > 0)
+                        output << ", " << counterName(static_cast<Counter>(i)) << " " << phase.counters[i];
+            }
+            output << '\n';
+        }
+        if (!countersEnabled())
+            output << "(counters disabled - build with -DTKOM_STATS=ON)\n";
+        if (!astNodes.empty()) {
+            std::size_t total = 0;
+            for (const auto& node : astNodes)
+                total += node.second;
+            output << "AST nodes: " << total << '\n';
+            for (const auto& [name, count] : astNodes)
+                output << "  " << std::left << std::setw(24) << name << count << '\n';
+        }
+    }
+
+    void Report::writeJson(std::ostream &output) const {
+        output << "{\"counters_enabled\":" << (countersEnabled() ? "true" : "false") << ",\"phases\":[";
+        for (std::size_t p = 0; p < phases.size(); p++) {
+            const auto& phase = phases[p];
+            if (p > 0)
+                output << ',';
+            output << "{\"name\":\"" << phase.name << "\",\"wall_ms\":" << std::fixed << std::setprecision(3) << phase.wallMs
+                   << ",\"peak_rss_kb\":" << phase.peakRssKb;
+            if (countersEnabled()) {
+                output << ",\"counters\":{";
+                for (std::size_t i = 0; i < phase.counters.size(); i++) {
+                    if (i > 0)
+                        output << ',';
+                    output << '"' << counterName(static_cast<Counter>(i)) << "\":" << phase.counters[i];
+                }
+                output << '}';
+            }
+            output << '}';
+        }
+        output << "],\"ast_nodes\":{";
+        bool first = true;
+        for (const auto& [name, count] : astNodes) {
+            if (!first)
+                output << ',';
+            first = false;
+            output << '"' << name << "\":" << count;
+        }
+        output << "}}\n";
+    }
+}
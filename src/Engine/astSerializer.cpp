@@ -0,0 +1,911 @@
+#include "astSerializer.h"
+
+#include <map>
+#include <type_traits>
+#include "myException.h"
+
+using AstFormat::Tag;
+
+std::uint64_t AstFormat::checksum(const char *data, std::size_t size) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// *********************************************************************************************************************
+//                  Writer
+// *********************************************************************************************************************
+
+std::string AstWriter::serialize(const Nodes::Program &program, const std::string &stamp) {
+    AstWriter body;
+    body.writeTree(&program);
+    AstWriter writer;
+    writer.writeScalar(AstFormat::MAGIC);
+    writer.writeScalar(AstFormat::VERSION);
+    writer.writeString(stamp);
+    writer.writeScalar(AstFormat::checksum(body.buffer.data(), body.buffer.size()));
+    writer.buffer.append(body.buffer);
+    return std::move(writer.buffer);
+}
+
+void AstWriter::writeString(const std::string &value) {
+    writeScalar(static_cast<std::uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+void AstWriter::writeHeader(Tag tag, const Node *node) {
+    writeScalar(tag);
+    writeScalar(node->getPos().line);
+    writeScalar(node->getPos().column);
+}
+
+// Rekord węzła (znacznik, pozycja, pola) zapisuje visit*, a dzieci odkłada przez writeChild;
+// zapisywane są potem w kolejności ze źródła z jawnego stosu - głębokość drzewa nie zagłębia rekurencji.
+void AstWriter::writeTree(const Node *root) {
+    std::vector<const Node*> pending{root};
+    while (!pending.empty()) {
+        auto node = pending.back();
+        pending.pop_back();
+        if (node == nullptr) {
+            writeScalar(Tag::NONE);
+            continue;
+        }
+        queued.clear();
+        // visitor nie zmienia drzewa - accept wymaga jedynie wskaźnika niestałego
+        const_cast<Node*>(node)->accept(*this);
+        pending.insert(pending.end(), queued.rbegin(), queued.rend());
+    }
+}
+
+void AstWriter::writeChild(const Node *child) {
+    queued.push_back(child);
+}
+
+void AstWriter::writeSlot(std::optional<std::size_t> slot) {
+    writeScalar(static_cast<std::uint8_t>(slot.has_value()));
+    if (slot)
+        writeScalar(static_cast<std::uint64_t>(*slot));
+}
+
+void AstWriter::visitBoolLiteral(Nodes::BooleanLiteral *literal) {
+    writeHeader(Tag::BOOL_LITERAL, literal);
+    writeScalar(static_cast<std::uint8_t>(literal->getValue()));
+}
+
+void AstWriter::visitIntLiteral(Nodes::IntLiteral *literal) {
+    writeHeader(Tag::INT_LITERAL, literal);
+    writeScalar(static_cast<std::int32_t>(literal->getValue()));
+}
+
+void AstWriter::visitFloatLiteral(Nodes::FloatLiteral *literal) {
+    writeHeader(Tag::FLOAT_LITERAL, literal);
+    writeScalar(literal->getValue());
+}
+
+void AstWriter::visitStringLiteral(Nodes::StringLiteral *literal) {
+    writeHeader(Tag::STRING_LITERAL, literal);
+    writeString(literal->getValue());
+}
+
+void AstWriter::visitIdentifier(Nodes::Identifier *identifier) {
+    writeHeader(Tag::IDENTIFIER, identifier);
+    writeString(identifier->getName());
+}
+
+void AstWriter::visitRelOp(Nodes::RelOp *relOp) {
+    writeHeader(Tag::REL_OP, relOp);
+    writeScalar(static_cast<std::uint8_t>(relOp->getType()));
+}
+
+void AstWriter::visitArtmOp(Nodes::ArtmOp *artmOp) {
+    writeHeader(Tag::ARTM_OP, artmOp);
+    writeScalar(static_cast<std::uint8_t>(artmOp->getType()));
+}
+
+void AstWriter::visitFactorOp(Nodes::FactorOp *factorOp) {
+    writeHeader(Tag::FACTOR_OP, factorOp);
+    writeScalar(static_cast<std::uint8_t>(factorOp->getType()));
+}
+
+void AstWriter::visitUnaryOp(Nodes::UnaryOp *unaryOp) {
+    writeHeader(Tag::UNARY_OP, unaryOp);
+    writeScalar(static_cast<std::uint8_t>(unaryOp->getType()));
+}
+
+void AstWriter::visitCastOp(Nodes::CastOp *castOp) {
+    writeHeader(Tag::CAST_OP, castOp);
+    writeScalar(static_cast<std::uint8_t>(castOp->getType()));
+}
+
+void AstWriter::visitCastingExpr(Nodes::CastingExpr *castingExpr) {
+    writeHeader(Tag::CASTING_EXPR, castingExpr);
+    writeChild(castingExpr->getExpression());
+    writeChild(castingExpr->getCastOp());
+}
+
+void AstWriter::visitUnaryExpr(Nodes::UnaryExpr *unaryExpr) {
+    writeHeader(Tag::UNARY_EXPR, unaryExpr);
+    writeChild(unaryExpr->getUnaryOp());
+    writeChild(unaryExpr->getExpression());
+}
+
+void AstWriter::visitMulExpr(Nodes::MulExpr *mulExpr) {
+    writeHeader(Tag::MUL_EXPR, mulExpr);
+    writeChild(mulExpr->getLeftOperand());
+    writeChild(mulExpr->getFactorOp());
+    writeChild(mulExpr->getRightOperand());
+}
+
+void AstWriter::visitArtmExpr(Nodes::ArtmExpr *artmExpr) {
+    writeHeader(Tag::ARTM_EXPR, artmExpr);
+    writeChild(artmExpr->getLeftOperand());
+    writeChild(artmExpr->getArtmOp());
+    writeChild(artmExpr->getRightOperand());
+}
+
+void AstWriter::visitRelExpr(Nodes::RelExpr *relExpr) {
+    writeHeader(Tag::REL_EXPR, relExpr);
+    writeChild(relExpr->getLeftOperand());
+    writeChild(relExpr->getRelOp());
+    writeChild(relExpr->getRightOperand());
+}
+
+void AstWriter::visitAndExpr(Nodes::AndExpr *andExpr) {
+    writeHeader(Tag::AND_EXPR, andExpr);
+    writeChild(andExpr->getLeftOperand());
+    writeChild(andExpr->getRightOperand());
+}
+
+void AstWriter::visitOrExpr(Nodes::OrExpr *orExpr) {
+    writeHeader(Tag::OR_EXPR, orExpr);
+    writeChild(orExpr->getLeftOperand());
+    writeChild(orExpr->getRightOperand());
+}
+
+void AstWriter::visitExpr(Nodes::Expression *expression) {
+    writeHeader(Tag::EXPRESSION, expression);
+    writeChild(expression->getExpression());
+}
+
+void AstWriter::visitFuncCall(Nodes::FunCall *funCall) {
+    writeHeader(Tag::FUN_CALL, funCall);
+    writeString(funCall->getIdentifier());
+    auto arguments = funCall->getArguments().value_or(std::vector<Nodes::Expression*>());
+    writeScalar(static_cast<std::uint32_t>(arguments.size()));
+    for (auto argument : arguments)
+        writeChild(argument);
+}
+
+void AstWriter::visitVariableRef(Nodes::VarReference *varReference) {
+    writeHeader(Tag::VAR_REFERENCE, varReference);
+    writeString(varReference->getIdentifier());
+    auto heldType = varReference->getHeldType();
+    writeScalar(static_cast<std::uint8_t>(heldType.has_value()));
+    if (heldType)
+        writeScalar(static_cast<std::uint8_t>(*heldType));
+    writeSlot(varReference->getSlot());
+}
+
+void AstWriter::visitStructFieldRef(Nodes::StructFieldReference *fieldReference) {
+    writeHeader(Tag::STRUCT_FIELD_REFERENCE, fieldReference);
+    writeString(fieldReference->getIdentifier());
+    writeString(fieldReference->getFieldName());
+    writeSlot(fieldReference->getSlot());
+    writeSlot(fieldReference->getFieldIndex());
+}
+
+void AstWriter::visitVariantHolding(Nodes::VariantHolding *variantHolding) {
+    writeHeader(Tag::VARIANT_HOLDING, variantHolding);
+    writeString(variantHolding->getIdentifier());
+    auto heldType = variantHolding->getHeldType();
+    writeScalar(static_cast<std::uint8_t>(heldType.has_value()));
+    if (heldType) {
+        writeScalar(static_cast<std::uint8_t>(*heldType));
+        writeScalar(static_cast<std::uint8_t>(variantHolding->isNegated()));
+    }
+    writeSlot(variantHolding->getSlot());
+}
+
+void AstWriter::visitDeclaration(Nodes::Declaration *declaration) {
+    throw MyException("Cannot serialize abstract declaration", declaration->getPos());
+}
+
+void AstWriter::visitType(Nodes::Type *type) {
+    writeHeader(Tag::TYPE, type);
+    auto idType = type->getIdType();
+    writeScalar(static_cast<std::uint8_t>(std::holds_alternative<IdType>(idType)));
+    if (std::holds_alternative<IdType>(idType))
+        writeScalar(static_cast<std::uint8_t>(std::get<IdType>(idType)));
+    else
+        writeString(std::get<std::string>(idType));
+}
+
+void AstWriter::visitTypeDecl(Nodes::TypeDecl *typeDecl) {
+    writeHeader(Tag::TYPE_DECL, typeDecl);
+    writeString(typeDecl->getIdentifier());
+    writeChild(typeDecl->getType());
+}
+
+void AstWriter::visitVariableDeclaration(Nodes::VariableDeclaration *variableDeclaration) {
+    writeHeader(Tag::VARIABLE_DECLARATION, variableDeclaration);
+    writeScalar(static_cast<std::uint8_t>(variableDeclaration->isMutable()));
+    writeSlot(variableDeclaration->getSlot());
+    writeChild(variableDeclaration->getTypeDecl());
+    writeChild(variableDeclaration->getInitExpr());
+}
+
+void AstWriter::visitStructTypeDefinition(Nodes::StructTypeDefinition *structTypeDefinition) {
+    writeHeader(Tag::STRUCT_TYPE_DEFINITION, structTypeDefinition);
+    writeString(structTypeDefinition->getStructName());
+    writeScalar(static_cast<std::uint32_t>(structTypeDefinition->getFields().size()));
+    for (const auto& field : structTypeDefinition->getFields())
+        writeChild(field.get());
+}
+
+void AstWriter::visitStructVarDeclaration(Nodes::StructVarDeclaration *structVarDeclaration) {
+    writeHeader(Tag::STRUCT_VAR_DECLARATION, structVarDeclaration);
+    writeScalar(static_cast<std::uint8_t>(structVarDeclaration->isMutable()));
+    auto arguments = structVarDeclaration->getArgs();
+    writeScalar(static_cast<std::uint32_t>(arguments.size()));
+    writeSlot(structVarDeclaration->getSlot());
+    writeChild(structVarDeclaration->getType());
+    for (auto argument : arguments)
+        writeChild(argument);
+}
+
+void AstWriter::visitVariantTypeDefinition(Nodes::VariantTypeDefinition *variantTypeDefinition) {
+    writeHeader(Tag::VARIANT_TYPE_DEFINITION, variantTypeDefinition);
+    writeString(variantTypeDefinition->getVariantName());
+    writeScalar(static_cast<std::uint32_t>(variantTypeDefinition->getFields().size()));
+    for (const auto& field : variantTypeDefinition->getFields())
+        writeChild(field.get());
+}
+
+void AstWriter::visitVariantVarDeclaration(Nodes::VariantVarDeclaration *variantVarDeclaration) {
+    writeHeader(Tag::VARIANT_VAR_DECLARATION, variantVarDeclaration);
+    writeSlot(variantVarDeclaration->getSlot());
+    writeChild(variantVarDeclaration->getType());
+    writeChild(variantVarDeclaration->getValue());
+}
+
+void AstWriter::visitAssignment(Nodes::Assignment *assignment) {
+    writeHeader(Tag::ASSIGNMENT, assignment);
+    writeString(assignment->getIdentifier());
+    writeSlot(assignment->getSlot());
+    writeChild(assignment->getExpression());
+}
+
+void AstWriter::visitStructFieldAssignment(Nodes::StructFieldAssignment *structFieldAssignment) {
+    writeHeader(Tag::STRUCT_FIELD_ASSIGNMENT, structFieldAssignment);
+    writeString(structFieldAssignment->getIdentifier());
+    writeString(structFieldAssignment->getFieldName());
+    writeSlot(structFieldAssignment->getSlot());
+    writeSlot(structFieldAssignment->getFieldIndex());
+    writeChild(structFieldAssignment->getExpression());
+}
+
+void AstWriter::visitReturnStatement(Nodes::ReturnStatement *returnStatement) {
+    writeHeader(Tag::RETURN_STATEMENT, returnStatement);
+    writeChild(returnStatement->getExpression());
+}
+
+void AstWriter::visitBlock(Nodes::Block *block) {
+    writeHeader(Tag::BLOCK, block);
+    writeScalar(static_cast<std::uint32_t>(block->getStatements().size()));
+    for (const auto& statement : block->getStatements())
+        writeChild(statement.get());
+}
+
+void AstWriter::visitIfStatement(Nodes::IfStatement *ifStatement) {
+    writeHeader(Tag::IF_STATEMENT, ifStatement);
+    writeChild(ifStatement->getCondition());
+    writeChild(ifStatement->getIfBlock());
+    writeChild(ifStatement->getElseBlock());
+}
+
+void AstWriter::visitWhileStatement(Nodes::WhileStatement *whileStatement) {
+    writeHeader(Tag::WHILE_STATEMENT, whileStatement);
+    writeChild(whileStatement->getCondition());
+    writeChild(whileStatement->getBlock());
+}
+
+void AstWriter::visitFunctionCallStatement(Nodes::FunctionCallStatement *functionCallStatement) {
+    writeHeader(Tag::FUNCTION_CALL_STATEMENT, functionCallStatement);
+    writeString(functionCallStatement->getFunctionName());
+    writeScalar(static_cast<std::uint32_t>(functionCallStatement->getArguments().size()));
+    for (const auto& argument : functionCallStatement->getArguments())
+        writeChild(argument.get());
+}
+
+void AstWriter::visitFunctionDeclaration(Nodes::FunctionDeclaration *functionDeclaration) {
+    writeHeader(Tag::FUNCTION_DECLARATION, functionDeclaration);
+    auto parameters = functionDeclaration->getParameters().value_or(std::vector<Nodes::TypeDecl*>());
+    writeScalar(static_cast<std::uint32_t>(parameters.size()));
+    writeScalar(static_cast<std::uint64_t>(functionDeclaration->getFrameSize()));
+    writeChild(functionDeclaration->getReturnType());
+    for (auto parameter : parameters)
+        writeChild(parameter);
+    writeChild(functionDeclaration->getBlock());
+}
+
+void AstWriter::visitProgram(Nodes::Program *program) {
+    writeHeader(Tag::PROGRAM, program);
+    writeScalar(static_cast<std::uint8_t>(program->areScopesResolved()));
+    writeScalar(static_cast<std::uint32_t>(program->getImports().size()));
+    for (const auto& import : program->getImports()) {
+        writeString(import.path);
+        writeScalar(import.pos.line);
+        writeScalar(import.pos.column);
+    }
+
+    // nazwy wszystkich map przed węzłami - dzieci zapisywane są dopiero po całym rekordzie
+    auto writeMap = [this](const auto& map) {
+        writeScalar(static_cast<std::uint32_t>(map.size()));
+        for (const auto& [name, node] : map)
+            writeString(name);
+        for (const auto& [name, node] : map)
+            writeChild(node.get());
+    };
+    writeMap(program->getFunctions());
+    writeMap(program->getVariables());
+    writeMap(program->getStructTypes());
+    writeMap(program->getVariantTypes());
+}
+
+// *********************************************************************************************************************
+//                  Reader
+// *********************************************************************************************************************
+
+std::unique_ptr<Nodes::Program> AstReader::deserialize(const char *data, std::size_t size, const std::string &stamp) {
+    AstReader reader(data, size);
+    if (reader.readScalar<std::uint32_t>() != AstFormat::MAGIC)
+        throw MyException("Not a compiled program");
+    if (reader.readScalar<std::uint32_t>() != AstFormat::VERSION || reader.readString() != stamp)
+        throw MyException("Compiled program has incompatible version");
+    // uszkodzona treść odrzucana zanim cokolwiek z niej zostanie zbudowane
+    auto checksum = reader.readScalar<std::uint64_t>();
+    if (AstFormat::checksum(data + reader.offset, size - reader.offset) != checksum)
+        throw MyException("Compiled program is corrupted");
+    auto program = reader.takeRequired<Nodes::Program>(reader.readTree());
+    if (reader.offset != reader.size)
+        throw MyException("Trailing data after compiled program");
+    // drzewa modułów przed linkowaniem odwołują się do elementów innych modułów
+    if (program->areScopesResolved())
+        reader.checkReferences(*program);
+    return program;
+}
+
+void AstReader::need(std::size_t bytes) const {
+    if (size - offset < bytes)
+        throw MyException("Truncated compiled program");
+}
+
+std::string AstReader::readString() {
+    auto length = readScalar<std::uint32_t>();
+    need(length);
+    std::string value(data + offset, length);
+    offset += length;
+    return value;
+}
+
+Position AstReader::readPosition() {
+    Position pos{};
+    pos.line = readScalar<unsigned int>();
+    pos.column = readScalar<unsigned int>();
+    return pos;
+}
+
+// węzły indeksują tablice nazw wartością enuma, więc zakres sprawdzany przed konstrukcją
+std::uint8_t AstReader::readEnum(std::uint8_t last) {
+    auto value = readScalar<std::uint8_t>();
+    if (value > last)
+        throw MyException("Invalid enum value in compiled program");
+    return value;
+}
+
+std::optional<std::size_t> AstReader::readIndex() {
+    if (readScalar<std::uint8_t>() == 0)
+        return std::nullopt;
+    auto index = readScalar<std::uint64_t>();
+    // każdy slot i pole ma w pliku własną deklarację, więc większy indeks nie może być poprawny
+    if (index >= size)
+        throw MyException("Index out of range in compiled program");
+    return static_cast<std::size_t>(index);
+}
+
+// sloty mają tylko zmienne lokalne; rozmiar ramki sprawdzany po wczytaniu całej funkcji
+std::optional<std::size_t> AstReader::readSlot() {
+    auto slot = readIndex();
+    if (!slot)
+        return slot;
+    if (!inFunction)
+        throw MyException("Slot outside of function in compiled program");
+    usedSlots = std::max(usedSlots, *slot + 1);
+    return slot;
+}
+
+void AstReader::declareSlot(std::optional<std::size_t> slot, const std::string &structName) {
+    if (!slot)
+        return;
+    if (slotStructs.size() <= *slot)
+        slotStructs.resize(*slot + 1);
+    slotStructs[*slot] = structName;
+}
+
+// slot w ramce należy do ostatniej wczytanej deklaracji - zasięgi dzielące slot są rozłączne
+void AstReader::useField(std::optional<std::size_t> slot, const std::string &identifier,
+                         std::optional<std::size_t> fieldIndex, const Position &pos) {
+    if (!fieldIndex)
+        return;
+    if (!slot) {
+        globalStructUses.push_back(Arity{identifier, *fieldIndex + 1, pos});
+        return;
+    }
+    if (*slot >= slotStructs.size() || slotStructs[*slot].empty())
+        throw MyException("Field of non-struct variable " + identifier + " in compiled program", pos);
+    structUses.push_back(Arity{slotStructs[*slot], *fieldIndex + 1, pos});
+}
+
+void AstReader::checkReferences(const Nodes::Program &program) const {
+    auto checkStruct = [&program](const Arity& use) {
+        auto found = program.getStructTypes().find(use.name);
+        if (found == program.getStructTypes().end() || found->second->getFields().size() < use.count)
+            throw MyException("Invalid use of struct " + use.name + " in compiled program", use.pos);
+    };
+    for (const auto& use : structUses)
+        checkStruct(use);
+    for (const auto& use : globalStructUses) {
+        auto found = program.getVariables().find(use.name);
+        auto declaration = found == program.getVariables().end() ? nullptr
+                : dynamic_cast<Nodes::StructVarDeclaration*>(found->second.get());
+        if (declaration == nullptr)
+            throw MyException("Field of non-struct variable " + use.name + " in compiled program", use.pos);
+        checkStruct(Arity{declaration->getTypeName(), use.count, use.pos});
+    }
+    for (const auto& use : variantUses)
+        if (program.getVariantTypes().count(use.name) == 0)
+            throw MyException("Unknown variant " + use.name + " in compiled program", use.pos);
+    for (const auto& call : calls) {
+        auto found = program.getFunctions().find(call.name);
+        if (found == program.getFunctions().end())
+            throw MyException("Unknown function " + call.name + " in compiled program", call.pos);
+        auto parameters = found->second->getParameters();
+        if ((parameters ? parameters->size() : 0) != call.count)
+            throw MyException("Invalid argument count for " + call.name + " in compiled program", call.pos);
+    }
+}
+
+// typ deklaracji struktury lub wariantu to nazwa, nie typ prosty
+static std::string typeNameOf(const Nodes::TypeDecl &typeDecl, const Position &pos) {
+    auto idType = typeDecl.getType()->getIdType();
+    if (!std::holds_alternative<std::string>(idType))
+        throw MyException("Expected type name in compiled program", pos);
+    return std::get<std::string>(idType);
+}
+
+
+// rekord węzła czekający na swoje dzieci; pola z rekordu potrzebne do zbudowania węzła
+struct AstReader::Frame
+{
+    Tag tag;
+    Position pos;
+    std::size_t childCount = 0;
+    // nullptr dla dziecka zapisanego jako Tag::NONE
+    std::vector<std::unique_ptr<Node>> children;
+    bool flag = false;
+    std::uint32_t count = 0;
+    std::string name;
+    std::string fieldName;
+    std::optional<std::size_t> slot;
+    std::optional<std::size_t> fieldIndex;
+    std::uint64_t frameSize = 0;
+    std::vector<Nodes::Import> imports;
+    // liczności i nazwy czterech map programu: funkcje, zmienne, struktury, warianty
+    std::uint32_t mapCounts[4] = {};
+    std::vector<std::string> names;
+};
+
+template<typename T>
+std::unique_ptr<T> AstReader::take(std::unique_ptr<Node> node) {
+    if (!node)
+        return nullptr;
+    auto typed = dynamic_cast<T*>(node.get());
+    if (typed == nullptr)
+        throw MyException("Unexpected node " + node->getNodeName() + " in compiled program", node->getPos());
+    node.release();
+    return std::unique_ptr<T>(typed);
+}
+
+template<typename T>
+std::unique_ptr<T> AstReader::takeRequired(std::unique_ptr<Node> node) {
+    auto typed = take<T>(std::move(node));
+    if (!typed)
+        throw MyException("Missing node in compiled program");
+    return typed;
+}
+
+// Rekordy w kolejności pre-order: węzeł z dziećmi czeka w ramce jawnego stosu, aż wczytane zostaną
+// wszystkie jego dzieci - głębokość drzewa nie zagłębia rekurencji.
+std::unique_ptr<Node> AstReader::readTree() {
+    std::vector<Frame> frames;
+    while (true) {
+        std::unique_ptr<Node> node;
+        auto tag = readScalar<Tag>();
+        if (tag != Tag::NONE) {
+            Frame frame{tag, readPosition()};
+            node = readRecord(frame);
+            if (!node) {
+                if (frame.childCount > 0) {
+                    prepareChild(frame);
+                    frames.push_back(std::move(frame));
+                    continue;
+                }
+                node = build(frame);
+            }
+        }
+        // gotowy węzeł trafia do rodzica; rodzic z kompletem dzieci jest budowany i trafia wyżej
+        while (true) {
+            if (frames.empty())
+                return node;
+            auto& parent = frames.back();
+            parent.children.push_back(std::move(node));
+            if (parent.children.size() < parent.childCount) {
+                prepareChild(parent);
+                break;
+            }
+            node = build(parent);
+            frames.pop_back();
+        }
+    }
+}
+
+// pola rekordu; liść zwracany od razu, dla pozostałych węzłów ustawia liczbę dzieci
+std::unique_ptr<Node> AstReader::readRecord(Frame &frame) {
+    auto pos = frame.pos;
+    switch (frame.tag) {
+        case Tag::REL_OP:
+            return std::make_unique<Nodes::RelOp>(static_cast<RelationalOperator>(readEnum(LESS_EQUAL)), pos);
+        case Tag::ARTM_OP:
+            return std::make_unique<Nodes::ArtmOp>(static_cast<ArtmOperator>(readEnum(MINUS)), pos);
+        case Tag::FACTOR_OP:
+            return std::make_unique<Nodes::FactorOp>(static_cast<FactorOperator>(readEnum(DIVIDE)), pos);
+        case Tag::UNARY_OP:
+            return std::make_unique<Nodes::UnaryOp>(static_cast<UnaryOperator>(readEnum(NEGATIVE)), pos);
+        case Tag::CAST_OP:
+            return std::make_unique<Nodes::CastOp>(static_cast<IdType>(readEnum(VARIANT)), pos);
+        case Tag::BOOL_LITERAL:
+            return std::make_unique<Nodes::BooleanLiteral>(readScalar<std::uint8_t>() != 0, pos);
+        case Tag::INT_LITERAL:
+            return std::make_unique<Nodes::IntLiteral>(readScalar<std::int32_t>(), pos);
+        case Tag::FLOAT_LITERAL:
+            return std::make_unique<Nodes::FloatLiteral>(readScalar<float>(), pos);
+        case Tag::STRING_LITERAL:
+            return std::make_unique<Nodes::StringLiteral>(readString(), pos);
+        case Tag::IDENTIFIER:
+            return std::make_unique<Nodes::Identifier>(readString(), pos);
+        case Tag::VAR_REFERENCE: {
+            auto node = std::make_unique<Nodes::VarReference>(readString(), pos);
+            if (readScalar<std::uint8_t>() != 0)
+                node->setHeldType(static_cast<IdType>(readEnum(BOOLEAN)));
+            if (auto slot = readSlot())
+                node->setSlot(*slot);
+            return node;
+        }
+        case Tag::STRUCT_FIELD_REFERENCE: {
+            auto identifier = readString();
+            auto fieldName = readString();
+            auto node = std::make_unique<Nodes::StructFieldReference>(std::move(identifier), std::move(fieldName), pos);
+            auto slot = readSlot();
+            auto fieldIndex = readIndex();
+            useField(slot, node->getIdentifier(), fieldIndex, pos);
+            if (slot)
+                node->setSlot(*slot);
+            if (fieldIndex)
+                node->setFieldIndex(*fieldIndex);
+            return node;
+        }
+        case Tag::VARIANT_HOLDING: {
+            auto identifier = readString();
+            std::unique_ptr<Nodes::VariantHolding> node;
+            if (readScalar<std::uint8_t>() != 0) {
+                // test znacznika dotyczy tylko typów prostych
+                auto heldType = static_cast<IdType>(readEnum(BOOLEAN));
+                bool negated = readScalar<std::uint8_t>() != 0;
+                node = std::make_unique<Nodes::VariantHolding>(std::move(identifier), heldType, negated, pos);
+            } else {
+                node = std::make_unique<Nodes::VariantHolding>(std::move(identifier), pos);
+            }
+            if (auto slot = readSlot())
+                node->setSlot(*slot);
+            return node;
+        }
+        case Tag::TYPE: {
+            if (readScalar<std::uint8_t>() != 0)
+                return std::make_unique<Nodes::Type>(static_cast<IdType>(readEnum(VARIANT)), pos);
+            return std::make_unique<Nodes::Type>(readString(), pos);
+        }
+        case Tag::CASTING_EXPR:
+        case Tag::UNARY_EXPR:
+        case Tag::AND_EXPR:
+        case Tag::OR_EXPR:
+        case Tag::WHILE_STATEMENT:
+            frame.childCount = 2;
+            return nullptr;
+        case Tag::MUL_EXPR:
+        case Tag::ARTM_EXPR:
+        case Tag::REL_EXPR:
+        case Tag::IF_STATEMENT:
+            frame.childCount = 3;
+            return nullptr;
+        case Tag::EXPRESSION:
+        case Tag::RETURN_STATEMENT:
+            frame.childCount = 1;
+            return nullptr;
+        case Tag::FUN_CALL:
+        case Tag::STRUCT_TYPE_DEFINITION:
+        case Tag::VARIANT_TYPE_DEFINITION:
+        case Tag::FUNCTION_CALL_STATEMENT:
+            frame.name = readString();
+            frame.count = readScalar<std::uint32_t>();
+            frame.childCount = frame.count;
+            return nullptr;
+        case Tag::BLOCK:
+            frame.count = readScalar<std::uint32_t>();
+            frame.childCount = frame.count;
+            return nullptr;
+        case Tag::TYPE_DECL:
+            frame.name = readString();
+            frame.childCount = 1;
+            return nullptr;
+        case Tag::VARIABLE_DECLARATION:
+            frame.flag = readScalar<std::uint8_t>() != 0;
+            frame.slot = readSlot();
+            frame.childCount = 2;
+            return nullptr;
+        case Tag::STRUCT_VAR_DECLARATION:
+            frame.flag = readScalar<std::uint8_t>() != 0;
+            frame.count = readScalar<std::uint32_t>();
+            frame.slot = readSlot();
+            frame.childCount = std::size_t{1} + frame.count;
+            return nullptr;
+        case Tag::VARIANT_VAR_DECLARATION:
+            frame.slot = readSlot();
+            frame.childCount = 2;
+            return nullptr;
+        case Tag::ASSIGNMENT:
+            frame.name = readString();
+            frame.slot = readSlot();
+            frame.childCount = 1;
+            return nullptr;
+        case Tag::STRUCT_FIELD_ASSIGNMENT:
+            frame.name = readString();
+            frame.fieldName = readString();
+            frame.slot = readSlot();
+            frame.fieldIndex = readIndex();
+            frame.childCount = 1;
+            return nullptr;
+        case Tag::FUNCTION_DECLARATION:
+            if (inFunction)
+                throw MyException("Nested function in compiled program", pos);
+            frame.count = readScalar<std::uint32_t>();
+            frame.frameSize = readScalar<std::uint64_t>();
+            if (frame.frameSize > size)
+                throw MyException("Invalid frame size in compiled program", pos);
+            frame.childCount = std::size_t{2} + frame.count;
+            return nullptr;
+        case Tag::PROGRAM: {
+            scopesResolved = readScalar<std::uint8_t>() != 0;
+            auto importCount = readScalar<std::uint32_t>();
+            // kolejność w liście inicjalizacyjnej jest gwarantowana: ścieżka, potem pozycja
+            for (std::uint32_t i = 0; i < importCount; i++)
+                frame.imports.push_back(Nodes::Import{readString(), readPosition()});
+            for (auto& count : frame.mapCounts) {
+                count = readScalar<std::uint32_t>();
+                for (std::uint32_t i = 0; i < count; i++)
+                    frame.names.push_back(readString());
+                frame.childCount += count;
+            }
+            return nullptr;
+        }
+        default:
+            throw MyException("Unknown node tag in compiled program", pos);
+    }
+}
+
+// stan czytania przed kolejnym dzieckiem: ciało funkcji czytane z parametrami w pierwszych slotach ramki
+void AstReader::prepareChild(Frame &frame) {
+    if (frame.tag != Tag::FUNCTION_DECLARATION || frame.children.size() != frame.childCount - 1)
+        return;
+    slotStructs.assign(frame.count, "");
+    for (std::uint32_t i = 0; i < frame.count; i++) {
+        auto& child = frame.children[1 + i];
+        if (!child)
+            throw MyException("Missing node in compiled program");
+        auto parameter = dynamic_cast<Nodes::TypeDecl*>(child.get());
+        if (parameter == nullptr)
+            throw MyException("Unexpected node " + child->getNodeName() + " in compiled program", child->getPos());
+        auto idType = parameter->getType()->getIdType();
+        if (auto name = std::get_if<std::string>(&idType))
+            slotStructs[i] = *name;
+    }
+    inFunction = true;
+    usedSlots = frame.count;
+}
+
+std::unique_ptr<Node> AstReader::build(Frame &frame) {
+    auto pos = frame.pos;
+    auto& children = frame.children;
+    switch (frame.tag) {
+        case Tag::CASTING_EXPR: {
+            auto expression = takeRequired<Nodes::Factor>(std::move(children[0]));
+            auto castOp = take<Nodes::CastOp>(std::move(children[1]));
+            if (castOp)
+                return std::make_unique<Nodes::CastingExpr>(std::move(expression), std::move(castOp), pos);
+            return std::make_unique<Nodes::CastingExpr>(std::move(expression), pos);
+        }
+        case Tag::UNARY_EXPR: {
+            auto unaryOp = take<Nodes::UnaryOp>(std::move(children[0]));
+            auto expression = takeRequired<Nodes::CastingExpr>(std::move(children[1]));
+            if (unaryOp)
+                return std::make_unique<Nodes::UnaryExpr>(std::move(unaryOp), std::move(expression), pos);
+            return std::make_unique<Nodes::UnaryExpr>(std::move(expression), pos);
+        }
+        case Tag::MUL_EXPR:
+            return std::make_unique<Nodes::MulExpr>(takeRequired<Nodes::UnaryExpr>(std::move(children[0])),
+                                                    take<Nodes::FactorOp>(std::move(children[1])),
+                                                    take<Nodes::MulExpr>(std::move(children[2])), pos);
+        case Tag::ARTM_EXPR:
+            return std::make_unique<Nodes::ArtmExpr>(takeRequired<Nodes::MulExpr>(std::move(children[0])),
+                                                     take<Nodes::ArtmOp>(std::move(children[1])),
+                                                     take<Nodes::ArtmExpr>(std::move(children[2])), pos);
+        case Tag::REL_EXPR:
+            return std::make_unique<Nodes::RelExpr>(takeRequired<Nodes::ArtmExpr>(std::move(children[0])),
+                                                    take<Nodes::RelOp>(std::move(children[1])),
+                                                    take<Nodes::RelExpr>(std::move(children[2])), pos);
+        case Tag::AND_EXPR:
+            return std::make_unique<Nodes::AndExpr>(takeRequired<Nodes::RelExpr>(std::move(children[0])),
+                                                    take<Nodes::AndExpr>(std::move(children[1])), pos);
+        case Tag::OR_EXPR:
+            return std::make_unique<Nodes::OrExpr>(takeRequired<Nodes::AndExpr>(std::move(children[0])),
+                                                   take<Nodes::OrExpr>(std::move(children[1])), pos);
+        case Tag::EXPRESSION:
+            return std::make_unique<Nodes::Expression>(takeRequired<Nodes::OrExpr>(std::move(children[0])), pos);
+        case Tag::FUN_CALL: {
+            std::vector<std::unique_ptr<Nodes::Expression>> arguments;
+            for (auto& child : children)
+                arguments.push_back(takeRequired<Nodes::Expression>(std::move(child)));
+            calls.push_back(Arity{frame.name, frame.count, pos});
+            return std::make_unique<Nodes::FunCall>(std::move(frame.name), std::move(arguments), pos);
+        }
+        case Tag::TYPE_DECL:
+            return std::make_unique<Nodes::TypeDecl>(takeRequired<Nodes::Type>(std::move(children[0])), std::move(frame.name), pos);
+        case Tag::VARIABLE_DECLARATION: {
+            auto typeDecl = takeRequired<Nodes::TypeDecl>(std::move(children[0]));
+            auto value = take<Nodes::Expression>(std::move(children[1]));
+            auto node = std::make_unique<Nodes::VariableDeclaration>(frame.flag, std::move(typeDecl), std::move(value), pos);
+            declareSlot(frame.slot, "");
+            if (frame.slot)
+                node->setSlot(*frame.slot);
+            return node;
+        }
+        case Tag::STRUCT_TYPE_DEFINITION: {
+            std::vector<std::unique_ptr<Nodes::TypeDecl>> fields;
+            for (auto& child : children)
+                fields.push_back(takeRequired<Nodes::TypeDecl>(std::move(child)));
+            return std::make_unique<Nodes::StructTypeDefinition>(std::move(frame.name), std::move(fields), pos);
+        }
+        case Tag::STRUCT_VAR_DECLARATION: {
+            auto typeDecl = takeRequired<Nodes::TypeDecl>(std::move(children[0]));
+            auto typeName = typeNameOf(*typeDecl, pos);
+            std::vector<std::unique_ptr<Nodes::Expression>> values;
+            for (std::size_t i = 1; i < children.size(); i++)
+                values.push_back(takeRequired<Nodes::Expression>(std::move(children[i])));
+            structUses.push_back(Arity{typeName, frame.count, pos});
+            auto node = std::make_unique<Nodes::StructVarDeclaration>(frame.flag, std::move(typeDecl), std::move(values), pos);
+            declareSlot(frame.slot, typeName);
+            if (frame.slot)
+                node->setSlot(*frame.slot);
+            return node;
+        }
+        case Tag::VARIANT_TYPE_DEFINITION: {
+            std::vector<std::unique_ptr<Nodes::Type>> fields;
+            for (auto& child : children)
+                fields.push_back(takeRequired<Nodes::Type>(std::move(child)));
+            return std::make_unique<Nodes::VariantTypeDefinition>(std::move(frame.name), std::move(fields), pos);
+        }
+        case Tag::VARIANT_VAR_DECLARATION: {
+            auto typeDecl = takeRequired<Nodes::TypeDecl>(std::move(children[0]));
+            variantUses.push_back(Arity{typeNameOf(*typeDecl, pos), 0, pos});
+            auto value = take<Nodes::Expression>(std::move(children[1]));
+            auto node = std::make_unique<Nodes::VariantVarDeclaration>(std::move(typeDecl), std::move(value), pos);
+            declareSlot(frame.slot, "");
+            if (frame.slot)
+                node->setSlot(*frame.slot);
+            return node;
+        }
+        case Tag::ASSIGNMENT: {
+            auto expression = takeRequired<Nodes::Expression>(std::move(children[0]));
+            auto node = std::make_unique<Nodes::Assignment>(std::move(frame.name), std::move(expression), pos);
+            if (frame.slot)
+                node->setSlot(*frame.slot);
+            return node;
+        }
+        case Tag::STRUCT_FIELD_ASSIGNMENT: {
+            auto expression = takeRequired<Nodes::Expression>(std::move(children[0]));
+            auto node = std::make_unique<Nodes::StructFieldAssignment>(std::move(frame.name), std::move(frame.fieldName), std::move(expression), pos);
+            useField(frame.slot, node->getIdentifier(), frame.fieldIndex, pos);
+            if (frame.slot)
+                node->setSlot(*frame.slot);
+            if (frame.fieldIndex)
+                node->setFieldIndex(*frame.fieldIndex);
+            return node;
+        }
+        case Tag::RETURN_STATEMENT:
+            return std::make_unique<Nodes::ReturnStatement>(take<Nodes::Expression>(std::move(children[0])), pos);
+        case Tag::BLOCK: {
+            std::vector<std::unique_ptr<Nodes::Statement>> statements;
+            for (auto& child : children)
+                statements.push_back(takeRequired<Nodes::Statement>(std::move(child)));
+            return std::make_unique<Nodes::Block>(std::move(statements), pos);
+        }
+        case Tag::IF_STATEMENT: {
+            auto condition = takeRequired<Nodes::Expression>(std::move(children[0]));
+            auto ifBlock = takeRequired<Nodes::Block>(std::move(children[1]));
+            auto elseBlock = take<Nodes::Block>(std::move(children[2]));
+            return std::make_unique<Nodes::IfStatement>(std::move(condition), std::move(ifBlock), std::move(elseBlock), pos);
+        }
+        case Tag::WHILE_STATEMENT: {
+            auto condition = takeRequired<Nodes::Expression>(std::move(children[0]));
+            auto block = takeRequired<Nodes::Block>(std::move(children[1]));
+            return std::make_unique<Nodes::WhileStatement>(std::move(condition), std::move(block), pos);
+        }
+        case Tag::FUNCTION_CALL_STATEMENT: {
+            std::vector<std::unique_ptr<Nodes::Expression>> arguments;
+            for (auto& child : children)
+                arguments.push_back(takeRequired<Nodes::Expression>(std::move(child)));
+            if (frame.name != "print")
+                calls.push_back(Arity{frame.name, frame.count, pos});
+            return std::make_unique<Nodes::FunctionCallStatement>(std::move(frame.name), std::move(arguments), pos);
+        }
+        case Tag::FUNCTION_DECLARATION: {
+            inFunction = false;
+            if (scopesResolved && frame.frameSize < usedSlots)
+                throw MyException("Invalid frame size in compiled program", pos);
+            auto returnType = takeRequired<Nodes::TypeDecl>(std::move(children[0]));
+            std::vector<std::unique_ptr<Nodes::TypeDecl>> parameters;
+            for (std::uint32_t i = 0; i < frame.count; i++)
+                parameters.push_back(takeRequired<Nodes::TypeDecl>(std::move(children[1 + i])));
+            auto block = takeRequired<Nodes::Block>(std::move(children.back()));
+            auto node = std::make_unique<Nodes::FunctionDeclaration>(std::move(returnType), std::move(parameters), std::move(block), pos);
+            node->setFrameSize(static_cast<std::size_t>(frame.frameSize));
+            return node;
+        }
+        case Tag::PROGRAM: {
+            std::size_t next = 0;
+            auto fill = [&](auto& map, std::uint32_t count) {
+                using NodeType = typename std::remove_reference_t<decltype(map)>::mapped_type::element_type;
+                for (std::uint32_t i = 0; i < count; i++, next++)
+                    map.emplace(std::move(frame.names[next]), takeRequired<NodeType>(std::move(children[next])));
+            };
+            std::map<std::string, std::unique_ptr<Nodes::FunctionDeclaration>> functions;
+            std::map<std::string, std::unique_ptr<Nodes::Declaration>> variables;
+            std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>> structTypes;
+            std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>> variantTypes;
+            fill(functions, frame.mapCounts[0]);
+            fill(variables, frame.mapCounts[1]);
+            fill(structTypes, frame.mapCounts[2]);
+            fill(variantTypes, frame.mapCounts[3]);
+            auto program = std::make_unique<Nodes::Program>(std::move(functions), std::move(variables),
+                                                            std::move(structTypes), std::move(variantTypes), pos);
+            program->setImports(std::move(frame.imports));
+            if (scopesResolved)
+                program->markScopesResolved();
+            return program;
+        }
+        default:
+            throw MyException("Unknown node tag in compiled program", pos);
+    }
+}
@@ -0,0 +1,147 @@
+#include "batchRunner.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "myException.h"
+#include "programCache.h"
+#include "workStealingPool.h"
+
+namespace {
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+BatchRunner::BatchRunner(std::size_t threads)
+        : threads(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {}
+
+std::vector<std::string> BatchRunner::collectSources(const std::string &listOrDirectory) {
+    std::vector<std::string> paths;
+    if (std::filesystem::is_directory(listOrDirectory)) {
+        for (const auto& entry : std::filesystem::directory_iterator(listOrDirectory))
+            if (entry.is_regular_file())
+                paths.push_back(entry.path().string());
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+    std::ifstream list(listOrDirectory);
+    if (!list)
+        throw MyException("Cannot open batch list " + listOrDirectory);
+    std::string line;
+    while (std::getline(list, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (!line.empty() && line[0] != '#')
+            paths.push_back(line);
+    }
+    return paths;
+}
+
+BatchResult BatchRunner::runScript(const std::string &path) const {
+    BatchResult result;
+    result.path = path;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        std::ifstream file(path);
+        if (!file)
+            throw MyException("Cannot open file " + path);
+        std::ostringstream source;
+        source << file.rdbuf();
+        auto compiled = cache ? cache->compile(source.str()) : Engine::compile(source.str());
+        result.compileMs = millisecondsSince(start);
+
+        // termin liczony od startu wykonania tego skryptu, nie od startu partii
+        start = std::chrono::steady_clock::now();
+        ExecutionBudget budget;
+        if (fuel)
+            budget.setFuel(*fuel);
+        if (timeLimit)
+            budget.setTimeLimit(*timeLimit);
+        std::ostringstream output;
+        try {
+            result.result = compiled->run({}, output, budget);
+        } catch (std::exception& e) {
+            result.error = e.what();
+        }
+        result.output = output.str();
+        result.runMs = millisecondsSince(start);
+    } catch (MyException& e) {
+        result.error = e.what();
+        result.compileMs = millisecondsSince(start);
+    } catch (std::exception& e) {
+        // błąd wewnętrzny jednego skryptu nie może zatrzymać całej partii
+        result.error = std::string("Internal error: ") + e.what();
+    }
+    return result;
+}
+
+std::vector<BatchResult> BatchRunner::run(const std::vector<std::string> &paths, std::ostream &output) {
+    std::vector<BatchResult> results(paths.size());
+    std::vector<bool> done(paths.size(), false);
+    std::mutex doneMutex;
+    std::condition_variable resultReady;
+
+    WorkStealingPool pool(threads);
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        pool.submit([&, i]() {
+            auto result = runScript(paths[i]);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            results[i] = std::move(result);
+            done[i] = true;
+            resultReady.notify_one();
+        });
+    }
+    // tylko ten wątek pisze do output - skrypty nie przeplatają się
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            resultReady.wait(lock, [&]() { return done[i]; });
+        }
+        writeResult(results[i], output);
+    }
+    pool.wait();
+    return results;
+}
+
+void BatchRunner::writeResult(const BatchResult &result, std::ostream &output) {
+    output << "==> " << result.path << " <==\n" << result.output;
+    if (!result.output.empty() && result.output.back() != '\n')
+        output << "\n";
+    if (!result.error.empty()) {
+        output << result.error;
+        if (result.error.back() != '\n')
+            output << "\n";
+    } else if (result.result) {
+        output << "returned: ";
+        std::visit([&output](const auto& value) { output << value; }, *result.result);
+        output << "\n";
+    }
+    output.flush();
+}
+
+void BatchRunner::writeSummary(const std::vector<BatchResult> &results, double wallMs, std::ostream &output) const {
+    double compileMs = 0;
+    double runMs = 0;
+    std::size_t failed = 0;
+    const BatchResult* slowest = nullptr;
+    for (const auto& result : results) {
+        compileMs += result.compileMs;
+        runMs += result.runMs;
+        if (!result.error.empty())
+            failed++;
+        if (!slowest || result.compileMs + result.runMs > slowest->compileMs + slowest->runMs)
+            slowest = &result;
+    }
+    output << std::fixed << std::setprecision(2);
+    output << "Batch: " << results.size() << " scripts, " << failed << " failed, " << threads << " threads\n";
+    output << "  wall " << wallMs << " ms, compile " << compileMs << " ms, run " << runMs << " ms (summed over scripts)\n";
+    if (slowest)
+        output << "  slowest " << slowest->path << " " << slowest->compileMs + slowest->runMs << " ms\n";
+    output << std::defaultfloat;
+}
@@ -0,0 +1,163 @@
+#include "engine.h"
+
+#include <fstream>
+#include <sstream>
+#include "parser.h"
+#include "semanticVisitor.h"
+#include "interpreterVisitor.h"
+#include "scopeResolver.h"
+#include "nodeCounter.h"
+#include "moduleGraph.h"
+#include "programCache.h"
+#include "allocTracker.h"
+#include "stats.h"
+
+namespace {
+    template<typename Input>
+    std::unique_ptr<Parser> openParser(Input& input, const CompileOptions& options) {
+        if (options.pipelined)
+            return std::make_unique<Parser>(input, Parser::Pipelined{});
+        return std::make_unique<Parser>(input);
+    }
+
+    // wpis pamięci podręcznej zapisuje całe drzewo, więc wtedy ciała parsowane są od razu
+    std::unique_ptr<Nodes::Program> parse(Parser& parser, const CompileOptions& options) {
+        if (options.lazyBodies && !options.cache)
+            parser.enableLazyBodies();
+        auto program = parser.parseProgram();
+        // pusty plik
+        if (!program)
+            throw MyException("main() function missing!");
+        return program;
+    }
+
+    // graf modułów sprawdza i zapisuje moduł w całości - leniwe ciała korzenia parsowane są z zapisanych
+    // tokenów, bez ponownego czytania pliku
+    void parseLazyBodies(Nodes::Program& program) {
+        for (const auto& [name, function] : program.getFunctions()) {
+            if (function->isBodyParsed())
+                continue;
+            function->attachBody(Parser::parseLazyBody(function->getLazyBody()));
+            function->publishBody();
+        }
+    }
+
+    void countNodes(Nodes::Program& program, const CompileOptions& options) {
+        if (!options.stats)
+            return;
+        NodeCounter nodeCounter;
+        program.accept(nodeCounter);
+        options.stats->setAstNodeCounts(nodeCounter.getCounts());
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+}
+
+std::shared_ptr<const CompiledProgram> Engine::compile(const std::string &source, bool lazyBodies) {
+    CompileOptions options;
+    options.lazyBodies = lazyBodies;
+    return compile(source, options);
+}
+
+std::shared_ptr<const CompiledProgram> Engine::compileFile(const std::string &path, bool lazyBodies) {
+    CompileOptions options;
+    options.lazyBodies = lazyBodies;
+    return compileFile(path, options);
+}
+
+std::shared_ptr<const CompiledProgram> Engine::compile(const std::string &source, const CompileOptions &options) {
+    std::unique_ptr<Nodes::Program> program;
+    bool cached = false;
+    {
+        Stats::PhaseScope statsPhase(options.stats, "parse");
+        AllocTracker::PhaseScope allocPhase(AllocTracker::Phase::PARSE);
+        if (options.cache)
+            program = options.cache->load(source);
+        cached = program != nullptr;
+        if (!cached) {
+            std::istringstream stream(source);
+            program = parse(*openParser(stream, options), options);
+        }
+    }
+    return finish(std::move(program), cached, source, options);
+}
+
+std::shared_ptr<const CompiledProgram> Engine::compileFile(const std::string &path, const CompileOptions &options) {
+    // kluczem wpisu pamięci podręcznej jest całe źródło, więc wtedy plik czytany jest z góry
+    std::string source = options.cache ? readFile(path) : std::string();
+    std::unique_ptr<Nodes::Program> program;
+    bool cached = false;
+    ModuleGraph modules(options.threads, options.pipelined);
+    bool linked = false;
+    {
+        Stats::PhaseScope statsPhase(options.stats, "parse");
+        AllocTracker::PhaseScope allocPhase(AllocTracker::Phase::PARSE);
+        if (options.cache)
+            program = options.cache->load(source);
+        cached = program != nullptr;
+        if (!cached) {
+            std::istringstream stream(source);
+            program = options.cache ? parse(*openParser(stream, options), options) : parse(*openParser(path, options), options);
+        }
+        // plik z importami: pozostałe moduły parsowane w tej samej fazie, korzeń przekazany do grafu
+        linked = !cached && !program->getImports().empty();
+        if (linked) {
+            parseLazyBodies(*program);
+            modules.parse(path, std::move(program));
+        }
+    }
+    if (linked) {
+        {
+            Stats::PhaseScope statsPhase(options.stats, "semantic");
+            AllocTracker::PhaseScope allocPhase(AllocTracker::Phase::SEMANTIC);
+            program = modules.check(path);
+        }
+        countNodes(*program, options);
+        return std::shared_ptr<const CompiledProgram>(new CompiledProgram(std::move(program)));
+    }
+    return finish(std::move(program), cached, source, options);
+}
+
+std::shared_ptr<const CompiledProgram> Engine::finish(std::unique_ptr<Nodes::Program> program, bool cached,
+                                                      const std::string &source, const CompileOptions &options) {
+    countNodes(*program, options);
+    // trafienie to drzewo już sprawdzone, z rozwiązanymi zasięgami
+    if (cached)
+        return std::shared_ptr<const CompiledProgram>(new CompiledProgram(std::move(program)));
+    auto compiled = compile(std::move(program), options);
+    if (options.cache)
+        options.cache->store(source, compiled->getProgram());
+    return compiled;
+}
+
+std::shared_ptr<const CompiledProgram> Engine::compile(std::unique_ptr<Nodes::Program> program, const CompileOptions &options) {
+    Stats::PhaseScope statsPhase(options.stats, "semantic");
+    AllocTracker::PhaseScope allocPhase(AllocTracker::Phase::SEMANTIC);
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    semanticVisitor.setThreads(options.threads);
+    program->accept(semanticVisitor);
+    ScopeResolver scopeResolver;
+    program->accept(scopeResolver);
+    std::shared_ptr<CompiledProgram> compiled(new CompiledProgram(std::move(program)));
+    if (compiled->program->hasLazyFunctions())
+        compiled->lazyBodies = std::make_unique<LazyBodyLoader>(*compiled->program);
+    return compiled;
+}
+
+CompiledProgram::Value CompiledProgram::run(const Inputs &inputs, std::ostream &output, ExecutionBudget budget,
+                                            Profiler *profiler) const {
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    interpreterVisitor.setOutput(output);
+    interpreterVisitor.setLazyBodyLoader(lazyBodies.get());
+    interpreterVisitor.setInputs(inputs);
+    interpreterVisitor.getBudget() = budget;
+    if (profiler)
+        interpreterVisitor.setProfiler(profiler);
+    program->accept(interpreterVisitor);
+    return interpreterVisitor.getResult();
+}
@@ -0,0 +1,15 @@
+#include "executionContext.h"
+
+ExecutionContext::ExecutionContext(std::shared_ptr<const CompiledProgram> program)
+        : program(std::move(program)),
+          interpreter(this->program->getProgram().getStructTypes(), this->program->getProgram().getVariantTypes()) {}
+
+CompiledProgram::Value ExecutionContext::run(const CompiledProgram::Inputs &inputs, std::ostream &output, ExecutionBudget budget) {
+    interpreter.reset();
+    interpreter.setOutput(output);
+    interpreter.setLazyBodyLoader(program->lazyBodies.get());
+    interpreter.setInputs(inputs);
+    interpreter.getBudget() = budget;
+    program->program->accept(interpreter);
+    return interpreter.getResult();
+}
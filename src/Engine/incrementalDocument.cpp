@@ -0,0 +1,416 @@
+#include "incrementalDocument.h"
+
+#include <algorithm>
+#include <istream>
+#include <cctype>
+#include <map>
+#include <set>
+#include <streambuf>
+#include "lexer.h"
+#include "myException.h"
+#include "parser.h"
+#include "semanticVisitor.h"
+
+namespace {
+    // strumień nad fragmentem tekstu bez kopiowania
+    class TextView : public std::streambuf
+    {
+    public:
+        TextView(const char* begin, const char* end) {
+            char* first = const_cast<char*>(begin);
+            setg(first, first, const_cast<char*>(end));
+        }
+    };
+
+    std::unique_ptr<Nodes::Program> emptyProgram() {
+        return std::make_unique<Nodes::Program>(std::map<std::string, std::unique_ptr<Nodes::FunctionDeclaration>>(),
+                                                std::map<std::string, std::unique_ptr<Nodes::Declaration>>(),
+                                                std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>>(),
+                                                std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>>(),
+                                                Position{1, 1});
+    }
+
+    bool onlyFunctions(const Nodes::Program::ItemNames& names) {
+        return names.variables.empty() && names.structTypes.empty() && names.variantTypes.empty();
+    }
+
+    bool isParseError(const IncrementalDocument::Item& item) {
+        return item.error.has_value() && !item.inProgram && item.names.functions.empty() && onlyFunctions(item.names);
+    }
+
+    unsigned int nextColumn(unsigned int column, char c) {
+        return c == '\t' ? column + TAB_WIDTH - (column - 1) % TAB_WIDTH : column + 1;
+    }
+}
+
+IncrementalDocument::~IncrementalDocument() = default;
+
+IncrementalDocument::IncrementalDocument(std::string initialText) : text(std::move(initialText)), program(emptyProgram()) {
+    rebuildLineStarts();
+    std::size_t scannedUntil = 0;
+    auto ranges = scanItems(0, [](std::size_t) { return false; }, scannedUntil);
+    for (const auto& range : ranges)
+        items.push_back(parseItem(range));
+    lastEdit.relexedBytes = scannedUntil;
+    lastEdit.reparsedItems = items.size();
+    if (std::none_of(items.begin(), items.end(), isParseError))
+        check(false);
+}
+
+// *********************************************************************************************************************
+//                  Pozycje
+// *********************************************************************************************************************
+
+void IncrementalDocument::rebuildLineStarts() {
+    lineStarts.assign(1, 0);
+    for (std::size_t i = 0; i < text.size(); i++)
+        if (text[i] == '\n')
+            lineStarts.push_back(i + 1);
+}
+
+void IncrementalDocument::updateLineStarts(std::size_t offset, std::size_t removed, const std::string &inserted) {
+    auto low = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    auto high = std::upper_bound(low, lineStarts.end(), offset + removed);
+    auto index = low - lineStarts.begin();
+    lineStarts.erase(low, high);
+    for (auto it = lineStarts.begin() + index; it != lineStarts.end(); ++it)
+        *it = *it - removed + inserted.size();
+    std::vector<std::size_t> added;
+    for (std::size_t i = 0; i < inserted.size(); i++)
+        if (inserted[i] == '\n')
+            added.push_back(offset + i + 1);
+    lineStarts.insert(lineStarts.begin() + index, added.begin(), added.end());
+}
+
+// pozycja liczona przez Lexer dla tekstu czytanego od base (kolumny z tabulacją jak w CharReader)
+std::size_t IncrementalDocument::offsetOfRelative(std::size_t base, Position relative) const {
+    std::size_t offset = base;
+    if (relative.line > 1) {
+        auto baseLine = static_cast<std::size_t>(std::upper_bound(lineStarts.begin(), lineStarts.end(), base) - lineStarts.begin() - 1);
+        std::size_t line = baseLine + relative.line - 1;
+        if (line >= lineStarts.size())
+            return text.size();
+        offset = lineStarts[line];
+    }
+    unsigned int column = 1;
+    while (offset < text.size() && column < relative.column && text[offset] != '\n')
+        column = nextColumn(column, text[offset++]);
+    return offset;
+}
+
+std::size_t IncrementalDocument::offsetOf(Position position) const {
+    return offsetOfRelative(0, position);
+}
+
+Position IncrementalDocument::positionOf(std::size_t offset) const {
+    offset = std::min(offset, text.size());
+    auto line = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset) - lineStarts.begin() - 1;
+    unsigned int column = 1;
+    for (std::size_t i = lineStarts[line]; i < offset; i++)
+        column = nextColumn(column, text[i]);
+    return Position{static_cast<unsigned int>(line + 1), column};
+}
+
+Position IncrementalDocument::toDocumentPosition(const Item &item, Position relative) const {
+    return positionOf(std::min(offsetOfRelative(item.begin, relative), item.end));
+}
+
+const IncrementalDocument::Item *IncrementalDocument::itemAt(std::size_t offset) const {
+    auto it = std::upper_bound(items.begin(), items.end(), offset, [](std::size_t value, const Item& item) {
+        return value < item.begin;
+    });
+    if (it == items.begin())
+        return nullptr;
+    --it;
+    return offset < it->end ? &*it : nullptr;
+}
+
+const IncrementalDocument::Item *IncrementalDocument::itemOf(const Node *topLevel) const {
+    if (topLevel == nullptr)
+        return nullptr;
+    auto find = [this, topLevel](const auto& map, auto names) -> const Item* {
+        for (const auto& [name, node] : map) {
+            if (node.get() != topLevel)
+                continue;
+            for (const auto& item : items)
+                if (item.inProgram && (item.names.*names).count(name) > 0)
+                    return &item;
+        }
+        return nullptr;
+    };
+    using Names = Nodes::Program::ItemNames;
+    if (auto item = find(program->getFunctions(), &Names::functions))
+        return item;
+    if (auto item = find(program->getVariables(), &Names::variables))
+        return item;
+    if (auto item = find(program->getStructTypes(), &Names::structTypes))
+        return item;
+    return find(program->getVariantTypes(), &Names::variantTypes);
+}
+
+// *********************************************************************************************************************
+//                  Skanowanie i parsowanie elementów
+// *********************************************************************************************************************
+
+// Granice elementów od start: funkcja kończy się ']' zamykającym jej ciało, reszta ';' poza nawiasami.
+// Po każdym elemencie stop(koniec) decyduje, czy dalszy tekst jest już znany. Błąd leksykalny nie
+// przerywa skanowania - lekser startuje ponownie od następnej linii, a błąd zgłosi parser elementu.
+template<typename StopPredicate>
+std::vector<IncrementalDocument::Range> IncrementalDocument::scanItems(std::size_t start, StopPredicate stop, std::size_t &scannedUntil) {
+    std::vector<Range> ranges;
+    bool inItem = false;
+    bool isFunction = false;
+    std::size_t begin = 0;
+    int parenDepth = 0;
+    int bracketDepth = 0;
+    std::size_t base = start;
+    while (base < text.size()) {
+        TextView view(text.data() + base, text.data() + text.size());
+        std::istream stream(&view);
+        Lexer lexer(stream);
+        std::size_t resume = text.size();
+        try {
+            while (true) {
+                auto token = lexer.getNextToken();
+                auto type = token.getType();
+                if (type == TokenTypes::EOF_TOKEN)
+                    break;
+                if (type == TokenTypes::SINGLE_COMMENT || type == TokenTypes::MULTILINE_COMMENT_START)
+                    continue;
+                auto offset = offsetOfRelative(base, token.getPosition());
+                if (!inItem) {
+                    inItem = true;
+                    begin = offset;
+                    isFunction = type == TokenTypes::FUN_KW;
+                    parenDepth = 0;
+                    bracketDepth = 0;
+                }
+                bool ends = false;
+                if (type == TokenTypes::PAREN_LEFT)
+                    parenDepth++;
+                else if (type == TokenTypes::PAREN_RIGHT)
+                    parenDepth--;
+                else if (type == TokenTypes::BRACKET_LEFT)
+                    bracketDepth++;
+                else if (type == TokenTypes::BRACKET_RIGHT)
+                    ends = --bracketDepth == 0 && isFunction;
+                else if (type == TokenTypes::SEMICOLON)
+                    ends = !isFunction && parenDepth <= 0 && bracketDepth <= 0;
+                if (ends) {
+                    inItem = false;
+                    ranges.push_back(Range{begin, offset + 1});
+                    if (stop(offset + 1)) {
+                        scannedUntil = offset + 1;
+                        return ranges;
+                    }
+                }
+            }
+        } catch (MyException& e) {
+            auto errorOffset = offsetOfRelative(base, e.getPosition());
+            if (!inItem) {
+                inItem = true;
+                begin = errorOffset;
+                isFunction = false;
+            }
+            auto nextLine = std::upper_bound(lineStarts.begin(), lineStarts.end(), errorOffset);
+            resume = nextLine == lineStarts.end() ? text.size() : *nextLine;
+        }
+        base = resume;
+    }
+    if (inItem)
+        ranges.push_back(Range{begin, text.size()});
+    scannedUntil = text.size();
+    return ranges;
+}
+
+std::vector<IncrementalDocument::ItemToken> IncrementalDocument::tokensOf(const Item &item) const {
+    std::vector<ItemToken> tokens;
+    TextView view(text.data() + item.begin, text.data() + item.end);
+    std::istream stream(&view);
+    Lexer lexer(stream);
+    try {
+        for (auto token = lexer.getNextToken(); token.getType() != TokenTypes::EOF_TOKEN; token = lexer.getNextToken())
+            if (token.getType() != TokenTypes::SINGLE_COMMENT && token.getType() != TokenTypes::MULTILINE_COMMENT_START)
+                tokens.push_back(ItemToken{token, offsetOfRelative(item.begin, token.getPosition())});
+    } catch (MyException&) {}
+    return tokens;
+}
+
+IncrementalDocument::Item IncrementalDocument::parseItem(Range range) {
+    Item item{range.begin, range.end};
+    if (text.compare(range.begin, 3, "fun") == 0) {
+        for (std::size_t i = range.begin; i < range.end && text[i] != '['; i++)
+            if (!std::isspace(static_cast<unsigned char>(text[i])))
+                item.header += text[i];
+    }
+    std::unique_ptr<Nodes::Program> parsed;
+    try {
+        TextView view(text.data() + range.begin, text.data() + range.end);
+        std::istream stream(&view);
+        Parser parser(stream);
+        parser.allowExternalTypes();
+        parsed = parser.parseProgram();
+    } catch (MyException& e) {
+        item.error = Diagnostic{e.getPosition(), e.getMessage()};
+        return item;
+    }
+    if (!parsed)
+        return item;
+    item.names = parsed->getItemNames();
+    try {
+        program->merge(*parsed);
+        item.inProgram = true;
+    } catch (MyException& e) {
+        item.error = Diagnostic{e.getPosition(), e.getMessage()};
+    }
+    return item;
+}
+
+// element odrzucony jako powtórzona nazwa może wejść do programu, gdy pierwsza definicja zniknęła
+bool IncrementalDocument::retryDuplicates() {
+    bool added = false;
+    for (auto& item : items) {
+        if (item.inProgram || isParseError(item) || !item.error)
+            continue;
+        item = parseItem(Range{item.begin, item.end});
+        added = added || item.inProgram;
+    }
+    return added;
+}
+
+// *********************************************************************************************************************
+//                  Edycja i analiza
+// *********************************************************************************************************************
+
+void IncrementalDocument::applyEdit(std::size_t offset, std::size_t length, const std::string &newText) {
+    if (offset > text.size() || length > text.size() - offset)
+        throw MyException("Edit range outside of document");
+    lastEdit = EditStats();
+    auto delta = static_cast<long long>(newText.size()) - static_cast<long long>(length);
+    auto oldEditEnd = offset + length;
+    auto newEditEnd = offset + newText.size();
+
+    // elementy kończące się przed edycją zostają; skanowanie od końca ostatniego z nich
+    auto first = static_cast<std::size_t>(std::partition_point(items.begin(), items.end(), [offset](const Item& item) {
+        return item.end <= offset;
+    }) - items.begin());
+    std::size_t windowStart = first > 0 ? items[first - 1].end : 0;
+
+    text.replace(offset, length, newText);
+    updateLineStarts(offset, length, newText);
+
+    // za edycją tekst jest taki sam, więc koniec nowego elementu w miejscu starej granicy kończy okno
+    std::size_t resumeIndex = items.size();
+    auto stop = [&](std::size_t end) {
+        if (end < newEditEnd)
+            return false;
+        auto oldEnd = static_cast<long long>(end) - delta;
+        if (oldEnd < static_cast<long long>(oldEditEnd))
+            return false;
+        // wstawienie między elementami kończy się na granicy sprzed okna
+        if (oldEnd == static_cast<long long>(windowStart)) {
+            resumeIndex = first;
+            return true;
+        }
+        auto it = std::lower_bound(items.begin() + first, items.end(), oldEnd, [](const Item& item, long long value) {
+            return static_cast<long long>(item.end) < value;
+        });
+        if (it == items.end() || static_cast<long long>(it->end) != oldEnd)
+            return false;
+        resumeIndex = it - items.begin() + 1;
+        return true;
+    };
+    std::size_t scannedUntil = 0;
+    auto ranges = scanItems(windowStart, stop, scannedUntil);
+
+    // zmiana tylko ciał funkcji (te same nazwy i nagłówki) nie unieważnia analizy pozostałych funkcji
+    std::map<std::string, std::string> removedHeaders;
+    bool bodiesOnly = true;
+    for (std::size_t i = first; i < resumeIndex; i++) {
+        const auto& item = items[i];
+        if (item.inProgram)
+            program->removeItems(item.names);
+        bodiesOnly = bodiesOnly && item.inProgram && onlyFunctions(item.names);
+        for (const auto& name : item.names.functions)
+            removedHeaders[name] = item.header;
+    }
+    std::vector<Item> fresh;
+    std::map<std::string, std::string> freshHeaders;
+    for (const auto& range : ranges) {
+        fresh.push_back(parseItem(range));
+        bodiesOnly = bodiesOnly && fresh.back().inProgram && onlyFunctions(fresh.back().names);
+        for (const auto& name : fresh.back().names.functions)
+            freshHeaders[name] = fresh.back().header;
+    }
+    bodiesOnly = bodiesOnly && removedHeaders == freshHeaders;
+
+    for (std::size_t i = resumeIndex; i < items.size(); i++) {
+        items[i].begin += delta;
+        items[i].end += delta;
+    }
+    items.erase(items.begin() + first, items.begin() + resumeIndex);
+    items.insert(items.begin() + first, fresh.begin(), fresh.end());
+    if (retryDuplicates())
+        bodiesOnly = false;
+
+    lastEdit.relexedBytes = scannedUntil - windowStart;
+    lastEdit.reparsedItems = fresh.size();
+    lastEdit.reusedItems = items.size() - fresh.size();
+    // z błędem składni analiza zgłaszałaby tylko skutki brakującego elementu
+    if (std::any_of(items.begin(), items.end(), isParseError)) {
+        semanticScope.reset();
+        return;
+    }
+    check(bodiesOnly);
+}
+
+// Elementy globalne sprawdzane są tylko przy pełnej analizie; ich kontekst zostaje w semanticScope,
+// a kolejne zmiany samych ciał sprawdzają na nim tylko nowe funkcje.
+void IncrementalDocument::check(bool bodiesOnly) {
+    lastEdit.fullSemanticCheck = !bodiesOnly || !semanticScope;
+    if (lastEdit.fullSemanticCheck) {
+        globalError.reset();
+        for (auto& item : items) {
+            item.bodyChecked = false;
+            item.semanticError.reset();
+        }
+        semanticScope = std::make_unique<SemanticVisitor>(program->getStructTypes(), program->getVariantTypes());
+        try {
+            semanticScope->declareGlobals(program.get());
+        } catch (MyException& e) {
+            auto owner = itemOf(semanticScope->getCurrentTopLevelNode());
+            globalError = Diagnostic{owner ? toDocumentPosition(*owner, e.getPosition()) : Position{1, 1}, e.getMessage()};
+            semanticScope.reset();
+            return;
+        }
+    }
+    for (auto& item : items) {
+        if (!item.inProgram || item.bodyChecked)
+            continue;
+        item.bodyChecked = true;
+        item.semanticError.reset();
+        for (const auto& name : item.names.functions) {
+            lastEdit.checkedFunctionBodies++;
+            try {
+                semanticScope->checkFunction(name, program->getFunctions().at(name).get());
+            } catch (MyException& e) {
+                item.semanticError = Diagnostic{e.getPosition(), e.getMessage()};
+                break;
+            }
+        }
+    }
+}
+
+std::vector<IncrementalDocument::Diagnostic> IncrementalDocument::getDiagnostics() const {
+    std::vector<Diagnostic> diagnostics;
+    bool parseErrors = std::any_of(items.begin(), items.end(), isParseError);
+    for (const auto& item : items) {
+        if (item.error)
+            diagnostics.push_back(Diagnostic{toDocumentPosition(item, item.error->pos), item.error->message});
+        if (item.semanticError && !parseErrors)
+            diagnostics.push_back(Diagnostic{toDocumentPosition(item, item.semanticError->pos), item.semanticError->message});
+    }
+    if (globalError && !parseErrors)
+        diagnostics.push_back(*globalError);
+    return diagnostics;
+}
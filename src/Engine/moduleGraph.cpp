@@ -0,0 +1,246 @@
+#include "moduleGraph.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include "astSerializer.h"
+#include "myException.h"
+#include "parser.h"
+#include "programCache.h"
+#include "scopeResolver.h"
+#include "semanticVisitor.h"
+#include "workStealingPool.h"
+
+namespace {
+    MyException inModule(const std::string& path, const MyException& error) {
+        std::string message = error.what();
+        if (!message.empty() && message.back() == '\n')
+            message.pop_back();
+        return MyException(path + ": " + message);
+    }
+
+    std::unique_ptr<Nodes::Program> readTree(const std::string& data) {
+        return AstReader::deserialize(data.data(), data.size());
+    }
+}
+
+std::string ModuleGraph::canonicalPath(const std::string &path) {
+    return std::filesystem::weakly_canonical(std::filesystem::absolute(path)).string();
+}
+
+// Wczytuje moduły osiągalne z root. Importy znalezione w sparsowanym module od razu trafiają do puli,
+// więc niezależne gałęzie grafu parsowane są równolegle. Plik o niezmienionej treści nie jest parsowany.
+std::set<std::string> ModuleGraph::discover(const std::string &root, std::unique_ptr<Nodes::Program> rootProgram) {
+    std::mutex mutex;
+    std::set<std::string> reachable{root};
+    WorkStealingPool pool(threads);
+
+    std::function<void(const std::string&)> load = [&](const std::string& path) {
+        std::ifstream file(path);
+        if (!file)
+            throw MyException("Cannot open module " + path);
+        std::ostringstream content;
+        content << file.rdbuf();
+        std::string source = content.str();
+        auto hash = ProgramCache::hashSource(source);
+
+        std::vector<std::string> imports;
+        bool upToDate;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto cached = modules.find(path);
+            upToDate = cached != modules.end() && cached->second.sourceHash == hash && !cached->second.parsed.empty();
+            if (upToDate)
+                imports = cached->second.imports;
+        }
+        if (!upToDate) {
+            std::unique_ptr<Nodes::Program> program;
+            if (path == root && rootProgram) {
+                program = std::move(rootProgram);
+            } else {
+                std::istringstream stream(source);
+                auto parser = pipelined ? std::make_unique<Parser>(stream, Parser::Pipelined{}) : std::make_unique<Parser>(stream);
+                try {
+                    program = parser->parseProgram();
+                } catch (MyException& e) {
+                    throw inModule(path, e);
+                }
+            }
+            if (!program)
+                throw MyException(path + ": module is empty");
+            auto directory = std::filesystem::path(path).parent_path();
+            for (const auto& import : program->getImports()) {
+                auto importPath = canonicalPath((directory / import.path).string());
+                if (!std::filesystem::is_regular_file(importPath))
+                    throw inModule(path, MyException("Cannot find module '" + import.path + "'", import.pos));
+                imports.push_back(importPath);
+            }
+            auto parsed = AstWriter::serialize(*program);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            modules[path] = Module{hash, imports, std::move(parsed), ""};
+            changed.insert(path);
+            lastBuild.parsed.push_back(path);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& import : imports)
+            if (reachable.insert(import).second)
+                pool.submit([&load, import]() { load(import); });
+    };
+
+    pool.submit([&load, root]() { load(root); });
+    pool.wait();
+    return reachable;
+}
+
+// kolejność topologiczna: zależności przed modułami, które je importują
+std::vector<std::string> ModuleGraph::orderModules(const std::string &root) const {
+    std::vector<std::string> order;
+    std::map<std::string, bool> finished;
+    std::vector<std::string> path;
+
+    std::function<void(const std::string&)> visit = [&](const std::string& module) {
+        finished[module] = false;
+        path.push_back(module);
+        for (const auto& import : modules.at(module).imports) {
+            auto state = finished.find(import);
+            if (state == finished.end()) {
+                visit(import);
+            } else if (!state->second) {
+                std::string cycle;
+                for (auto it = std::find(path.begin(), path.end(), import); it != path.end(); ++it)
+                    cycle += *it + " -> ";
+                throw MyException("Import cycle: " + cycle + import);
+            }
+        }
+        path.pop_back();
+        finished[module] = true;
+        order.push_back(module);
+    };
+    visit(root);
+    return order;
+}
+
+// Moduł sprawdzany jest razem z kopiami swoich zależności (już sprawdzonych, ich funkcji nie analizuje
+// się ponownie); w wyniku zostają tylko jego własne elementy z adnotacjami analizy.
+void ModuleGraph::checkModule(const std::string &path, const std::set<std::string> &dependencies) {
+    Module& module = modules.at(path);
+    auto program = readTree(module.parsed);
+    auto ownItems = program->getItemNames();
+    std::set<std::string> importedFunctions;
+    try {
+        for (const auto& dependency : dependencies) {
+            auto imported = readTree(modules.at(dependency).checked);
+            auto names = imported->getItemNames();
+            importedFunctions.insert(names.functions.begin(), names.functions.end());
+            program->merge(*imported);
+        }
+        SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+        semanticVisitor.setThreads(threads);
+        semanticVisitor.checkAsModule(std::move(importedFunctions));
+        program->accept(semanticVisitor);
+    } catch (MyException& e) {
+        throw inModule(path, e);
+    }
+    program->retainItems(ownItems);
+    module.checked = AstWriter::serialize(*program);
+}
+
+void ModuleGraph::parse(const std::string &rootPath, std::unique_ptr<Nodes::Program> root) {
+    lastBuild = BuildReport();
+    changed.clear();
+    auto rootModule = canonicalPath(rootPath);
+    if (!std::filesystem::is_regular_file(rootModule))
+        throw MyException("Cannot open module " + rootPath);
+    discover(rootModule, std::move(root));
+}
+
+std::unique_ptr<Nodes::Program> ModuleGraph::check(const std::string &rootPath) {
+    auto root = canonicalPath(rootPath);
+    auto order = orderModules(root);
+
+    // do ponownej analizy: moduły zmienione, bez wyniku analizy lub zależne od takich
+    std::map<std::string, std::set<std::string>> dependencies;
+    std::set<std::string> stale;
+    for (const auto& path : order) {
+        auto& moduleDependencies = dependencies[path];
+        bool isStale = changed.count(path) > 0 || modules.at(path).checked.empty();
+        for (const auto& import : modules.at(path).imports) {
+            moduleDependencies.insert(import);
+            moduleDependencies.insert(dependencies[import].begin(), dependencies[import].end());
+            isStale = isStale || stale.count(import) > 0;
+        }
+        if (isStale) {
+            stale.insert(path);
+            // nieudana analiza nie może zostawić nieaktualnego wyniku
+            modules.at(path).checked.clear();
+        }
+    }
+
+    // moduł trafia do puli, gdy wszystkie jego nieaktualne zależności są już sprawdzone
+    std::mutex mutex;
+    std::map<std::string, std::size_t> waitingFor;
+    std::map<std::string, std::vector<std::string>> dependents;
+    for (const auto& path : stale) {
+        for (const auto& import : modules.at(path).imports) {
+            if (stale.count(import) > 0) {
+                waitingFor[path]++;
+                dependents[import].push_back(path);
+            }
+        }
+    }
+    // gotowe od razu wybierane przed startem zadań - potem waitingFor zmieniają już tylko wątki puli
+    std::vector<std::string> ready;
+    for (const auto& path : order)
+        if (stale.count(path) > 0 && waitingFor[path] == 0)
+            ready.push_back(path);
+    {
+        WorkStealingPool pool(threads);
+        std::function<void(const std::string&)> check = [&](const std::string& path) {
+            checkModule(path, dependencies.at(path));
+            std::lock_guard<std::mutex> lock(mutex);
+            lastBuild.checked.push_back(path);
+            for (const auto& dependent : dependents[path])
+                if (--waitingFor[dependent] == 0)
+                    pool.submit([&check, dependent]() { check(dependent); });
+        };
+        for (const auto& path : ready)
+            pool.submit([&check, path]() { check(path); });
+        pool.wait();
+    }
+    std::sort(lastBuild.parsed.begin(), lastBuild.parsed.end());
+    std::sort(lastBuild.checked.begin(), lastBuild.checked.end());
+
+    auto program = std::make_unique<Nodes::Program>(std::map<std::string, std::unique_ptr<Nodes::FunctionDeclaration>>(),
+                                                    std::map<std::string, std::unique_ptr<Nodes::Declaration>>(),
+                                                    std::map<std::string, std::unique_ptr<Nodes::StructTypeDefinition>>(),
+                                                    std::map<std::string, std::unique_ptr<Nodes::VariantTypeDefinition>>(),
+                                                    Position{1, 1});
+    for (const auto& path : order) {
+        auto part = readTree(modules.at(path).checked);
+        try {
+            program->merge(*part);
+        } catch (MyException& e) {
+            throw inModule(path, e);
+        }
+    }
+    if (program->getFunctions().find("main") == program->getFunctions().end())
+        throw MyException("main() function missing!");
+    ScopeResolver scopeResolver;
+    program->accept(scopeResolver);
+    changed.clear();
+    return program;
+}
+
+std::unique_ptr<Nodes::Program> ModuleGraph::link(const std::string &rootPath) {
+    parse(rootPath);
+    return check(rootPath);
+}
+
+std::shared_ptr<const CompiledProgram> ModuleGraph::build(const std::string &rootPath) {
+    return std::shared_ptr<const CompiledProgram>(new CompiledProgram(link(rootPath)));
+}
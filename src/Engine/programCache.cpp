@@ -0,0 +1,88 @@
+#include "programCache.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include "astSerializer.h"
+#include "buildStamp.h"
+#include "myException.h"
+
+ProgramCache::ProgramCache(std::string directory) : directory(std::move(directory)) {
+    mkdir(this->directory.c_str(), 0755);
+}
+
+std::uint64_t ProgramCache::hashSource(const std::string &source) {
+    return AstFormat::checksum(source.data(), source.size());
+}
+
+std::string ProgramCache::entryPath(const std::string &source) const {
+    std::ostringstream path;
+    path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << hashSource(source)
+         << "-" << std::dec << source.size() << "-v" << AstFormat::VERSION
+         << "-" << std::hex << std::setw(8) << (hashSource(TKOM_BUILD_STAMP) & 0xffffffffU) << ".tkc";
+    return path.str();
+}
+
+std::unique_ptr<Nodes::Program> ProgramCache::load(const std::string &source) const {
+    std::string path = entryPath(source);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    auto size = static_cast<std::size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return nullptr;
+
+    std::unique_ptr<Nodes::Program> program;
+    try {
+        // znacznik = źródło, żeby kolizja skrótu nie zwróciła cudzego programu
+        program = AstReader::deserialize(static_cast<const char*>(mapped), size, source);
+        // interpreter nie może przeliczać zasięgów współdzielonego programu
+        if (!program->areScopesResolved())
+            program = nullptr;
+    } catch (std::exception&) {
+        program = nullptr;
+    }
+    munmap(mapped, size);
+    // uszkodzony wpis usuwany - compile() zapisze go od nowa
+    if (!program)
+        std::remove(path.c_str());
+    return program;
+}
+
+void ProgramCache::store(const std::string &source, const Nodes::Program &program) const {
+    std::string path = entryPath(source);
+    // osobny plik tymczasowy dla każdego wątku - równoległe zapisy tego samego wpisu się nie mieszają
+    std::string temporary = path + ".tmp" + std::to_string(getpid()) + "-"
+                            + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return;
+        file << AstWriter::serialize(program, source);
+        if (!file) {
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+        std::remove(temporary.c_str());
+}
+
+std::shared_ptr<const CompiledProgram> ProgramCache::compile(const std::string &source) const {
+    CompileOptions options;
+    options.cache = this;
+    return Engine::compile(source, options);
+}
@@ -0,0 +1,119 @@
+#include "workStealingPool.h"
+
+#include <algorithm>
+#include "myException.h"
+
+namespace {
+    // pula i kolejka wątku roboczego; nullptr dla wątków spoza puli
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local std::size_t currentIndex = 0;
+}
+
+WorkStealingPool::WorkStealingPool(std::size_t threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t i = 0; i < threads; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (std::size_t i = 0; i < threads; i++)
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        allDone.wait(lock, [this]() { return pending.load() == 0; });
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void WorkStealingPool::submit(Task task) {
+    // zadanie zgłoszone z wątku puli trafia do jego własnej kolejki
+    std::size_t index = currentPool == this ? currentIndex : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(Entry{std::move(task), AllocTracker::currentPhase()});
+    }
+    // Wątek zasypia po idle++ i sprawdzeniu queued pod stateMutex. Jeśli nie widzimy go jako
+    // uśpionego, to on zobaczy nasze queued++ i nie zaśnie; jeśli widzimy - blokada gwarantuje,
+    // że powiadomienie trafi do niego już w wait
+    queued.fetch_add(1);
+    if (idle.load() > 0) {
+        { std::lock_guard<std::mutex> lock(stateMutex); }
+        taskAvailable.notify_one();
+    }
+}
+
+void WorkStealingPool::wait() {
+    if (currentPool == this)
+        throw MyException("WorkStealingPool::wait() called from a task of the same pool");
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this]() { return pending.load() == 0; });
+    if (firstError) {
+        auto error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool WorkStealingPool::popLocal(std::size_t index, Entry &entry) {
+    auto& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    entry = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(std::size_t index, Entry &entry) {
+    for (std::size_t offset = 1; offset < queues.size(); offset++) {
+        auto& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty())
+            continue;
+        entry = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(Entry &entry) {
+    queued.fetch_sub(1);
+    try {
+        // alokacje zadania liczone są w fazie, w której je zgłoszono
+        AllocTracker::PhaseScope phase(entry.phase);
+        entry.task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!firstError)
+            firstError = std::current_exception();
+    }
+    entry.task = nullptr;
+    if (pending.fetch_sub(1) == 1) {
+        { std::lock_guard<std::mutex> lock(stateMutex); }
+        allDone.notify_all();
+    }
+}
+
+void WorkStealingPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        Entry entry;
+        if (popLocal(index, entry) || steal(index, entry)) {
+            run(entry);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(stateMutex);
+        idle.fetch_add(1);
+        taskAvailable.wait(lock, [this]() { return queued.load() > 0 || stopping; });
+        idle.fetch_sub(1);
+        if (stopping && queued.load() == 0)
+            return;
+    }
+}
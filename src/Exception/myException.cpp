@@ -3,7 +3,7 @@
 //
 #include "Exception/myException.h"
 
-MyException::MyException(const std::string& message, struct Position pos) noexcept {
+MyException::MyException(const std::string& message, struct Position pos) noexcept : message(message) {
     errorMessage += message;
     errorMessage += "\n\tat Line: ";
     errorMessage += std::to_string(pos.line);
@@ -21,7 +21,7 @@ struct Position MyException::getPosition() const noexcept {
     return this->pos;
 }
 
-MyException::MyException(const std::string &message) noexcept {
+MyException::MyException(const std::string &message) noexcept : message(message) {
     errorMessage += message;
     errorMessage += "\n";
 }
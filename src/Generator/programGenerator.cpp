@@ -0,0 +1,190 @@
+#include "Generator/programGenerator.h"
+
+#include <algorithm>
+#include <utility>
+
+ProgramGenerator::ProgramGenerator(GeneratorOptions options) : options(options), random(options.seed) {}
+
+std::string ProgramGenerator::generate() {
+    source.clear();
+    nextVariable = 0;
+    generateStructTypes();
+    generateVariantTypes();
+    for (int i = 0; i < options.functions; i++)
+        generateFunction(i);
+    generateMain();
+    return std::move(source);
+}
+
+void ProgramGenerator::generateStructTypes() {
+    for (int i = 0; i < options.structCount; i++)
+        source += "struct::rec" + std::to_string(i) + "(int::first; int::second; str::label;);\n";
+}
+
+void ProgramGenerator::generateVariantTypes() {
+    for (int i = 0; i < options.variantCount; i++)
+        source += "variant::alt" + std::to_string(i) + "(int; str;);\n";
+}
+
+void ProgramGenerator::generateFunction(int index) {
+    scopes.clear();
+    scopes.emplace_back();
+    scopes.back().ints = {"depth", "seed", "acc"};
+    scopes.back().mutableInts = {"acc"};
+
+    source += "fun int::f" + std::to_string(index) + "(int::depth, int::seed)[\n";
+    source += "    mut int::acc = seed;\n";
+    generateBlock(0, "    ", true);
+    generateCalls(index, "    ");
+    source += "    return acc;\n]\n";
+}
+
+void ProgramGenerator::generateMain() {
+    source += "fun int::main()[\n    mut int::result = 0;\n";
+    if (options.functions > 0)
+        source += "    result = f0(" + std::to_string(options.callDepth) + ", 1);\n";
+    source += "    return 0;\n]\n";
+}
+
+void ProgramGenerator::generateCalls(int index, const std::string &indent) {
+    int last = std::min(options.functions - 1, index + options.callFanOut);
+    if (last <= index)
+        return;
+    source += indent + "if (depth > 0)[\n";
+    for (int callee = index + 1; callee <= last; callee++)
+        source += indent + "    acc = acc + f" + std::to_string(callee) + "(depth - 1, " + operand() + ");\n";
+    source += indent + "]\n";
+}
+
+void ProgramGenerator::generateBlock(int depth, const std::string &indent, bool chain) {
+    int nestedAt = chain && depth < options.nestingDepth ? randomInt(0, std::max(options.statementsPerBlock - 1, 0)) : -1;
+    for (int i = 0; i < std::max(options.statementsPerBlock, nestedAt + 1); i++) {
+        if (i == nestedAt)
+            generateNested(depth, indent);
+        else
+            generateStatement(indent);
+    }
+}
+
+// ogniwo łańcucha: if z płaskim else albo pętla; łańcuch biegnie dalej tylko przez jeden blok
+void ProgramGenerator::generateNested(int depth, const std::string &indent) {
+    if (randomInt(0, 1) == 0) {
+        source += indent + "if (" + operand() + " < " + std::to_string(randomInt(0, 50)) + " and " + operand() + " != " + operand() + ")[\n";
+        scopes.emplace_back();
+        generateBlock(depth + 1, indent + "    ", true);
+        scopes.pop_back();
+        source += indent + "] else [\n";
+        scopes.emplace_back();
+        generateBlock(depth + 1, indent + "    ", false);
+        scopes.pop_back();
+        source += indent + "]\n";
+        return;
+    }
+    // licznik nie trafia do mutableInts, żeby losowe przypisania nie zepsuły warunku pętli
+    std::string counter = newVariable("i");
+    source += indent + "mut int::" + counter + " = 0;\n";
+    scopes.back().ints.push_back(counter);
+    source += indent + "while (" + counter + " < " + std::to_string(randomInt(2, 4)) + ")[\n";
+    scopes.emplace_back();
+    generateBlock(depth + 1, indent + "    ", true);
+    scopes.pop_back();
+    source += indent + "    " + counter + " = " + counter + " + 1;\n";
+    source += indent + "]\n";
+}
+
+void ProgramGenerator::generateStatement(const std::string &indent) {
+    int kind = randomInt(0, 3);
+    if (kind == 2 && options.structCount == 0)
+        kind = 0;
+    if (kind == 3 && options.variantCount == 0)
+        kind = 1;
+
+    switch (kind) {
+        case 0: {
+            std::string name = newVariable("x");
+            source += indent + "mut int::" + name + " = " + expression() + ";\n";
+            scopes.back().ints.push_back(name);
+            scopes.back().mutableInts.push_back(name);
+            break;
+        }
+        case 1: {
+            source += indent + pickVisible(&Scope::mutableInts).value() + " = " + expression() + ";\n";
+            break;
+        }
+        case 2: {
+            auto structVar = pickVisible(&Scope::mutableStructs);
+            if (structVar && randomInt(0, 1) == 0) {
+                source += indent + *structVar + (randomInt(0, 1) == 0 ? ".first" : ".second") + " = " + expression() + ";\n";
+                break;
+            }
+            std::string name = newVariable("s");
+            std::string type = "rec" + std::to_string(randomInt(0, options.structCount - 1));
+            source += indent + "mut " + type + "::" + name + "(" + expression() + ", " + expression() + ", \"" + name + "\");\n";
+            scopes.back().structs.push_back(name);
+            scopes.back().mutableStructs.push_back(name);
+            break;
+        }
+        case 3: {
+            auto variantVar = pickVisible(&Scope::variants);
+            if (variantVar && randomInt(0, 1) == 0) {
+                const std::string& variant = *variantVar;
+                if (randomInt(0, 1) == 0)
+                    source += indent + variant + " = \"" + variant + "\";\n";
+                else
+                    source += indent + variant + " = " + expression() + ";\n";
+                break;
+            }
+            std::string name = newVariable("w");
+            std::string type = "alt" + std::to_string(randomInt(0, options.variantCount - 1));
+            source += indent + "mut " + type + "::" + name + " = " + expression() + ";\n";
+            source += indent + "str::" + newVariable("h") + " = " + name + ".holding();\n";
+            scopes.back().variants.push_back(name);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+std::string ProgramGenerator::expression() {
+    std::string result = operand();
+    for (int i = 1; i < options.expressionLength; i++)
+        result += (randomInt(0, 1) == 0 ? " + " : " - ") + operand();
+    return result;
+}
+
+std::string ProgramGenerator::operand() {
+    int kind = randomInt(0, 3);
+    if (kind == 0)
+        return std::to_string(randomInt(0, 9));
+    if (kind == 1) {
+        auto structVar = pickVisible(&Scope::structs);
+        if (structVar)
+            return *structVar + (randomInt(0, 1) == 0 ? ".first" : ".second");
+    }
+    return pickVisible(&Scope::ints).value();
+}
+
+std::string ProgramGenerator::newVariable(const std::string &prefix) {
+    return prefix + std::to_string(nextVariable++);
+}
+
+int ProgramGenerator::randomInt(int from, int to) {
+    return std::uniform_int_distribution<int>(from, to)(random);
+}
+
+std::optional<std::string> ProgramGenerator::pickVisible(std::vector<std::string> Scope::*member) {
+    std::size_t count = 0;
+    for (const auto& scope : scopes)
+        count += (scope.*member).size();
+    if (count == 0)
+        return std::nullopt;
+
+    auto index = static_cast<std::size_t>(randomInt(0, static_cast<int>(count) - 1));
+    for (const auto& scope : scopes) {
+        if (index < (scope.*member).size())
+            return (scope.*member)[index];
+        index -= (scope.*member).size();
+    }
+    return std::nullopt;
+}
@@ -1,5 +1,10 @@
+#include <charconv>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include "lexer.h"
+#include "stats.h"
+#include "allocTracker.h"
 
 static const std::map<std::string, TokenTypes> keywordMap = {
         {"int", TokenTypes::INT_KW},
@@ -8,6 +13,7 @@ static const std::map<std::string, TokenTypes> keywordMap = {
         {"bool", TokenTypes::BOOL_KW},
         {"mut", TokenTypes::MUT_KW},
         {"fun", TokenTypes::FUN_KW},
+        {"import", TokenTypes::IMPORT_KW},
         {"if", TokenTypes::IF_KW},
         {"else", TokenTypes::ELSE_KW},
         {"else", TokenTypes::ELSE_KW},
@@ -47,10 +53,12 @@ bool Lexer::nextChar() {
 }
 
 Token Lexer::getNextToken(){
+    TKOM_STATS_INC(TOKENS);
+    TKOM_ALLOC_PHASE(LEX);
     while (isspace(currChar)) {
         nextChar();
     }
-    tokenPos = charReader.getPos();
+    tokenPos = charReader.getLocation();
 
     currToken = Token(TokenTypes::UNDEF, tokenPos);
     if (
@@ -87,47 +95,54 @@ bool Lexer::checkAndAssignTokenNumber() {
         return false;
 
 
-    std::string numberStr;
-    if (currChar == '-') {
-        numberStr += currChar;
+    // Cyfry części całkowitej liczone od razu w arytmetyce całkowitej; znaki literału trafiają
+    // do numberChars (bufor lexera, bez alokacji po pierwszych liczbach) tylko dla from_chars.
+    numberChars.clear();
+    bool negative = currChar == '-';
+    if (negative) {
+        numberChars += currChar;
         nextChar();
     }
 
-    // Accumulate digits before the decimal point
+    // |INT_MIN| = INT_MAX + 1
+    const std::int64_t limit = std::int64_t(std::numeric_limits<int>::max()) + (negative ? 1 : 0);
+    std::int64_t magnitude = 0;
+    bool intOverflow = false;
+    bool leadingZero = currChar == '0';
+    std::size_t digits = 0;
     while (isdigit(currChar)) {
-        numberStr += currChar;
+        if (!intOverflow) {
+            magnitude = magnitude * 10 + (currChar - '0');
+            intOverflow = magnitude > limit;
+        }
+        numberChars += currChar;
+        digits++;
         nextChar();
     }
 
-    bool isFloat = false;
-    // Check for decimal point and accumulate digits after it
     if (currChar == '.') {
-        isFloat = true;
-        numberStr += currChar;
+        numberChars += currChar;
         nextChar();
         while (isdigit(currChar)) {
-            numberStr += currChar;
+            numberChars += currChar;
             nextChar();
         }
+        float floatValue = 0;
+        auto error = std::from_chars(numberChars.data(), numberChars.data() + numberChars.size(), floatValue).ec;
+        if (error == std::errc::result_out_of_range)
+            throw MyException("Number too long", tokenPos);
+        if (error != std::errc())
+            throw MyException("Invalid number format", tokenPos);
+        currToken = Token(TokenTypes::FLOAT_VALUE, floatValue, tokenPos);
+        return true;
     }
 
-    // Convert the string to a number token
-    try {
-        if (isFloat) {
-            float floatValue = std::stof(numberStr);
-            currToken = Token(TokenTypes::FLOAT_VALUE, floatValue, tokenPos);
-        } else {
-            if (numberStr.length() > 1 && numberStr[0] == '0')
-                throw MyException("Number cannot start with 0", tokenPos);
-            int intValue = std::stoi(numberStr);
-            currToken = Token(TokenTypes::INT_VALUE, intValue, tokenPos);
-        }
-    } catch (const std::invalid_argument& e) {
-        throw MyException("Invalid number format", tokenPos);
-    } catch (const std::out_of_range& e) {
+    if (!negative && leadingZero && digits > 1)
+        throw MyException("Number cannot start with 0", tokenPos);
+    if (intOverflow)
         throw MyException("Number too long", tokenPos);
-    }
-
+    auto intValue = static_cast<int>(negative ? -magnitude : magnitude);
+    currToken = Token(TokenTypes::INT_VALUE, intValue, tokenPos);
     return true;
 }
 
@@ -327,6 +342,9 @@ bool Lexer::checkAndAssignTokenStrLiteral() {
     if (matchAndGetNext('"')){
         std::string lexeme;
         while (currChar != '"'){
+            // niedomknięty literał (np. w trakcie pisania w edytorze) - bez tego pętla nie kończy się na EOF
+            if (currChar == EOF)
+                throw MyException("Unterminated string literal", tokenPos);
             if (currChar == '\\'){
                 nextChar();
                 switch (currChar) {
@@ -1,23 +1,23 @@
 #include "token.h"
 
 Token::Token()
-    : tokenType(TokenTypes::UNDEF), position({0, 0}){
+    : tokenType(TokenTypes::UNDEF){
 }
 
-Token::Token(TokenTypes type, struct Position pos)
-    : tokenType(type), position(pos){
+Token::Token(TokenTypes type, SourceLocation pos)
+    : tokenType(type), location(pos){
 }
 
-Token::Token(TokenTypes type, std::string lexeme, struct Position pos)
-    : tokenType(type), position(pos), tokenValue(std::move(lexeme)){
+Token::Token(TokenTypes type, std::string lexeme, SourceLocation pos)
+    : tokenType(type), location(pos), tokenValue(std::move(lexeme)){
 }
 
-Token::Token(TokenTypes type, int value, Position pos)
-    : tokenType(type), tokenValue(value), position(pos) {
+Token::Token(TokenTypes type, int value, SourceLocation pos)
+    : tokenType(type), tokenValue(value), location(pos) {
 }
 
-Token::Token(TokenTypes type, float value, Position pos)
-    : tokenType(type), tokenValue(value), position(pos) {
+Token::Token(TokenTypes type, float value, SourceLocation pos)
+    : tokenType(type), tokenValue(value), location(pos) {
 }
 
 TokenTypes Token::getType() const {
@@ -29,7 +29,11 @@ Token::valueContainer Token::getValue() const {
 }
 
 struct Position Token::getPosition() const {
-    return position;
+    return location.resolve();
+}
+
+SourceLocation Token::getLocation() const {
+    return location;
 }
 
 
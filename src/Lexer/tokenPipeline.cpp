@@ -0,0 +1,95 @@
+#include "tokenPipeline.h"
+
+TokenPipeline::TokenPipeline(std::istream &input_stream) : lexer(input_stream) {
+    producer = std::thread(&TokenPipeline::produce, this, AllocTracker::currentPhase());
+}
+
+TokenPipeline::TokenPipeline(const std::string &file_name) : lexer(file_name) {
+    producer = std::thread(&TokenPipeline::produce, this, AllocTracker::currentPhase());
+}
+
+TokenPipeline::~TokenPipeline() {
+    stopping.store(true);
+    wake();
+    producer.join();
+}
+
+// Usypiający zwiększa sleepers i dopiero potem sprawdza ready, budzący zmienia stan i dopiero potem
+// czyta sleepers (bariery seq_cst po obu stronach) - co najmniej jeden z nich widzi zmianę drugiego,
+// więc pominięcie powiadomienia nie zostawia śpiącego wątku.
+template<typename Ready>
+void TokenPipeline::park(Ready ready) {
+    std::unique_lock<std::mutex> lock(parkMutex);
+    sleepers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    parked.wait(lock, ready);
+    sleepers.fetch_sub(1);
+}
+
+void TokenPipeline::wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load() == 0)
+        return;
+    { std::lock_guard<std::mutex> lock(parkMutex); }
+    parked.notify_all();
+}
+
+bool TokenPipeline::push(Batch &batch) {
+    for (std::size_t tries = 0; !queue.tryPush(batch); tries++) {
+        if (stopping.load(std::memory_order_relaxed))
+            return false;
+        if (tries < SPIN_TRIES)
+            std::this_thread::yield();
+        else
+            park([this]() { return !queue.full() || stopping.load(); });
+    }
+    wake();
+    return true;
+}
+
+void TokenPipeline::produce(AllocTracker::Phase phase) {
+    // faza jest per wątek - bez tego paczki tokenów trafiałyby do "other"
+    AllocTracker::PhaseScope phaseScope(phase);
+    Batch batch;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        batch.tokens.reserve(BATCH_SIZE);
+        bool finished = false;
+        try {
+            while (batch.tokens.size() < BATCH_SIZE && !finished) {
+                auto token = lexer.getNextToken();
+                if (token.getType() == TokenTypes::SINGLE_COMMENT || token.getType() == TokenTypes::MULTILINE_COMMENT_START)
+                    continue;
+                finished = token.getType() == TokenTypes::EOF_TOKEN;
+                batch.tokens.push_back(std::move(token));
+            }
+        } catch (...) {
+            batch.error = std::current_exception();
+            finished = true;
+        }
+        if (!push(batch) || finished)
+            return;
+        batch = Batch{};
+    }
+}
+
+Token TokenPipeline::next() {
+    while (index == current.tokens.size()) {
+        if (current.error)
+            std::rethrow_exception(current.error);
+        // EOF był ostatnim tokenem - producent już skończył
+        if (!current.tokens.empty() && current.tokens.back().getType() == TokenTypes::EOF_TOKEN)
+            return current.tokens.back();
+        for (std::size_t tries = 0; !queue.tryPop(current); tries++) {
+            if (tries < SPIN_TRIES)
+                std::this_thread::yield();
+            else
+                park([this]() { return !queue.empty(); });
+        }
+        // producent mógł czekać na wolne miejsce
+        wake();
+        index = 0;
+    }
+    // każdy token oddawany jest raz, więc bez kopii wartości; EOF nie ma wartości do przeniesienia
+    // i dalej służy pętli wyżej
+    return std::move(current.tokens[index++]);
+}
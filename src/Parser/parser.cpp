@@ -7,18 +7,58 @@ bool Parser::matchToken(TokenTypes tokenType) const {
     return currToken.getType() == tokenType;
 }
 
+Parser::Parser(std::vector<Token> tokens) : replayTokens(std::move(tokens)), replaying(true) {
+    getNextToken();
+}
+
+Parser::Parser(std::istream &input_stream, Pipelined) : pipeline(std::make_unique<TokenPipeline>(input_stream)) {
+    getNextToken();
+}
+
+Parser::Parser(const std::string &file_name, Pipelined) : pipeline(std::make_unique<TokenPipeline>(file_name)) {
+    getNextToken();
+}
+
 void Parser::getNextToken() {
-    currToken = lexer.getNextToken();
-    while(currToken.getType() == TokenTypes::SINGLE_COMMENT || currToken.getType() == TokenTypes::MULTILINE_COMMENT_START) {
+    if (peekedToken) {
+        currToken = std::move(*peekedToken);
+        peekedToken.reset();
+        return;
+    }
+    if (replaying) {
+        // komentarze pominięte już przy zapisie tokenów
+        if (replayIndex < replayTokens.size())
+            currToken = replayTokens[replayIndex++];
+        else
+            currToken = Token(TokenTypes::EOF_TOKEN, replayTokens.empty() ? SourceLocation{} : replayTokens.back().getLocation());
+        return;
+    }
+    if (pipeline) {
+        // komentarze odfiltrowane już w wątku leksera
+        currToken = pipeline->next();
+    } else {
         currToken = lexer.getNextToken();
+        while(currToken.getType() == TokenTypes::SINGLE_COMMENT || currToken.getType() == TokenTypes::MULTILINE_COMMENT_START) {
+            currToken = lexer.getNextToken();
+        }
     }
     if(currToken.getType() == TokenTypes::UNDEF)
-        throw MyException("Undefined token!", currToken.getPosition());
+        throw MyException("Undefined token!", currToken.getLocation());
+}
+
+const Token &Parser::peekToken() {
+    if (!peekedToken) {
+        Token current = currToken;
+        getNextToken();
+        peekedToken = std::move(currToken);
+        currToken = std::move(current);
+    }
+    return *peekedToken;
 }
 
 void Parser::consumeToken(TokenTypes tokenType, const std::string &exceptionMessage) {
     if(!matchToken(tokenType)) {
-        throw MyException(exceptionMessage, currToken.getPosition());
+        throw MyException(exceptionMessage, currToken.getLocation());
     }
     getNextToken();
 }
@@ -50,7 +90,7 @@ IdType Parser::getIdTypeOfToken(TokenTypes) const {
     if (currToken.getType() == TokenTypes::BOOL_KW) return IdType::BOOLEAN;
     if (currToken.getType() == TokenTypes::STRUCT_KW) return IdType::STRUCT;
     if (currToken.getType() == TokenTypes::VARIANT_KW) return IdType::VARIANT;
-    throw MyException("Errow in getIdTypeOfToken (this should never be thrown)", currToken.getPosition());
+    throw MyException("Errow in getIdTypeOfToken (this should never be thrown)", currToken.getLocation());
 }
 
 bool Parser::contains(const std::vector<std::string> &vec, const std::string &value) const {
@@ -62,7 +102,7 @@ bool Parser::checkIfStructTypeExists(const std::string &id) const {
     if (sType != structTypes.end())
         return true;
     return false;
-    //throw MyException("Type with this id already exists", currToken.getPosition());
+    //throw MyException("Type with this id already exists", currToken.getLocation());
 }
 
 bool Parser::checkIfVariantTypeExists(const std::string& id) const {
@@ -70,14 +110,14 @@ bool Parser::checkIfVariantTypeExists(const std::string& id) const {
     if (vType != variantTypes.end())
         return true;
     return false;
-    //throw MyException("Type with this id already exists", currToken.getPosition());
+    //throw MyException("Type with this id already exists", currToken.getLocation());
 }
 
 bool Parser::checkIfFunctionExists(const std::string &id) const {
     auto fun = functions.find(id);
     if (fun != functions.end())
         return false;
-        // throw MyException("Function with this id already exists", currToken.getPosition());
+        // throw MyException("Function with this id already exists", currToken.getLocation());
     return true;
 }
 
@@ -85,7 +125,7 @@ bool Parser::checkIfVariableExists(const std::string &id) const {
     auto var =variables.find(id);
     if (var != variables.end())
         return false;
-        //throw MyException("Variable with this id already exists", currToken.getPosition());
+        //throw MyException("Variable with this id already exists", currToken.getLocation());
     return true;
 }
 
@@ -95,27 +135,27 @@ bool Parser::checkIfVariableExists(const std::string &id) const {
 
 std::unique_ptr<Nodes::StringLiteral> Parser::parseStringLiteral() {
     if (currToken.getType() == TokenTypes::STR_VALUE){
-        std::string value = std::get<std::string>(currToken.getValue());
+        std::string value = tokenValue<std::string>();
         getNextToken();
-        return std::make_unique<Nodes::StringLiteral>(value, currToken.getPosition());
+        return std::make_unique<Nodes::StringLiteral>(value, currToken.getLocation());
     }
     return nullptr;
 }
 
 std::unique_ptr<Nodes::FloatLiteral> Parser::parseFloatLiteral() {
     if (currToken.getType() == TokenTypes::FLOAT_VALUE){
-        float value = std::get<float>(currToken.getValue());
+        float value = tokenValue<float>();
         getNextToken();
-        return std::make_unique<Nodes::FloatLiteral>(value, currToken.getPosition());
+        return std::make_unique<Nodes::FloatLiteral>(value, currToken.getLocation());
     }
     return nullptr;
 }
 
 std::unique_ptr<Nodes::IntLiteral> Parser::parseIntLiteral() {
     if (currToken.getType() == TokenTypes::INT_VALUE){
-        int value = std::get<int>(currToken.getValue());
+        int value = tokenValue<int>();
         getNextToken();
-        return std::make_unique<Nodes::IntLiteral>(value, currToken.getPosition());
+        return std::make_unique<Nodes::IntLiteral>(value, currToken.getLocation());
     }
     return nullptr;
 }
@@ -124,21 +164,21 @@ std::unique_ptr<Nodes::BooleanLiteral> Parser::parseBooleanLiteral() {
     if (currToken.getType() == TokenTypes::TRUE_KW){
         bool value = true;
         getNextToken();
-        return std::make_unique<Nodes::BooleanLiteral>(value, currToken.getPosition());
+        return std::make_unique<Nodes::BooleanLiteral>(value, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::FALSE_KW){
         bool value = false;
         getNextToken();
-        return std::make_unique<Nodes::BooleanLiteral>(value, currToken.getPosition());
+        return std::make_unique<Nodes::BooleanLiteral>(value, currToken.getLocation());
     }
     return nullptr;
 }
 
 std::unique_ptr<Nodes::Identifier> Parser::parseIdentifier() {
     if (currToken.getType() == TokenTypes::IDENTIFIER){
-        std::string value = std::get<std::string>(currToken.getValue());
+        std::string value = tokenValue<std::string>();
         getNextToken();
-        return std::make_unique<Nodes::Identifier>(value, currToken.getPosition());
+        return std::make_unique<Nodes::Identifier>(value, currToken.getLocation());
     }
     return nullptr;
 }
@@ -150,27 +190,27 @@ std::unique_ptr<Nodes::Identifier> Parser::parseIdentifier() {
 std::unique_ptr<Nodes::RelOp> Parser::parseRelOp() {
     if (currToken.getType() == TokenTypes::LESS){
         getNextToken();
-        return std::make_unique<Nodes::RelOp>(LESS, currToken.getPosition());
+        return std::make_unique<Nodes::RelOp>(LESS, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::LESS_EQUAL){
         getNextToken();
-        return std::make_unique<Nodes::RelOp>(LESS_EQUAL, currToken.getPosition());
+        return std::make_unique<Nodes::RelOp>(LESS_EQUAL, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::GREATER){
         getNextToken();
-        return std::make_unique<Nodes::RelOp>(GREATER, currToken.getPosition());
+        return std::make_unique<Nodes::RelOp>(GREATER, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::GREATER_EQUAL){
         getNextToken();
-        return std::make_unique<Nodes::RelOp>(GREATER_EQUAL, currToken.getPosition());
+        return std::make_unique<Nodes::RelOp>(GREATER_EQUAL, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::EQUAL){
         getNextToken();
-        return std::make_unique<Nodes::RelOp>(EQUAL, currToken.getPosition());
+        return std::make_unique<Nodes::RelOp>(EQUAL, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::NOT_EQUAL){
         getNextToken();
-        return std::make_unique<Nodes::RelOp>(NOT_EQUAL, currToken.getPosition());
+        return std::make_unique<Nodes::RelOp>(NOT_EQUAL, currToken.getLocation());
     }
     return nullptr;
 }
@@ -178,11 +218,11 @@ std::unique_ptr<Nodes::RelOp> Parser::parseRelOp() {
 std::unique_ptr<Nodes::ArtmOp> Parser::parseArtmOp() {
     if (currToken.getType() == TokenTypes::PLUS) {
         getNextToken();
-        return std::make_unique<Nodes::ArtmOp>(PLUS, currToken.getPosition());
+        return std::make_unique<Nodes::ArtmOp>(PLUS, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::MINUS) {
         getNextToken();
-        return std::make_unique<Nodes::ArtmOp>(MINUS, currToken.getPosition());
+        return std::make_unique<Nodes::ArtmOp>(MINUS, currToken.getLocation());
     }
     return nullptr;
 }
@@ -190,11 +230,11 @@ std::unique_ptr<Nodes::ArtmOp> Parser::parseArtmOp() {
 std::unique_ptr<Nodes::FactorOp> Parser::parseFactorOp() {
     if (currToken.getType() == TokenTypes::MULTIPLY) {
         getNextToken();
-        return std::make_unique<Nodes::FactorOp>(MULTIPLY, currToken.getPosition());
+        return std::make_unique<Nodes::FactorOp>(MULTIPLY, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::DIVIDE) {
         getNextToken();
-        return std::make_unique<Nodes::FactorOp>(DIVIDE, currToken.getPosition());
+        return std::make_unique<Nodes::FactorOp>(DIVIDE, currToken.getLocation());
     }
     return nullptr;
 }
@@ -202,11 +242,11 @@ std::unique_ptr<Nodes::FactorOp> Parser::parseFactorOp() {
 std::unique_ptr<Nodes::UnaryOp> Parser::parseUnaryOp() {
     if (currToken.getType() == TokenTypes::NEGATE) {
         getNextToken();
-        return std::make_unique<Nodes::UnaryOp>(NEGATE, currToken.getPosition());
+        return std::make_unique<Nodes::UnaryOp>(NEGATE, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::MINUS) {
         getNextToken();
-        return std::make_unique<Nodes::UnaryOp>(NEGATIVE, currToken.getPosition());
+        return std::make_unique<Nodes::UnaryOp>(NEGATIVE, currToken.getLocation());
     }
     return nullptr;
 }
@@ -214,19 +254,19 @@ std::unique_ptr<Nodes::UnaryOp> Parser::parseUnaryOp() {
 std::unique_ptr<Nodes::CastOp> Parser::parseCastOp(){
     if (currToken.getType() == TokenTypes::INT_KW){
         getNextToken();
-        return std::make_unique<Nodes::CastOp>(INT, currToken.getPosition());
+        return std::make_unique<Nodes::CastOp>(INT, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::FLOAT_KW){
         getNextToken();
-        return std::make_unique<Nodes::CastOp>(FLOAT, currToken.getPosition());
+        return std::make_unique<Nodes::CastOp>(FLOAT, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::STR_KW){
         getNextToken();
-        return std::make_unique<Nodes::CastOp>(STR, currToken.getPosition());
+        return std::make_unique<Nodes::CastOp>(STR, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::BOOL_KW){
         getNextToken();
-        return std::make_unique<Nodes::CastOp>(BOOLEAN, currToken.getPosition());
+        return std::make_unique<Nodes::CastOp>(BOOLEAN, currToken.getLocation());
     }
     return nullptr;
 }
@@ -239,37 +279,64 @@ std::unique_ptr<Nodes::CastOp> Parser::parseCastOp(){
 std::unique_ptr<Nodes::Factor> Parser::parseFunctionCallOrVarRef() {
     if (currToken.getType() != TokenTypes::IDENTIFIER)
         return nullptr;
-    std::string identifier = std::get<std::string>(currToken.getValue());
-    Position pos = currToken.getPosition();
+    std::string identifier = tokenValue<std::string>();
+    SourceLocation pos = currToken.getLocation();
     getNextToken();
+    if (currToken.getType() == TokenTypes::DOT) {
+        getNextToken();
+        if (currToken.getType() != TokenTypes::IDENTIFIER)
+            throw MyException("Expected field name after '.'", currToken.getLocation());
+        std::string field = tokenValue<std::string>();
+        getNextToken();
+        if (currToken.getType() == TokenTypes::PAREN_LEFT) {
+            if (field != "holding")
+                throw MyException("Unknown method '" + field + "'", currToken.getLocation());
+            getNextToken();
+            consumeToken(TokenTypes::PAREN_RIGHT, "Expected ')' after 'holding('");
+            // e.holding() == int - porównanie znacznika zamiast nazwy typu
+            if ((matchToken(TokenTypes::EQUAL) || matchToken(TokenTypes::NOT_EQUAL)) && isSimpleVarType(peekToken().getType())) {
+                bool negated = matchToken(TokenTypes::NOT_EQUAL);
+                getNextToken();
+                auto heldType = getIdTypeOfToken(currToken.getType());
+                getNextToken();
+                return std::make_unique<Nodes::VariantHolding>(identifier, heldType, negated, pos);
+            }
+            return std::make_unique<Nodes::VariantHolding>(identifier, pos);
+        }
+        return std::make_unique<Nodes::StructFieldReference>(identifier, field, pos);
+    }
     if (currToken.getType() != TokenTypes::PAREN_LEFT)
         return std::make_unique<Nodes::VarReference>(identifier, pos);
     getNextToken();
     auto arguments = parseArguments();
     if (currToken.getType() != TokenTypes::PAREN_RIGHT)
-        throw MyException("Expected ')' after function call", currToken.getPosition());
+        throw MyException("Expected ')' after function call", currToken.getLocation());
     getNextToken();
-    return std::make_unique<Nodes::FunCall>(identifier, std::move(arguments), currToken.getPosition());
+    return std::make_unique<Nodes::FunCall>(identifier, std::move(arguments), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::CastingExpr> Parser::parseCastingExpression() {
     auto expr = parseFactor();
     if (!expr)
         return nullptr;
+    return finishCastingExpression(std::move(expr));
+}
+
+std::unique_ptr<Nodes::CastingExpr> Parser::finishCastingExpression(std::unique_ptr<Nodes::Factor> expr) {
     if (currToken.getType() == TokenTypes::AS_KW) {
         getNextToken();
         if (currToken.getType() != TokenTypes::BRACKET_LEFT)
-            throw MyException("Expected '(' after 'as'", currToken.getPosition());
+            throw MyException("Expected '(' after 'as'", currToken.getLocation());
         getNextToken();
         auto castOp = parseCastOp();
         if (castOp == nullptr)
-            throw MyException("Invalid type in casting expression", currToken.getPosition());
+            throw MyException("Invalid type in casting expression", currToken.getLocation());
         if (currToken.getType() != TokenTypes::BRACKET_RIGHT)
-            throw MyException("Expected ']' after type in casting expression", currToken.getPosition());
+            throw MyException("Expected ']' after type in casting expression", currToken.getLocation());
         getNextToken();
-        return std::make_unique<Nodes::CastingExpr>(std::move(expr), std::move(castOp), currToken.getPosition());
+        return std::make_unique<Nodes::CastingExpr>(std::move(expr), std::move(castOp), currToken.getLocation());
     }
-    return std::make_unique<Nodes::CastingExpr>(std::move(expr),  currToken.getPosition());
+    return std::make_unique<Nodes::CastingExpr>(std::move(expr),  currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::UnaryExpr> Parser::parseUnaryExpression() {
@@ -277,97 +344,256 @@ std::unique_ptr<Nodes::UnaryExpr> Parser::parseUnaryExpression() {
         auto op = parseUnaryOp();
         auto expr = parseCastingExpression();
         if (!expr)
-            throw MyException("Expected expression after unary operator", currToken.getPosition());
-        return std::make_unique<Nodes::UnaryExpr>(std::move(op), std::move(expr), currToken.getPosition());
+            throw MyException("Expected expression after unary operator", currToken.getLocation());
+        return finishUnaryExpression(std::move(op), std::move(expr));
     }
     auto expr = parseCastingExpression();
     if (!expr)
         return nullptr;
-    return std::make_unique<Nodes::UnaryExpr>( std::move(expr), currToken.getPosition());
+    return finishUnaryExpression(nullptr, std::move(expr));
+}
+
+std::unique_ptr<Nodes::UnaryExpr> Parser::finishUnaryExpression(std::unique_ptr<Nodes::UnaryOp> op, std::unique_ptr<Nodes::CastingExpr> expr) {
+    if (op)
+        return std::make_unique<Nodes::UnaryExpr>(std::move(op), std::move(expr), currToken.getLocation());
+    return std::make_unique<Nodes::UnaryExpr>(std::move(expr), currToken.getLocation());
+}
+
+namespace {
+    using ExprLevel = Parser::ExprLevel;
+
+    // tablica priorytetów: poziom operatora dwuargumentowego albo brak
+    std::optional<ExprLevel> binaryLevel(TokenTypes type) {
+        switch (type) {
+            case TokenTypes::MULTIPLY:
+            case TokenTypes::DIVIDE:
+                return ExprLevel::MUL;
+            case TokenTypes::PLUS:
+            case TokenTypes::MINUS:
+                return ExprLevel::ARTM;
+            case TokenTypes::LESS:
+            case TokenTypes::LESS_EQUAL:
+            case TokenTypes::GREATER:
+            case TokenTypes::GREATER_EQUAL:
+            case TokenTypes::EQUAL:
+            case TokenTypes::NOT_EQUAL:
+                return ExprLevel::REL;
+            case TokenTypes::AND:
+                return ExprLevel::AND;
+            case TokenTypes::OR:
+                return ExprLevel::OR;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    // and/or są łączne - prawostronne wiązanie zachowuje dotychczasowy kształt drzewa i kolejność obliczania
+    bool rightAssociative(ExprLevel level) {
+        return level == ExprLevel::AND || level == ExprLevel::OR;
+    }
+
+    bool startsOperand(TokenTypes type) {
+        return type == TokenTypes::INT_VALUE || type == TokenTypes::FLOAT_VALUE || type == TokenTypes::STR_VALUE ||
+               type == TokenTypes::TRUE_KW || type == TokenTypes::FALSE_KW || type == TokenTypes::IDENTIFIER ||
+               type == TokenTypes::PAREN_LEFT || type == TokenTypes::NEGATE;
+    }
+
+    template<typename T, typename Base>
+    std::unique_ptr<T> downcast(std::unique_ptr<Base> node) {
+        return std::unique_ptr<T>(static_cast<T*>(node.release()));
+    }
+
+    struct Operand
+    {
+        std::unique_ptr<Nodes::Factor> node;
+        ExprLevel level;
+    };
+
+    struct Operator
+    {
+        ExprLevel level;
+        // nullptr dla and/or
+        std::unique_ptr<Node> op;
+    };
+
+    // węzeł poziomu 'target': niższe poziomy opakowywane w kolejne węzły jednoargumentowe, wyższy (lewy
+    // operand łańcucha lewostronnego) - tak jak wyrażenie w nawiasach
+    std::unique_ptr<Nodes::Factor> lift(Operand operand, ExprLevel target, SourceLocation pos) {
+        auto node = std::move(operand.node);
+        auto level = operand.level;
+        if (level > target) {
+            node = std::make_unique<Nodes::UnaryExpr>(std::make_unique<Nodes::CastingExpr>(std::move(node), pos), pos);
+            level = ExprLevel::UNARY;
+        }
+        while (level < target) {
+            switch (level) {
+                case ExprLevel::UNARY:
+                    node = std::make_unique<Nodes::MulExpr>(downcast<Nodes::UnaryExpr>(std::move(node)), pos);
+                    level = ExprLevel::MUL;
+                    break;
+                case ExprLevel::MUL:
+                    node = std::make_unique<Nodes::ArtmExpr>(downcast<Nodes::MulExpr>(std::move(node)), pos);
+                    level = ExprLevel::ARTM;
+                    break;
+                case ExprLevel::ARTM:
+                    node = std::make_unique<Nodes::RelExpr>(downcast<Nodes::ArtmExpr>(std::move(node)), pos);
+                    level = ExprLevel::REL;
+                    break;
+                case ExprLevel::REL:
+                    node = std::make_unique<Nodes::AndExpr>(downcast<Nodes::RelExpr>(std::move(node)), pos);
+                    level = ExprLevel::AND;
+                    break;
+                case ExprLevel::AND:
+                case ExprLevel::OR:
+                    node = std::make_unique<Nodes::OrExpr>(downcast<Nodes::AndExpr>(std::move(node)), pos);
+                    level = ExprLevel::OR;
+                    break;
+            }
+        }
+        return node;
+    }
+
+    Operand combine(Operand left, Operator op, Operand right, SourceLocation pos) {
+        switch (op.level) {
+            case ExprLevel::MUL:
+                return {std::make_unique<Nodes::MulExpr>(downcast<Nodes::UnaryExpr>(lift(std::move(left), ExprLevel::UNARY, pos)),
+                                                         downcast<Nodes::FactorOp>(std::move(op.op)),
+                                                         downcast<Nodes::MulExpr>(lift(std::move(right), ExprLevel::MUL, pos)), pos),
+                        ExprLevel::MUL};
+            case ExprLevel::ARTM:
+                return {std::make_unique<Nodes::ArtmExpr>(downcast<Nodes::MulExpr>(lift(std::move(left), ExprLevel::MUL, pos)),
+                                                          downcast<Nodes::ArtmOp>(std::move(op.op)),
+                                                          downcast<Nodes::ArtmExpr>(lift(std::move(right), ExprLevel::ARTM, pos)), pos),
+                        ExprLevel::ARTM};
+            case ExprLevel::REL:
+                return {std::make_unique<Nodes::RelExpr>(downcast<Nodes::ArtmExpr>(lift(std::move(left), ExprLevel::ARTM, pos)),
+                                                         downcast<Nodes::RelOp>(std::move(op.op)),
+                                                         downcast<Nodes::RelExpr>(lift(std::move(right), ExprLevel::REL, pos)), pos),
+                        ExprLevel::REL};
+            case ExprLevel::AND:
+                return {std::make_unique<Nodes::AndExpr>(downcast<Nodes::RelExpr>(lift(std::move(left), ExprLevel::REL, pos)),
+                                                         downcast<Nodes::AndExpr>(lift(std::move(right), ExprLevel::AND, pos)), pos),
+                        ExprLevel::AND};
+            default:
+                return {std::make_unique<Nodes::OrExpr>(downcast<Nodes::AndExpr>(lift(std::move(left), ExprLevel::AND, pos)),
+                                                        downcast<Nodes::OrExpr>(lift(std::move(right), ExprLevel::OR, pos)), pos),
+                        ExprLevel::OR};
+        }
+    }
+}
+
+// Operandy i operatory na jawnych stosach - długie łańcuchy nie zagłębiają rekurencji C++, a każdy
+// operand to jedno wywołanie parseFactor zamiast zejścia przez wszystkie poziomy.
+// Operatory lewostronne (a - b - c == (a - b) - c) redukowane są, gdy przyjdzie operator tego samego
+// albo słabszego poziomu. Nawias otwiera nową ramkę poziomu OR zamiast wywołania parseFactor ->
+// parseOrExpression, więc głęboko zagnieżdżone nawiasy też nie rosną na stosie wywołań.
+std::unique_ptr<Nodes::Factor> Parser::parseBinaryExpression(ExprLevel level) {
+    struct Frame
+    {
+        ExprLevel level;
+        std::vector<Operand> operands;
+        std::vector<Operator> operators;
+        // operator jednoargumentowy stojący przed nawiasem
+        std::unique_ptr<Nodes::UnaryOp> unaryOp;
+    };
+    std::vector<Frame> frames;
+    frames.push_back({level, {}, {}, nullptr});
+
+    auto reduce = [&](Frame& frame) {
+        auto right = std::move(frame.operands.back());
+        frame.operands.pop_back();
+        auto left = std::move(frame.operands.back());
+        frame.operands.pop_back();
+        frame.operands.push_back(combine(std::move(left), std::move(frame.operators.back()), std::move(right), currToken.getLocation()));
+        frame.operators.pop_back();
+    };
+
+    while (true) {
+        std::unique_ptr<Nodes::UnaryOp> unaryOp;
+        if (matchToken(TokenTypes::NEGATE) || matchToken(TokenTypes::MINUS))
+            unaryOp = parseUnaryOp();
+        if (matchToken(TokenTypes::PAREN_LEFT)) {
+            getNextToken();
+            frames.push_back({ExprLevel::OR, {}, {}, std::move(unaryOp)});
+            continue;
+        }
+        auto factor = parseFactor();
+        if (!factor) {
+            if (unaryOp)
+                throw MyException("Expected expression after unary operator", currToken.getLocation());
+            if (!frames.back().operators.empty())
+                throw MyException("Missing right factor (consider using parentheses)", currToken.getLocation());
+            if (frames.size() > 1)
+                throw MyException("Invalid expression in parentheses", currToken.getLocation());
+            return nullptr;
+        }
+        Operand operand{finishUnaryExpression(std::move(unaryOp), finishCastingExpression(std::move(factor))), ExprLevel::UNARY};
+
+        // operand trafia do bieżącej ramki; jeśli nie stoi za nim operator jej poziomu, ramka się
+        // zamyka, a jej wynik (po ')') staje się operandem ramki niżej
+        while (true) {
+            auto& frame = frames.back();
+            frame.operands.push_back(std::move(operand));
+            auto opLevel = binaryLevel(currToken.getType());
+            if (opLevel && opLevel.value() <= frame.level) {
+                while (!frame.operators.empty() && (frame.operators.back().level < opLevel.value() ||
+                                                    (frame.operators.back().level == opLevel.value() && !rightAssociative(opLevel.value()))))
+                    reduce(frame);
+
+                std::unique_ptr<Node> op;
+                if (opLevel == ExprLevel::MUL)
+                    op = parseFactorOp();
+                else if (opLevel == ExprLevel::ARTM)
+                    op = parseArtmOp();
+                else if (opLevel == ExprLevel::REL)
+                    op = parseRelOp();
+                else
+                    getNextToken();
+                frame.operators.push_back({opLevel.value(), std::move(op)});
+                break;
+            }
+            // np. "a -1": lekser czyta "-1" jako literał
+            if (frame.level >= ExprLevel::ARTM && startsOperand(currToken.getType()))
+                throw MyException("Missing operator between factors", currToken.getLocation());
+
+            while (!frame.operators.empty())
+                reduce(frame);
+            auto node = lift(std::move(frame.operands.back()), frame.level, currToken.getLocation());
+            if (frames.size() == 1)
+                return node;
+            consumeToken(TokenTypes::PAREN_RIGHT, "Expected ')' after expression in parentheses");
+            auto frameOp = std::move(frame.unaryOp);
+            frames.pop_back();
+            operand = {finishUnaryExpression(std::move(frameOp), finishCastingExpression(std::move(node))), ExprLevel::UNARY};
+        }
+    }
 }
 
 std::unique_ptr<Nodes::MulExpr> Parser::parseMulExpression() {
-    auto leftExpr = parseUnaryExpression();
-    if (!leftExpr)
-        return nullptr;
-    auto op = parseFactorOp();
-    if(!op)
-        return std::make_unique<Nodes::MulExpr>(std::move(leftExpr), currToken.getPosition());
-    auto rightExpr = parseMulExpression();
-    if (rightExpr && !op) // possibly smth - smth
-        throw MyException("Missing operator between factors", currToken.getPosition());
-    if (!rightExpr && op)
-        throw MyException("Missing right factor (consider using parentheses)", currToken.getPosition());
-    if (!rightExpr && !op)
-        return std::make_unique<Nodes::MulExpr>(std::move(leftExpr), currToken.getPosition());
-    return std::make_unique<Nodes::MulExpr>(std::move(leftExpr), std::move(op), std::move(rightExpr), currToken.getPosition());
+    return downcast<Nodes::MulExpr>(parseBinaryExpression(ExprLevel::MUL));
 }
 
 std::unique_ptr<Nodes::ArtmExpr> Parser::parseArtmExpression() {
-    auto leftExpr = parseMulExpression();
-    if (!leftExpr)
-        return nullptr;
-    auto op = parseArtmOp();
-    auto rightExpr = parseArtmExpression();
-    if (rightExpr && !op)
-        throw MyException("Missing operator between factors", currToken.getPosition());
-    if (!rightExpr && op)
-        throw MyException("Missing right factor (consider using parentheses)", currToken.getPosition());
-    if (!rightExpr && !op)
-        return std::make_unique<Nodes::ArtmExpr>(std::move(leftExpr), currToken.getPosition());
-    return std::make_unique<Nodes::ArtmExpr>(std::move(leftExpr), std::move(op), std::move(rightExpr), currToken.getPosition());
+    return downcast<Nodes::ArtmExpr>(parseBinaryExpression(ExprLevel::ARTM));
 }
 
 std::unique_ptr<Nodes::RelExpr> Parser::parseRelExpression() {
-    auto leftExpr = parseArtmExpression();
-    if (!leftExpr)
-        return nullptr;
-    auto op = parseRelOp();
-    auto rightExpr = parseRelExpression();
-    if (rightExpr && !op)
-        throw MyException("Missing operator between factors", currToken.getPosition());
-    if (!rightExpr && op)
-        throw MyException("Missing right factor (consider using parentheses)", currToken.getPosition());
-    if (!rightExpr && !op)
-        return std::make_unique<Nodes::RelExpr>(std::move(leftExpr), currToken.getPosition());
-    return std::make_unique<Nodes::RelExpr>(std::move(leftExpr), std::move(op), std::move(rightExpr), currToken.getPosition());
+    return downcast<Nodes::RelExpr>(parseBinaryExpression(ExprLevel::REL));
 }
 
 std::unique_ptr<Nodes::AndExpr> Parser::parseAndExpression() {
-    auto leftExpr = parseRelExpression();
-    if (!leftExpr)
-        return nullptr;
-    if (currToken.getType() == TokenTypes::AND) {
-        getNextToken(); // Consume the AND token
-        auto rightExpr = parseAndExpression(); // Recursive call
-        if (!rightExpr) {
-            throw MyException("Missing right factor (consider using parentheses)", currToken.getPosition());
-        }
-        return std::make_unique<Nodes::AndExpr>(std::move(leftExpr), std::move(rightExpr), currToken.getPosition());
-    }
-    return std::make_unique<Nodes::AndExpr>(std::move(leftExpr),  currToken.getPosition());
+    return downcast<Nodes::AndExpr>(parseBinaryExpression(ExprLevel::AND));
 }
 
 std::unique_ptr<Nodes::OrExpr> Parser::parseOrExpression() {
-    auto leftExpr = parseAndExpression();
-    if (!leftExpr)
-        return nullptr;
-    if (currToken.getType() == TokenTypes::OR) {
-        getNextToken(); // Consume the OR token
-        auto rightExpr = parseOrExpression(); // Recursive call
-        if (!rightExpr) {
-            throw MyException("Missing right factor (consider using parentheses)", currToken.getPosition());
-        }
-        return std::make_unique<Nodes::OrExpr>(std::move(leftExpr), std::move(rightExpr), currToken.getPosition());
-    }
-    return std::make_unique<Nodes::OrExpr>(std::move(leftExpr), currToken.getPosition());
+    return downcast<Nodes::OrExpr>(parseBinaryExpression(ExprLevel::OR));
 }
 
 std::unique_ptr<Nodes::Expression> Parser::parseExpression() {
     auto expr = parseOrExpression();
     if (expr == nullptr)
         return nullptr;
-    return std::make_unique<Nodes::Expression>(std::move(expr), currToken.getPosition());
+    return std::make_unique<Nodes::Expression>(std::move(expr), currToken.getLocation());
 }
 
 // (expr) or 123 or 1.25 or "string" or True or False or fun(1, 2, 3)
@@ -376,7 +602,7 @@ std::unique_ptr<Nodes::Factor> Parser::parseFactor() {
         getNextToken();
         auto expr = parseOrExpression();
         if (!expr)
-            throw MyException("Invalid expression in parentheses", currToken.getPosition());
+            throw MyException("Invalid expression in parentheses", currToken.getLocation());
         consumeToken(TokenTypes::PAREN_RIGHT, "Expected ')' after expression in parentheses");
         return expr;
     }
@@ -405,26 +631,32 @@ std::unique_ptr<Nodes::FunctionDeclaration> Parser::parseFunctionDeclaration() {
     getNextToken();
     std::unique_ptr<Nodes::TypeDecl> funTypeDecl = parseTypeDeclaration();
     if (!funTypeDecl)
-        throw MyException("Invalid type declaration in function declaration", currToken.getPosition());
+        throw MyException("Invalid type declaration in function declaration", currToken.getLocation());
     consumeToken(TokenTypes::PAREN_LEFT, "Expected '(' after function name");
     std::vector<std::unique_ptr<Nodes::TypeDecl>> types;
 
     while(currToken.getType() != TokenTypes::PAREN_RIGHT){
         auto typeDecl = parseTypeDeclaration();
         if (!typeDecl)
-            throw MyException("Invalid type declaration in function declaration", currToken.getPosition());
+            throw MyException("Invalid type declaration in function declaration", currToken.getLocation());
         types.push_back(std::move(typeDecl));
         if (currToken.getType() != TokenTypes::PAREN_RIGHT) {
             consumeToken(TokenTypes::COMMA, "Expected ',' after type declaration in function declaration");
             if (currToken.getType() == TokenTypes::PAREN_RIGHT)
-                throw MyException("Expected type declaration after ',' in function declaration", currToken.getPosition());
+                throw MyException("Expected type declaration after ',' in function declaration", currToken.getLocation());
         }
     }
     getNextToken(); // skoro wyszliśmy z while
+    if (lazyBodies) {
+        auto body = skipBlock();
+        auto function = std::make_unique<Nodes::FunctionDeclaration>(std::move(funTypeDecl), std::move(types), nullptr, currToken.getLocation());
+        function->setLazyBody(std::move(body));
+        return function;
+    }
     std::unique_ptr<Nodes::Block> block = parseBlock();
     if (!block)
-        throw MyException("Invalid body of function declaration", currToken.getPosition());
-    return std::make_unique<Nodes::FunctionDeclaration>(std::move(funTypeDecl), std::move(types), std::move(block), currToken.getPosition());
+        throw MyException("Invalid body of function declaration", currToken.getLocation());
+    return std::make_unique<Nodes::FunctionDeclaration>(std::move(funTypeDecl), std::move(types), std::move(block), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::WhileStatement> Parser::parseWhileStatement() {
@@ -434,15 +666,15 @@ std::unique_ptr<Nodes::WhileStatement> Parser::parseWhileStatement() {
     getNextToken();
     auto expression = parseExpression();
     if (!expression)
-        throw MyException("Invalid expression in while statement", currToken.getPosition());
+        throw MyException("Invalid expression in while statement", currToken.getLocation());
 
 
     auto whileBlock = parseBlock();
     if (!whileBlock)
-        throw MyException("Invalid body of while statement", currToken.getPosition());
+        throw MyException("Invalid body of while statement", currToken.getLocation());
 
 
-    return std::make_unique<Nodes::WhileStatement>(std::move(expression), std::move(whileBlock), currToken.getPosition());
+    return std::make_unique<Nodes::WhileStatement>(std::move(expression), std::move(whileBlock), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::IfStatement> Parser::parseIfStatement() {
@@ -452,35 +684,109 @@ std::unique_ptr<Nodes::IfStatement> Parser::parseIfStatement() {
     getNextToken();
     auto expression = parseExpression();
     if (!expression)
-        throw MyException("Invalid expression in if statement", currToken.getPosition());
+        throw MyException("Invalid expression in if statement", currToken.getLocation());
 
     auto ifBlock = parseBlock();
     if (!ifBlock)
-        throw MyException("Invalid body of if statement", currToken.getPosition());
+        throw MyException("Invalid body of if statement", currToken.getLocation());
 
     std::unique_ptr<Nodes::Block> elseBlock = nullptr;
     if (currToken.getType() == TokenTypes::ELSE_KW){
         getNextToken();
         elseBlock = parseBlock();
         if (!elseBlock)
-            throw MyException("No body after else statement", currToken.getPosition());
+            throw MyException("No body after else statement", currToken.getLocation());
     }
     return std::make_unique<Nodes::IfStatement>(
             std::move(expression),
             std::move(ifBlock),
             std::move(elseBlock),
-            currToken.getPosition());
+            currToken.getLocation());
 }
 
+// Bloki if/while na jawnym stosie - tysiące poziomów zagnieżdżenia nie zagłębiają rekurencji C++.
+// Nagłówek if/while przechwytywany jest przed parseStatement, a ']' zamyka instrukcję właściciela bloku.
 std::unique_ptr<Nodes::Block> Parser::parseBlock() {
-    std::set<std::string> declaredIDs;
+    enum class Owner { NONE, IF, ELSE, WHILE };
+    struct OpenBlock
+    {
+        Owner owner;
+        std::unique_ptr<Nodes::Expression> condition;
+        // blok 'if' czekający na zamknięcie bloku 'else'
+        std::unique_ptr<Nodes::Block> ifBlock;
+        std::set<std::string> declaredIDs;
+        std::vector<std::unique_ptr<Nodes::Statement>> statements;
+    };
+    std::vector<OpenBlock> blocks;
     consumeToken(TokenTypes::BRACKET_LEFT, "Expected '[' at the beginning of block");
-    std::vector<std::unique_ptr<Nodes::Statement>> statements;
-    std::unique_ptr<Nodes::Statement> stmt;
-    while ( (stmt = parseStatement(declaredIDs)) )
-        statements.push_back(std::move(stmt));
-    consumeToken(TokenTypes::BRACKET_RIGHT, "Expected ']' at the end of block");
-    return std::make_unique<Nodes::Block>(std::move(statements), currToken.getPosition());
+    blocks.push_back({Owner::NONE, nullptr, nullptr, {}, {}});
+
+    while (true) {
+        if (matchToken(TokenTypes::IF_KW) || matchToken(TokenTypes::WHILE_KW)) {
+            Owner owner = matchToken(TokenTypes::IF_KW) ? Owner::IF : Owner::WHILE;
+            getNextToken();
+            auto condition = parseExpression();
+            if (!condition)
+                throw MyException(owner == Owner::IF ? "Invalid expression in if statement" : "Invalid expression in while statement",
+                                  currToken.getLocation());
+            consumeToken(TokenTypes::BRACKET_LEFT, "Expected '[' at the beginning of block");
+            blocks.push_back({owner, std::move(condition), nullptr, {}, {}});
+            continue;
+        }
+        if (auto stmt = parseStatement(blocks.back().declaredIDs)) {
+            blocks.back().statements.push_back(std::move(stmt));
+            continue;
+        }
+        consumeToken(TokenTypes::BRACKET_RIGHT, "Expected ']' at the end of block");
+        auto closed = std::move(blocks.back());
+        blocks.pop_back();
+        auto block = std::make_unique<Nodes::Block>(std::move(closed.statements), currToken.getLocation());
+        if (closed.owner == Owner::NONE)
+            return block;
+
+        if (closed.owner == Owner::IF && matchToken(TokenTypes::ELSE_KW)) {
+            getNextToken();
+            consumeToken(TokenTypes::BRACKET_LEFT, "Expected '[' at the beginning of block");
+            blocks.push_back({Owner::ELSE, std::move(closed.condition), std::move(block), {}, {}});
+            continue;
+        }
+        std::unique_ptr<Nodes::Statement> statement;
+        if (closed.owner == Owner::WHILE)
+            statement = std::make_unique<Nodes::WhileStatement>(std::move(closed.condition), std::move(block), currToken.getLocation());
+        else if (closed.owner == Owner::ELSE)
+            statement = std::make_unique<Nodes::IfStatement>(std::move(closed.condition), std::move(closed.ifBlock), std::move(block),
+                                                             currToken.getLocation());
+        else
+            statement = std::make_unique<Nodes::IfStatement>(std::move(closed.condition), std::move(block), nullptr, currToken.getLocation());
+        blocks.back().statements.push_back(std::move(statement));
+    }
+}
+
+// zapisuje tokeny bloku od '[' do pasującego ']' bez budowania drzewa
+std::vector<Token> Parser::skipBlock() {
+    if (!matchToken(TokenTypes::BRACKET_LEFT))
+        throw MyException("Expected '[' at the beginning of block", currToken.getLocation());
+    std::vector<Token> tokens;
+    std::size_t depth = 0;
+    do {
+        if (matchToken(TokenTypes::EOF_TOKEN))
+            throw MyException("Expected ']' at the end of block", currToken.getLocation());
+        if (matchToken(TokenTypes::BRACKET_LEFT))
+            depth++;
+        else if (matchToken(TokenTypes::BRACKET_RIGHT))
+            depth--;
+        tokens.push_back(currToken);
+        getNextToken();
+    } while (depth > 0);
+    return tokens;
+}
+
+std::unique_ptr<Nodes::Block> Parser::parseLazyBody(const std::vector<Token> &tokens) {
+    Parser parser(tokens);
+    auto block = parser.parseBlock();
+    if (!parser.matchToken(TokenTypes::EOF_TOKEN))
+        throw MyException("Unexpected token after function body", parser.currToken.getLocation());
+    return block;
 }
 
 std::unique_ptr<Nodes::ReturnStatement> Parser::parseReturnStatement() {
@@ -491,13 +797,13 @@ std::unique_ptr<Nodes::ReturnStatement> Parser::parseReturnStatement() {
     getNextToken();
     if (currToken.getType() == TokenTypes::SEMICOLON){
         getNextToken();
-        return std::make_unique<Nodes::ReturnStatement>(nullptr, currToken.getPosition());
+        return std::make_unique<Nodes::ReturnStatement>(nullptr, currToken.getLocation());
     }
     auto expression = parseExpression();
     if (expression == nullptr)
-        throw MyException("Invalid return statement", currToken.getPosition());
+        throw MyException("Invalid return statement", currToken.getLocation());
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after expression in return statement");
-    return std::make_unique<Nodes::ReturnStatement>(std::move(expression), currToken.getPosition());
+    return std::make_unique<Nodes::ReturnStatement>(std::move(expression), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::FunctionCallStatement> Parser::parseFunctionCallStatement(std::string identifier){
@@ -505,39 +811,39 @@ std::unique_ptr<Nodes::FunctionCallStatement> Parser::parseFunctionCallStatement
     auto args = parseArguments();
     consumeToken(TokenTypes::PAREN_RIGHT, "Expected ')' after function call");
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after function call");
-    return std::make_unique<Nodes::FunctionCallStatement>(std::move(identifier), std::move(args), currToken.getPosition());
+    return std::make_unique<Nodes::FunctionCallStatement>(std::move(identifier), std::move(args), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::Assignment> Parser::parseAssignment(std::string identifier){
     consumeToken(TokenTypes::ASSIGN,"no assign after id token");
     std::unique_ptr<Nodes::Expression> expr = parseExpression();
     if (!expr)
-        throw MyException("Invalid expression in assignment", currToken.getPosition());
+        throw MyException("Invalid expression in assignment", currToken.getLocation());
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after expression in assignment");
-    return std::make_unique<Nodes::Assignment>(std::move(identifier), std::move(expr), currToken.getPosition());
+    return std::make_unique<Nodes::Assignment>(std::move(identifier), std::move(expr), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::StructFieldAssignment> Parser::parseStructFieldAssignment(std::string identifier) {
     getNextToken();
     if (currToken.getType() != TokenTypes::IDENTIFIER)
-        throw MyException("Expected identifier after '.'", currToken.getPosition());
-    std::string field = std::get<std::string>(currToken.getValue());
+        throw MyException("Expected identifier after '.'", currToken.getLocation());
+    std::string field = tokenValue<std::string>();
     getNextToken();
     if (currToken.getType() != TokenTypes::ASSIGN)
-        throw MyException("Expected '=' after field name", currToken.getPosition());
+        throw MyException("Expected '=' after field name", currToken.getLocation());
     getNextToken();
     std::unique_ptr<Nodes::Expression> expr = parseExpression();
     if (!expr)
-        throw MyException("Invalid expression in assignment", currToken.getPosition());
+        throw MyException("Invalid expression in assignment", currToken.getLocation());
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after expression in assignment");
-    return std::make_unique<Nodes::StructFieldAssignment>(std::move(identifier), std::move(field), std::move(expr), currToken.getPosition());
+    return std::make_unique<Nodes::StructFieldAssignment>(std::move(identifier), std::move(field), std::move(expr), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::Statement> Parser::parseAssignmentOrCallOrVar(std::set<std::string>& declaredIds) {
     if (currToken.getType() != TokenTypes::IDENTIFIER)
         return nullptr;
-    std::string identifier = std::get<std::string>(currToken.getValue());
-    Position typePos = currToken.getPosition();
+    std::string identifier = tokenValue<std::string>();
+    SourceLocation typePos = currToken.getLocation();
     getNextToken();
 
     // Base cases
@@ -558,11 +864,11 @@ std::unique_ptr<Nodes::Statement> Parser::parseAssignmentOrCallOrVar(std::set<st
         std::string type = identifier;
         consumeToken(TokenTypes::DOUBLE_COLON, "Expected '::' after type name");
         if (currToken.getType() != TokenTypes::IDENTIFIER)
-            throw MyException("Expected identifier after '::'", currToken.getPosition());
-        std::string id = std::get<std::string>(currToken.getValue());
-        Position idPos = currToken.getPosition();
+            throw MyException("Expected identifier after '::'", currToken.getLocation());
+        std::string id = tokenValue<std::string>();
+        SourceLocation idPos = currToken.getLocation();
         if (!declaredIds.insert(id).second)
-            throw MyException("redefiniton found in local variable definition", currToken.getPosition());
+            throw MyException("redefiniton found in local variable definition", currToken.getLocation());
 
         // mamy typ (variant albo struct) i id
         getNextToken();
@@ -571,21 +877,21 @@ std::unique_ptr<Nodes::Statement> Parser::parseAssignmentOrCallOrVar(std::set<st
         if (currToken.getType() == TokenTypes::PAREN_LEFT) { // to znaczy że zmienna struktury
             auto structVar = parseStructVarDeclaration(isMutable, std::move(typeDeclNode));
             if (!structVar)
-                throw MyException("Invalid struct variable declaration", currToken.getPosition());
+                throw MyException("Invalid struct variable declaration", currToken.getLocation());
             return std::move(structVar);
         }
         if (currToken.getType() == TokenTypes::ASSIGN) { // to znaczy że zmienna typu variant
             auto variantVar = parseVariantVarDeclaration(std::move(typeDeclNode));
             if (!variantVar)
-                throw MyException("Invalid variant variable declaration", currToken.getPosition());
+                throw MyException("Invalid variant variable declaration", currToken.getLocation());
             return std::move(variantVar);
         } // to znaczy że pusta zmienna variant
         else{
             consumeToken(TokenTypes::SEMICOLON, "Expected ';' after variant variable declaration");
-            return std::make_unique<Nodes::VariantVarDeclaration>(std::move(typeDeclNode), nullptr, currToken.getPosition());
+            return std::make_unique<Nodes::VariantVarDeclaration>(std::move(typeDeclNode), nullptr, currToken.getLocation());
         }
     }
-    throw MyException("This should not be reached!", currToken.getPosition());
+    throw MyException("This should not be reached!", currToken.getLocation());
 }
 
 
@@ -630,7 +936,7 @@ std::vector<std::unique_ptr<Nodes::Expression>> Parser::parseArguments() {
         if (arg)
             args.push_back(std::move(arg));
         else
-            throw MyException("Invalid expression in argument list", currToken.getPosition());
+            throw MyException("Invalid expression in argument list", currToken.getLocation());
     }
     return std::move(args);
 }
@@ -645,31 +951,31 @@ std::unique_ptr<Nodes::VariantTypeDefinition> Parser::parseVariantTypeDefinition
     getNextToken();
     consumeToken(TokenTypes::DOUBLE_COLON, "Expected '::' after 'variant' keyword");
     if (currToken.getType() != TokenTypes::IDENTIFIER)
-        throw MyException("Expected identifier after 'variant' keyword", currToken.getPosition());
-    std::string identifier = std::get<std::string>(currToken.getValue());
+        throw MyException("Expected identifier after 'variant' keyword", currToken.getLocation());
+    std::string identifier = tokenValue<std::string>();
     getNextToken();
     consumeToken(TokenTypes::PAREN_LEFT, "Expected '(' after identifier in variant type definition");
     std::vector<std::unique_ptr<Nodes::Type>> types;
     while(currToken.getType() != TokenTypes::PAREN_RIGHT){
         auto type = parseType();
         if (!type)
-            throw MyException("Invalid type in variant type definition", currToken.getPosition());
+            throw MyException("Invalid type in variant type definition", currToken.getLocation());
         types.push_back(std::move(type));
         consumeToken(TokenTypes::SEMICOLON, "Expected ';' after type in variant type definition");
     }
     getNextToken(); // skoro wyszliśmy z while
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after variant type definition");
     variantTypeNames.push_back(identifier); // trzeba będzie zmienić na symbolTable;
-    return std::make_unique<Nodes::VariantTypeDefinition>(identifier, std::move(types), currToken.getPosition());
+    return std::make_unique<Nodes::VariantTypeDefinition>(identifier, std::move(types), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::VariantVarDeclaration> Parser::parseVariantVarDeclaration(std::unique_ptr<Nodes::TypeDecl> typeDecl) {
     consumeToken(TokenTypes::ASSIGN, "Expected '=' after variant variable name");
     std::unique_ptr<Nodes::Expression> expr = parseExpression();
     if (!expr)
-        throw MyException("Invalid expression in variant variable declaration", currToken.getPosition());
+        throw MyException("Invalid expression in variant variable declaration", currToken.getLocation());
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after expression in variant variable declaration");
-    return std::make_unique<Nodes::VariantVarDeclaration>(std::move(typeDecl), std::move(expr), currToken.getPosition());
+    return std::make_unique<Nodes::VariantVarDeclaration>(std::move(typeDecl), std::move(expr), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::StructVarDeclaration> Parser::parseStructVarDeclaration(bool isMutable, std::unique_ptr<Nodes::TypeDecl> typeDecl) {
@@ -678,14 +984,14 @@ std::unique_ptr<Nodes::StructVarDeclaration> Parser::parseStructVarDeclaration(b
     while(currToken.getType() != TokenTypes::PAREN_RIGHT){
         auto arg = parseExpression();
         if (!arg)
-            throw MyException("Invalid expression in struct variable declaration", currToken.getPosition());
+            throw MyException("Invalid expression in struct variable declaration", currToken.getLocation());
         args.push_back(std::move(arg));
         if (currToken.getType() != TokenTypes::PAREN_RIGHT)
             consumeToken(TokenTypes::COMMA, "Expected ',' after expression in struct variable declaration");
     }
     getNextToken(); // skoro wyszliśmy z while
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after struct variable declaration");
-    return std::make_unique<Nodes::StructVarDeclaration>(isMutable, std::move(typeDecl), std::move(args), currToken.getPosition());
+    return std::make_unique<Nodes::StructVarDeclaration>(isMutable, std::move(typeDecl), std::move(args), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::StructTypeDefinition> Parser::parseStructTypeDefinition() {
@@ -694,26 +1000,26 @@ std::unique_ptr<Nodes::StructTypeDefinition> Parser::parseStructTypeDefinition()
     getNextToken();
     consumeToken(TokenTypes::DOUBLE_COLON, "Expected '::' after 'struct' keyword");
     if (currToken.getType() != TokenTypes::IDENTIFIER)
-        throw MyException("Expected identifier after 'struct' keyword", currToken.getPosition());
-    std::string identifier = std::get<std::string>(currToken.getValue());
+        throw MyException("Expected identifier after 'struct' keyword", currToken.getLocation());
+    std::string identifier = tokenValue<std::string>();
     getNextToken();
     consumeToken(TokenTypes::PAREN_LEFT, "Expected '(' after identifier in struct type definition");
     std::vector<std::unique_ptr<Nodes::TypeDecl>> types;
     while(currToken.getType() != TokenTypes::PAREN_RIGHT){
         auto typeDecl = parseTypeDeclaration();
         if (!typeDecl)
-            throw MyException("Invalid type declaration in struct type definition", currToken.getPosition());
+            throw MyException("Invalid type declaration in struct type definition", currToken.getLocation());
         types.push_back(std::move(typeDecl));
         consumeToken(TokenTypes::SEMICOLON, "Expected ';' after type declaration in struct type definition");
     }
     getNextToken(); // skoro wyszliśmy z while
     consumeToken(TokenTypes::SEMICOLON, "Expected ';' after struct type definition");
     structTypeNames.push_back(identifier);
-    return std::make_unique<Nodes::StructTypeDefinition>(identifier, std::move(types), currToken.getPosition());
+    return std::make_unique<Nodes::StructTypeDefinition>(identifier, std::move(types), currToken.getLocation());
 }
 
 std::unique_ptr<Nodes::VariableDeclaration> Parser::parseSimpleVariableDeclaration(bool isMut) {
-    Position varPos = currToken.getPosition();
+    SourceLocation varPos = currToken.getLocation();
     auto typeDecl = parseTypeDeclaration();
     if (!typeDecl)
         return nullptr;
@@ -722,19 +1028,19 @@ std::unique_ptr<Nodes::VariableDeclaration> Parser::parseSimpleVariableDeclarati
         return nullptr;
     if (currToken.getType() == TokenTypes::SEMICOLON){
         getNextToken();
-        return std::make_unique<Nodes::VariableDeclaration>(isMut, std::move(typeDecl), nullptr, currToken.getPosition());
+        return std::make_unique<Nodes::VariableDeclaration>(isMut, std::move(typeDecl), nullptr, currToken.getLocation());
     }
     if (currToken.getType() == TokenTypes::ASSIGN){
         getNextToken();
         initExpr = parseExpression();
         if (!initExpr)
-            throw MyException("Invalid expression in variable declaration", currToken.getPosition());
+            throw MyException("Invalid expression in variable declaration", currToken.getLocation());
         if (currToken.getType() != TokenTypes::SEMICOLON)
-            throw MyException("Expected ';' after expression in variable declaration", currToken.getPosition());
+            throw MyException("Expected ';' after expression in variable declaration", currToken.getLocation());
         getNextToken();
         return std::make_unique<Nodes::VariableDeclaration>(isMut, std::move(typeDecl), std::move(initExpr), varPos);
     }
-    throw MyException("Invalid variable declaration", currToken.getPosition());
+    throw MyException("Invalid variable declaration", currToken.getLocation());
 }
 
 // int, float, str, bool, struct, variant or user_type(identifier)
@@ -742,7 +1048,7 @@ std::unique_ptr<Nodes::Type> Parser::parseType() {
     std::string typeName;
     IdType type;
     if (currToken.getType() == TokenTypes::IDENTIFIER){
-        typeName = std::get<std::string>(currToken.getValue());
+        typeName = tokenValue<std::string>();
         getNextToken();
     } else if (isIdType(currToken.getType())){
         type = getIdTypeOfToken(currToken.getType());
@@ -750,14 +1056,14 @@ std::unique_ptr<Nodes::Type> Parser::parseType() {
     } else
         return nullptr;
     if (typeName.empty())
-        return std::make_unique<Nodes::Type>(type, currToken.getPosition());
+        return std::make_unique<Nodes::Type>(type, currToken.getLocation());
     else
-        return std::make_unique<Nodes::Type>(typeName, currToken.getPosition());
+        return std::make_unique<Nodes::Type>(typeName, currToken.getLocation());
 }
 
 // variant::ala, int::a, float::b, str::c
 std::unique_ptr<Nodes::TypeDecl> Parser::parseTypeDeclaration() {
-    Position typePos = currToken.getPosition();
+    SourceLocation typePos = currToken.getLocation();
     std::string identifier;
     std::unique_ptr<Nodes::Type> type = parseType();
     if (!type)
@@ -766,9 +1072,9 @@ std::unique_ptr<Nodes::TypeDecl> Parser::parseTypeDeclaration() {
         return nullptr;
     getNextToken();
     if (currToken.getType() != TokenTypes::IDENTIFIER)
-        throw MyException("Expected identifier after '::'", currToken.getPosition());
+        throw MyException("Expected identifier after '::'", currToken.getLocation());
 
-    identifier = std::get<std::string>(currToken.getValue());
+    identifier = tokenValue<std::string>();
     getNextToken();
     return std::make_unique<Nodes::TypeDecl>(std::move(type), identifier, typePos);
 }
@@ -783,48 +1089,48 @@ std::unique_ptr<Nodes::Declaration> Parser::parseLocalVarDeclaration(std::set<st
     // mut int::a; float::b; str::c; mut bool:g;
     if (isSimpleVarType(currToken.getType())) {
         auto varDecl = parseSimpleVariableDeclaration(isMutable);
-        std::string id = varDecl->getIdentifier();
         if (!varDecl)
-            throw MyException("Invalid variable declaration", currToken.getPosition());
+            throw MyException("Invalid variable declaration", currToken.getLocation());
+        std::string id = varDecl->getIdentifier();
         if(!declaredIds.insert(id).second)
-            throw MyException("redefiniton found in local variable definition", currToken.getPosition());
+            throw MyException("redefiniton found in local variable definition", currToken.getLocation());
         return std::move(varDecl);
     }
 
     // struct::pos(int::x);
     if (currToken.getType() == TokenTypes::STRUCT_KW){
         auto structTypeDef = parseStructTypeDefinition();
-        std::string id = structTypeDef->getStructName();
         if (!structTypeDef)
-            throw MyException("Invalid struct type definition", currToken.getPosition());
+            throw MyException("Invalid struct type definition", currToken.getLocation());
+        std::string id = structTypeDef->getStructName();
         if(!declaredIds.insert(id).second)
-            throw MyException("redefiniton found in local struct type definition", currToken.getPosition());
+            throw MyException("redefiniton found in local struct type definition", currToken.getLocation());
         return std::move(structTypeDef);
     }
 
     // variant::inp(int;str;);
     if (currToken.getType() == TokenTypes::VARIANT_KW){
         auto variantTypeDef = parseVariantTypeDefinition();
-        std::string id = variantTypeDef->getVariantName();
         if (!variantTypeDef)
-            throw MyException("Invalid variant type definition", currToken.getPosition());
+            throw MyException("Invalid variant type definition", currToken.getLocation());
+        std::string id = variantTypeDef->getVariantName();
         if(!declaredIds.insert(id).second)
-            throw MyException("redefiniton found in local variant type definition", currToken.getPosition());
+            throw MyException("redefiniton found in local variant type definition", currToken.getLocation());
         return std::move(variantTypeDef);
     }
 
     // typ zdefiniowany przez użytkownika: usr_defined::a = 5;
     if (currToken.getType() == TokenTypes::IDENTIFIER){
-        std::string type = std::get<std::string>(currToken.getValue());
-        Position typePos = currToken.getPosition();
+        std::string type = tokenValue<std::string>();
+        SourceLocation typePos = currToken.getLocation();
         getNextToken();
         consumeToken(TokenTypes::DOUBLE_COLON, "Expected '::' after type name");
         if (currToken.getType() != TokenTypes::IDENTIFIER)
-            throw MyException("Expected identifier after '::'", currToken.getPosition());
-        std::string id = std::get<std::string>(currToken.getValue());
-        Position idPos = currToken.getPosition();
+            throw MyException("Expected identifier after '::'", currToken.getLocation());
+        std::string id = tokenValue<std::string>();
+        SourceLocation idPos = currToken.getLocation();
         if(!declaredIds.insert(id).second)
-            throw MyException("redefiniton found in local variable definition", currToken.getPosition());
+            throw MyException("redefiniton found in local variable definition", currToken.getLocation());
         // mamy typ (variant albo struct) i id
         getNextToken();
         auto typeNode = std::make_unique<Nodes::Type>(type, typePos);
@@ -832,13 +1138,13 @@ std::unique_ptr<Nodes::Declaration> Parser::parseLocalVarDeclaration(std::set<st
         if (currToken.getType() == TokenTypes::PAREN_LEFT){ // to znaczy że zmienna struktury
             auto structVar = parseStructVarDeclaration(isMutable, std::move(typeDeclNode));
             if (!structVar)
-                throw MyException("Invalid struct variable declaration", currToken.getPosition());
+                throw MyException("Invalid struct variable declaration", currToken.getLocation());
             return std::move(structVar);
         }
         if (currToken.getType() == TokenTypes::ASSIGN){ // to znaczy że zmienna typu variant
             auto variantVar = parseVariantVarDeclaration(std::move(typeDeclNode));
             if (!variantVar)
-                throw MyException("Invalid variant variable declaration", currToken.getPosition());
+                throw MyException("Invalid variant variable declaration", currToken.getLocation());
             return std::move(variantVar);
         }
     }
@@ -854,11 +1160,28 @@ std::unique_ptr<Nodes::Program> Parser::parseProgram() {
         return nullptr;
     if (currToken.getType() == TokenTypes::SINGLE_COMMENT || currToken.getType() == TokenTypes::MULTILINE_COMMENT_START)
         getNextToken();
+    // importy tylko na początku pliku
+    while (parseImport()) {}
     while (parseFunction() || parseDeclaration())
         if (currToken.getType() == TokenTypes::EOF_TOKEN)
             break;
 
-    return std::make_unique<Nodes::Program>(std::move(functions), std::move(variables), std::move(structTypes), std::move(variantTypes), currToken.getPosition());
+    auto program = std::make_unique<Nodes::Program>(std::move(functions), std::move(variables), std::move(structTypes), std::move(variantTypes), currToken.getLocation());
+    program->setImports(std::move(imports));
+    return program;
+}
+
+bool Parser::parseImport() {
+    if (currToken.getType() != TokenTypes::IMPORT_KW)
+        return false;
+    auto pos = currToken.getLocation();
+    getNextToken();
+    if (currToken.getType() != TokenTypes::STR_VALUE)
+        throw MyException("Expected module path after import", currToken.getLocation());
+    imports.push_back(Nodes::Import{tokenValue<std::string>(), pos});
+    getNextToken();
+    consumeToken(TokenTypes::SEMICOLON, "Expected ';' after import");
+    return true;
 }
 
 bool Parser::parseFunction() {
@@ -866,9 +1189,9 @@ bool Parser::parseFunction() {
         return false;
     auto funDecl = parseFunctionDeclaration();
     if (!funDecl)
-        throw MyException("Invalid function declaration", currToken.getPosition());
+        throw MyException("Invalid function declaration", currToken.getLocation());
     if(!checkIfFunctionExists(funDecl->getFunctionName()))
-        throw MyException("Function with this id already exists", currToken.getPosition());
+        throw MyException("Function with this id already exists", currToken.getLocation());
     functions.insert(std::make_pair(funDecl->getFunctionName(), std::move(funDecl)));
     return true;
 }
@@ -901,28 +1224,29 @@ bool Parser::parseVarDeclaration() {
     if (isIdType(currToken.getType())) {
         auto varDecl = parseSimpleVariableDeclaration(isMutable);
         if (!varDecl)
-            throw MyException("Invalid variable declaration", currToken.getPosition());
+            throw MyException("Invalid variable declaration", currToken.getLocation());
         variables.insert(std::make_pair(varDecl->getIdentifier(), std::move(varDecl)));
         return true;
     }
     auto typeDecl = parseTypeDeclaration();
     if (!typeDecl) // przeparsowaliśmy funkcję albo podstawową zmienną albo typ więc tu musi być już jakaś zmienna typu zdefiniowanego przez użytkwonika
-        throw MyException("Expected type declaration", currToken.getPosition());
+        throw MyException("Expected type declaration", currToken.getLocation());
     if (currToken.getType() == TokenTypes::PAREN_LEFT) { // to znaczy że zmienna stuktury
         auto structVarDecl = parseStructVarDeclaration(isMutable, std::move(typeDecl));
         if (!structVarDecl)
-            throw MyException("Invalid struct variable declaration", currToken.getPosition());
-        if(!checkIfStructTypeExists(structVarDecl->getTypeName()))
-            throw MyException("Type with this id already exists", currToken.getPosition());
+            throw MyException("Invalid struct variable declaration", currToken.getLocation());
+        // typ może pochodzić z importowanego modułu - wtedy sprawdza go analiza semantyczna
+        if(imports.empty() && !externalTypes && !checkIfStructTypeExists(structVarDecl->getTypeName()))
+            throw MyException("Type with this id already exists", currToken.getLocation());
         variables.insert(std::make_pair(structVarDecl->getIdentifier(), std::move(structVarDecl)));
         return true;
     }
     // skoro nie ma nawiasu to znaczy że zmienna typu variant
     auto variantVarDecl = parseVariantVarDeclaration(std::move(typeDecl));
     if (!variantVarDecl)
-        throw MyException("Invalid variant variable declaration", currToken.getPosition());
-    if(!checkIfVariantTypeExists(variantVarDecl->getTypeName()))
-        throw MyException("Type with this id already exists", currToken.getPosition());
+        throw MyException("Invalid variant variable declaration", currToken.getLocation());
+    if(imports.empty() && !externalTypes && !checkIfVariantTypeExists(variantVarDecl->getTypeName()))
+        throw MyException("Type with this id already exists", currToken.getLocation());
     variables.insert(std::make_pair(variantVarDecl->getIdentifier(), std::move(variantVarDecl)));
     return true;
 }
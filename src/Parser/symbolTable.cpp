@@ -1,5 +1,25 @@
 #include "symbolTable.h"
 
+StructInfo::StructInfo(std::shared_ptr<const StructLayout> layout) : layout(std::move(layout)) {
+    values.reserve(this->layout->getFieldCount());
+    for (const auto& field : this->layout->getFields()) {
+        switch (field.type) {
+            case IdType::INT:
+                values.emplace_back(0);
+                break;
+            case IdType::FLOAT:
+                values.emplace_back(0.0f);
+                break;
+            case IdType::BOOLEAN:
+                values.emplace_back(false);
+                break;
+            default:
+                values.emplace_back(std::string(""));
+                break;
+        }
+    }
+}
+
 SymbolInfo::SymbolInfo(const std::string &identifier, const std::variant<IdType, std::string, std::shared_ptr<StructInfo>>& type,
                        bool isFunction, bool isMutable, bool isSimpleType,
                        const std::optional<std::variant<std::variant<int, float, bool, std::string>, Nodes::FunctionDeclaration *>>& value) {
@@ -7,7 +27,7 @@ SymbolInfo::SymbolInfo(const std::string &identifier, const std::variant<IdType,
     this->isMutable = isMutable;
     this->isFunction = isFunction;
     this->isSimpleType = isSimpleType;
-    this->type = type;
+    std::visit([this](const auto& held) { this->type = held; }, type);
     if (isFunction)
         this->funcPointer = std::get<Nodes::FunctionDeclaration *>(value.value());
     else if (value.has_value())
@@ -19,10 +39,14 @@ std::string SymbolInfo::getIdentifier() const {
 }
 
 std::variant<IdType, std::string> SymbolInfo::getType() const {
-    if (isSimpleType)
-        return std::get<IdType>(type);
-    else
-        return std::get<std::string>(type);
+    if (auto simple = std::get_if<IdType>(&type))
+        return *simple;
+    if (auto name = std::get_if<std::string>(&type))
+        return *name;
+    if (auto variant = std::get_if<VariantInfo>(&type))
+        return variant->layout->getVariantName();
+    // zmienna struktury - typem jest nazwa struktury
+    return std::get<std::shared_ptr<StructInfo>>(type)->layout->getStructName();
 }
 
 bool SymbolInfo::isFun() const {
@@ -38,10 +62,10 @@ bool SymbolInfo::isSimple() const {
 }
 
 std::string SymbolInfo::getTypeAsString() const {
-    if (isSimpleType)
-        return Nodes::idTypesToStr[std::get<IdType>(type)];
-
-    return std::get<std::string>(type);
+    auto symbolType = getType();
+    if (auto simple = std::get_if<IdType>(&symbolType))
+        return Nodes::idTypesToStr[*simple];
+    return std::get<std::string>(symbolType);
 }
 
 bool SymbolInfo::isStruct() const {
@@ -55,6 +79,19 @@ std::shared_ptr<StructInfo> SymbolInfo::getStructInfo() const {
     return nullptr;
 }
 
+void SymbolInfo::setVariantLayout(std::shared_ptr<const VariantLayout> layout) {
+    VariantInfo variantInfo(std::move(layout));
+    if (value.has_value())
+        variantInfo.tag = variantInfo.layout->getTagForValue(value.value());
+    type = std::move(variantInfo);
+}
+
+void SymbolInfo::setValue(std::variant<int, float, bool, std::string> &val) {
+    if (auto variantInfo = std::get_if<VariantInfo>(&type))
+        variantInfo->tag = variantInfo->layout->getTagForValue(val);
+    this->value = val;
+}
+
 std::optional<std::variant<int, float, bool, std::string>> SymbolInfo::getValue() const {
     return value;
 }
@@ -77,6 +114,13 @@ std::optional<SymbolInfo> SymbolTable::getSymbol(const std::string &identifier)
     return found->second;
 }
 
+SymbolInfo* SymbolTable::findSymbol(const std::string &identifier) {
+    auto found = table.find(identifier);
+    if (found == table.end())
+        return nullptr;
+    return &found->second;
+}
+
 bool SymbolTable::setValue(const std::string &identifier, std::variant<int, float, bool, std::string> newValue) {
     auto symbol = table.find(identifier);
     if (symbol == table.end())
@@ -1,4 +1,5 @@
 #include "Parser/symbolTableManager.h"
+#include "stats.h"
 
 SymbolTableManager::SymbolTableManager() {
     tables = {};
@@ -32,6 +33,7 @@ bool SymbolTableManager::leaveContext() {
 }
 
 std::optional<SymbolInfo> SymbolTableManager::getSymbol(const std::string &identifier, bool isFun) {
+    TKOM_STATS_INC(SYMBOL_LOOKUPS);
     if (isFun) {
         if (!tables.empty() && !tables.front().empty()) {
             return tables.front().front().getSymbol(identifier);
@@ -58,6 +60,22 @@ std::optional<SymbolInfo> SymbolTableManager::getSymbol(const std::string &ident
     return std::nullopt;
 }
 
+SymbolInfo* SymbolTableManager::findSymbol(const std::string &identifier) {
+    TKOM_STATS_INC(SYMBOL_LOOKUPS);
+    if (tables.empty())
+        return nullptr;
+
+    for (auto it = tables.back().rbegin(); it != tables.back().rend(); ++it) {
+        auto symbol = it->findSymbol(identifier);
+        if (symbol != nullptr)
+            return symbol;
+    }
+
+    if (!tables.front().empty())
+        return tables.front().front().findSymbol(identifier);
+    return nullptr;
+}
+
 bool SymbolTableManager::insertSymbol(const std::string &identifier, const SymbolInfo& symbol) {
     return tables.back().back().insert(identifier, symbol);
 }
@@ -1,8 +1,10 @@
 #include "Parser/syntaxTree.h"
+#include "Parser/typeLayout.h"
 #include "visitorTemplate.h"
+#include "myException.h"
 
 Position Node::getPos() const {
-    return pos;
+    return pos.resolve();
 }
 
 std::ostream &operator<<(std::ostream &os, Node *node) {
@@ -14,6 +16,19 @@ std::string Node::getNodeName() const {
     return nodeName;
 }
 
+namespace {
+    // rozbiera poddrzewo na jawnym stosie: węzeł niszczony na końcu iteracji już bez dzieci
+    void releaseTree(Node& root) {
+        std::vector<std::unique_ptr<Node>> pending;
+        root.releaseChildren(pending);
+        while (!pending.empty()) {
+            auto node = std::move(pending.back());
+            pending.pop_back();
+            node->releaseChildren(pending);
+        }
+    }
+}
+
 namespace Nodes {
     const std::vector<std::string> relationalOpToStr = {
             "EQUALS",
@@ -62,6 +77,10 @@ namespace Nodes {
     void CastOp::accept(SyntaxTreeVisitor &visitor) {visitor.visitCastOp(this);}
 
     void CastingExpr::accept(SyntaxTreeVisitor &visitor) {visitor.visitCastingExpr(this);}
+    void CastingExpr::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (expression)
+            out.push_back(std::move(expression));
+    }
     void CastingExpr::acceptExpr(SyntaxTreeVisitor &visitor) const {
         if (expression)
             expression->accept(visitor);
@@ -72,6 +91,10 @@ namespace Nodes {
     }
 
     void UnaryExpr::accept(SyntaxTreeVisitor &visitor) {visitor.visitUnaryExpr(this);}
+    void UnaryExpr::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (expression)
+            out.push_back(std::move(expression));
+    }
     void UnaryExpr::acceptExpr(SyntaxTreeVisitor &visitor) const {
         if (expression)
             expression->accept(visitor);
@@ -82,6 +105,12 @@ namespace Nodes {
     }
 
     void MulExpr::accept(SyntaxTreeVisitor &visitor) {visitor.visitMulExpr(this);}
+    void MulExpr::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (left)
+            out.push_back(std::move(left));
+        if (right)
+            out.push_back(std::move(right));
+    }
 
     void MulExpr::acceptLeft(SyntaxTreeVisitor &visitor) const {
         if (left)
@@ -97,6 +126,12 @@ namespace Nodes {
     }
 
     void ArtmExpr::accept(SyntaxTreeVisitor &visitor) {visitor.visitArtmExpr(this);}
+    void ArtmExpr::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (left)
+            out.push_back(std::move(left));
+        if (right)
+            out.push_back(std::move(right));
+    }
 
     void ArtmExpr::acceptLeft(SyntaxTreeVisitor &visitor) const {
         if (left)
@@ -112,6 +147,12 @@ namespace Nodes {
     }
 
     void RelExpr::accept(SyntaxTreeVisitor &visitor) {visitor.visitRelExpr(this);}
+    void RelExpr::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (left)
+            out.push_back(std::move(left));
+        if (right)
+            out.push_back(std::move(right));
+    }
     void RelExpr::acceptLeft(SyntaxTreeVisitor &visitor) const {
         if (left)
             left->accept(visitor);
@@ -126,6 +167,12 @@ namespace Nodes {
     }
 
     void AndExpr::accept(SyntaxTreeVisitor &visitor) {visitor.visitAndExpr(this);}
+    void AndExpr::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (left)
+            out.push_back(std::move(left));
+        if (right)
+            out.push_back(std::move(right));
+    }
     void AndExpr::acceptLeft(SyntaxTreeVisitor &visitor) const {
         if (left)
             left->accept(visitor);
@@ -136,6 +183,12 @@ namespace Nodes {
     }
 
     void OrExpr::accept(SyntaxTreeVisitor &visitor) {visitor.visitOrExpr(this);}
+    void OrExpr::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (left)
+            out.push_back(std::move(left));
+        if (right)
+            out.push_back(std::move(right));
+    }
     void OrExpr::acceptLeft(SyntaxTreeVisitor &visitor) const {
         if (left)
             left->accept(visitor);
@@ -150,6 +203,13 @@ namespace Nodes {
     void StringLiteral::accept(SyntaxTreeVisitor &visitor) {visitor.visitStringLiteral(this);}
     void Identifier::accept(SyntaxTreeVisitor &visitor) {visitor.visitIdentifier(this);}
     void Expression::accept(SyntaxTreeVisitor &visitor) {visitor.visitExpr(this);}
+    void Expression::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (expression)
+            out.push_back(std::move(expression));
+    }
+    Expression::~Expression() {
+        releaseTree(*this);
+    }
 
     void Expression::acceptExpr(SyntaxTreeVisitor &visitor) const {
         if (expression)
@@ -157,6 +217,8 @@ namespace Nodes {
     }
     void FunCall::accept(SyntaxTreeVisitor &visitor) {visitor.visitFuncCall(this);}
     void VarReference::accept(SyntaxTreeVisitor &visitor) {visitor.visitVariableRef(this);}
+    void StructFieldReference::accept(SyntaxTreeVisitor &visitor) {visitor.visitStructFieldRef(this);}
+    void VariantHolding::accept(SyntaxTreeVisitor &visitor) {visitor.visitVariantHolding(this);}
     void Declaration::accept(SyntaxTreeVisitor &visitor) {visitor.visitDeclaration(this);}
     void Type::accept(SyntaxTreeVisitor &visitor) {visitor.visitType(this);}
 
@@ -177,9 +239,25 @@ namespace Nodes {
     }
 
     void StructTypeDefinition::accept(SyntaxTreeVisitor &visitor) {visitor.visitStructTypeDefinition(this);}
+    void StructTypeDefinition::computeLayout() {
+        for (const auto & field : fields) {
+            if (!std::holds_alternative<IdType>(field->getType()->getIdType()))
+                return;
+        }
+        layout = std::make_shared<const StructLayout>(*this);
+    }
     void StructVarDeclaration::accept(SyntaxTreeVisitor &visitor) {visitor.visitStructVarDeclaration(this);}
 
     void VariantTypeDefinition::accept(SyntaxTreeVisitor &visitor) {visitor.visitVariantTypeDefinition(this);}
+    void VariantTypeDefinition::computeLayout() {
+        if (fields.empty())
+            return;
+        for (const auto & field : fields) {
+            if (!std::holds_alternative<IdType>(field->getIdType()))
+                return;
+        }
+        layout = std::make_shared<const VariantLayout>(*this);
+    }
     void VariantVarDeclaration::accept(SyntaxTreeVisitor &visitor) {visitor.visitVariantVarDeclaration(this);}
     void VariantVarDeclaration::acceptType(SyntaxTreeVisitor &visitor) const {
         if (typeDecl)
@@ -209,6 +287,14 @@ namespace Nodes {
     }
 
     void Block::accept(SyntaxTreeVisitor &visitor) {visitor.visitBlock(this);}
+    void Block::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        for (auto& statement : statements)
+            out.push_back(std::move(statement));
+        statements.clear();
+    }
+    Block::~Block() {
+        releaseTree(*this);
+    }
     void Block::acceptStatements(SyntaxTreeVisitor &visitor) const {
         for (const auto & statement : statements) {
             statement->accept(visitor);
@@ -216,6 +302,12 @@ namespace Nodes {
     }
 
     void IfStatement::accept(SyntaxTreeVisitor &visitor) {visitor.visitIfStatement(this);}
+    void IfStatement::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (ifBlock)
+            out.push_back(std::move(ifBlock));
+        if (elseBlock)
+            out.push_back(std::move(elseBlock));
+    }
     void IfStatement::acceptCondition(SyntaxTreeVisitor &visitor) const {
         if (condition)
             condition->accept(visitor);
@@ -230,6 +322,10 @@ namespace Nodes {
     }
 
     void WhileStatement::accept(SyntaxTreeVisitor &visitor) {visitor.visitWhileStatement(this);}
+    void WhileStatement::releaseChildren(std::vector<std::unique_ptr<Node>>& out) {
+        if (block)
+            out.push_back(std::move(block));
+    }
     void WhileStatement::acceptCondition(SyntaxTreeVisitor &visitor) const {
         if (condition)
             condition->accept(visitor);
@@ -252,6 +348,19 @@ namespace Nodes {
         }
         return args;
     }
+    void FunctionDeclaration::setLazyBody(std::vector<Token> tokens) {
+        lazyBody = std::move(tokens);
+        block.reset();
+        bodyParsed.store(false, std::memory_order_release);
+    }
+    void FunctionDeclaration::attachBody(std::unique_ptr<Block> body) {
+        block = std::move(body);
+    }
+    void FunctionDeclaration::publishBody() {
+        lazyBody.clear();
+        lazyBody.shrink_to_fit();
+        bodyParsed.store(true, std::memory_order_release);
+    }
     void FunctionDeclaration::acceptFunctionBody(SyntaxTreeVisitor &visitor) const {
         if (block)
             block->accept(visitor);
@@ -288,4 +397,69 @@ namespace Nodes {
     }
 
     void Program::accept(SyntaxTreeVisitor &visitor) {visitor.visitProgram(this);}
+
+    namespace {
+        template<typename Map>
+        void mergeMap(Map& target, Map& source) {
+            for (auto& [name, node] : source) {
+                if (target.find(name) != target.end())
+                    throw MyException("'" + name + "' is already defined", node->getPos());
+            }
+            for (auto& [name, node] : source)
+                target.emplace(name, std::move(node));
+            source.clear();
+        }
+
+        template<typename Map>
+        std::set<std::string> keysOf(const Map& map) {
+            std::set<std::string> keys;
+            for (const auto& item : map)
+                keys.insert(item.first);
+            return keys;
+        }
+
+        template<typename Map>
+        void eraseKeys(Map& map, const std::set<std::string>& keys) {
+            for (const auto& key : keys)
+                map.erase(key);
+        }
+
+        template<typename Map>
+        void retainKeys(Map& map, const std::set<std::string>& keys) {
+            for (auto it = map.begin(); it != map.end();)
+                it = keys.count(it->first) ? std::next(it) : map.erase(it);
+        }
+    }
+
+    bool Program::hasLazyFunctions() const {
+        for (const auto& function : functions)
+            if (!function.second->isBodyParsed())
+                return true;
+        return false;
+    }
+    void Program::merge(Program &other) {
+        mergeMap(functions, other.functions);
+        mergeMap(variables, other.variables);
+        mergeMap(structTypes, other.structTypes);
+        mergeMap(variantTypes, other.variantTypes);
+        scopesResolved = false;
+    }
+
+    Program::ItemNames Program::getItemNames() const {
+        return ItemNames{keysOf(functions), keysOf(variables), keysOf(structTypes), keysOf(variantTypes)};
+    }
+
+    void Program::retainItems(const ItemNames &names) {
+        retainKeys(functions, names.functions);
+        retainKeys(variables, names.variables);
+        retainKeys(structTypes, names.structTypes);
+        retainKeys(variantTypes, names.variantTypes);
+    }
+
+    void Program::removeItems(const ItemNames &names) {
+        eraseKeys(functions, names.functions);
+        eraseKeys(variables, names.variables);
+        eraseKeys(structTypes, names.structTypes);
+        eraseKeys(variantTypes, names.variantTypes);
+    }
 }
\ No newline at end of file
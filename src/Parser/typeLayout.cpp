@@ -0,0 +1,85 @@
+#include "Parser/typeLayout.h"
+#include "myException.h"
+
+StructLayout::StructLayout(const Nodes::StructTypeDefinition &definition) {
+    structName = definition.getStructName();
+    fields.reserve(definition.getFields().size());
+    for (const auto& field : definition.getFields()) {
+        auto fieldType = field->getType()->getIdType();
+        if (!std::holds_alternative<IdType>(fieldType))
+            throw MyException("Struct '" + structName + "' contains unknown type '" + field->getType()->getTypeAsString() + "' (maybe struct or variant)", field->getPos());
+        IdType type = std::get<IdType>(fieldType);
+
+        std::size_t index = fields.size();
+        fields.push_back(StructFieldLayout{field->getIdentifier(), type, index});
+        fieldIndices.insert(std::make_pair(field->getIdentifier(), index));
+    }
+}
+
+std::optional<std::size_t> StructLayout::getFieldIndex(const std::string &fieldName) const {
+    auto found = fieldIndices.find(fieldName);
+    if (found == fieldIndices.end())
+        return std::nullopt;
+    return found->second;
+}
+
+VariantLayout::VariantLayout(const Nodes::VariantTypeDefinition &definition) {
+    variantName = definition.getVariantName();
+    tagsByValueIndex.fill(NO_TAG);
+    if (definition.getFields().size() >= NO_TAG)
+        throw MyException("Variant '" + variantName + "' has too many alternatives", definition.getPos());
+
+    for (const auto& field : definition.getFields()) {
+        auto fieldType = field->getIdType();
+        if (!std::holds_alternative<IdType>(fieldType))
+            throw MyException("Variant '" + variantName + "' contains unknown type '" + field->getTypeAsString() + "' (maybe struct or variant)", field->getPos());
+        IdType type = std::get<IdType>(fieldType);
+
+        auto tag = static_cast<std::uint8_t>(alternatives.size());
+        alternatives.push_back(type);
+        alternativeNames.push_back(keywordOf(type));
+        std::size_t valueIndex = valueIndexOf(type);
+        if (tagsByValueIndex[valueIndex] == NO_TAG)
+            tagsByValueIndex[valueIndex] = tag;
+    }
+}
+
+std::uint8_t VariantLayout::getTag(IdType type) const {
+    switch (type) {
+        case IdType::INT:
+        case IdType::FLOAT:
+        case IdType::BOOLEAN:
+        case IdType::STR:
+            return tagsByValueIndex[valueIndexOf(type)];
+        default:
+            return NO_TAG;
+    }
+}
+
+std::size_t VariantLayout::valueIndexOf(IdType type) {
+    switch (type) {
+        case IdType::INT:
+            return 0;
+        case IdType::FLOAT:
+            return 1;
+        case IdType::BOOLEAN:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+std::string VariantLayout::keywordOf(IdType type) {
+    switch (type) {
+        case IdType::INT:
+            return "int";
+        case IdType::FLOAT:
+            return "float";
+        case IdType::BOOLEAN:
+            return "bool";
+        case IdType::STR:
+            return "str";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,120 @@
+#include "definitionFinder.h"
+
+#include <map>
+
+using Tokens = std::vector<IncrementalDocument::ItemToken>;
+
+std::string DefinitionFinder::identifierAt(const Tokens &tokens, std::size_t index) {
+    if (index >= tokens.size() || tokens[index].token.getType() != TokenTypes::IDENTIFIER)
+        return "";
+    return std::get<std::string>(tokens[index].token.getValue());
+}
+
+// deklaracja ma zawsze postać typ::nazwa
+bool DefinitionFinder::declaresAt(const Tokens &tokens, std::size_t index) {
+    return index >= 2 && tokens[index - 1].token.getType() == TokenTypes::DOUBLE_COLON && !identifierAt(tokens, index).empty();
+}
+
+std::optional<DefinitionFinder::Symbol> DefinitionFinder::findGlobal(const std::string &name,
+                                                                     std::set<std::string> Nodes::Program::ItemNames::* kind) const {
+    for (const auto& item : document.getItems()) {
+        if (!item.inProgram || (item.names.*kind).count(name) == 0)
+            continue;
+        auto tokens = document.tokensOf(item);
+        for (std::size_t i = 0; i < tokens.size(); i++)
+            if (declaresAt(tokens, i) && identifierAt(tokens, i) == name)
+                return Symbol{&item, std::move(tokens), i};
+    }
+    return std::nullopt;
+}
+
+// zakresy jak w ScopeResolver: parametry w zakresie funkcji, każdy blok '[' ... ']' otwiera nowy
+std::optional<DefinitionFinder::Symbol> DefinitionFinder::findVariable(const std::string &name, const IncrementalDocument::Item &item,
+                                                                       const Tokens &tokens, std::size_t index) const {
+    if (!tokens.empty() && tokens[0].token.getType() == TokenTypes::FUN_KW) {
+        std::vector<std::map<std::string, std::size_t>> scopes(1);
+        bool functionName = true;
+        for (std::size_t i = 0; i < index; i++) {
+            auto type = tokens[i].token.getType();
+            if (type == TokenTypes::BRACKET_LEFT) {
+                scopes.emplace_back();
+            } else if (type == TokenTypes::BRACKET_RIGHT) {
+                if (scopes.size() > 1)
+                    scopes.pop_back();
+            } else if (declaresAt(tokens, i)) {
+                // pierwsza deklaracja to nazwa samej funkcji
+                if (!functionName)
+                    scopes.back()[identifierAt(tokens, i)] = i;
+                functionName = false;
+            }
+        }
+        for (auto scope = scopes.rbegin(); scope != scopes.rend(); ++scope) {
+            auto found = scope->find(name);
+            if (found != scope->end())
+                return Symbol{&item, tokens, found->second};
+        }
+    }
+    if (document.getProgram().getVariables().count(name) == 0)
+        return std::nullopt;
+    return findGlobal(name, &Nodes::Program::ItemNames::variables);
+}
+
+std::optional<DefinitionFinder::Symbol> DefinitionFinder::findField(const Symbol &variable, const std::string &field) const {
+    auto typeName = identifierAt(variable.tokens, variable.index - 2);
+    if (typeName.empty() || document.getProgram().getStructTypes().count(typeName) == 0)
+        return std::nullopt;
+    auto structType = findGlobal(typeName, &Nodes::Program::ItemNames::structTypes);
+    if (!structType)
+        return std::nullopt;
+    for (auto i = structType->index + 1; i < structType->tokens.size(); i++) {
+        if (declaresAt(structType->tokens, i) && identifierAt(structType->tokens, i) == field) {
+            structType->index = i;
+            return structType;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<DefinitionFinder::Definition> DefinitionFinder::find(std::size_t offset) const {
+    auto item = document.itemAt(offset);
+    if (item == nullptr && offset > 0)
+        item = document.itemAt(offset - 1);
+    if (item == nullptr)
+        return std::nullopt;
+    auto tokens = document.tokensOf(*item);
+
+    // kursor w identyfikatorze albo tuż za nim
+    std::optional<std::size_t> index;
+    for (std::size_t i = 0; i < tokens.size() && tokens[i].offset <= offset; i++) {
+        auto name = identifierAt(tokens, i);
+        if (!name.empty() && offset <= tokens[i].offset + name.size())
+            index = i;
+    }
+    if (!index)
+        return std::nullopt;
+    auto i = index.value();
+    auto name = identifierAt(tokens, i);
+
+    // kursor na samej deklaracji
+    if (declaresAt(tokens, i))
+        return Definition{tokens[i].offset, tokens[i].offset + name.size()};
+
+    std::optional<Symbol> symbol;
+    if (i + 1 < tokens.size() && tokens[i + 1].token.getType() == TokenTypes::DOUBLE_COLON) {
+        // nazwa typu w deklaracji
+        symbol = findGlobal(name, &Nodes::Program::ItemNames::structTypes);
+        if (!symbol)
+            symbol = findGlobal(name, &Nodes::Program::ItemNames::variantTypes);
+    } else if (i >= 2 && tokens[i - 1].token.getType() == TokenTypes::DOT) {
+        if (auto variable = findVariable(identifierAt(tokens, i - 2), *item, tokens, i - 2))
+            symbol = findField(*variable, name);
+    } else {
+        symbol = findVariable(name, *item, tokens, i);
+        if (!symbol && document.getProgram().getFunctions().count(name) > 0)
+            symbol = findGlobal(name, &Nodes::Program::ItemNames::functions);
+    }
+    if (!symbol)
+        return std::nullopt;
+    const auto& target = symbol->tokens[symbol->index];
+    return Definition{target.offset, target.offset + identifierAt(symbol->tokens, symbol->index).size()};
+}
@@ -0,0 +1,343 @@
+#include "json.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include "myException.h"
+
+namespace {
+    class JsonParser
+    {
+    private:
+        const std::string& text;
+        std::size_t position = 0;
+
+        [[noreturn]] void fail(const std::string& message) const {
+            throw MyException("Invalid JSON at offset " + std::to_string(position) + ": " + message);
+        }
+
+        void skipWhitespace() {
+            while (position < text.size() && (text[position] == ' ' || text[position] == '\t'
+                                               || text[position] == '\n' || text[position] == '\r'))
+                position++;
+        }
+
+        void expect(char c) {
+            skipWhitespace();
+            if (position >= text.size() || text[position] != c)
+                fail(std::string("expected '") + c + "'");
+            position++;
+        }
+
+        bool consume(const std::string& word) {
+            if (text.compare(position, word.size(), word) != 0)
+                return false;
+            position += word.size();
+            return true;
+        }
+
+        unsigned int parseHex4() {
+            if (position + 4 > text.size())
+                fail("truncated \\u escape");
+            unsigned int code = 0;
+            for (int i = 0; i < 4; i++) {
+                char c = text[position++];
+                code <<= 4;
+                if (c >= '0' && c <= '9')
+                    code |= c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    code |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    code |= c - 'A' + 10;
+                else
+                    fail("invalid \\u escape");
+            }
+            return code;
+        }
+
+        static void appendUtf8(std::string& out, unsigned int code) {
+            if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else if (code < 0x800) {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        std::string parseString() {
+            expect('"');
+            std::string result;
+            while (true) {
+                if (position >= text.size())
+                    fail("unterminated string");
+                char c = text[position++];
+                if (c == '"')
+                    return result;
+                if (c != '\\') {
+                    result += c;
+                    continue;
+                }
+                if (position >= text.size())
+                    fail("unterminated string");
+                switch (text[position++]) {
+                    case '"': result += '"'; break;
+                    case '\\': result += '\\'; break;
+                    case '/': result += '/'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'n': result += '\n'; break;
+                    case 'r': result += '\r'; break;
+                    case 't': result += '\t'; break;
+                    case 'u': {
+                        auto code = parseHex4();
+                        // para surogatów UTF-16
+                        if (code >= 0xD800 && code < 0xDC00 && consume("\\u")) {
+                            auto low = parseHex4();
+                            if (low < 0xDC00 || low >= 0xE000)
+                                fail("invalid surrogate pair");
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        appendUtf8(result, code);
+                        break;
+                    }
+                    default:
+                        fail("invalid escape");
+                }
+            }
+        }
+
+        double parseNumber() {
+            auto start = position;
+            if (position < text.size() && text[position] == '-')
+                position++;
+            while (position < text.size() && (std::isdigit(static_cast<unsigned char>(text[position]))
+                                               || text[position] == '.' || text[position] == 'e' || text[position] == 'E'
+                                               || text[position] == '+' || text[position] == '-'))
+                position++;
+            auto number = text.substr(start, position - start);
+            char* end = nullptr;
+            double result = std::strtod(number.c_str(), &end);
+            if (number.empty() || end != number.c_str() + number.size())
+                fail("invalid number");
+            return result;
+        }
+
+    public:
+        explicit JsonParser(const std::string& text) : text(text) {}
+
+        Json parseValue() {
+            skipWhitespace();
+            if (position >= text.size())
+                fail("unexpected end");
+            char c = text[position];
+            if (c == '{') {
+                position++;
+                Json::Object object;
+                skipWhitespace();
+                if (position < text.size() && text[position] == '}') {
+                    position++;
+                    return object;
+                }
+                while (true) {
+                    auto key = parseString();
+                    expect(':');
+                    object[key] = parseValue();
+                    skipWhitespace();
+                    if (position < text.size() && text[position] == ',') {
+                        position++;
+                        skipWhitespace();
+                        continue;
+                    }
+                    expect('}');
+                    return object;
+                }
+            }
+            if (c == '[') {
+                position++;
+                Json::Array array;
+                skipWhitespace();
+                if (position < text.size() && text[position] == ']') {
+                    position++;
+                    return array;
+                }
+                while (true) {
+                    array.push_back(parseValue());
+                    skipWhitespace();
+                    if (position < text.size() && text[position] == ',') {
+                        position++;
+                        continue;
+                    }
+                    expect(']');
+                    return array;
+                }
+            }
+            if (c == '"')
+                return parseString();
+            if (consume("true"))
+                return true;
+            if (consume("false"))
+                return false;
+            if (consume("null"))
+                return nullptr;
+            return parseNumber();
+        }
+
+        void expectEnd() {
+            skipWhitespace();
+            if (position != text.size())
+                fail("unexpected trailing characters");
+        }
+    };
+
+    void writeString(std::ostream& output, const std::string& string) {
+        output << '"';
+        for (char c : string) {
+            switch (c) {
+                case '"': output << "\\\""; break;
+                case '\\': output << "\\\\"; break;
+                case '\b': output << "\\b"; break;
+                case '\f': output << "\\f"; break;
+                case '\n': output << "\\n"; break;
+                case '\r': output << "\\r"; break;
+                case '\t': output << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                        output << escaped;
+                    } else {
+                        output << c;
+                    }
+            }
+        }
+        output << '"';
+    }
+
+    [[noreturn]] void wrongType(const std::string& expected) {
+        throw MyException("JSON value is not " + expected);
+    }
+}
+
+Json Json::parse(const std::string &text) {
+    JsonParser parser(text);
+    auto result = parser.parseValue();
+    parser.expectEnd();
+    return result;
+}
+
+bool Json::asBool() const {
+    if (!isBool())
+        wrongType("a boolean");
+    return std::get<bool>(value);
+}
+
+double Json::asNumber() const {
+    if (!isNumber())
+        wrongType("a number");
+    return std::get<double>(value);
+}
+
+std::size_t Json::asIndex() const {
+    auto number = asNumber();
+    if (number < 0 || number != std::floor(number))
+        wrongType("a non-negative integer");
+    return static_cast<std::size_t>(number);
+}
+
+const std::string &Json::asString() const {
+    if (!isString())
+        wrongType("a string");
+    return std::get<std::string>(value);
+}
+
+const Json::Array &Json::asArray() const {
+    if (!isArray())
+        wrongType("an array");
+    return std::get<Array>(value);
+}
+
+const Json::Object &Json::asObject() const {
+    if (!isObject())
+        wrongType("an object");
+    return std::get<Object>(value);
+}
+
+bool Json::contains(const std::string &key) const {
+    return isObject() && std::get<Object>(value).count(key) > 0;
+}
+
+const Json &Json::operator[](const std::string &key) const {
+    static const Json null;
+    if (!isObject())
+        return null;
+    const auto& object = std::get<Object>(value);
+    auto found = object.find(key);
+    return found == object.end() ? null : found->second;
+}
+
+Json &Json::operator[](const std::string &key) {
+    if (isNull())
+        value = Object();
+    if (!isObject())
+        wrongType("an object");
+    return std::get<Object>(value)[key];
+}
+
+void Json::write(std::ostream &output) const {
+    if (isNull()) {
+        output << "null";
+    } else if (isBool()) {
+        output << (std::get<bool>(value) ? "true" : "false");
+    } else if (isNumber()) {
+        auto number = std::get<double>(value);
+        if (number == std::floor(number) && std::fabs(number) < 1e15) {
+            output << static_cast<long long>(number);
+        } else {
+            std::ostringstream formatted;
+            formatted.precision(17);
+            formatted << number;
+            output << formatted.str();
+        }
+    } else if (isString()) {
+        writeString(output, std::get<std::string>(value));
+    } else if (isArray()) {
+        output << '[';
+        bool first = true;
+        for (const auto& element : std::get<Array>(value)) {
+            if (!first)
+                output << ',';
+            first = false;
+            element.write(output);
+        }
+        output << ']';
+    } else {
+        output << '{';
+        bool first = true;
+        for (const auto& [key, element] : std::get<Object>(value)) {
+            if (!first)
+                output << ',';
+            first = false;
+            writeString(output, key);
+            output << ':';
+            element.write(output);
+        }
+        output << '}';
+    }
+}
+
+std::string Json::dump() const {
+    std::ostringstream output;
+    write(output);
+    return output.str();
+}
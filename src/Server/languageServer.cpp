@@ -0,0 +1,332 @@
+#include "languageServer.h"
+
+#include <cctype>
+#include <thread>
+#include "definitionFinder.h"
+#include "myException.h"
+
+namespace {
+    // kody błędów JSON-RPC
+    const int PARSE_ERROR = -32700;
+    const int INVALID_REQUEST = -32600;
+    const int METHOD_NOT_FOUND = -32601;
+    const int INVALID_PARAMS = -32602;
+    const int INTERNAL_ERROR = -32603;
+
+    const int TEXT_DOCUMENT_SYNC_INCREMENTAL = 2;
+    const int SEVERITY_ERROR = 1;
+    const int MESSAGE_TYPE_ERROR = 1;
+
+    // większy nagłówek to błąd klienta, nie powód do alokacji
+    const std::size_t MAX_MESSAGE_SIZE = std::size_t(1) << 28;
+
+    // wartość Content-Length: same cyfry, otoczone spacjami; brak dla nagłówka niepoprawnego
+    std::optional<std::size_t> parseLength(const std::string& text) {
+        std::size_t begin = text.find_first_not_of(' ');
+        std::size_t end = text.find_last_not_of(' ');
+        if (begin == std::string::npos)
+            return std::nullopt;
+        std::size_t length = 0;
+        for (std::size_t i = begin; i <= end; i++) {
+            if (!std::isdigit(static_cast<unsigned char>(text[i])))
+                return std::nullopt;
+            length = length * 10 + static_cast<std::size_t>(text[i] - '0');
+            if (length > MAX_MESSAGE_SIZE)
+                return std::nullopt;
+        }
+        return length;
+    }
+
+    std::size_t utf8Length(unsigned char lead) {
+        return lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+    }
+
+    // znaki spoza BMP zajmują w UTF-16 dwie jednostki
+    std::size_t utf16Units(std::size_t utf8Length) {
+        return utf8Length == 4 ? 2 : 1;
+    }
+}
+
+// *********************************************************************************************************************
+//                  Transport
+// *********************************************************************************************************************
+
+std::optional<std::string> LanguageServer::readMessage() {
+    std::optional<std::size_t> length;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty()) {
+            if (!length)
+                continue;
+            std::string body(length.value(), '\0');
+            if (!input.read(body.data(), static_cast<std::streamsize>(body.size())))
+                return std::nullopt;
+            return body;
+        }
+        const std::string header = "Content-Length:";
+        if (line.compare(0, header.size(), header) == 0) {
+            length = parseLength(line.substr(header.size()));
+            // bez długości nie wiadomo, gdzie kończy się treść - pomijane do następnego nagłówka
+            if (!length)
+                respondError(nullptr, PARSE_ERROR, "Invalid Content-Length header: " + line);
+        }
+    }
+    return std::nullopt;
+}
+
+void LanguageServer::send(const Json &message) {
+    auto body = message.dump();
+    std::lock_guard<std::mutex> lock(outputMutex);
+    output << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    output.flush();
+}
+
+void LanguageServer::respond(const Json &id, Json result) {
+    send(Json::Object{{"jsonrpc", "2.0"}, {"id", id}, {"result", std::move(result)}});
+}
+
+void LanguageServer::respondError(const Json &id, int code, const std::string &message) {
+    send(Json::Object{{"jsonrpc", "2.0"}, {"id", id},
+                      {"error", Json::Object{{"code", code}, {"message", message}}}});
+}
+
+void LanguageServer::notify(const std::string &method, Json params) {
+    send(Json::Object{{"jsonrpc", "2.0"}, {"method", method}, {"params", std::move(params)}});
+}
+
+void LanguageServer::logError(const std::string &message) {
+    notify("window/logMessage", Json::Object{{"type", MESSAGE_TYPE_ERROR}, {"message", message}});
+}
+
+int LanguageServer::run() {
+    std::thread analysis([this]() { analyze(); });
+    try {
+        readMessages();
+    } catch (...) {
+        // niedołączony std::thread przy wyjściu z funkcji woła std::terminate
+        closeInput();
+        analysis.join();
+        throw;
+    }
+    closeInput();
+    analysis.join();
+    return shutdownRequested ? 0 : 1;
+}
+
+void LanguageServer::closeInput() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        inputClosed = true;
+    }
+    queueChanged.notify_one();
+}
+
+void LanguageServer::readMessages() {
+    while (auto body = readMessage()) {
+        Json message;
+        try {
+            message = Json::parse(body.value());
+        } catch (MyException& e) {
+            respondError(nullptr, PARSE_ERROR, e.getMessage());
+            continue;
+        }
+        bool exit = message["method"] == Json("exit");
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(std::move(message));
+        }
+        queueChanged.notify_one();
+        if (exit)
+            break;
+    }
+}
+
+// *********************************************************************************************************************
+//                  Analiza
+// *********************************************************************************************************************
+
+void LanguageServer::analyze() {
+    while (!exitRequested) {
+        Json message;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this]() { return !queue.empty() || inputClosed; });
+            if (queue.empty())
+                return;
+            message = std::move(queue.front());
+            queue.pop_front();
+        }
+        // odpowiedź na żądanie przychodzi po diagnostykach stanu, którego dotyczy
+        if (message.contains("id"))
+            publishChangedDocuments();
+        handle(message);
+
+        bool idle;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            idle = queue.empty();
+        }
+        if (idle)
+            publishChangedDocuments();
+    }
+}
+
+void LanguageServer::publishChangedDocuments() {
+    // błąd wewnętrzny analizy jednego dokumentu nie może zatrzymać serwera
+    for (const auto& uri : changedDocuments) {
+        try {
+            publishDiagnostics(uri);
+        } catch (std::exception& e) {
+            logError("publishDiagnostics " + uri + ": " + e.what());
+        }
+    }
+    changedDocuments.clear();
+}
+
+void LanguageServer::handle(const Json &message) {
+    const auto& method = message["method"];
+    const auto& id = message["id"];
+    bool isRequest = message.contains("id");
+    if (!method.isString()) {
+        if (isRequest)
+            respondError(id, INVALID_REQUEST, "Missing method");
+        return;
+    }
+    const auto& name = method.asString();
+    const auto& params = message["params"];
+    try {
+        if (name == "initialize") {
+            Json capabilities = Json::Object{
+                    {"textDocumentSync", Json::Object{{"openClose", true}, {"change", TEXT_DOCUMENT_SYNC_INCREMENTAL}}},
+                    {"definitionProvider", true}};
+            respond(id, Json::Object{{"capabilities", capabilities},
+                                     {"serverInfo", Json::Object{{"name", "tkom_lsp"}}}});
+        } else if (name == "shutdown") {
+            shutdownRequested = true;
+            respond(id, nullptr);
+        } else if (name == "exit") {
+            exitRequested = true;
+        } else if (name == "textDocument/didOpen") {
+            const auto& textDocument = params["textDocument"];
+            const auto& uri = textDocument["uri"].asString();
+            documents[uri] = std::make_unique<IncrementalDocument>(textDocument["text"].asString());
+            changedDocuments.insert(uri);
+        } else if (name == "textDocument/didChange") {
+            changeDocument(params);
+        } else if (name == "textDocument/didClose") {
+            const auto& uri = params["textDocument"]["uri"].asString();
+            documents.erase(uri);
+            changedDocuments.erase(uri);
+            notify("textDocument/publishDiagnostics", Json::Object{{"uri", uri}, {"diagnostics", Json::Array()}});
+        } else if (name == "textDocument/definition") {
+            respond(id, findDefinition(params));
+        } else if (isRequest) {
+            respondError(id, METHOD_NOT_FOUND, "Unsupported method " + name);
+        }
+    } catch (MyException& e) {
+        if (isRequest)
+            respondError(id, INVALID_PARAMS, e.getMessage());
+        else
+            logError(name + ": " + e.getMessage());
+    } catch (std::exception& e) {
+        // błąd wewnętrzny (nie błąd w tekście programu) - zgłoszony, serwer działa dalej
+        if (isRequest)
+            respondError(id, INTERNAL_ERROR, e.what());
+        else
+            logError(name + ": " + e.what());
+    }
+}
+
+const IncrementalDocument &LanguageServer::documentOf(const Json &textDocument) const {
+    auto found = documents.find(textDocument["uri"].asString());
+    if (found == documents.end())
+        throw MyException("Document " + textDocument["uri"].asString() + " is not open");
+    return *found->second;
+}
+
+void LanguageServer::changeDocument(const Json &params) {
+    const auto& uri = params["textDocument"]["uri"].asString();
+    if (documents.count(uri) == 0)
+        throw MyException("Document " + uri + " is not open");
+    for (const auto& change : params["contentChanges"].asArray()) {
+        const auto& text = change["text"].asString();
+        // zmiana bez zakresu zastępuje cały tekst
+        if (!change.contains("range")) {
+            documents[uri] = std::make_unique<IncrementalDocument>(text);
+            continue;
+        }
+        auto& document = *documents[uri];
+        auto begin = toOffset(document, change["range"]["start"]);
+        auto end = toOffset(document, change["range"]["end"]);
+        if (end < begin)
+            throw MyException("Change range ends before it starts");
+        document.applyEdit(begin, end - begin, text);
+    }
+    changedDocuments.insert(uri);
+}
+
+Json LanguageServer::findDefinition(const Json &params) const {
+    const auto& document = documentOf(params["textDocument"]);
+    auto definition = DefinitionFinder(document).find(toOffset(document, params["position"]));
+    if (!definition)
+        return nullptr;
+    return Json::Object{{"uri", params["textDocument"]["uri"]},
+                        {"range", Json::Object{{"start", toLspPosition(document, definition->begin)},
+                                               {"end", toLspPosition(document, definition->end)}}}};
+}
+
+void LanguageServer::publishDiagnostics(const std::string &uri) {
+    auto found = documents.find(uri);
+    if (found == documents.end())
+        return;
+    const auto& document = *found->second;
+    const auto& text = document.getText();
+    Json::Array diagnostics;
+    for (const auto& diagnostic : document.getDiagnostics()) {
+        // zakres: słowo zaczynające się w miejscu błędu, co najmniej jeden znak
+        auto begin = document.offsetOf(diagnostic.pos);
+        auto end = begin;
+        while (end < text.size() && (std::isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_'))
+            end++;
+        if (end == begin && end < text.size() && text[end] != '\n')
+            end++;
+        diagnostics.push_back(Json::Object{
+                {"range", Json::Object{{"start", toLspPosition(document, begin)}, {"end", toLspPosition(document, end)}}},
+                {"severity", SEVERITY_ERROR},
+                {"source", "tkom"},
+                {"message", diagnostic.message}});
+    }
+    notify("textDocument/publishDiagnostics", Json::Object{{"uri", uri}, {"diagnostics", std::move(diagnostics)}});
+}
+
+// *********************************************************************************************************************
+//                  Pozycje
+// *********************************************************************************************************************
+
+std::size_t LanguageServer::toOffset(const IncrementalDocument &document, const Json &position) {
+    auto line = position["line"].asIndex();
+    auto character = position["character"].asIndex();
+    const auto& text = document.getText();
+    auto offset = document.offsetOf(Position{static_cast<unsigned int>(line + 1), 1});
+    std::size_t units = 0;
+    while (offset < text.size() && text[offset] != '\n' && units < character) {
+        auto length = utf8Length(static_cast<unsigned char>(text[offset]));
+        units += utf16Units(length);
+        offset += length;
+    }
+    return std::min(offset, text.size());
+}
+
+Json LanguageServer::toLspPosition(const IncrementalDocument &document, std::size_t offset) {
+    auto position = document.positionOf(offset);
+    const auto& text = document.getText();
+    std::size_t units = 0;
+    for (auto i = document.offsetOf(Position{position.line, 1}); i < offset && i < text.size();) {
+        auto length = utf8Length(static_cast<unsigned char>(text[i]));
+        units += utf16Units(length);
+        i += length;
+    }
+    return Json::Object{{"line", position.line - 1}, {"character", units}};
+}
@@ -0,0 +1,57 @@
+#include "executionBudget.h"
+
+#include <algorithm>
+#include <limits>
+#include "myException.h"
+
+void ExecutionBudget::setFuel(std::uint64_t fuel) {
+    fuelLeft = fuel;
+    sliceRemaining = 0;
+}
+
+// termin liczony od startu wykonania (pierwszej porcji), nie od konfiguracji budżetu
+void ExecutionBudget::setTimeLimit(std::chrono::milliseconds limit) {
+    dropSlice();
+    timeLimit = limit;
+    deadline.reset();
+}
+
+void ExecutionBudget::dropSlice() {
+    if (fuelLeft)
+        *fuelLeft += static_cast<std::uint64_t>(std::max<std::int64_t>(sliceRemaining, 0));
+    sliceRemaining = 0;
+}
+
+std::optional<std::uint64_t> ExecutionBudget::getFuelLeft() const {
+    if (!fuelLeft)
+        return std::nullopt;
+    return *fuelLeft + static_cast<std::uint64_t>(std::max<std::int64_t>(sliceRemaining, 0));
+}
+
+// paliwo porcji jest od razu odejmowane od całkowitego limitu
+void ExecutionBudget::startSlice() {
+    if (timeLimit && !deadline)
+        deadline = std::chrono::steady_clock::now() + *timeLimit;
+    auto slice = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+    if (fuelLeft)
+        slice = std::min(slice, *fuelLeft);
+    if (deadline)
+        slice = std::min(slice, static_cast<std::uint64_t>(DEADLINE_CHECK_INTERVAL));
+    if (fuelLeft)
+        *fuelLeft -= slice;
+    sliceRemaining = static_cast<std::int64_t>(slice);
+}
+
+void ExecutionBudget::refill(SourceLocation location) {
+    if (fuelLeft && *fuelLeft == 0) {
+        sliceRemaining = 0;
+        throw MyException("Execution budget exhausted", location);
+    }
+    if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+        sliceRemaining = 0;
+        throw MyException("Execution time limit exceeded", location);
+    }
+    startSlice();
+    // punkt kontrolny, który wywołał uzupełnienie, też zużywa paliwo
+    sliceRemaining--;
+}
@@ -1,5 +1,9 @@
 #include "interpreterVisitor.h"
 #include "myException.h"
+#include "scopeResolver.h"
+#include "lazyBodyLoader.h"
+#include "profiler.h"
+#include "stats.h"
 
 void InterpreterVisitor::visitBoolLiteral(Nodes::BooleanLiteral *booleanLiteral) { currentValue = booleanLiteral->getValue(); }
 
@@ -18,7 +22,40 @@ void InterpreterVisitor::visitCastOp(Nodes::CastOp *castOp) {}
 void InterpreterVisitor::visitType(Nodes::Type *type) {}
 void InterpreterVisitor::visitTypeDecl(Nodes::TypeDecl *typeDecl) {}
 
+// wartość dziecka węzła liczonego przez sterownik; liście (literały, odwołania do zmiennych) liczone są po prostu ponownie
+bool InterpreterVisitor::replayed(Node *node) {
+    auto value = replay.find(node);
+    if (value == nullptr)
+        return false;
+    currentValue = *value;
+    return true;
+}
+
+void InterpreterVisitor::evaluateIteratively(Node *root) {
+    using Value = std::variant<int, float, bool, std::string>;
+    auto step = [this](Node *node, const Traversal::Operand<Value> *first, const Traversal::Operand<Value> *last) {
+        replay = {node, first, last};
+        node->accept(*this);
+        replay = {};
+        return currentValue;
+    };
+    try {
+        currentValue = Traversal::evaluatePostOrder<Value>(root, step);
+    } catch (...) {
+        replay = {};
+        throw;
+    }
+}
+
 void InterpreterVisitor::visitCastingExpr(Nodes::CastingExpr *castingExpr) {
+    if (replayed(castingExpr))
+        return;
+    // każdy poziom nawiasów i łańcucha operatorów przechodzi przez CastingExpr
+    Traversal::DepthGuard depth(expressionDepth);
+    if (depth.exceeded() && !replay.active()) {
+        evaluateIteratively(castingExpr);
+        return;
+    }
     castingExpr->acceptExpr(*this);
     if (castingExpr->getCastOp()) {
         auto op = castingExpr->getCastOp()->getType();
@@ -56,6 +93,8 @@ void InterpreterVisitor::visitCastingExpr(Nodes::CastingExpr *castingExpr) {
 }
 
 void InterpreterVisitor::visitUnaryExpr(Nodes::UnaryExpr *unaryExpr) {
+    if (replayed(unaryExpr))
+        return;
     unaryExpr->acceptExpr(*this);
     if (unaryExpr->getUnaryOp()) {
         auto op = unaryExpr->getUnaryOp()->getType();
@@ -80,6 +119,8 @@ void InterpreterVisitor::visitUnaryExpr(Nodes::UnaryExpr *unaryExpr) {
 }
 
 void InterpreterVisitor::visitMulExpr(Nodes::MulExpr *mulExpr) {
+    if (replayed(mulExpr))
+        return;
     mulExpr->acceptLeft(*this);
     auto left = currentValue;
 
@@ -110,6 +151,8 @@ void InterpreterVisitor::visitMulExpr(Nodes::MulExpr *mulExpr) {
 }
 
 void InterpreterVisitor::visitArtmExpr(Nodes::ArtmExpr *artmExpr) {
+    if (replayed(artmExpr))
+        return;
     artmExpr->acceptLeft(*this);
     auto left = currentValue;
 
@@ -142,6 +185,8 @@ void InterpreterVisitor::visitArtmExpr(Nodes::ArtmExpr *artmExpr) {
 }
 
 void InterpreterVisitor::visitRelExpr(Nodes::RelExpr *relExpr) {
+    if (replayed(relExpr))
+        return;
     relExpr->acceptLeft(*this);
     auto left = currentValue;
 
@@ -174,6 +219,8 @@ void InterpreterVisitor::visitRelExpr(Nodes::RelExpr *relExpr) {
 }
 
 void InterpreterVisitor::visitAndExpr(Nodes::AndExpr *andExpr) {
+    if (replayed(andExpr))
+        return;
     andExpr->acceptLeft(*this);
     auto left = currentValue;
 
@@ -187,6 +234,8 @@ void InterpreterVisitor::visitAndExpr(Nodes::AndExpr *andExpr) {
 }
 
 void InterpreterVisitor::visitOrExpr(Nodes::OrExpr *orExpr) {
+    if (replayed(orExpr))
+        return;
     orExpr->acceptLeft(*this);
     auto left = currentValue;
 
@@ -202,6 +251,8 @@ void InterpreterVisitor::visitOrExpr(Nodes::OrExpr *orExpr) {
 }
 
 void InterpreterVisitor::visitExpr(Nodes::Expression *expression) {
+    if (replayed(expression))
+        return;
     auto prevType = expectedType;
     expectedType=std::nullopt;
     expression->acceptExpr(*this);
@@ -209,50 +260,70 @@ void InterpreterVisitor::visitExpr(Nodes::Expression *expression) {
 }
 
 void InterpreterVisitor::visitFuncCall(Nodes::FunCall *funCall) {
+    if (replayed(funCall))
+        return;
     auto symbol = symbolManager.getSymbol(funCall->getIdentifier(), true);
     auto funArgs = funCall->getArguments();
-    arguments.clear();
+    // argumenty liczone lokalnie - wywołanie w argumencie nadpisałoby 'arguments'
+    std::vector<std::variant<int, float, bool, std::string>> callArgs;
     if (funArgs.has_value()) {
         for (auto &arg : funArgs.value()) {
             arg->accept(*this);
-            arguments.push_back(currentValue);
+            callArgs.push_back(currentValue);
         }
     }
+    arguments = std::move(callArgs);
     auto func = symbol.value().getFuncPointer().value();
+    // ciało funkcji nie jest krokiem sterownika wyrażenia, w którym stoi wywołanie
+    auto suspended = std::exchange(replay, {});
     func->accept(*this);
+    replay = suspended;
 }
 
 void InterpreterVisitor::visitVariableRef(Nodes::VarReference *varReference) {
-    auto symbol = symbolManager.getSymbol(varReference->getIdentifier(), false);
-
-    if(symbol.has_value())
-    {
-        currentValue = symbol.value().getValue().value();
+    auto symbol = lookupVariable(varReference->getIdentifier(), varReference->getSlot());
+    if (symbol == nullptr)
+        throw MyException("Variable " + varReference->getIdentifier() + " not declared", varReference->getPos());
+
+    auto value = symbol->getValue();
+    if (!value.has_value())
+        throw MyException("Variable " + varReference->getIdentifier() + " holds no value", varReference->getPos());
+    // test holding() mógł się zdezaktualizować (przypisanie w pętli, zmiana wariantu globalnego w wywołaniu)
+    if (auto heldType = varReference->getHeldType()) {
+        auto variantInfo = symbol->getVariantInfo();
+        if (variantInfo == nullptr || variantInfo->tag != variantInfo->layout->getTag(*heldType))
+            throw MyException("Variant " + varReference->getIdentifier() + " no longer holds " + VariantLayout::keywordOf(*heldType), varReference->getPos());
     }
-    else
-    {
-        auto type = symbol.value().getType();
-        if (std::holds_alternative<IdType>(type)) {
-            switch (std::get<IdType>(type)) {
-                case IdType::INT:
-                    currentValue.emplace<int>(0);
-                    break;
-                case IdType::FLOAT:
-                    currentValue.emplace<float>(0.0);
-                    break;
-                case IdType::BOOLEAN:
-                    currentValue.emplace<bool>(false);
-                    break;
-                case IdType::STR:
-                    currentValue.emplace<std::string>("");
-                    break;
-                default:
-                    throw MyException("Invalid type of argument in var reference", varReference->getPos());
-            }
-        } else {
-            currentValue = "!!!!";
-        }
+    currentValue = value.value();
+}
+
+void InterpreterVisitor::visitStructFieldRef(Nodes::StructFieldReference *fieldReference) {
+    auto symbol = lookupVariable(fieldReference->getIdentifier(), fieldReference->getSlot());
+    if (symbol == nullptr || !symbol->isStruct())
+        throw MyException("Identifier is not a struct: " + fieldReference->getIdentifier(), fieldReference->getPos());
+    auto structInfo = symbol->getStructInfo();
+
+    auto fieldIndex = fieldReference->getFieldIndex();
+    if (!fieldIndex.has_value())
+        fieldIndex = structInfo->layout->getFieldIndex(fieldReference->getFieldName());
+    if (!fieldIndex.has_value())
+        throw MyException("Field not found in struct: " + fieldReference->getFieldName(), fieldReference->getPos());
+    currentValue = structInfo->values[fieldIndex.value()];
+}
+
+void InterpreterVisitor::visitVariantHolding(Nodes::VariantHolding *variantHolding) {
+    auto symbol = lookupVariable(variantHolding->getIdentifier(), variantHolding->getSlot());
+    if (symbol == nullptr || !symbol->isVariant())
+        throw MyException("Identifier is not a variant: " + variantHolding->getIdentifier(), variantHolding->getPos());
+    auto &variantInfo = *symbol->getVariantInfo();
+    if (variantInfo.tag == VariantLayout::NO_TAG)
+        throw MyException("Variant " + variantHolding->getIdentifier() + " holds no value", variantHolding->getPos());
+    // test znacznika - bez budowania nazwy typu
+    if (auto heldType = variantHolding->getHeldType()) {
+        currentValue = (variantInfo.tag == variantInfo.layout->getTag(*heldType)) != variantHolding->isNegated();
+        return;
     }
+    currentValue = variantInfo.layout->getTypeName(variantInfo.tag);
 }
 
 void InterpreterVisitor::visitDeclaration(Nodes::Declaration *declaration) {}
@@ -276,15 +347,15 @@ void InterpreterVisitor::visitVariableDeclaration(Nodes::VariableDeclaration *va
         default:
             throw MyException("Invalid type of argument in var declaration", variableDeclaration->getPos());
     }
-    symbolManager.insertSymbol(variableDeclaration->getIdentifier(), SymbolInfo(variableDeclaration->getIdentifier(), varType, false, variableDeclaration->isMutable(), true, std::nullopt));
 
     if (variableDeclaration->getInitExpr()) {
         auto prevExpectedType = expectedType;
         expectedType = varType;
         variableDeclaration->acceptInitExpr(*this);
-        symbolManager.setValue(variableDeclaration->getIdentifier(), currentValue);
+        value = std::move(currentValue);
         expectedType = prevExpectedType;
     }
+    declareVariable(variableDeclaration->getSlot(), SymbolInfo(variableDeclaration->getIdentifier(), varType, false, variableDeclaration->isMutable(), true, value));
 }
 
 void InterpreterVisitor::visitStructTypeDefinition(Nodes::StructTypeDefinition *structTypeDefinition) {}
@@ -295,19 +366,16 @@ void InterpreterVisitor::visitStructVarDeclaration(Nodes::StructVarDeclaration *
     bool isMutable = structVarDeclaration->isMutable();
 
     auto structValues = structVarDeclaration->getArgs();
-    auto &structAgrTypes = structTypes.at(structTypeName)->getFields();
-    std::map<std::string, StructFieldInfo> structInstanceFields;
+    auto &layout = structTypes.at(structTypeName)->getLayout();
+    auto structInfo = std::make_shared<StructInfo>(layout);
     for (int i = 0; i < structValues.size(); i++) {
-        auto fieldType = std::get<IdType>(structAgrTypes[i]->getType()->getIdType());
         auto prevExpectedType = expectedType;
-        expectedType = fieldType;
+        expectedType = layout->getField(i).type;
         structValues[i]->accept(*this);
-        structInstanceFields.insert(std::make_pair(structAgrTypes[i]->getIdentifier(), StructFieldInfo(fieldType, currentValue)));
+        structInfo->values[i] = currentValue;
         expectedType = prevExpectedType;
     }
-    auto structInfo = std::make_shared<StructInfo>(structInstanceFields);
-    SymbolInfo structVarSymbol(varName, structInfo, false, isMutable, false, std::nullopt);
-    symbolManager.insertSymbol(varName, structVarSymbol);
+    declareVariable(structVarDeclaration->getSlot(), SymbolInfo(varName, structInfo, false, isMutable, false, std::nullopt));
 }
 
 
@@ -331,36 +399,65 @@ void InterpreterVisitor::visitVariantTypeDefinition(Nodes::VariantTypeDefinition
 void InterpreterVisitor::visitVariantVarDeclaration(Nodes::VariantVarDeclaration *variantVarDeclaration) {
     std::string varName = variantVarDeclaration->getIdentifier();
     std::string variantTypeName = variantVarDeclaration->getTypeName();
-    auto &variantArgs = variantTypes.at(variantTypeName)->getFields();
     auto value = variantVarDeclaration->getValue();
+    SymbolInfo variantVarSymbol(varName, variantTypeName, false, true, false, std::nullopt);
+    variantVarSymbol.setVariantLayout(variantTypes.at(variantTypeName)->getLayout());
     if (value) {
+        auto prevExpectedType = expectedType;
+        expectedType = std::nullopt;
         value->acceptExpr(*this);
+        expectedType = prevExpectedType;
+        variantVarSymbol.setValue(currentValue);
     }
-    SymbolInfo variantVarSymbol(varName, variantTypeName, false, true, false, currentValue);
-    symbolManager.insertSymbol(varName, variantVarSymbol);
+    declareVariable(variantVarDeclaration->getSlot(), std::move(variantVarSymbol));
 }
 
 void InterpreterVisitor::visitAssignment(Nodes::Assignment *assignment) {
     if(returned)
         return;
 
-    auto symbol = symbolManager.getSymbol(assignment->getIdentifier(), false);
+    auto symbol = lookupVariable(assignment->getIdentifier(), assignment->getSlot());
+    if (symbol == nullptr)
+        throw MyException("Undefined Variable:" + assignment->getIdentifier(), assignment->getPos());
     auto prevExpectedType = expectedType;
-    auto symbval = symbol.value();
-    //expectedType = symbol.value().getType();
-    expectedType = symbval.getType();
+    if (symbol->isVariant())
+        expectedType = std::nullopt;
+    else
+        expectedType = symbol->getType();
 
     assignment->acceptExpr(*this);
-    symbol.value().setValue(currentValue);
-    symbolManager.setValue(assignment->getIdentifier(), currentValue);
+    // wywołanie funkcji w wyrażeniu mogło przenieść stos ramek - szukamy symbolu ponownie
+    symbol = lookupVariable(assignment->getIdentifier(), assignment->getSlot());
+    symbol->setValue(currentValue);
 
-    if (symbolManager.isGlobal(assignment->getIdentifier()))
+    if (!assignment->getSlot().has_value())
         variables[assignment->getIdentifier()] = currentValue;
 
     expectedType = prevExpectedType;
 }
 
-void InterpreterVisitor::visitStructFieldAssignment(Nodes::StructFieldAssignment *structFieldAssignment) {}
+void InterpreterVisitor::visitStructFieldAssignment(Nodes::StructFieldAssignment *structFieldAssignment) {
+    if(returned)
+        return;
+
+    // instancja modyfikowana w miejscu - bez kopiowania SymbolInfo
+    auto symbol = lookupVariable(structFieldAssignment->getIdentifier(), structFieldAssignment->getSlot());
+    if (symbol == nullptr || !symbol->isStruct())
+        throw MyException("Identifier is not a struct: " + structFieldAssignment->getIdentifier(), structFieldAssignment->getPos());
+    auto &structInfo = *symbol->getStructInfo();
+
+    auto fieldIndex = structFieldAssignment->getFieldIndex();
+    if (!fieldIndex.has_value())
+        fieldIndex = structInfo.layout->getFieldIndex(structFieldAssignment->getFieldName());
+    if (!fieldIndex.has_value())
+        throw MyException("Field not found in struct: " + structFieldAssignment->getFieldName(), structFieldAssignment->getPos());
+
+    auto prevExpectedType = expectedType;
+    expectedType = structInfo.layout->getField(fieldIndex.value()).type;
+    structFieldAssignment->getExpression()->accept(*this);
+    structInfo.values[fieldIndex.value()] = std::move(currentValue);
+    expectedType = prevExpectedType;
+}
 
 void InterpreterVisitor::visitReturnStatement(Nodes::ReturnStatement *returnStatement) {
     if(returned)
@@ -369,82 +466,70 @@ void InterpreterVisitor::visitReturnStatement(Nodes::ReturnStatement *returnStat
     returned = true;
 }
 
+// zakresy rozwiązane statycznie przez ScopeResolver - blok nie tworzy tablicy symboli
 void InterpreterVisitor::visitBlock(Nodes::Block *block) {
-    symbolManager.enterNewScope();
-    block->acceptStatements(*this);
-    symbolManager.leaveScope();
+    runBlock(block, nullptr);
 }
 
-void InterpreterVisitor::visitIfStatement(Nodes::IfStatement *ifStatement) {
-    if(returned)
-        return;
+// Bloki zagnieżdżone w if/while wykonywane w pętli BlockStack::run - głębokość zagnieżdżenia nie
+// zagłębia rekurencji. Ciało pętli powtarzane jest przy wyjściu z bloku, dopóki warunek jest spełniony.
+void InterpreterVisitor::runBlock(Nodes::Block *block, Nodes::WhileStatement *loop) {
+    blocks.run(block, loop,
+               [](Nodes::Block*, Nodes::WhileStatement*) {},
+               [this](Node* statement) {
+                   if (profiler)
+                       profiler->setLine(statement->getLocation());
+                   TKOM_STATS_INC(STATEMENTS);
+                   statement->accept(*this);
+                   return !returned;
+               },
+               [this](Nodes::Block*, Nodes::WhileStatement* whileStatement) {
+                   if (!whileStatement)
+                       return false;
+                   budget.consume(whileStatement->getLocation());
+                   return conditionHolds(whileStatement->getCondition(), whileStatement->getLocation());
+               });
+}
+
+void InterpreterVisitor::acceptBlock(Nodes::Block *block, Nodes::WhileStatement *loop) {
+    if (blocks.active())
+        blocks.push(block, loop);
+    else
+        runBlock(block, loop);
+}
 
+bool InterpreterVisitor::conditionHolds(Nodes::Expression *condition, SourceLocation pos) {
     auto prevExpectedType = expectedType;
     expectedType = std::nullopt;
-    ifStatement->acceptCondition(*this);
-
-    if(std::holds_alternative<bool>(currentValue)) {
-        auto cond = std::get<bool>(currentValue);
-        if(cond)
-            ifStatement->acceptIfBlock(*this);
-        if(ifStatement->getElseBlock() && cond == 0)
-            ifStatement->acceptElseBlock(*this);
-    }
-    else if (std::holds_alternative<int>(currentValue)) {
-        auto cond = std::get<int>(currentValue);
-        if(cond)
-            ifStatement->acceptIfBlock(*this);
-        if(ifStatement->getElseBlock() && cond == 0)
-            ifStatement->acceptElseBlock(*this);
-    }
-    else if (std::holds_alternative<float>(currentValue)) {
-        auto cond = std::get<float>(currentValue);
-        if(cond != 0.0)
-            ifStatement->acceptIfBlock(*this);
-        if(ifStatement->getElseBlock() && cond == 0.0)
-            ifStatement->acceptElseBlock(*this);
-    }
-    else // string
-        throw MyException("Invalid type of condition", ifStatement->getPos());
-
+    condition->accept(*this);
     expectedType = prevExpectedType;
+
+    if (std::holds_alternative<bool>(currentValue))
+        return std::get<bool>(currentValue);
+    if (std::holds_alternative<int>(currentValue))
+        return std::get<int>(currentValue) != 0;
+    if (std::holds_alternative<float>(currentValue))
+        return std::get<float>(currentValue) != 0.0;
+    // string
+    throw MyException("Invalid type of condition", pos);
+}
+
+void InterpreterVisitor::visitIfStatement(Nodes::IfStatement *ifStatement) {
+    if(returned)
+        return;
+
+    if (conditionHolds(ifStatement->getCondition(), ifStatement->getLocation()))
+        acceptBlock(ifStatement->getIfBlock(), nullptr);
+    else if (ifStatement->getElseBlock())
+        acceptBlock(ifStatement->getElseBlock(), nullptr);
 }
 
 void InterpreterVisitor::visitWhileStatement(Nodes::WhileStatement *whileStatement) {
     if(returned)
         return;
 
-    auto prevExpectedType = expectedType;
-    expectedType = std::nullopt;
-    whileStatement->acceptCondition(*this);
-
-    if (std::holds_alternative<bool>(currentValue)){
-        bool cond = std::get<bool>(currentValue);
-        while (cond){
-            whileStatement->acceptWhileBlock(*this);
-            whileStatement->acceptCondition(*this);
-            cond = std::get<bool>(currentValue);
-        }
-    }
-    else if (std::holds_alternative<int>(currentValue)){
-        int cond = std::get<int>(currentValue);
-        while (cond){
-            whileStatement->acceptWhileBlock(*this);
-            whileStatement->acceptCondition(*this);
-            cond = std::get<int>(currentValue);
-        }
-    }
-    else if (std::holds_alternative<float>(currentValue)){
-        float cond = std::get<float>(currentValue);
-        while (cond){
-            whileStatement->acceptWhileBlock(*this);
-            whileStatement->acceptCondition(*this);
-            cond = std::get<float>(currentValue);
-        }
-    }
-    else // string
-        throw MyException("Invalid type of condition", whileStatement->getPos());
-    expectedType = prevExpectedType;
+    if (conditionHolds(whileStatement->getCondition(), whileStatement->getLocation()))
+        acceptBlock(whileStatement->getBlock(), whileStatement);
 }
 
 void InterpreterVisitor::visitFunctionCallStatement(Nodes::FunctionCallStatement *functionCallStatement) {
@@ -456,45 +541,50 @@ void InterpreterVisitor::visitFunctionCallStatement(Nodes::FunctionCallStatement
             for (auto &arg: functionCallStatement->getArguments()) {
                 arg->accept(*this);
                 if (std::holds_alternative<int>(currentValue))
-                    std::cout << std::get<int>(currentValue);
+                    *output << std::get<int>(currentValue);
                 else if (std::holds_alternative<float>(currentValue))
-                    std::cout << std::get<float>(currentValue);
+                    *output << std::get<float>(currentValue);
                 else if (std::holds_alternative<bool>(currentValue))
-                    std::cout << std::get<bool>(currentValue);
+                    *output << std::get<bool>(currentValue);
                 else if (std::holds_alternative<std::string>(currentValue))
-                    std::cout << std::get<std::string>(currentValue);
+                    *output << std::get<std::string>(currentValue);
                 else
                     throw MyException("Invalid type of argument in function call stmt", functionCallStatement->getPos());
             }
         } else
-            std::cout << std::endl;
+            *output << std::endl;
         return;
     }
 
     auto &calledArgs = functionCallStatement->getArguments();
-    arguments.clear();
+    std::vector<std::variant<int, float, bool, std::string>> callArgs;
     for (auto &arg : calledArgs) {
         arg->accept(*this);
-        arguments.push_back(currentValue);
+        callArgs.push_back(currentValue);
     }
+    arguments = std::move(callArgs);
 
     symbol.value().getFuncPointer().value()->accept(*this);
 }
 
 void InterpreterVisitor::visitFunctionDeclaration(Nodes::FunctionDeclaration *functionDeclaration) {
-    auto funReturnType = functionDeclaration->getReturnType()->getType()->getIdType();
-    std::variant<IdType, std::string, std::shared_ptr<StructInfo>> typeVariant;
-    if (std::holds_alternative<IdType>(funReturnType)) {
-        typeVariant = std::get<IdType>(funReturnType);
-    } else {
-        typeVariant = std::get<std::string>(funReturnType);
+    if (!functionDeclaration->isBodyParsed()) {
+        if (lazyBodies == nullptr)
+            throw MyException("Body of function " + functionDeclaration->getFunctionName() + " was not parsed", functionDeclaration->getPos());
+        lazyBodies->load(functionDeclaration);
     }
-    symbolManager.insertSymbol(functionDeclaration->getFunctionName(), SymbolInfo(functionDeclaration->getFunctionName(), typeVariant, true, false, false, functionDeclaration));
-
     auto prevType = expectedType;
     expectedType = functionDeclaration->getReturnType()->getType()->getIdType();
-    symbolManager.enterNewContext();
-    symbolManager.enterNewScope();
+
+    // jedna ramka na wywołanie, o rozmiarze policzonym przez ScopeResolver
+    auto prevFrameBase = frameBase;
+    auto callArgs = std::move(arguments);
+    frameBase = frames.size();
+    frames.resize(frameBase + functionDeclaration->getFrameSize());
+    TKOM_STATS_INC(FUNCTION_CALLS);
+    budget.consume(functionDeclaration->getLocation());
+    if (profiler)
+        profiler->enterFunction(functionDeclaration, functionDeclaration->getLocation());
 
     if (functionDeclaration->getParameters().has_value())
     {
@@ -504,12 +594,13 @@ void InterpreterVisitor::visitFunctionDeclaration(Nodes::FunctionDeclaration *fu
             auto &param = parameters[i];
             auto paramType = param->getType()->getIdType();
             std::variant<IdType, std::string, std::shared_ptr<StructInfo>> type;
-            if (std::holds_alternative<IdType>(paramType)) {
+            bool isSimple = std::holds_alternative<IdType>(paramType);
+            if (isSimple) {
                 type = std::get<IdType>(paramType);
             } else {
                 type = std::get<std::string>(paramType);
             }
-            symbolManager.insertSymbol(param->getIdentifier(), SymbolInfo(param->getIdentifier(), type, false, true, false, arguments[i]));
+            frames[frameBase + i].emplace(param->getIdentifier(), type, false, true, isSimple, callArgs[i]);
         }
     }
 
@@ -517,17 +608,61 @@ void InterpreterVisitor::visitFunctionDeclaration(Nodes::FunctionDeclaration *fu
     if (returned)
         returned = false;
 
-    symbolManager.leaveContext();
+    if (profiler)
+        profiler->leaveFunction();
+    frames.resize(frameBase);
+    frameBase = prevFrameBase;
     expectedType = prevType;
 }
 
+// wejścia nadpisują wartości początkowe zmiennych globalnych prostego typu lub wariantu
+void InterpreterVisitor::applyInputs() {
+    for (const auto& [name, value] : inputs) {
+        SymbolInfo* symbol = symbolManager.findSymbol(name);
+        if (symbol == nullptr || symbol->isFun() || symbol->isStruct())
+            throw MyException("Input '" + name + "' is not a global variable");
+        bool matches;
+        if (symbol->isVariant())
+            matches = symbol->getVariantInfo()->layout->getTagForValue(value) != VariantLayout::NO_TAG;
+        else
+            matches = VariantLayout::valueIndexOf(std::get<IdType>(symbol->getType())) == value.index();
+        if (!matches)
+            throw MyException("Input '" + name + "' does not match type " + symbol->getTypeAsString());
+        auto newValue = value;
+        symbol->setValue(newValue);
+    }
+}
+
+void InterpreterVisitor::reset() {
+    symbolManager = SymbolTableManager();
+    expectedType.reset();
+    currentValue = 0;
+    arguments.clear();
+    variables.clear();
+    frames.clear();
+    frameBase = 0;
+    inputs.clear();
+    returned = false;
+    expressionDepth = 0;
+    replay = {};
+    blocks.clear();
+}
+
 void InterpreterVisitor::visitProgram(Nodes::Program *program) {
+    // jedyna modyfikacja drzewa w czasie wykonania; programy współdzielone między wątkami
+    // (CompiledProgram) mają zasięgi rozwiązane przy kompilacji
+    if (!program->areScopesResolved()) {
+        ScopeResolver scopeResolver;
+        program->accept(scopeResolver);
+    }
+
     symbolManager.enterNewContext();
     symbolManager.enterNewScope();
 
     for (const auto& var : program->getVariables()){
         var.second->accept(*this);
     }
+    applyInputs();
 
     for (const auto& func : program->getFunctions()){
         auto returnType = func.second->getReturnType()->getType()->getIdType();
@@ -544,6 +679,23 @@ void InterpreterVisitor::visitProgram(Nodes::Program *program) {
     symbolManager.leaveContext();
 }
 
+SymbolInfo *InterpreterVisitor::lookupVariable(const std::string &identifier, std::optional<std::size_t> slot) {
+    if (!slot.has_value())
+        return symbolManager.findSymbol(identifier);
+    TKOM_STATS_INC(SYMBOL_LOOKUPS);
+    auto &frameSlot = frames[frameBase + slot.value()];
+    return frameSlot.has_value() ? &frameSlot.value() : nullptr;
+}
+
+void InterpreterVisitor::declareVariable(std::optional<std::size_t> slot, SymbolInfo symbol) {
+    if (!slot.has_value()) {
+        auto identifier = symbol.getIdentifier();
+        symbolManager.insertSymbol(identifier, symbol);
+        return;
+    }
+    frames[frameBase + slot.value()] = std::move(symbol);
+}
+
 bool InterpreterVisitor::valueToBool(std::variant<int, float, bool, std::string> variant) {
     return std::visit([](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
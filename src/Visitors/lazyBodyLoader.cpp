@@ -0,0 +1,31 @@
+#include "lazyBodyLoader.h"
+
+#include "parser.h"
+#include "scopeResolver.h"
+
+LazyBodyLoader::LazyBodyLoader(Nodes::Program &program)
+        : semanticVisitor(program.getStructTypes(), program.getVariantTypes()) {
+    semanticVisitor.declareGlobals(&program);
+}
+
+void LazyBodyLoader::loadLocked(Nodes::FunctionDeclaration *function) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // inny wątek mógł załadować ciało, zanim dostaliśmy blokadę
+    if (function->isBodyParsed())
+        return;
+    auto failure = failures.find(function);
+    if (failure != failures.end())
+        throw failure->second;
+
+    try {
+        function->attachBody(Parser::parseLazyBody(function->getLazyBody()));
+        semanticVisitor.checkFunction(function->getFunctionName(), function);
+    } catch (MyException& e) {
+        function->attachBody(nullptr);
+        failures.emplace(function, e);
+        throw;
+    }
+    ScopeResolver scopeResolver;
+    function->accept(scopeResolver);
+    function->publishBody();
+}
@@ -0,0 +1,50 @@
+#include "nodeCounter.h"
+#include "traversal.h"
+
+void NodeCounter::visitBoolLiteral(Nodes::BooleanLiteral *) { count("BooleanLiteral"); }
+void NodeCounter::visitIntLiteral(Nodes::IntLiteral *) { count("IntLiteral"); }
+void NodeCounter::visitFloatLiteral(Nodes::FloatLiteral *) { count("FloatLiteral"); }
+void NodeCounter::visitStringLiteral(Nodes::StringLiteral *) { count("StringLiteral"); }
+void NodeCounter::visitIdentifier(Nodes::Identifier *) { count("Identifier"); }
+void NodeCounter::visitRelOp(Nodes::RelOp *) { count("RelOp"); }
+void NodeCounter::visitArtmOp(Nodes::ArtmOp *) { count("ArtmOp"); }
+void NodeCounter::visitFactorOp(Nodes::FactorOp *) { count("FactorOp"); }
+void NodeCounter::visitUnaryOp(Nodes::UnaryOp *) { count("UnaryOp"); }
+void NodeCounter::visitCastOp(Nodes::CastOp *) { count("CastOp"); }
+void NodeCounter::visitDeclaration(Nodes::Declaration *) { count("Declaration"); }
+void NodeCounter::visitType(Nodes::Type *) { count("Type"); }
+void NodeCounter::visitCastingExpr(Nodes::CastingExpr *) { count("CastingExpr"); }
+void NodeCounter::visitUnaryExpr(Nodes::UnaryExpr *) { count("UnaryExpr"); }
+void NodeCounter::visitMulExpr(Nodes::MulExpr *) { count("MulExpr"); }
+void NodeCounter::visitArtmExpr(Nodes::ArtmExpr *) { count("ArtmExpr"); }
+void NodeCounter::visitRelExpr(Nodes::RelExpr *) { count("RelExpr"); }
+void NodeCounter::visitAndExpr(Nodes::AndExpr *) { count("AndExpr"); }
+void NodeCounter::visitOrExpr(Nodes::OrExpr *) { count("OrExpr"); }
+void NodeCounter::visitExpr(Nodes::Expression *) { count("Expression"); }
+void NodeCounter::visitFuncCall(Nodes::FunCall *) { count("FunCall"); }
+void NodeCounter::visitVariableRef(Nodes::VarReference *) { count("VarReference"); }
+void NodeCounter::visitStructFieldRef(Nodes::StructFieldReference *) { count("StructFieldReference"); }
+void NodeCounter::visitVariantHolding(Nodes::VariantHolding *) { count("VariantHolding"); }
+void NodeCounter::visitTypeDecl(Nodes::TypeDecl *) { count("TypeDecl"); }
+void NodeCounter::visitVariableDeclaration(Nodes::VariableDeclaration *) { count("VariableDeclaration"); }
+void NodeCounter::visitStructTypeDefinition(Nodes::StructTypeDefinition *) { count("StructTypeDefinition"); }
+void NodeCounter::visitStructVarDeclaration(Nodes::StructVarDeclaration *) { count("StructVarDeclaration"); }
+void NodeCounter::visitVariantTypeDefinition(Nodes::VariantTypeDefinition *) { count("VariantTypeDefinition"); }
+void NodeCounter::visitVariantVarDeclaration(Nodes::VariantVarDeclaration *) { count("VariantVarDeclaration"); }
+void NodeCounter::visitAssignment(Nodes::Assignment *) { count("Assignment"); }
+void NodeCounter::visitStructFieldAssignment(Nodes::StructFieldAssignment *) { count("StructFieldAssignment"); }
+void NodeCounter::visitReturnStatement(Nodes::ReturnStatement *) { count("ReturnStatement"); }
+void NodeCounter::visitBlock(Nodes::Block *) { count("Block"); }
+void NodeCounter::visitIfStatement(Nodes::IfStatement *) { count("IfStatement"); }
+void NodeCounter::visitWhileStatement(Nodes::WhileStatement *) { count("WhileStatement"); }
+void NodeCounter::visitFunctionCallStatement(Nodes::FunctionCallStatement *) { count("FunctionCallStatement"); }
+void NodeCounter::visitFunctionDeclaration(Nodes::FunctionDeclaration *) { count("FunctionDeclaration"); }
+
+// visit* tylko liczą, drzewo przechodzi iterator - głęboko zagnieżdżony program nie wyczerpie stosu;
+// metoda dla węzła wybierana switchem po rodzaju (VisitorTemplate::visit), a nie przez accept
+void NodeCounter::visitProgram(Nodes::Program *program) {
+    count("Program");
+    for (auto node : Traversal::PreOrder(program))
+        if (node != program)
+            visit(node);
+}
@@ -85,6 +85,14 @@ void ParserVisitor::visitVariableRef(Nodes::VarReference *) {
 
 }
 
+void ParserVisitor::visitStructFieldRef(Nodes::StructFieldReference *) {
+
+}
+
+void ParserVisitor::visitVariantHolding(Nodes::VariantHolding *) {
+
+}
+
 void ParserVisitor::visitDeclaration(Nodes::Declaration *) {
 
 }
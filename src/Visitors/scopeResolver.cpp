@@ -0,0 +1,219 @@
+#include "scopeResolver.h"
+
+std::optional<std::size_t> ScopeResolver::resolve(const std::string &identifier) const {
+    for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+        auto found = it->find(identifier);
+        if (found != it->end())
+            return found->second;
+    }
+    // nie znaleziono lokalnie - zmienna globalna
+    return std::nullopt;
+}
+
+std::optional<std::size_t> ScopeResolver::declare(const std::string &identifier) {
+    // deklaracja poza funkcją - zmienna globalna
+    if (scopes.empty())
+        return std::nullopt;
+    std::size_t slot = nextSlot++;
+    frameSize = std::max(frameSize, nextSlot);
+    scopes.back()[identifier] = slot;
+    return slot;
+}
+
+// Zakresy otwierane i zamykane na jawnym stosie Traversal::walk - zagnieżdżenie wyrażeń i bloków
+// nie zagłębia rekurencji visit*. Odwołania rozwiązywane przy wejściu do węzła, deklaracje przy
+// wyjściu, więc inicjalizator widzi jeszcze zmienną z zakresu zewnętrznego.
+void ScopeResolver::resolveTree(Node *root) {
+    Traversal::walk(root, [this](Node *node) { enter(node); }, [this](Node *node) { leave(node); });
+}
+
+template<typename T>
+void ScopeResolver::resolveSlot(T *node) {
+    if (auto slot = resolve(node->getIdentifier()))
+        node->setSlot(slot.value());
+}
+
+template<typename T>
+void ScopeResolver::declareSlot(T *node) {
+    if (auto slot = declare(node->getIdentifier()))
+        node->setSlot(slot.value());
+}
+
+void ScopeResolver::enter(Node *node) {
+    switch (node->getKind()) {
+        case NodeKind::BLOCK:
+            blockSlots.push_back(nextSlot);
+            scopes.emplace_back();
+            break;
+        case NodeKind::VAR_REFERENCE:
+            resolveSlot(static_cast<Nodes::VarReference*>(node));
+            break;
+        case NodeKind::STRUCT_FIELD_REFERENCE:
+            resolveSlot(static_cast<Nodes::StructFieldReference*>(node));
+            break;
+        case NodeKind::VARIANT_HOLDING:
+            resolveSlot(static_cast<Nodes::VariantHolding*>(node));
+            break;
+        case NodeKind::ASSIGNMENT:
+            resolveSlot(static_cast<Nodes::Assignment*>(node));
+            break;
+        case NodeKind::STRUCT_FIELD_ASSIGNMENT:
+            resolveSlot(static_cast<Nodes::StructFieldAssignment*>(node));
+            break;
+        default:
+            break;
+    }
+}
+
+void ScopeResolver::leave(Node *node) {
+    switch (node->getKind()) {
+        case NodeKind::BLOCK:
+            scopes.pop_back();
+            nextSlot = blockSlots.back();
+            blockSlots.pop_back();
+            break;
+        case NodeKind::VARIABLE_DECLARATION:
+            declareSlot(static_cast<Nodes::VariableDeclaration*>(node));
+            break;
+        case NodeKind::STRUCT_VAR_DECLARATION:
+            declareSlot(static_cast<Nodes::StructVarDeclaration*>(node));
+            break;
+        case NodeKind::VARIANT_VAR_DECLARATION:
+            declareSlot(static_cast<Nodes::VariantVarDeclaration*>(node));
+            break;
+        default:
+            break;
+    }
+}
+
+void ScopeResolver::visitBoolLiteral(Nodes::BooleanLiteral *) {}
+void ScopeResolver::visitIntLiteral(Nodes::IntLiteral *) {}
+void ScopeResolver::visitFloatLiteral(Nodes::FloatLiteral *) {}
+void ScopeResolver::visitStringLiteral(Nodes::StringLiteral *) {}
+void ScopeResolver::visitIdentifier(Nodes::Identifier *) {}
+void ScopeResolver::visitRelOp(Nodes::RelOp *) {}
+void ScopeResolver::visitArtmOp(Nodes::ArtmOp *) {}
+void ScopeResolver::visitFactorOp(Nodes::FactorOp *) {}
+void ScopeResolver::visitUnaryOp(Nodes::UnaryOp *) {}
+void ScopeResolver::visitCastOp(Nodes::CastOp *) {}
+void ScopeResolver::visitDeclaration(Nodes::Declaration *) {}
+void ScopeResolver::visitType(Nodes::Type *) {}
+void ScopeResolver::visitTypeDecl(Nodes::TypeDecl *) {}
+void ScopeResolver::visitStructTypeDefinition(Nodes::StructTypeDefinition *) {}
+void ScopeResolver::visitVariantTypeDefinition(Nodes::VariantTypeDefinition *) {}
+
+void ScopeResolver::visitCastingExpr(Nodes::CastingExpr *castingExpr) {
+    resolveTree(castingExpr);
+}
+
+void ScopeResolver::visitUnaryExpr(Nodes::UnaryExpr *unaryExpr) {
+    resolveTree(unaryExpr);
+}
+
+void ScopeResolver::visitMulExpr(Nodes::MulExpr *mulExpr) {
+    resolveTree(mulExpr);
+}
+
+void ScopeResolver::visitArtmExpr(Nodes::ArtmExpr *artmExpr) {
+    resolveTree(artmExpr);
+}
+
+void ScopeResolver::visitRelExpr(Nodes::RelExpr *relExpr) {
+    resolveTree(relExpr);
+}
+
+void ScopeResolver::visitAndExpr(Nodes::AndExpr *andExpr) {
+    resolveTree(andExpr);
+}
+
+void ScopeResolver::visitOrExpr(Nodes::OrExpr *orExpr) {
+    resolveTree(orExpr);
+}
+
+void ScopeResolver::visitExpr(Nodes::Expression *expression) {
+    resolveTree(expression);
+}
+
+void ScopeResolver::visitFuncCall(Nodes::FunCall *funCall) {
+    resolveTree(funCall);
+}
+
+void ScopeResolver::visitVariableRef(Nodes::VarReference *varReference) {
+    resolveTree(varReference);
+}
+
+void ScopeResolver::visitStructFieldRef(Nodes::StructFieldReference *fieldReference) {
+    resolveTree(fieldReference);
+}
+
+void ScopeResolver::visitVariantHolding(Nodes::VariantHolding *variantHolding) {
+    resolveTree(variantHolding);
+}
+
+void ScopeResolver::visitVariableDeclaration(Nodes::VariableDeclaration *variableDeclaration) {
+    resolveTree(variableDeclaration);
+}
+
+void ScopeResolver::visitStructVarDeclaration(Nodes::StructVarDeclaration *structVarDeclaration) {
+    resolveTree(structVarDeclaration);
+}
+
+void ScopeResolver::visitVariantVarDeclaration(Nodes::VariantVarDeclaration *variantVarDeclaration) {
+    resolveTree(variantVarDeclaration);
+}
+
+void ScopeResolver::visitAssignment(Nodes::Assignment *assignment) {
+    resolveTree(assignment);
+}
+
+void ScopeResolver::visitStructFieldAssignment(Nodes::StructFieldAssignment *structFieldAssignment) {
+    resolveTree(structFieldAssignment);
+}
+
+void ScopeResolver::visitReturnStatement(Nodes::ReturnStatement *returnStatement) {
+    resolveTree(returnStatement);
+}
+
+void ScopeResolver::visitBlock(Nodes::Block *block) {
+    resolveTree(block);
+}
+
+void ScopeResolver::visitIfStatement(Nodes::IfStatement *ifStatement) {
+    resolveTree(ifStatement);
+}
+
+void ScopeResolver::visitWhileStatement(Nodes::WhileStatement *whileStatement) {
+    resolveTree(whileStatement);
+}
+
+void ScopeResolver::visitFunctionCallStatement(Nodes::FunctionCallStatement *functionCallStatement) {
+    resolveTree(functionCallStatement);
+}
+
+void ScopeResolver::visitFunctionDeclaration(Nodes::FunctionDeclaration *functionDeclaration) {
+    scopes.clear();
+    blockSlots.clear();
+    scopes.emplace_back();
+    nextSlot = 0;
+    frameSize = 0;
+
+    // parametry zajmują pierwsze sloty ramki, w kolejności deklaracji
+    auto parameters = functionDeclaration->getParameters();
+    if (parameters.has_value())
+        for (auto param : parameters.value())
+            declare(param->getIdentifier());
+
+    if (auto block = functionDeclaration->getBlock())
+        resolveTree(block);
+    functionDeclaration->setFrameSize(frameSize);
+    scopes.clear();
+}
+
+void ScopeResolver::visitProgram(Nodes::Program *program) {
+    for (const auto &var : program->getVariables())
+        var.second->accept(*this);
+
+    for (const auto &func : program->getFunctions())
+        func.second->accept(*this);
+    program->markScopesResolved();
+}
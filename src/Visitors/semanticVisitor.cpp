@@ -1,5 +1,78 @@
+#include <algorithm>
+#include <atomic>
 #include <set>
 #include "semanticVisitor.h"
+#include "workStealingPool.h"
+
+namespace {
+    // v.holding() == T / != T jako cały warunek (także w nawiasach); nullptr dla innych warunków
+    const Nodes::VariantHolding* tagTestOf(const Nodes::Factor* condition) {
+        const Nodes::Factor* node = condition;
+        while (node) {
+            switch (node->getKind()) {
+                case NodeKind::EXPRESSION:
+                    node = static_cast<const Nodes::Expression*>(node)->getExpression();
+                    break;
+                case NodeKind::OR_EXPR: {
+                    auto orExpr = static_cast<const Nodes::OrExpr*>(node);
+                    if (orExpr->getRightOperand())
+                        return nullptr;
+                    node = orExpr->getLeftOperand();
+                    break;
+                }
+                case NodeKind::AND_EXPR: {
+                    auto andExpr = static_cast<const Nodes::AndExpr*>(node);
+                    if (andExpr->getRightOperand())
+                        return nullptr;
+                    node = andExpr->getLeftOperand();
+                    break;
+                }
+                case NodeKind::REL_EXPR: {
+                    auto relExpr = static_cast<const Nodes::RelExpr*>(node);
+                    if (relExpr->getRightOperand())
+                        return nullptr;
+                    node = relExpr->getLeftOperand();
+                    break;
+                }
+                case NodeKind::ARTM_EXPR: {
+                    auto artmExpr = static_cast<const Nodes::ArtmExpr*>(node);
+                    if (artmExpr->getRightOperand())
+                        return nullptr;
+                    node = artmExpr->getLeftOperand();
+                    break;
+                }
+                case NodeKind::MUL_EXPR: {
+                    auto mulExpr = static_cast<const Nodes::MulExpr*>(node);
+                    if (mulExpr->getRightOperand())
+                        return nullptr;
+                    node = mulExpr->getLeftOperand();
+                    break;
+                }
+                case NodeKind::UNARY_EXPR: {
+                    auto unaryExpr = static_cast<const Nodes::UnaryExpr*>(node);
+                    if (unaryExpr->getUnaryOp())
+                        return nullptr;
+                    node = unaryExpr->getExpression();
+                    break;
+                }
+                case NodeKind::CASTING_EXPR: {
+                    auto castingExpr = static_cast<const Nodes::CastingExpr*>(node);
+                    if (castingExpr->getCastOp())
+                        return nullptr;
+                    node = castingExpr->getExpression();
+                    break;
+                }
+                case NodeKind::VARIANT_HOLDING: {
+                    auto holding = static_cast<const Nodes::VariantHolding*>(node);
+                    return holding->getHeldType() ? holding : nullptr;
+                }
+                default:
+                    return nullptr;
+            }
+        }
+        return nullptr;
+    }
+}
 
 void SemanticVisitor::visitBoolLiteral(Nodes::BooleanLiteral *literal) {
     lastEvaluatedType = IdType::BOOLEAN;
@@ -45,14 +118,14 @@ void SemanticVisitor::visitStringLiteral(Nodes::StringLiteral *literal) {
 void SemanticVisitor::visitIdentifier(Nodes::Identifier *identifier) {
     // zmienna
     auto symbol = symbolManager.getSymbol(identifier->getName(), false);
-    if (symbol.has_value())
+    if (symbol.has_value() && std::holds_alternative<IdType>(symbol.value().getType()))
     {
         lastEvaluatedType = std::get<IdType>(symbol.value().getType());
         return;
     }
     // funkcja
     symbol = symbolManager.getSymbol(identifier->getName(), true);
-    if (symbol.has_value())
+    if (symbol.has_value() && std::holds_alternative<IdType>(symbol.value().getType()))
     {
         lastEvaluatedType = std::get<IdType>(symbol.value().getType());
         return;
@@ -66,13 +139,105 @@ void SemanticVisitor::visitFactorOp(Nodes::FactorOp *) {}
 void SemanticVisitor::visitUnaryOp(Nodes::UnaryOp *) {}
 void SemanticVisitor::visitCastOp(Nodes::CastOp *) {}
 
+// wartość dziecka węzła liczonego przez sterownik; liście liczone są po prostu ponownie
+bool SemanticVisitor::replayed(Node *node) {
+    auto type = replay.find(node);
+    if (type == nullptr)
+        return false;
+    lastEvaluatedType = *type;
+    return true;
+}
+
+// poniżej CastingExpr oczekiwany typ jest zawsze pusty - tak jak przy zejściu rekurencyjnym
+void SemanticVisitor::evaluateIteratively(Node *root) {
+    using Type = std::optional<IdType>;
+    auto prevExpectedType = expectedType;
+    auto step = [&](Node *node, const Traversal::Operand<Type> *first, const Traversal::Operand<Type> *last) {
+        expectedType = node == root ? prevExpectedType : std::nullopt;
+        replay = {node, first, last};
+        node->accept(*this);
+        replay = {};
+        return lastEvaluatedType;
+    };
+    try {
+        lastEvaluatedType = Traversal::evaluatePostOrder<Type>(root, step);
+    } catch (...) {
+        replay = {};
+        expectedType = prevExpectedType;
+        throw;
+    }
+    expectedType = prevExpectedType;
+}
+
+void SemanticVisitor::requireChecked(const Node *node) const {
+    if (lastEvaluatedType == IdType::VARIANT)
+        throw MyException("Variant value must be checked with holding() before use", node->getPos());
+}
+
+void SemanticVisitor::acceptNarrowed(Nodes::Block *block, const Nodes::VariantHolding *test) {
+    if (!block)
+        return;
+    if (blocks.active())
+        blocks.push(block, {test, std::nullopt});
+    else
+        checkBlock(block, {test, std::nullopt});
+}
+
+// instrukcje bloków zagnieżdżonych w if/while sprawdzane w pętli BlockStack::run, nie rekurencyjnie
+void SemanticVisitor::checkBlock(Nodes::Block *block, Narrowing narrowing) {
+    blocks.run(block, narrowing,
+               [this](Nodes::Block*, Narrowing& entered) {
+                   symbolManager.enterNewScope();
+                   narrow(entered);
+               },
+               [this](Node* statement) {
+                   statement->accept(*this);
+                   return true;
+               },
+               [this](Nodes::Block*, Narrowing& left) {
+                   symbolManager.leaveScope();
+                   restoreNarrowing(left);
+                   return false;
+               });
+}
+
+void SemanticVisitor::narrow(Narrowing &narrowing) {
+    if (!narrowing.test)
+        return;
+    auto name = narrowing.test->getIdentifier();
+    auto previous = narrowedVariants.find(name);
+    if (previous != narrowedVariants.end())
+        narrowing.previous = previous->second;
+    narrowedVariants[name] = narrowing.test->getHeldType().value();
+}
+
+void SemanticVisitor::restoreNarrowing(const Narrowing &narrowing) {
+    if (!narrowing.test)
+        return;
+    // przypisanie w bloku mogło już usunąć zawężenie - wraca stan sprzed bloku
+    auto name = narrowing.test->getIdentifier();
+    if (narrowing.previous)
+        narrowedVariants[name] = *narrowing.previous;
+    else
+        narrowedVariants.erase(name);
+}
+
 void SemanticVisitor::visitCastingExpr(Nodes::CastingExpr *castingExpr) {
+    if (replayed(castingExpr))
+        return;
+    // każdy poziom nawiasów i łańcucha operatorów przechodzi przez CastingExpr
+    Traversal::DepthGuard depth(expressionDepth);
+    if (depth.exceeded() && !replay.active()) {
+        evaluateIteratively(castingExpr);
+        return;
+    }
     castingExpr->acceptCastOperator(*this);
     auto prevExpectedType = expectedType;
     expectedType = std::nullopt;
     castingExpr->acceptExpr(*this);
     if (castingExpr->getCastOp())
     {
+        requireChecked(castingExpr);
         auto op = castingExpr->getCastOp()->getType();
         if (op == IdType::BOOLEAN && lastEvaluatedType == IdType::STR)
             throw MyException("Cannot cast STR to BOOLEAN", castingExpr->getPos());
@@ -82,10 +247,13 @@ void SemanticVisitor::visitCastingExpr(Nodes::CastingExpr *castingExpr) {
 }
 
 void SemanticVisitor::visitUnaryExpr(Nodes::UnaryExpr *unaryExpr) {
+    if (replayed(unaryExpr))
+        return;
     unaryExpr->acceptUnaryOperator(*this);
     unaryExpr->acceptExpr(*this);
     if (unaryExpr->getUnaryOp())
     {
+        requireChecked(unaryExpr);
         auto op = unaryExpr->getUnaryOp()->getType();
         if (op == UnaryOperator::NEGATE) {
             if (lastEvaluatedType != IdType::BOOLEAN)
@@ -98,6 +266,8 @@ void SemanticVisitor::visitUnaryExpr(Nodes::UnaryExpr *unaryExpr) {
 }
 
 void SemanticVisitor::visitMulExpr(Nodes::MulExpr *mulExpr) {
+    if (replayed(mulExpr))
+        return;
     mulExpr->acceptLeft(*this);
     auto leftType = lastEvaluatedType;
     mulExpr->acceptFactorOperator(*this);
@@ -106,6 +276,8 @@ void SemanticVisitor::visitMulExpr(Nodes::MulExpr *mulExpr) {
 
     if (mulExpr->getLeftOperand() && mulExpr->getRightOperand())
     {
+        if (leftType == IdType::VARIANT || rightType == IdType::VARIANT)
+            throw MyException("Variant value must be checked with holding() before use", mulExpr->getPos());
         if (leftType.value() != rightType.value())
             throw MyException("Cannot perform arithmetic operation on different types", mulExpr->getPos());
         if (leftType.value() == IdType::STR || rightType.value() == IdType::STR)
@@ -116,6 +288,8 @@ void SemanticVisitor::visitMulExpr(Nodes::MulExpr *mulExpr) {
 }
 
 void SemanticVisitor::visitArtmExpr(Nodes::ArtmExpr *artmExpr) {
+    if (replayed(artmExpr))
+        return;
     artmExpr->acceptLeft(*this);
     auto leftType = lastEvaluatedType;
     artmExpr->acceptArtmOperator(*this);
@@ -123,6 +297,8 @@ void SemanticVisitor::visitArtmExpr(Nodes::ArtmExpr *artmExpr) {
     auto rightType = lastEvaluatedType;
     if (artmExpr->getLeftOperand() && artmExpr->getRightOperand())
     {
+        if (leftType == IdType::VARIANT || rightType == IdType::VARIANT)
+            throw MyException("Variant value must be checked with holding() before use", artmExpr->getPos());
         auto op = artmExpr->getArtmOp()->getType();
         if (leftType.value() != rightType.value())
             throw MyException("Cannot perform arithmetic operation on different types", artmExpr->getPos());
@@ -137,6 +313,8 @@ void SemanticVisitor::visitArtmExpr(Nodes::ArtmExpr *artmExpr) {
 }
 
 void SemanticVisitor::visitRelExpr(Nodes::RelExpr *relExpr) {
+    if (replayed(relExpr))
+        return;
     relExpr->acceptLeft(*this);
     auto leftType = lastEvaluatedType;
     relExpr->acceptRelOperator(*this);
@@ -144,40 +322,54 @@ void SemanticVisitor::visitRelExpr(Nodes::RelExpr *relExpr) {
     auto rightType = lastEvaluatedType;
     if (relExpr->getLeftOperand() && relExpr->getRightOperand())
     {
+        if (leftType == IdType::VARIANT || rightType == IdType::VARIANT)
+            throw MyException("Variant value must be checked with holding() before use", relExpr->getPos());
         auto op = relExpr->getRelOp()->getType();
         if (leftType.value() != rightType.value())
             throw MyException("Cannot compare different types", relExpr->getPos());
         if (leftType.value() == IdType::STR && rightType.value() == IdType::STR )
             if (op != RelationalOperator::EQUAL && op != RelationalOperator::NOT_EQUAL)
                 throw MyException("Cannot use relational operator on strings", relExpr->getPos());
+        // porównanie daje bool niezależnie od typu argumentów - np. e.holding() == "int" jako warunek
+        lastEvaluatedType = IdType::BOOLEAN;
     }
 }
 
 void SemanticVisitor::visitAndExpr(Nodes::AndExpr *andExpr) {
+    if (replayed(andExpr))
+        return;
     andExpr->acceptLeft(*this);
     auto leftType = lastEvaluatedType;
     andExpr->acceptRight(*this);
     auto rightType = lastEvaluatedType;
     if (andExpr->getLeftOperand() && andExpr->getRightOperand())
     {
+        if (leftType == IdType::VARIANT || rightType == IdType::VARIANT)
+            throw MyException("Variant value must be checked with holding() before use", andExpr->getPos());
         if (leftType.value() == IdType::STR || rightType.value() == IdType::STR)
             throw MyException("Cannot use AND operator on strings", andExpr->getPos());
     }
 }
 
 void SemanticVisitor::visitOrExpr(Nodes::OrExpr *orExpr) {
+    if (replayed(orExpr))
+        return;
     orExpr->acceptLeft(*this);
     auto leftType = lastEvaluatedType;
     orExpr->acceptRight(*this);
     auto rightType = lastEvaluatedType;
     if (orExpr->getLeftOperand() && orExpr->getRightOperand())
     {
+        if (leftType == IdType::VARIANT || rightType == IdType::VARIANT)
+            throw MyException("Variant value must be checked with holding() before use", orExpr->getPos());
         if (leftType.value() == IdType::STR || rightType.value() == IdType::STR)
             throw MyException("Cannot use OR operator on strings", orExpr->getPos());
     }
 }
 
 void SemanticVisitor::visitExpr(Nodes::Expression *expr) {
+    if (replayed(expr))
+        return;
     auto prevType = expectedType;
     expectedType=std::nullopt;
     expr->acceptExpr(*this);
@@ -185,6 +377,8 @@ void SemanticVisitor::visitExpr(Nodes::Expression *expr) {
 }
 
 void SemanticVisitor::visitFuncCall(Nodes::FunCall *funCall) {
+    if (replayed(funCall))
+        return;
     if (funCall->getIdentifier() == "print") {
         throw MyException("Cannot call print function as value", funCall->getPos());
     }
@@ -216,6 +410,7 @@ void SemanticVisitor::visitFuncCall(Nodes::FunCall *funCall) {
         expectedType = funArgs.value()[i]->getType()->getIdType();
         calledArgs.value()[i]->accept(*this);
         expectedType = prevExpectedType;
+        requireChecked(calledArgs.value()[i]);
     }
 }
 
@@ -227,13 +422,77 @@ void SemanticVisitor::visitVariableRef(Nodes::VarReference *varReference) {
     if (symbol.value().isFun()) {
         throw MyException("Cannot use function " + varReference->getIdentifier() + " as value", varReference->getPos());
     }
+    if (symbol.value().isVariant()) {
+        // w gałęzi po teście holding() wariant jest wartością testowanego typu; poza nią typ
+        // aktywnej alternatywy znany jest dopiero w czasie wykonania
+        auto narrowed = narrowedVariants.find(varReference->getIdentifier());
+        if (narrowed == narrowedVariants.end()) {
+            lastEvaluatedType = IdType::VARIANT;
+            return;
+        }
+        if (expectedType.has_value() && Nodes::idTypesToStr[narrowed->second] != this->getExpectedTypeAsString())
+            throw MyException("Expected type: " + this->getExpectedTypeAsString() + ", got: " + Nodes::idTypesToStr[narrowed->second], varReference->getPos());
+        varReference->setHeldType(narrowed->second);
+        lastEvaluatedType = narrowed->second;
+        return;
+    }
     if (expectedType.has_value() && symbol.value().getTypeAsString() != this->getExpectedTypeAsString()) {
         throw MyException(
                 "Expected type: " + this->getExpectedTypeAsString() +
                 ", got: " + symbol.value().getTypeAsString(),
                 varReference->getPos());
     }
-    lastEvaluatedType = std::get<IdType>(symbol.value().getType());
+    auto type = symbol.value().getType();
+    // zmienna struktury nie jest wartością - tylko jej pola (r.pole)
+    if (!std::holds_alternative<IdType>(type))
+        throw MyException("Cannot use " + symbol.value().getTypeAsString() + " variable " + varReference->getIdentifier() + " as value", varReference->getPos());
+    lastEvaluatedType = std::get<IdType>(type);
+}
+
+void SemanticVisitor::visitVariantHolding(Nodes::VariantHolding *variantHolding) {
+    auto symbol = symbolManager.getSymbol(variantHolding->getIdentifier(), false);
+    if (!symbol.has_value()) {
+        throw MyException("Variable " + variantHolding->getIdentifier() + " not declared", variantHolding->getPos());
+    }
+    if (!symbol.value().isVariant()) {
+        throw MyException("Identifier is not a variant: " + variantHolding->getIdentifier(), variantHolding->getPos());
+    }
+    IdType resultType = IdType::STR;
+    if (auto heldType = variantHolding->getHeldType()) {
+        auto &layout = symbol.value().getVariantInfo()->layout;
+        if (layout->getTag(*heldType) == VariantLayout::NO_TAG)
+            throw MyException("Variant type '" + layout->getVariantName() + "' cannot hold " + Nodes::idTypesToStr[*heldType], variantHolding->getPos());
+        resultType = IdType::BOOLEAN;
+    }
+    if (expectedType.has_value() && this->getExpectedTypeAsString() != Nodes::idTypesToStr[resultType]) {
+        throw MyException("Expected type: " + this->getExpectedTypeAsString() + ", got: " + Nodes::idTypesToStr[resultType], variantHolding->getPos());
+    }
+    lastEvaluatedType = resultType;
+}
+
+void SemanticVisitor::visitStructFieldRef(Nodes::StructFieldReference *fieldReference) {
+    auto symbol = symbolManager.getSymbol(fieldReference->getIdentifier(), false);
+    if (!symbol.has_value()) {
+        throw MyException("Variable " + fieldReference->getIdentifier() + " not declared", fieldReference->getPos());
+    }
+    if (!symbol.value().isStruct()) {
+        throw MyException("Identifier is not a struct: " + fieldReference->getIdentifier(), fieldReference->getPos());
+    }
+    auto layout = symbol.value().getStructInfo()->layout;
+    auto fieldIndex = layout->getFieldIndex(fieldReference->getFieldName());
+    if (!fieldIndex.has_value()) {
+        throw MyException("Field not found in struct: " + fieldReference->getFieldName(), fieldReference->getPos());
+    }
+    fieldReference->setFieldIndex(fieldIndex.value());
+
+    auto fieldType = layout->getField(fieldIndex.value()).type;
+    if (expectedType.has_value() && Nodes::idTypesToStr[fieldType] != this->getExpectedTypeAsString()) {
+        throw MyException(
+                "Expected type: " + this->getExpectedTypeAsString() +
+                ", got: " + Nodes::idTypesToStr[fieldType],
+                fieldReference->getPos());
+    }
+    lastEvaluatedType = fieldType;
 }
 
 void SemanticVisitor::visitDeclaration(Nodes::Declaration *declaration) {}
@@ -241,6 +500,8 @@ void SemanticVisitor::visitType(Nodes::Type *) {}
 
 void SemanticVisitor::visitTypeDecl(Nodes::TypeDecl *typeDecl) {
     std::variant<int, float, bool, std::string, std::shared_ptr<StructInfo>> value;
+    if (!std::holds_alternative<IdType>(typeDecl->getType()->getIdType()))
+        throw MyException("Parameter " + typeDecl->getIdentifier() + " must have a simple type", typeDecl->getPos());
     auto type = std::get<IdType>(typeDecl->getType()->getIdType());
     switch (type) {
         case IdType::INT:
@@ -305,6 +566,7 @@ void SemanticVisitor::visitVariableDeclaration(Nodes::VariableDeclaration *varia
         expectedType = type;
         variableDeclaration->getInitExpr()->acceptExpr(*this);
         expectedType = previousType;
+        requireChecked(variableDeclaration);
     }
 }
 
@@ -353,31 +615,13 @@ void SemanticVisitor::visitStructVarDeclaration(Nodes::StructVarDeclaration *str
         expectedType = structAgrTypes[i]->getType()->getIdType();
         structValues[i]->accept(*this);
         expectedType = prevExpectedType;
+        requireChecked(structValues[i]);
     }
 
-    std::map<std::string, StructFieldInfo> structInstanceFields;
-    for (const auto & structAgrType : structAgrTypes) {
-        auto fieldType = std::get<IdType>(structAgrType->getType()->getIdType());
-        std::optional<std::variant<int, float, bool, std::string>> fieldValue;
-
-        switch (fieldType) {
-            case IdType::INT:
-                fieldValue.emplace(0);
-                break;
-            case IdType::FLOAT:
-                fieldValue.emplace(0.0f);
-                break;
-            case IdType::BOOLEAN:
-                fieldValue.emplace(false);
-                break;
-            case IdType::STR:
-                fieldValue.emplace(std::string(""));
-                break;
-        }
-        structInstanceFields[structAgrType->getIdentifier()] = StructFieldInfo(fieldType, fieldValue);
-    }
-
-    auto structInfo = std::make_shared<StructInfo>(structInstanceFields);
+    auto layout = structTypes.at(structTypeName)->getLayout();
+    if (!layout)
+        throw MyException("Struct type '" + structTypeName + "' contains fields of unknown type", structVarDeclaration->getPos());
+    auto structInfo = std::make_shared<StructInfo>(layout);
 
     SymbolInfo structVarSymbol(varName, structInfo, false, isMutable, false, std::nullopt);
 
@@ -412,24 +656,22 @@ void SemanticVisitor::visitVariantVarDeclaration(Nodes::VariantVarDeclaration *v
         throw MyException("Variant type '" + variantTypeName + "' not declared", variantVarDeclaration->getPos());
     if (symbolManager.checkIfExists(varName))
         throw MyException("Variable '" + varName + "' is already declared", variantVarDeclaration->getPos());
-    auto &variantArgs = variantTypes.at(variantTypeName)->getFields();
+    auto &layout = variantTypes.at(variantTypeName)->getLayout();
+    if (!layout)
+        throw MyException("Variant type '" + variantTypeName + "' contains non-simple types", variantVarDeclaration->getPos());
     auto value = variantVarDeclaration->getValue();
     if (value) {
         value->accept(*this);
-        bool typeMatchFound = false;
-        for (const auto &argType: variantTypes.at(variantTypeName)->getFields()) {
-            if (std::get<IdType>(argType->getIdType()) == lastEvaluatedType) {
-                typeMatchFound = true;
-                break;
-            }
-        }
-        if (!typeMatchFound) {
+        if (!lastEvaluatedType.has_value() || layout->getTag(lastEvaluatedType.value()) == VariantLayout::NO_TAG) {
             throw MyException("Type of expression does not match any of the allowed variant types",
                               variantVarDeclaration->getPos());
         }
     }
+    // nowa zmienna o tej nazwie nie jest objęta testem z otaczającego bloku
+    narrowedVariants.erase(varName);
     // value set in interpreter
     SymbolInfo variantVarSymbol(varName, variantTypeName, false, true, false, std::nullopt);
+    variantVarSymbol.setVariantLayout(layout);
     symbolManager.insertSymbol(varName, variantVarSymbol);
 }
 
@@ -445,9 +687,21 @@ void SemanticVisitor::visitAssignment(Nodes::Assignment *assignment) {
         throw MyException("Cannot assign value to immutable variable " + assignment->getIdentifier(), assignment->getPos());
     }
     auto prevExpectedType = expectedType;
+    if (symbol.value().isVariant()) {
+        expectedType = std::nullopt;
+        assignment->acceptExpr(*this);
+        expectedType = prevExpectedType;
+        auto &layout = symbol.value().getVariantInfo()->layout;
+        if (!lastEvaluatedType.has_value() || layout->getTag(lastEvaluatedType.value()) == VariantLayout::NO_TAG)
+            throw MyException("Type of expression does not match any of the allowed variant types", assignment->getPos());
+        // alternatywa mogła się zmienić - wcześniejszy test holding() już nie obowiązuje
+        narrowedVariants.erase(assignment->getIdentifier());
+        return;
+    }
     expectedType = symbol.value().getType();
     assignment->acceptExpr(*this);
     expectedType = prevExpectedType;
+    requireChecked(assignment);
 
 }
 
@@ -459,46 +713,53 @@ void SemanticVisitor::visitStructFieldAssignment(Nodes::StructFieldAssignment *s
     if (!structSymbol.value().isStruct()) {
         throw MyException("Identifier is not a struct: " + structFieldAssignment->getIdentifier(), structFieldAssignment->getPos());
     }
+    if (!structSymbol.value().isMut()) {
+        throw MyException("Cannot assign field of immutable struct " + structFieldAssignment->getIdentifier(), structFieldAssignment->getPos());
+    }
 
-    auto structInfo = structSymbol.value().getStructInfo();
+    auto layout = structSymbol.value().getStructInfo()->layout;
     auto fieldName = structFieldAssignment->getFieldName();
-    if (structInfo->fields.find(fieldName) == structInfo->fields.end()) {
+    auto fieldIndex = layout->getFieldIndex(fieldName);
+    if (!fieldIndex.has_value()) {
         throw MyException("Field not found in struct: " + fieldName, structFieldAssignment->getPos());
     }
+    structFieldAssignment->setFieldIndex(fieldIndex.value());
 
-    auto fieldInfo = structInfo->fields[fieldName];
-    auto fieldType = fieldInfo.getFieldType();
+    auto fieldType = layout->getField(fieldIndex.value()).type;
     auto prevExpectedType = expectedType;
     expectedType = fieldType;
     structFieldAssignment->getExpression()->accept(*this);
     expectedType = prevExpectedType;
-
-    // The actual assignment of the value will be done in the interpreter
+    requireChecked(structFieldAssignment);
 }
 
 void SemanticVisitor::visitReturnStatement(Nodes::ReturnStatement *returnStatement) {
     returnStatement->acceptReturnExpr(*this);
+    if (returnStatement->getExpression())
+        requireChecked(returnStatement);
 }
 
 void SemanticVisitor::visitBlock(Nodes::Block *block) {
-    symbolManager.enterNewScope();
-    block->acceptStatements(*this);
-    symbolManager.leaveScope();
+    checkBlock(block, {nullptr, std::nullopt});
 }
 
 void SemanticVisitor::visitIfStatement(Nodes::IfStatement *ifStatement) {
     ifStatement->acceptCondition(*this);
     if (lastEvaluatedType == IdType::STR)
         throw MyException("Cannot use string as condition", ifStatement->getPos());
-    ifStatement->acceptIfBlock(*this);
-    ifStatement->acceptElseBlock(*this);
+    requireChecked(ifStatement);
+    auto test = tagTestOf(ifStatement->getCondition());
+    acceptNarrowed(ifStatement->getIfBlock(), test && !test->isNegated() ? test : nullptr);
+    acceptNarrowed(ifStatement->getElseBlock(), test && test->isNegated() ? test : nullptr);
 }
 
 void SemanticVisitor::visitWhileStatement(Nodes::WhileStatement *whileStatement) {
     whileStatement->acceptCondition(*this);
     if (lastEvaluatedType == IdType::STR)
         throw MyException("Cannot use string as condition", whileStatement->getPos());
-    whileStatement->acceptWhileBlock(*this);
+    requireChecked(whileStatement);
+    auto test = tagTestOf(whileStatement->getCondition());
+    acceptNarrowed(whileStatement->getBlock(), test && !test->isNegated() ? test : nullptr);
 }
 
 void SemanticVisitor::visitFunctionCallStatement(Nodes::FunctionCallStatement *functionCallStatement) {
@@ -532,6 +793,7 @@ void SemanticVisitor::visitFunctionCallStatement(Nodes::FunctionCallStatement *f
         expectedType = funArgs.value()[i]->getType()->getIdType();
         calledArgs[i]->accept(*this);
         expectedType = prevExpectedType;
+        requireChecked(calledArgs[i].get());
     }
 }
 
@@ -556,26 +818,106 @@ void SemanticVisitor::visitFunctionDeclaration(Nodes::FunctionDeclaration *funct
 }
 
 void SemanticVisitor::visitProgram(Nodes::Program *program) {
-    if(program->getFunctions().empty())
+    if(!moduleMode && program->getFunctions().empty())
         throw MyException("Program does not contain any functions!");
-    if(program->getFunctions().find("main")==program->getFunctions().end())
+    if(!moduleMode && program->getFunctions().find("main")==program->getFunctions().end())
         throw MyException("main() function missing!");
 
+    declareGlobals(program);
+
+    std::vector<Nodes::FunctionDeclaration*> functions;
+    for (const auto & it : program->getFunctions()){
+        // leniwe ciała sprawdza LazyBodyLoader przy pierwszym wywołaniu
+        if (importedFunctions.count(it.first) == 0 && it.second->isBodyParsed())
+            functions.push_back(it.second.get());
+    }
+    std::sort(functions.begin(), functions.end(), [](const Nodes::FunctionDeclaration* a, const Nodes::FunctionDeclaration* b) {
+        auto posA = a->getPos();
+        auto posB = b->getPos();
+        return posA.line != posB.line ? posA.line < posB.line : posA.column < posB.column;
+    });
+    checkBodies(functions);
+    symbolManager.leaveContext();
+}
+
+void SemanticVisitor::checkBodies(const std::vector<Nodes::FunctionDeclaration*> &functions) {
+    std::vector<std::optional<MyException>> results(functions.size());
+    if (threads == 1 || functions.size() < PARALLEL_MIN_FUNCTIONS) {
+        for (std::size_t i = 0; i < functions.size(); i++) {
+            try {
+                checkBody(functions[i]);
+            } catch (MyException& e) {
+                results[i] = e;
+            }
+        }
+    } else {
+        // ciała czytają tylko symbole globalne i piszą wyłącznie do własnych węzłów, więc wystarczy
+        // kopia kontekstu na wątek; funkcje rozdzielane dynamicznie, bo ich rozmiary są różne
+        WorkStealingPool pool(threads);
+        std::atomic<std::size_t> next{0};
+        for (std::size_t t = 0; t < pool.size(); t++) {
+            pool.submit([this, &functions, &results, &next]() {
+                SemanticVisitor worker(*this);
+                for (auto i = next++; i < functions.size(); i = next++) {
+                    try {
+                        worker.checkBody(functions[i]);
+                    } catch (MyException& e) {
+                        results[i] = e;
+                    }
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    errors.clear();
+    const Nodes::FunctionDeclaration* firstFailed = nullptr;
+    for (std::size_t i = 0; i < functions.size(); i++) {
+        if (!results[i])
+            continue;
+        if (!firstFailed)
+            firstFailed = functions[i];
+        errors.push_back(std::move(results[i].value()));
+    }
+    currentTopLevel = firstFailed;
+    if (!errors.empty())
+        throw errors.front();
+}
+
+void SemanticVisitor::checkBody(Nodes::FunctionDeclaration *function) {
+    auto globalContexts = symbolManager.getContextCount();
+    currentTopLevel = function;
+    try {
+        function->accept(*this);
+    } catch (MyException&) {
+        while (symbolManager.getContextCount() > globalContexts)
+            symbolManager.leaveContext();
+        expectedType.reset();
+        narrowedVariants.clear();
+        throw;
+    }
+    currentTopLevel = nullptr;
+}
+
+void SemanticVisitor::declareGlobals(Nodes::Program *program) {
     symbolManager.enterNewContext();
     symbolManager.enterNewScope();
 
     for(const auto & it : program->getVariables())
     {
+        currentTopLevel = it.second.get();
         it.second->accept(*this);
     }
 
     for(const auto & it : program->getStructTypes())
     {
+        currentTopLevel = it.second.get();
         it.second->accept(*this);
     }
 
     for(const auto & it : program->getVariantTypes())
     {
+        currentTopLevel = it.second.get();
         it.second->accept(*this);
     }
 
@@ -590,11 +932,13 @@ void SemanticVisitor::visitProgram(Nodes::Program *program) {
         }
         symbolManager.insertSymbol(it.first, SymbolInfo(it.first, typeVariant, true, false, false, it.second.get()));
     }
+    currentTopLevel = nullptr;
+}
 
-    for (const auto & it : program->getFunctions()){
-        it.second->accept(*this);
-    }
-    symbolManager.leaveContext();
+void SemanticVisitor::checkFunction(const std::string &name, Nodes::FunctionDeclaration *function) {
+    if (auto symbol = symbolManager.findSymbol(name))
+        symbol->setFuncPointer(function);
+    checkBody(function);
 }
 
 std::string SemanticVisitor::getExpectedTypeAsString() {
@@ -0,0 +1,262 @@
+#include "traversal.h"
+#include "visitorTemplate.h"
+
+namespace {
+    // Wywołany na węźle rozwija go o jeden poziom: accept* dzieci trafiają z powrotem tutaj
+    // i zamiast schodzić niżej tylko dopisują dziecko do listy.
+    class ChildCollector : public VisitorTemplate<ChildCollector>
+    {
+    private:
+        Node* parent;
+        std::vector<Node*>& children;
+
+        // true dla dziecka - zapisane, nie rozwijamy
+        bool record(Node* node) {
+            if (node == parent)
+                return false;
+            children.push_back(node);
+            return true;
+        }
+    public:
+        ChildCollector(Node* parent, std::vector<Node*>& children) : parent(parent), children(children) {}
+
+        void visitBoolLiteral(Nodes::BooleanLiteral *literal) override { record(literal); }
+        void visitIntLiteral(Nodes::IntLiteral *literal) override { record(literal); }
+        void visitFloatLiteral(Nodes::FloatLiteral *literal) override { record(literal); }
+        void visitStringLiteral(Nodes::StringLiteral *literal) override { record(literal); }
+        void visitIdentifier(Nodes::Identifier *identifier) override { record(identifier); }
+        void visitRelOp(Nodes::RelOp *relOp) override { record(relOp); }
+        void visitArtmOp(Nodes::ArtmOp *artmOp) override { record(artmOp); }
+        void visitFactorOp(Nodes::FactorOp *factorOp) override { record(factorOp); }
+        void visitUnaryOp(Nodes::UnaryOp *unaryOp) override { record(unaryOp); }
+        void visitCastOp(Nodes::CastOp *castOp) override { record(castOp); }
+        void visitDeclaration(Nodes::Declaration *declaration) override { record(declaration); }
+        void visitType(Nodes::Type *type) override { record(type); }
+        void visitVariableRef(Nodes::VarReference *varReference) override { record(varReference); }
+        void visitStructFieldRef(Nodes::StructFieldReference *fieldReference) override { record(fieldReference); }
+        void visitVariantHolding(Nodes::VariantHolding *variantHolding) override { record(variantHolding); }
+
+        void visitCastingExpr(Nodes::CastingExpr *castingExpr) override {
+            if (record(castingExpr))
+                return;
+            castingExpr->acceptExpr(*this);
+            castingExpr->acceptCastOperator(*this);
+        }
+
+        void visitUnaryExpr(Nodes::UnaryExpr *unaryExpr) override {
+            if (record(unaryExpr))
+                return;
+            unaryExpr->acceptUnaryOperator(*this);
+            unaryExpr->acceptExpr(*this);
+        }
+
+        void visitMulExpr(Nodes::MulExpr *mulExpr) override {
+            if (record(mulExpr))
+                return;
+            mulExpr->acceptLeft(*this);
+            mulExpr->acceptFactorOperator(*this);
+            mulExpr->acceptRight(*this);
+        }
+
+        void visitArtmExpr(Nodes::ArtmExpr *artmExpr) override {
+            if (record(artmExpr))
+                return;
+            artmExpr->acceptLeft(*this);
+            artmExpr->acceptArtmOperator(*this);
+            artmExpr->acceptRight(*this);
+        }
+
+        void visitRelExpr(Nodes::RelExpr *relExpr) override {
+            if (record(relExpr))
+                return;
+            relExpr->acceptLeft(*this);
+            relExpr->acceptRelOperator(*this);
+            relExpr->acceptRight(*this);
+        }
+
+        void visitAndExpr(Nodes::AndExpr *andExpr) override {
+            if (record(andExpr))
+                return;
+            andExpr->acceptLeft(*this);
+            andExpr->acceptRight(*this);
+        }
+
+        void visitOrExpr(Nodes::OrExpr *orExpr) override {
+            if (record(orExpr))
+                return;
+            orExpr->acceptLeft(*this);
+            orExpr->acceptRight(*this);
+        }
+
+        void visitExpr(Nodes::Expression *expression) override {
+            if (record(expression))
+                return;
+            expression->acceptExpr(*this);
+        }
+
+        void visitFuncCall(Nodes::FunCall *funCall) override {
+            if (record(funCall))
+                return;
+            auto arguments = funCall->getArguments();
+            if (arguments.has_value())
+                for (auto arg : arguments.value())
+                    arg->accept(*this);
+        }
+
+        void visitTypeDecl(Nodes::TypeDecl *typeDecl) override {
+            if (record(typeDecl))
+                return;
+            typeDecl->acceptType(*this);
+        }
+
+        void visitVariableDeclaration(Nodes::VariableDeclaration *variableDeclaration) override {
+            if (record(variableDeclaration))
+                return;
+            variableDeclaration->getTypeDecl()->accept(*this);
+            variableDeclaration->acceptInitExpr(*this);
+        }
+
+        void visitStructTypeDefinition(Nodes::StructTypeDefinition *structTypeDefinition) override {
+            if (record(structTypeDefinition))
+                return;
+            for (const auto &field : structTypeDefinition->getFields())
+                field->accept(*this);
+        }
+
+        void visitStructVarDeclaration(Nodes::StructVarDeclaration *structVarDeclaration) override {
+            if (record(structVarDeclaration))
+                return;
+            structVarDeclaration->getType()->accept(*this);
+            for (auto arg : structVarDeclaration->getArgs())
+                arg->accept(*this);
+        }
+
+        void visitVariantTypeDefinition(Nodes::VariantTypeDefinition *variantTypeDefinition) override {
+            if (record(variantTypeDefinition))
+                return;
+            for (const auto &field : variantTypeDefinition->getFields())
+                field->accept(*this);
+        }
+
+        void visitVariantVarDeclaration(Nodes::VariantVarDeclaration *variantVarDeclaration) override {
+            if (record(variantVarDeclaration))
+                return;
+            variantVarDeclaration->acceptType(*this);
+            variantVarDeclaration->acceptValue(*this);
+        }
+
+        void visitAssignment(Nodes::Assignment *assignment) override {
+            if (record(assignment))
+                return;
+            assignment->acceptExpr(*this);
+        }
+
+        void visitStructFieldAssignment(Nodes::StructFieldAssignment *structFieldAssignment) override {
+            if (record(structFieldAssignment))
+                return;
+            structFieldAssignment->acceptExpr(*this);
+        }
+
+        void visitReturnStatement(Nodes::ReturnStatement *returnStatement) override {
+            if (record(returnStatement))
+                return;
+            returnStatement->acceptReturnExpr(*this);
+        }
+
+        void visitBlock(Nodes::Block *block) override {
+            if (record(block))
+                return;
+            block->acceptStatements(*this);
+        }
+
+        void visitIfStatement(Nodes::IfStatement *ifStatement) override {
+            if (record(ifStatement))
+                return;
+            ifStatement->acceptCondition(*this);
+            ifStatement->acceptIfBlock(*this);
+            ifStatement->acceptElseBlock(*this);
+        }
+
+        void visitWhileStatement(Nodes::WhileStatement *whileStatement) override {
+            if (record(whileStatement))
+                return;
+            whileStatement->acceptCondition(*this);
+            whileStatement->acceptWhileBlock(*this);
+        }
+
+        void visitFunctionCallStatement(Nodes::FunctionCallStatement *functionCallStatement) override {
+            if (record(functionCallStatement))
+                return;
+            for (const auto &arg : functionCallStatement->getArguments())
+                arg->accept(*this);
+        }
+
+        void visitFunctionDeclaration(Nodes::FunctionDeclaration *functionDeclaration) override {
+            if (record(functionDeclaration))
+                return;
+            functionDeclaration->acceptReturnType(*this);
+            auto parameters = functionDeclaration->getParameters();
+            if (parameters.has_value())
+                for (auto param : parameters.value())
+                    param->accept(*this);
+            functionDeclaration->acceptFunctionBody(*this);
+        }
+
+        void visitProgram(Nodes::Program *program) override {
+            if (record(program))
+                return;
+            for (const auto &structType : program->getStructTypes())
+                structType.second->accept(*this);
+            for (const auto &variantType : program->getVariantTypes())
+                variantType.second->accept(*this);
+            for (const auto &var : program->getVariables())
+                var.second->accept(*this);
+            for (const auto &func : program->getFunctions())
+                func.second->accept(*this);
+        }
+    };
+}
+
+namespace Traversal {
+    void appendChildren(Node* node, std::vector<Node*>& children) {
+        ChildCollector collector(node, children);
+        collector.visit(node);
+    }
+
+    PreOrderIterator::PreOrderIterator(Node* root) {
+        if (root)
+            stack.push_back(root);
+    }
+
+    PreOrderIterator& PreOrderIterator::operator++() {
+        auto node = stack.back();
+        stack.pop_back();
+        children.clear();
+        appendChildren(node, children);
+        stack.insert(stack.end(), children.rbegin(), children.rend());
+        return *this;
+    }
+
+    PostOrderIterator::PostOrderIterator(Node* root) {
+        if (!root)
+            return;
+        stack.push_back({root, false});
+        descend();
+    }
+
+    void PostOrderIterator::descend() {
+        while (!stack.empty() && !stack.back().expanded) {
+            stack.back().expanded = true;
+            children.clear();
+            appendChildren(stack.back().node, children);
+            for (auto child = children.rbegin(); child != children.rend(); ++child)
+                stack.push_back({*child, false});
+        }
+    }
+
+    PostOrderIterator& PostOrderIterator::operator++() {
+        stack.pop_back();
+        descend();
+        return *this;
+    }
+}
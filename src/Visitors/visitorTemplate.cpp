@@ -1,150 +0,0 @@
-#include "visitorTemplate.h"
-
-
-void VisitorTemplate::visitBoolLiteral(Nodes::BooleanLiteral *) {
-
-}
-
-void VisitorTemplate::visitIntLiteral(Nodes::IntLiteral *) {
-
-}
-
-void VisitorTemplate::visitFloatLiteral(Nodes::FloatLiteral *) {
-
-}
-
-void VisitorTemplate::visitStringLiteral(Nodes::StringLiteral *) {
-
-}
-
-void VisitorTemplate::visitIdentifier(Nodes::Identifier *) {
-
-}
-
-void VisitorTemplate::visitRelOp(Nodes::RelOp *) {
-
-}
-
-void VisitorTemplate::visitArtmOp(Nodes::ArtmOp *) {
-
-}
-
-void VisitorTemplate::visitFactorOp(Nodes::FactorOp *) {
-
-}
-
-void VisitorTemplate::visitUnaryOp(Nodes::UnaryOp *) {
-
-}
-
-void VisitorTemplate::visitCastOp(Nodes::CastOp *) {
-
-}
-
-void VisitorTemplate::visitCastingExpr(Nodes::CastingExpr *) {
-
-}
-
-void VisitorTemplate::visitUnaryExpr(Nodes::UnaryExpr *) {
-
-}
-
-void VisitorTemplate::visitMulExpr(Nodes::MulExpr *) {
-
-}
-
-void VisitorTemplate::visitArtmExpr(Nodes::ArtmExpr *) {
-
-}
-
-void VisitorTemplate::visitRelExpr(Nodes::RelExpr *) {
-
-}
-
-void VisitorTemplate::visitAndExpr(Nodes::AndExpr *) {
-
-}
-
-void VisitorTemplate::visitOrExpr(Nodes::OrExpr *) {
-
-}
-
-void VisitorTemplate::visitFuncCall(Nodes::FunCall *) {
-
-}
-
-void VisitorTemplate::visitVariableRef(Nodes::VarReference *) {
-
-}
-
-void VisitorTemplate::visitDeclaration(Nodes::Declaration *) {
-
-}
-
-void VisitorTemplate::visitType(Nodes::Type *) {
-
-}
-
-void VisitorTemplate::visitTypeDecl(Nodes::TypeDecl *) {
-
-}
-
-void VisitorTemplate::visitVariableDeclaration(Nodes::VariableDeclaration *) {
-
-}
-
-void VisitorTemplate::visitStructTypeDefinition(Nodes::StructTypeDefinition *) {
-
-}
-
-void VisitorTemplate::visitStructVarDeclaration(Nodes::StructVarDeclaration *) {
-
-}
-
-void VisitorTemplate::visitVariantTypeDefinition(Nodes::VariantTypeDefinition *) {
-
-}
-
-void VisitorTemplate::visitVariantVarDeclaration(Nodes::VariantVarDeclaration *) {
-
-}
-
-void VisitorTemplate::visitAssignment(Nodes::Assignment *) {
-
-}
-
-void VisitorTemplate::visitStructFieldAssignment(Nodes::StructFieldAssignment *) {
-
-}
-
-void VisitorTemplate::visitReturnStatement(Nodes::ReturnStatement *) {
-
-}
-
-void VisitorTemplate::visitBlock(Nodes::Block *) {
-
-}
-
-void VisitorTemplate::visitIfStatement(Nodes::IfStatement *) {
-
-}
-
-void VisitorTemplate::visitWhileStatement(Nodes::WhileStatement *) {
-
-}
-
-void VisitorTemplate::visitFunctionCallStatement(Nodes::FunctionCallStatement *) {
-
-}
-
-void VisitorTemplate::visitFunctionDeclaration(Nodes::FunctionDeclaration *) {
-
-}
-
-void VisitorTemplate::visitProgram(Nodes::Program *) {
-
-}
-
-void VisitorTemplate::visitExpr(Nodes::Expression *) {
-
-}
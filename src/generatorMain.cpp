@@ -0,0 +1,64 @@
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "Generator/programGenerator.h"
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName
+              << " [--functions N] [--statements N] [--depth N] [--expression N] [--structs N] [--variants N]"
+                 " [--fan-out N] [--call-depth N] [--seed N] [-o <output_file>]" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    GeneratorOptions options;
+    std::map<std::string, int*> intOptions = {
+            {"--functions", &options.functions},
+            {"--statements", &options.statementsPerBlock},
+            {"--depth", &options.nestingDepth},
+            {"--expression", &options.expressionLength},
+            {"--structs", &options.structCount},
+            {"--variants", &options.variantCount},
+            {"--fan-out", &options.callFanOut},
+            {"--call-depth", &options.callDepth},
+    };
+    std::string output;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "-o") {
+                output = value;
+            } else if (arg == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value));
+            } else if (intOptions.count(arg) != 0 && std::stoi(value) >= 0) {
+                *intOptions.at(arg) = std::stoi(value);
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } catch (std::logic_error&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+
+    std::string source = ProgramGenerator(options).generate();
+    if (output.empty()) {
+        std::cout << source;
+        return 0;
+    }
+    std::ofstream file(output);
+    if (!file) {
+        std::cerr << "Cannot write program to " << output << std::endl;
+        return 1;
+    }
+    file << source;
+    return 0;
+}
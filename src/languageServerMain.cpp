@@ -0,0 +1,10 @@
+#include <iostream>
+
+#include "languageServer.h"
+
+// serwer LSP komunikujący się przez stdin/stdout
+int main() {
+    std::ios::sync_with_stdio(false);
+    LanguageServer server(std::cin, std::cout);
+    return server.run();
+}
@@ -1,11 +1,15 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <sstream>
-#include "lexer.h"
-#include "parser.h"
-#include "semanticVisitor.h"
-#include "interpreterVisitor.h"
+#include "engine.h"
+#include "profiler.h"
+#include "stats.h"
+#include "allocTracker.h"
+#include "programCache.h"
+#include "batchRunner.h"
 
 std::string ex1 = "fun int::main()[ int::number = 29; if number [ print(5); ] return 1; ]";
 std::string ex2 = "# testing string escaping\n"
@@ -54,40 +58,160 @@ std::string ex3 = "# Function to check if a number is prime\n"
                   "]";
 
 
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " [--profile <output_file>] [--stats[=text|json]] [--lazy] [--pipeline] [--fuel <steps>] [--timeout-ms <ms>]"
+                 " [--cache <directory>] [--jobs <threads>] -f <file_path> or -s <string>" << std::endl;
+    std::cerr << "       " << programName << " [--fuel <steps>] [--timeout-ms <ms>] [--cache <directory>] [--jobs <threads>]"
+                 " --batch <list_file|directory>" << std::endl;
+}
+
 int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " -f <file_path> or -s <string>" << std::endl;
+    std::string argType;
+    std::string argValue;
+    std::string profileOutput;
+    std::string statsFormat;
+    std::optional<std::uint64_t> fuel;
+    std::optional<long> timeoutMs;
+    std::string cacheDirectory;
+    std::string batchSource;
+    std::size_t jobs = 0;
+    bool lazyBodies = false;
+    bool pipelined = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--stats" || arg == "--stats=text") {
+            statsFormat = "text";
+            continue;
+        }
+        if (arg == "--stats=json") {
+            statsFormat = "json";
+            continue;
+        }
+        if (arg == "--lazy") {
+            lazyBodies = true;
+            continue;
+        }
+        if (arg == "--pipeline") {
+            pipelined = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (arg == "--profile") {
+            profileOutput = argv[++i];
+        } else if (arg == "--cache") {
+            cacheDirectory = argv[++i];
+        } else if (arg == "--batch") {
+            batchSource = argv[++i];
+        } else if (arg == "--fuel" || arg == "--timeout-ms" || arg == "--jobs") {
+            try {
+                long long limit = std::stoll(argv[++i]);
+                if (limit < 0)
+                    throw std::invalid_argument(arg);
+                if (arg == "--fuel")
+                    fuel = static_cast<std::uint64_t>(limit);
+                else if (arg == "--jobs")
+                    jobs = static_cast<std::size_t>(limit);
+                else
+                    timeoutMs = static_cast<long>(limit);
+            } catch (std::logic_error&) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "-f" || arg == "-s") {
+            argType = arg;
+            argValue = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!batchSource.empty()) {
+        auto start = std::chrono::steady_clock::now();
+        BatchRunner runner(jobs);
+        if (fuel)
+            runner.setFuel(*fuel);
+        if (timeoutMs)
+            runner.setTimeLimit(std::chrono::milliseconds(*timeoutMs));
+        std::unique_ptr<ProgramCache> cache;
+        if (!cacheDirectory.empty()) {
+            cache = std::make_unique<ProgramCache>(cacheDirectory);
+            runner.setCache(cache.get());
+        }
+        try {
+            auto results = runner.run(BatchRunner::collectSources(batchSource), std::cout);
+            runner.writeSummary(results, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), std::cerr);
+            bool failed = std::any_of(results.begin(), results.end(), [](const BatchResult& result) { return !result.error.empty(); });
+            return failed ? 1 : 0;
+        } catch (MyException &e) {
+            std::cerr << e.what();
+            return 1;
+        }
+    }
+    if (argType.empty()) {
+        printUsage(argv[0]);
         return 1;
     }
-    std::string argType = argv[1];
-    std::string argValue = argv[2];
-    std::istringstream strStream;
-    Lexer* lexer;
-    Parser* parser;
     if (argType == "-f") {
         std::cout << "File path provided: " << argValue << std::endl;
-        lexer = new Lexer(argValue);
-        parser = new Parser(argValue);
-    } else if (argType == "-s") {
-        std::cout << "String provided: " << argValue << std::endl;
-        // here change example provided
-        strStream.str(ex3);
-        lexer = new Lexer(strStream);
-        parser = new Parser(strStream);
     } else {
-        std::cerr << "Invalid argument. Use -f for file path or -s for string." << std::endl;
-        return 1;
+        std::cout << "String provided: " << argValue << std::endl;
     }
+    Stats::Report stats;
+    std::unique_ptr<ProgramCache> cache;
+    if (!cacheDirectory.empty())
+        cache = std::make_unique<ProgramCache>(cacheDirectory);
+    CompileOptions options;
+    options.lazyBodies = lazyBodies;
+    options.pipelined = pipelined;
+    options.threads = jobs;
+    options.cache = cache.get();
+    if (!statsFormat.empty())
+        options.stats = &stats;
+    std::unique_ptr<Profiler> profiler;
+    if (!profileOutput.empty())
+        profiler = std::make_unique<Profiler>();
+    // próbki profilera wskazują na węzły drzewa - program musi żyć do zapisu profilu
+    std::shared_ptr<const CompiledProgram> compiled;
     try {
-        std::unique_ptr<Nodes::Program> program = std::move(parser->parseProgram());
-        SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
-        program->accept(semanticVisitor);
-        InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
-        program->accept(interpreterVisitor);
+        // here change example provided
+        compiled = argType == "-f" ? Engine::compileFile(argValue, options) : Engine::compile(ex3, options);
+
+        Stats::PhaseScope statsPhase(options.stats, "interpret");
+        AllocTracker::PhaseScope allocPhase(AllocTracker::Phase::INTERPRET);
+        ExecutionBudget budget;
+        if (fuel)
+            budget.setFuel(*fuel);
+        if (timeoutMs)
+            budget.setTimeLimit(std::chrono::milliseconds(*timeoutMs));
+        if (profiler)
+            profiler->start();
+        compiled->run({}, std::cout, budget, profiler.get());
     }
     catch (MyException &e) {
         std::cout << e.what();
     }
+    if (AllocTracker::enabled())
+        AllocTracker::writeReport(std::cerr);
+    if (statsFormat == "json")
+        stats.writeJson(std::cerr);
+    else if (statsFormat == "text")
+        stats.writeText(std::cerr);
+    if (profiler) {
+        profiler->stop();
+        std::ofstream profileFile(profileOutput);
+        if (!profileFile) {
+            std::cerr << "Cannot write profile to " << profileOutput << std::endl;
+            return 1;
+        }
+        profiler->writeFoldedStacks(profileFile);
+        std::cerr << "Profile: " << profiler->getSampleCount() << " samples";
+        if (profiler->getDroppedSamples() > 0)
+            std::cerr << " (" << profiler->getDroppedSamples() << " dropped)";
+        std::cerr << " written to " << profileOutput << std::endl;
+    }
     return 0;
 
 }
\ No newline at end of file
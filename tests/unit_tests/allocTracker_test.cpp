@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+
+#include "allocTracker.h"
+#include "parser.h"
+#include "workStealingPool.h"
+
+TEST(AllocTrackerTest, PhaseScopeRestoresPreviousPhase) {
+    AllocTracker::setPhase(AllocTracker::Phase::PARSE);
+    {
+        AllocTracker::PhaseScope scope(AllocTracker::Phase::LEX);
+        EXPECT_EQ(AllocTracker::currentPhase(), AllocTracker::Phase::LEX);
+    }
+    EXPECT_EQ(AllocTracker::currentPhase(), AllocTracker::Phase::PARSE);
+    AllocTracker::setPhase(AllocTracker::Phase::NONE);
+}
+
+TEST(AllocTrackerTest, PoolTasksRunInSubmittersPhase) {
+    AllocTracker::setPhase(AllocTracker::Phase::SEMANTIC);
+    std::atomic<int> inPhase{0};
+    {
+        WorkStealingPool pool(2);
+        for (int i = 0; i < 8; i++)
+            pool.submit([&inPhase]() {
+                if (AllocTracker::currentPhase() == AllocTracker::Phase::SEMANTIC)
+                    inPhase++;
+            });
+        pool.wait();
+    }
+    AllocTracker::setPhase(AllocTracker::Phase::NONE);
+    EXPECT_EQ(inPhase.load(), 8);
+}
+
+TEST(AllocTrackerTest, CountsAllocationsOfCurrentPhase) {
+    if (!AllocTracker::enabled())
+        GTEST_SKIP() << "built without TKOM_ALLOC_TRACKING";
+
+    AllocTracker::reset();
+    AllocTracker::setPhase(AllocTracker::Phase::SEMANTIC);
+    for (int i = 0; i < 10; i++)
+        auto value = std::make_unique<long>(i);
+    AllocTracker::setPhase(AllocTracker::Phase::NONE);
+
+    auto totals = AllocTracker::totals(AllocTracker::Phase::SEMANTIC);
+    EXPECT_EQ(totals.allocations, 10);
+    EXPECT_EQ(totals.bytes, 10 * sizeof(long));
+    EXPECT_EQ(totals.frees, 10);
+    EXPECT_EQ(AllocTracker::totals(AllocTracker::Phase::INTERPRET).allocations, 0);
+}
+
+TEST(AllocTrackerTest, LexerAllocationsAreTaggedSeparately) {
+    if (!AllocTracker::enabled())
+        GTEST_SKIP() << "built without TKOM_ALLOC_TRACKING";
+
+    AllocTracker::reset();
+    AllocTracker::setPhase(AllocTracker::Phase::PARSE);
+    std::istringstream strStream("fun int::main()[ str::text = \"a string long enough to allocate on the heap\"; return 0; ]");
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    AllocTracker::setPhase(AllocTracker::Phase::NONE);
+
+    EXPECT_GT(AllocTracker::totals(AllocTracker::Phase::LEX).allocations, 0);
+    EXPECT_GT(AllocTracker::totals(AllocTracker::Phase::PARSE).allocations, 0);
+
+    std::ostringstream report;
+    AllocTracker::writeReport(report);
+    EXPECT_NE(report.str().find("Top allocation sites (parse):"), std::string::npos);
+    EXPECT_NE(report.str().find("Parser::"), std::string::npos);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+#include "batchRunner.h"
+#include "myException.h"
+#include "workStealingPool.h"
+
+TEST(WorkStealingPoolTest, RunsAllTasksIncludingNestedOnes) {
+    std::atomic<int> counter{0};
+    WorkStealingPool pool(4);
+    for (int i = 0; i < 100; i++) {
+        pool.submit([&pool, &counter]() {
+            counter++;
+            // zadania zgłaszane z wątku puli trafiają do jego kolejki i mogą zostać ukradzione
+            for (int j = 0; j < 10; j++)
+                pool.submit([&counter]() { counter++; });
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(counter.load(), 1100);
+}
+
+TEST(WorkStealingPoolTest, WaitRethrowsTaskError) {
+    WorkStealingPool pool(2);
+    pool.submit([]() { throw std::runtime_error("task failed"); });
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    // pula działa dalej
+    std::atomic<int> counter{0};
+    pool.submit([&counter]() { counter++; });
+    pool.wait();
+    EXPECT_EQ(counter.load(), 1);
+}
+
+TEST(WorkStealingPoolTest, WaitFromOwnTaskThrowsInsteadOfDeadlocking) {
+    WorkStealingPool pool(1);
+    pool.submit([&pool]() { pool.wait(); });
+    EXPECT_THROW(pool.wait(), MyException);
+}
+
+TEST(WorkStealingPoolTest, IdleWorkersWakeForLaterTasks) {
+    WorkStealingPool pool(4);
+    std::atomic<int> counter{0};
+    for (int round = 0; round < 50; round++) {
+        // między rundami wszystkie wątki zasypiają; każde zgłoszenie musi któryś obudzić
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        for (int i = 0; i < 8; i++)
+            pool.submit([&counter]() { counter++; });
+        pool.wait();
+        ASSERT_EQ(counter.load(), (round + 1) * 8);
+    }
+}
+
+class BatchRunnerTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+    std::vector<std::string> paths;
+
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() / ("tkom_batch_test_" + std::to_string(getpid()));
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        for (int i = 0; i < 24; i++) {
+            std::ostringstream source;
+            // różna długość pętli - skrypty kończą się w innej kolejności niż zostały zgłoszone
+            source << "fun int::main()[ mut int::i = 0; while(i < " << (24 - i) * 200 << ")[ i = i + 1; ]"
+                   << " print(\"script " << i << "\"); return " << i << "; ]";
+            writeScript(name(i), source.str());
+        }
+        writeScript(name(24), "fun int::main()[ int::a = missing; return 0; ]");
+        for (int i = 0; i < 25; i++)
+            paths.push_back((directory / name(i)).string());
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    static std::string name(int i) {
+        std::ostringstream stream;
+        stream << "script" << std::setw(2) << std::setfill('0') << i << ".tk";
+        return stream.str();
+    }
+
+    void writeScript(const std::string& file, const std::string& source) const {
+        std::ofstream(directory / file) << source;
+    }
+};
+
+TEST_F(BatchRunnerTest, OutputOrderDoesNotDependOnThreadCount) {
+    std::ostringstream serial;
+    auto serialResults = BatchRunner(1).run(paths, serial);
+    std::ostringstream parallel;
+    auto parallelResults = BatchRunner(4).run(paths, parallel);
+
+    EXPECT_EQ(parallel.str(), serial.str());
+    ASSERT_EQ(parallelResults.size(), 25);
+    for (int i = 0; i < 24; i++) {
+        EXPECT_EQ(parallelResults[i].output, "script " + std::to_string(i));
+        EXPECT_EQ(std::get<int>(*parallelResults[i].result), i);
+    }
+    EXPECT_FALSE(parallelResults[24].result.has_value());
+    EXPECT_FALSE(parallelResults[24].error.empty());
+    EXPECT_EQ(parallel.str().rfind("==> " + paths[0] + " <==\nscript 0\nreturned: 0\n", 0), 0);
+}
+
+TEST_F(BatchRunnerTest, BudgetAppliesToEachScript) {
+    BatchRunner runner(2);
+    runner.setFuel(1000);
+    std::ostringstream output;
+    auto results = runner.run(paths, output);
+    // pętle 24*200 .. 6*200 iteracji przekraczają limit, krótsze mieszczą się
+    EXPECT_FALSE(results[0].error.empty());
+    EXPECT_TRUE(results[23].error.empty());
+    EXPECT_EQ(std::get<int>(*results[23].result), 23);
+}
+
+TEST_F(BatchRunnerTest, CollectsSourcesFromDirectoryAndList) {
+    auto fromDirectory = BatchRunner::collectSources(directory.string());
+    EXPECT_EQ(fromDirectory, paths);
+
+    auto listPath = directory.parent_path() / ("tkom_batch_list_" + std::to_string(getpid()) + ".txt");
+    std::ofstream(listPath) << "# nightly\n" << paths[3] << "\n\n  " << paths[1] << "  \n";
+    auto fromList = BatchRunner::collectSources(listPath.string());
+    std::filesystem::remove(listPath);
+    EXPECT_EQ(fromList, (std::vector<std::string>{paths[3], paths[1]}));
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <sstream>
+#include <vector>
 #include "charReader.h"
 
 TEST(CharReader, streamConstructor) {
@@ -102,3 +103,51 @@ TEST(CharReaderTest, NextCharTest) {
     while (charReader.nextChar()) {} // Read until EOF
     ASSERT_EQ(charReader.getCurrChar(), EOF);
 }
+
+TEST(CharReaderTest, PositionsAcrossLinesAndTabs) {
+    std::istringstream input("ab\n\tc\td\n");
+    CharReader charReader(input);
+    std::vector<Position> positions;
+    while (charReader.nextChar())
+        positions.push_back(charReader.getPos());
+    std::vector<std::pair<unsigned int, unsigned int>> expected{{1, 1}, {1, 2}, {1, 3}, {2, 1}, {2, 5}, {2, 6}, {2, 9}, {2, 10}};
+    ASSERT_EQ(positions.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(positions[i].line, expected[i].first);
+        EXPECT_EQ(positions[i].column, expected[i].second);
+    }
+    // EOF - pierwsza kolumna linii za ostatnim '\n'
+    EXPECT_EQ(charReader.getLine(), 3);
+    EXPECT_EQ(charReader.getColumn(), 1);
+}
+
+TEST(CharReaderTest, LineTableResolvesEarlierOffsets) {
+    std::istringstream input("x\n\ty\nz");
+    CharReader charReader(input);
+    while (charReader.nextChar()) {}
+    const auto &lines = charReader.getLineTable();
+    EXPECT_EQ(lines.resolve(0).column, 0);
+    EXPECT_EQ(lines.resolve(1).line, 1);
+    EXPECT_EQ(lines.resolve(4).line, 2);
+    EXPECT_EQ(lines.resolve(4).column, 5);
+    EXPECT_EQ(lines.resolve(6).line, 3);
+    EXPECT_EQ(lines.resolve(6).column, 1);
+}
+
+TEST(CharReaderTest, SourceLocationResolvesAfterReaderIsGone) {
+    SourceLocation location;
+    {
+        std::istringstream input("x\n\ty\nz");
+        CharReader charReader(input);
+        for (int i = 0; i < 4; i++)
+            charReader.nextChar();
+        location = charReader.getLocation();
+        while (charReader.nextChar()) {}
+    }
+    EXPECT_EQ(location.resolve().line, 2);
+    EXPECT_EQ(location.resolve().column, 5);
+
+    SourceLocation explicitLocation(Position{7, 3});
+    EXPECT_EQ(explicitLocation.resolve().line, 7);
+    EXPECT_EQ(explicitLocation.resolve().column, 3);
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "engine.h"
+#include "executionContext.h"
+#include "myException.h"
+#include "stats.h"
+
+static const std::string greeter = "str::name = \"world\";"
+                                   "int::times = 1;"
+                                   "fun int::main()[ mut int::i = 0; while(i < times)[ print(\"hello \", name, \" \"); i = i + 1; ] return times * 10; ]";
+
+TEST(EngineTest, CompiledProgramRunsManyTimesWithDifferentInputs) {
+    auto compiled = Engine::compile(greeter);
+
+    std::ostringstream first;
+    auto result = compiled->run({}, first);
+    EXPECT_EQ(first.str(), "hello world ");
+    EXPECT_EQ(std::get<int>(result), 10);
+
+    std::ostringstream second;
+    result = compiled->run({{"name", std::string("engine")}, {"times", 2}}, second);
+    EXPECT_EQ(second.str(), "hello engine hello engine ");
+    EXPECT_EQ(std::get<int>(result), 20);
+
+    // wejścia nie zmieniają skompilowanego programu
+    std::ostringstream third;
+    compiled->run({}, third);
+    EXPECT_EQ(third.str(), "hello world ");
+}
+
+TEST(EngineTest, CompileReportsSemanticErrors) {
+    EXPECT_THROW(Engine::compile("fun int::main()[ int::a = missing; return 0; ]"), MyException);
+}
+
+TEST(EngineTest, CompileReportsFrontEndPhases) {
+    Stats::Report stats;
+    CompileOptions options;
+    options.pipelined = true;
+    options.stats = &stats;
+    Engine::compile(greeter, options);
+    ASSERT_EQ(stats.getPhases().size(), 2);
+    EXPECT_EQ(stats.getPhases()[0].name, "parse");
+    EXPECT_EQ(stats.getPhases()[1].name, "semantic");
+    EXPECT_FALSE(stats.getAstNodeCounts().empty());
+
+    // błąd analizy też zamyka swoją fazę
+    Stats::Report failed;
+    options.stats = &failed;
+    EXPECT_THROW(Engine::compile("fun int::main()[ int::a = missing; return 0; ]", options), MyException);
+    EXPECT_EQ(failed.getPhases().size(), 2);
+}
+
+TEST(EngineTest, RejectsInvalidInputs) {
+    auto compiled = Engine::compile(greeter);
+    std::ostringstream output;
+    EXPECT_THROW(compiled->run({{"missing", 1}}, output), MyException);
+    EXPECT_THROW(compiled->run({{"times", std::string("two")}}, output), MyException);
+    EXPECT_THROW(compiled->run({{"main", 1}}, output), MyException);
+}
+
+TEST(EngineTest, RunUsesGivenBudget) {
+    auto compiled = Engine::compile("fun int::main()[ while(true)[ ] return 0; ]");
+    ExecutionBudget budget;
+    budget.setFuel(1000);
+    std::ostringstream output;
+    EXPECT_THROW(compiled->run({}, output, budget), MyException);
+}
+
+TEST(EngineTest, ExecutionContextIsReusedAcrossRuns) {
+    ExecutionContext context(Engine::compile(greeter));
+    std::ostringstream first;
+    EXPECT_EQ(std::get<int>(context.run({{"times", 3}}, first)), 30);
+    EXPECT_EQ(first.str(), "hello world hello world hello world ");
+
+    // błąd w trakcie wykonania nie zostawia stanu dla kolejnego uruchomienia
+    std::ostringstream failed;
+    EXPECT_THROW(context.run({{"missing", 1}}, failed), MyException);
+    std::ostringstream second;
+    EXPECT_EQ(std::get<int>(context.run({}, second)), 10);
+    EXPECT_EQ(second.str(), "hello world ");
+}
+
+TEST(EngineTest, ThreadsRunOneCompiledProgramConcurrently) {
+    auto compiled = Engine::compile(greeter);
+    constexpr int threadCount = 8;
+    constexpr int runsPerThread = 50;
+    std::vector<int> mismatches(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&compiled, &mismatches, t]() {
+            ExecutionContext context(compiled);
+            std::string name = "thread" + std::to_string(t);
+            for (int run = 0; run < runsPerThread; run++) {
+                int times = 1 + (t + run) % 4;
+                std::ostringstream output;
+                auto result = context.run({{"name", name}, {"times", times}}, output);
+                std::string expected;
+                for (int i = 0; i < times; i++)
+                    expected += "hello " + name + " ";
+                if (output.str() != expected || std::get<int>(result) != times * 10)
+                    mismatches[t]++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (int t = 0; t < threadCount; t++)
+        EXPECT_EQ(mismatches[t], 0) << "thread " << t;
+}
+
+static const std::string lazyProgram = "struct::pair(int::first; int::second;);"
+                                       "fun int::used(int::a)[ mut pair::p(a, 2); if (a > 0)[ return p.first + p.second; ] return 0; ]"
+                                       "fun int::unused()[ return missing; ]"
+                                       "fun int::broken()[ return 1 ]"
+                                       "fun int::main()[ return used(40); ]";
+
+TEST(EngineTest, LazyBodiesAreParsedOnFirstCall) {
+    auto compiled = Engine::compile(lazyProgram, true);
+    const auto& functions = compiled->getProgram().getFunctions();
+    EXPECT_FALSE(functions.at("used")->isBodyParsed());
+    EXPECT_EQ(functions.at("used")->getBlock(), nullptr);
+
+    std::ostringstream output;
+    EXPECT_EQ(std::get<int>(compiled->run({}, output)), 42);
+    EXPECT_TRUE(functions.at("main")->isBodyParsed());
+    EXPECT_TRUE(functions.at("used")->isBodyParsed());
+    // nigdy niewołane funkcje nie są parsowane ani sprawdzane
+    EXPECT_FALSE(functions.at("unused")->isBodyParsed());
+    EXPECT_FALSE(functions.at("broken")->isBodyParsed());
+
+    // kolejne uruchomienie korzysta z załadowanych ciał
+    auto usedBody = functions.at("used")->getBlock();
+    EXPECT_EQ(std::get<int>(compiled->run({}, output)), 42);
+    EXPECT_EQ(functions.at("used")->getBlock(), usedBody);
+}
+
+TEST(EngineTest, LazyBodyErrorsSurfaceOnCall) {
+    EXPECT_THROW(Engine::compile(lazyProgram), MyException);
+    EXPECT_THROW(Engine::compile("fun int::main()[ return 0; ", true), MyException);
+
+    for (const std::string callee : {"unused", "broken"}) {
+        auto source = "fun int::main()[ return " + callee + "(); ]" +
+                      lazyProgram.substr(0, lazyProgram.find("fun int::main"));
+        auto compiled = Engine::compile(source, true);
+        std::ostringstream output;
+        EXPECT_THROW(compiled->run({}, output), MyException) << callee;
+        // błąd zapamiętany - kolejne wywołanie zgłasza go ponownie
+        EXPECT_THROW(compiled->run({}, output), MyException) << callee;
+        EXPECT_FALSE(compiled->getProgram().getFunctions().at(callee)->isBodyParsed());
+    }
+}
+
+TEST(EngineTest, ThreadsLoadLazyBodiesConcurrently) {
+    std::string source;
+    for (int i = 0; i < 64; i++)
+        source += "fun int::f" + std::to_string(i) + "(int::a)[ mut int::b = a + " + std::to_string(i) + "; return b; ]";
+    source += "int::which = 0;";
+    source += "fun int::main()[ mut int::sum = 0;";
+    for (int i = 0; i < 64; i++)
+        source += " if (which == " + std::to_string(i) + ")[ sum = sum + f" + std::to_string(i) + "(1); ]";
+    source += " return sum; ]";
+    auto compiled = Engine::compile(source, true);
+
+    constexpr int threadCount = 8;
+    std::vector<int> mismatches(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&compiled, &mismatches, t]() {
+            ExecutionContext context(compiled);
+            for (int i = 0; i < 64; i++) {
+                int which = (i + t * 8) % 64;
+                std::ostringstream output;
+                if (std::get<int>(context.run({{"which", which}}, output)) != which + 1)
+                    mismatches[t]++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (int t = 0; t < threadCount; t++)
+        EXPECT_EQ(mismatches[t], 0) << "thread " << t;
+    EXPECT_FALSE(compiled->getProgram().hasLazyFunctions());
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include "incrementalDocument.h"
+#include "myException.h"
+
+static const std::string source = "int::base = 3;\n"
+                                  "fun int::square(int::a)[\n"
+                                  "    return a * a;\n"
+                                  "]\n"
+                                  "# komentarz między elementami\n"
+                                  "fun int::scaled(int::a)[ return square(a) * base; ]\n"
+                                  "fun int::main()[\n"
+                                  "\tprint(scaled(2));\n"
+                                  "\treturn 0;\n"
+                                  "]\n";
+
+static void replace(IncrementalDocument& document, const std::string& from, const std::string& to) {
+    auto offset = document.getText().find(from);
+    ASSERT_NE(offset, std::string::npos) << from;
+    document.applyEdit(offset, from.size(), to);
+}
+
+TEST(IncrementalDocumentTest, SplitsTopLevelItems) {
+    IncrementalDocument document(source);
+    ASSERT_EQ(document.getItems().size(), 4);
+    EXPECT_EQ(document.getItems()[0].names.variables.count("base"), 1);
+    EXPECT_EQ(document.getItems()[2].names.functions.count("scaled"), 1);
+    EXPECT_EQ(document.getItems()[2].header, "funint::scaled(int::a)");
+    EXPECT_TRUE(document.getDiagnostics().empty());
+    EXPECT_EQ(document.getProgram().getFunctions().size(), 3);
+    EXPECT_TRUE(document.getLastEdit().fullSemanticCheck);
+}
+
+TEST(IncrementalDocumentTest, BodyEditReparsesOneItem) {
+    IncrementalDocument document(source);
+    replace(document, "return a * a;", "return a * a + 1;");
+
+    const auto& stats = document.getLastEdit();
+    EXPECT_EQ(stats.reparsedItems, 1);
+    EXPECT_EQ(stats.reusedItems, 3);
+    EXPECT_LT(stats.relexedBytes, document.getText().size() / 2);
+    // pozostałe funkcje nie są sprawdzane ponownie
+    EXPECT_FALSE(stats.fullSemanticCheck);
+    EXPECT_EQ(stats.checkedFunctionBodies, 1);
+    EXPECT_TRUE(document.getDiagnostics().empty());
+}
+
+TEST(IncrementalDocumentTest, SignatureChangeRechecksEverything) {
+    IncrementalDocument document(source);
+    replace(document, "fun int::square(int::a)", "fun int::square(int::a, int::b)");
+
+    EXPECT_TRUE(document.getLastEdit().fullSemanticCheck);
+    auto diagnostics = document.getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 1);
+    // błąd w wywołaniu square wewnątrz scaled, pozycja w dokumencie
+    EXPECT_EQ(diagnostics[0].pos.line, 6);
+
+    replace(document, "fun int::square(int::a, int::b)", "fun int::square(int::a)");
+    EXPECT_TRUE(document.getDiagnostics().empty());
+}
+
+TEST(IncrementalDocumentTest, ParseErrorsUseDocumentPositions) {
+    IncrementalDocument document(source);
+    replace(document, "\treturn 0;", "\treturn 0");
+
+    auto diagnostics = document.getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 1);
+    EXPECT_EQ(diagnostics[0].pos.line, 10);
+    EXPECT_EQ(document.getItems().size(), 4);
+
+    replace(document, "\treturn 0", "\treturn 0;");
+    EXPECT_TRUE(document.getDiagnostics().empty());
+    EXPECT_EQ(document.getProgram().getFunctions().size(), 3);
+}
+
+TEST(IncrementalDocumentTest, InsertedLinesShiftLaterItems) {
+    IncrementalDocument document(source);
+    document.applyEdit(document.getText().find('\n'), 0, "\n\nfun int::cube(int::a)[ return a * a * a; ]");
+
+    EXPECT_EQ(document.getLastEdit().reparsedItems, 1);
+    ASSERT_EQ(document.getItems().size(), 5);
+    replace(document, "print(scaled(2));", "print(missing(2));");
+    auto diagnostics = document.getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 1);
+    EXPECT_EQ(diagnostics[0].pos.line, 10);
+
+    // parser zapisuje pozycję wywołania po jego argumentach
+    auto offset = document.offsetOf(diagnostics[0].pos);
+    auto call = document.getText().find("missing(2)");
+    EXPECT_GT(offset, call);
+    EXPECT_LE(offset, call + 10);
+    ASSERT_NE(document.itemAt(offset), nullptr);
+    EXPECT_EQ(document.itemAt(offset)->names.functions.count("main"), 1);
+}
+
+TEST(IncrementalDocumentTest, DuplicateNamesReportedUntilRemoved) {
+    IncrementalDocument document(source);
+    auto end = document.getText().size();
+    document.applyEdit(end, 0, "fun int::square(int::b)[ return b; ]\n");
+
+    auto diagnostics = document.getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 1);
+    EXPECT_EQ(diagnostics[0].pos.line, 11);
+    EXPECT_FALSE(document.getItems().back().inProgram);
+
+    // usunięcie pierwszej definicji wprowadza drugą do programu
+    replace(document, "fun int::square(int::a)[\n    return a * a;\n]\n", "");
+    EXPECT_TRUE(document.getDiagnostics().empty());
+    EXPECT_TRUE(document.getItems().back().inProgram);
+    EXPECT_EQ(document.getProgram().getFunctions().size(), 3);
+}
+
+TEST(IncrementalDocumentTest, EditsMatchFreshDocument) {
+    IncrementalDocument document(source);
+    replace(document, "int::base = 3;", "int::base = 4; str::name = \"x\";");
+    replace(document, "square(a) * base", "square(a) * base + 1");
+    replace(document, "# komentarz", "/# komentarz\nfun int::f()[ return 1; ]\n#/ #");
+    document.applyEdit(document.getText().size(), 0, "struct::pair(int::a; int::b;);");
+
+    IncrementalDocument fresh(document.getText());
+    ASSERT_EQ(document.getItems().size(), fresh.getItems().size());
+    for (std::size_t i = 0; i < fresh.getItems().size(); i++) {
+        EXPECT_EQ(document.getItems()[i].begin, fresh.getItems()[i].begin);
+        EXPECT_EQ(document.getItems()[i].end, fresh.getItems()[i].end);
+        EXPECT_EQ(document.getItems()[i].names.functions, fresh.getItems()[i].names.functions);
+    }
+    EXPECT_EQ(document.getProgram().getVariables().size(), 2);
+    EXPECT_EQ(document.getProgram().getStructTypes().size(), 1);
+    EXPECT_TRUE(document.getDiagnostics().empty());
+    for (std::size_t offset = 0; offset <= document.getText().size(); offset++)
+        EXPECT_EQ(document.offsetOf(document.positionOf(offset)), offset);
+}
+
+TEST(IncrementalDocumentTest, RejectsEditOutsideDocument) {
+    IncrementalDocument document(source);
+    EXPECT_THROW(document.applyEdit(source.size() + 1, 0, "x"), MyException);
+    EXPECT_THROW(document.applyEdit(source.size() - 1, 2, ""), MyException);
+}
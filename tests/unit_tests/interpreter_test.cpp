@@ -1,5 +1,215 @@
 #include <gtest/gtest.h>
 #include <sstream>
+#include <thread>
 
 #include "interpreterVisitor.h"
-#include "parser.h"
\ No newline at end of file
+#include "parser.h"
+#include "semanticVisitor.h"
+#include "scopeResolver.h"
+
+std::string runInterpreter(const std::string& source) {
+    std::istringstream strStream(source);
+    Parser parser(strStream);
+    std::unique_ptr<Nodes::Program> program = parser.parseProgram();
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(semanticVisitor);
+    testing::internal::CaptureStdout();
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(interpreterVisitor);
+    return testing::internal::GetCapturedStdout();
+}
+
+std::string structFieldRead = "struct::car(str::model; int::hp; bool::sale; float::price;);"
+                              "fun int::main()[ car::c(\"Mazda\", 250, true, 9.5); int::hp = c.hp; print(c.model, \" \", hp); return 0; ]";
+
+TEST(InterpreterTest, StructFieldRead) {
+    EXPECT_EQ(runInterpreter(structFieldRead), "Mazda 250");
+}
+
+TEST(InterpreterTest, OperatorChainsAreLeftAssociative) {
+    EXPECT_EQ(runInterpreter("fun int::main()[ print(10 - 3 - 2, \" \", 100 / 10 / 5, \" \", 2 + 3 * 4 - 1); return 0; ]"), "5 2 13");
+}
+
+std::string structFieldUnknown = "struct::car(str::model;);"
+                                 "fun int::main()[ car::c(\"Mazda\"); print(c.speed); return 0; ]";
+
+TEST(InterpreterTest, StructFieldUnknown) {
+    EXPECT_THROW(runInterpreter(structFieldUnknown), MyException);
+}
+
+std::string structFieldMutation = "struct::acc(int::count; int::sum; str::name;);"
+                                  "fun int::main()[ mut acc::a(0, 0, \"acc\"); mut int::i = 0;"
+                                  "while(i < 5)[ a.count = a.count + 1; a.sum = a.sum + i; i = i + 1; ]"
+                                  "print(a.name, \" \", a.count, \" \", a.sum); return 0; ]";
+
+TEST(InterpreterTest, StructFieldMutationInPlace) {
+    EXPECT_EQ(runInterpreter(structFieldMutation), "acc 5 10");
+}
+
+std::string structFieldImmutable = "struct::acc(int::count;);"
+                                   "fun int::main()[ acc::a(0); a.count = 1; return 0; ]";
+
+TEST(InterpreterTest, StructFieldAssignmentToImmutableStruct) {
+    EXPECT_THROW(runInterpreter(structFieldImmutable), MyException);
+}
+
+std::string variantHolding = "variant::event(int; str; bool;);"
+                             "fun int::main()[ event::e = 5; print(e.holding(), \" \"); e = \"click\";"
+                             "print(e.holding(), \" \", e); return 0; ]";
+
+TEST(InterpreterTest, VariantHoldingFollowsAssignments) {
+    EXPECT_EQ(runInterpreter(variantHolding), "int str click");
+}
+
+std::string variantWrongAlternative = "variant::event(int; str;);"
+                                      "fun int::main()[ event::e = 5; e = true; return 0; ]";
+
+TEST(InterpreterTest, VariantAssignmentOfUnlistedType) {
+    EXPECT_THROW(runInterpreter(variantWrongAlternative), MyException);
+}
+
+std::string variantBranching = "variant::event(int; str; bool;);"
+                               "fun int::main()[ mut event::e = 5; mut int::i = 0; while (i < 3)["
+                               "if (i == 1)[ e = \"click\"; ] if (i == 2)[ e = true; ]"
+                               "if (e.holding() == int)[ print(\"int \"); ] if (e.holding() == str)[ print(\"str \"); ]"
+                               "if (e.holding() != bool)[ i = i + 1; ] else [ print(\"bool \"); i = i + 1; ] ]"
+                               "if (e.holding() == \"bool\")[ print(\"named\"); ] return 0; ]";
+
+TEST(InterpreterTest, VariantBranchesOnEachAlternative) {
+    EXPECT_EQ(runInterpreter(variantBranching), "int str bool named");
+}
+
+std::string holdingOfUnlistedType = "variant::event(int; str;);"
+                                    "fun int::main()[ event::e = 5; if (e.holding() == float)[ print(1); ] return 0; ]";
+
+TEST(InterpreterTest, HoldingComparedWithUnlistedType) {
+    EXPECT_THROW(runInterpreter(holdingOfUnlistedType), MyException);
+}
+
+std::string holdingOnScalar = "fun int::main()[ int::x = 5; print(x.holding()); return 0; ]";
+
+TEST(InterpreterTest, HoldingOnNonVariant) {
+    EXPECT_THROW(runInterpreter(holdingOnScalar), MyException);
+}
+
+std::string uncheckedVariantAsScalar = "variant::ev(int; str;);"
+                                       "fun int::main()[ ev::e = \"a\"; int::x = e; print(x); return 0; ]";
+
+TEST(InterpreterTest, UncheckedVariantAsScalar) {
+    try {
+        runInterpreter(uncheckedVariantAsScalar);
+        FAIL() << "Expected MyException";
+    } catch (const MyException& e) {
+        EXPECT_NE(std::string(e.what()).find("checked with holding()"), std::string::npos);
+    }
+    EXPECT_THROW(runInterpreter("variant::ev(int; str;); fun int::main()[ ev::e = 1; print(e + 1); return 0; ]"), MyException);
+    EXPECT_THROW(runInterpreter("variant::ev(int; str;); fun int::f()[ ev::e = 1; return e; ] fun int::main()[ return f(); ]"), MyException);
+}
+
+std::string checkedVariantAsScalar = "variant::ev(int; str;);"
+                                     "fun int::main()[ ev::e = 5; if (e.holding() == int)[ int::x = e + 1; print(x); ]"
+                                     "if (e.holding() != str)[ print(\" int\"); ] else [ str::s = e; print(s); ] return 0; ]";
+
+TEST(InterpreterTest, CheckedVariantAsScalar) {
+    EXPECT_EQ(runInterpreter(checkedVariantAsScalar), "6 int");
+    // w gałęzi wariant ma testowany typ, nie dowolny
+    EXPECT_THROW(runInterpreter("variant::ev(int; str;); fun int::main()[ ev::e = 5; if (e.holding() == int)[ print(e + \"a\"); ] return 0; ]"), MyException);
+}
+
+std::string staleHoldingInLoop = "variant::ev(int; str;);"
+                                 "fun int::main()[ mut ev::e = 5; if (e.holding() == int)[ mut int::i = 0;"
+                                 "while (i < 2)[ int::x = e; print(x); e = \"a\"; i = i + 1; ] ] return 0; ]";
+
+TEST(InterpreterTest, StaleHoldingInLoop) {
+    try {
+        runInterpreter(staleHoldingInLoop);
+        FAIL() << "Expected MyException";
+    } catch (const MyException& e) {
+        testing::internal::GetCapturedStdout();
+        EXPECT_NE(std::string(e.what()).find("Variant e no longer holds int"), std::string::npos);
+    }
+}
+
+std::string recursiveCalls = "fun int::fib(int::n)[ if (n < 2)[ return n; ] int::a = fib(n - 1); int::b = fib(n - 2); return a + b; ]"
+                             "fun int::main()[ print(fib(10), \" \", fib(1)); return 0; ]";
+
+TEST(InterpreterTest, RecursiveCallsUseSeparateFrames) {
+    EXPECT_EQ(runInterpreter(recursiveCalls), "55 1");
+}
+
+std::string blockLocals = "mut int::total = 0;"
+                          "fun int::main()[ mut int::i = 0; while(i < 3)[ int::sq = i * i; total = total + sq; i = i + 1; ]"
+                          "if (total > 0)[ str::msg = \"total \"; print(msg, total); ] else [ int::other = 1; print(other); ] return 0; ]";
+
+TEST(InterpreterTest, BlockLocalsAndGlobals) {
+    EXPECT_EQ(runInterpreter(blockLocals), "total 5");
+}
+
+TEST(ScopeResolverTest, FrameSizeReusesSlotsOfClosedBlocks) {
+    std::istringstream strStream("fun int::f(int::p)[ int::a = 1; if (a > 0)[ int::b = 2; int::c = 3; ] while(a < 0)[ int::d = 4; ] return a; ]");
+    Parser parser(strStream);
+    std::unique_ptr<Nodes::Program> program = parser.parseProgram();
+    ScopeResolver scopeResolver;
+    program->accept(scopeResolver);
+    // p, a oraz maksymalnie dwie zmienne bloku naraz
+    EXPECT_EQ(program->getFunctions().at("f")->getFrameSize(), 4);
+}
+
+static void runWithBudget(const std::string& source, std::optional<std::uint64_t> fuel,
+                          std::optional<std::chrono::milliseconds> timeLimit = std::nullopt) {
+    std::istringstream strStream(source);
+    Parser parser(strStream);
+    std::unique_ptr<Nodes::Program> program = parser.parseProgram();
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(semanticVisitor);
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    if (fuel)
+        interpreterVisitor.getBudget().setFuel(*fuel);
+    if (timeLimit)
+        interpreterVisitor.getBudget().setTimeLimit(*timeLimit);
+    program->accept(interpreterVisitor);
+}
+
+TEST(InterpreterTest, FuelStopsInfiniteLoop) {
+    try {
+        runWithBudget("fun int::main()[ mut int::i = 0; while(true)[ i = i + 1; ] return 0; ]", 10000);
+        FAIL() << "Expected MyException";
+    } catch (const MyException& e) {
+        EXPECT_EQ(std::string(e.what()).rfind("Execution budget exhausted", 0), 0);
+    }
+}
+
+TEST(InterpreterTest, FuelStopsInfiniteRecursion) {
+    EXPECT_THROW(runWithBudget("fun int::f(int::n)[ int::r = f(n + 1); return r; ] fun int::main()[ int::x = f(0); return 0; ]", 200),
+                 MyException);
+}
+
+TEST(InterpreterTest, FuelCountsBackEdgesAndCalls) {
+    // wejście do main + 3 skoki wstecz pętli
+    std::string loop = "fun int::main()[ mut int::i = 0; while(i < 3)[ i = i + 1; ] return 0; ]";
+    EXPECT_NO_THROW(runWithBudget(loop, 4));
+    EXPECT_THROW(runWithBudget(loop, 3), MyException);
+}
+
+TEST(InterpreterTest, DeadlineStopsInfiniteLoop) {
+    try {
+        runWithBudget("fun int::main()[ while(true)[ ] return 0; ]", std::nullopt, std::chrono::milliseconds(20));
+        FAIL() << "Expected MyException";
+    } catch (const MyException& e) {
+        EXPECT_EQ(std::string(e.what()).rfind("Execution time limit exceeded", 0), 0);
+    }
+}
+
+TEST(InterpreterTest, DeadlineCountsFromStartOfRun) {
+    std::istringstream strStream("fun int::main()[ mut int::i = 0; while(i < 5000)[ i = i + 1; ] return 0; ]");
+    Parser parser(strStream);
+    std::unique_ptr<Nodes::Program> program = parser.parseProgram();
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(semanticVisitor);
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    interpreterVisitor.getBudget().setTimeLimit(std::chrono::milliseconds(200));
+    // czas między ustawieniem limitu a startem wykonania nie zużywa terminu; pętla przechodzi
+    // przez kilka sprawdzeń zegara (co DEADLINE_CHECK_INTERVAL punktów kontrolnych)
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    EXPECT_NO_THROW(program->accept(interpreterVisitor));
+}
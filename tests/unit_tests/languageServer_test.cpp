@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+
+#include "definitionFinder.h"
+#include "json.h"
+#include "languageServer.h"
+#include "myException.h"
+
+static const std::string uri = "file:///test.tk";
+static const std::string source = "struct::rec(int::first; str::label;);\n"
+                                  "int::base = 3;\n"
+                                  "fun int::twice(int::a)[ return a + a + base; ]\n"
+                                  "fun int::main()[\n"
+                                  "    mut rec::r(1, \"x\");\n"
+                                  "    int::a = twice(r.first);\n"
+                                  "    if (a > 2)[ int::a = 5; print(a); ]\n"
+                                  "    return a;\n"
+                                  "]\n";
+
+static std::string frame(const Json& message) {
+    auto body = message.dump();
+    return "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+static Json request(int id, const std::string& method, Json params) {
+    return Json::Object{{"jsonrpc", "2.0"}, {"id", id}, {"method", method}, {"params", std::move(params)}};
+}
+
+static Json notification(const std::string& method, Json params) {
+    return Json::Object{{"jsonrpc", "2.0"}, {"method", method}, {"params", std::move(params)}};
+}
+
+static Json lspPosition(std::size_t line, std::size_t character) {
+    return Json::Object{{"line", line}, {"character", character}};
+}
+
+static Json openDocument(const std::string& text) {
+    return notification("textDocument/didOpen", Json::Object{
+            {"textDocument", Json::Object{{"uri", uri}, {"languageId", "tkom"}, {"version", 1}, {"text", text}}}});
+}
+
+static Json changeDocument(std::size_t line, std::size_t from, std::size_t to, const std::string& text) {
+    Json range = Json::Object{{"start", lspPosition(line, from)}, {"end", lspPosition(line, to)}};
+    return notification("textDocument/didChange", Json::Object{
+            {"textDocument", Json::Object{{"uri", uri}, {"version", 2}}},
+            {"contentChanges", Json::Array{Json::Object{{"range", range}, {"text", text}}}}});
+}
+
+class LanguageServerTest : public ::testing::Test
+{
+protected:
+    std::string input;
+    std::vector<Json> messages;
+    int exitCode = -1;
+
+    void send(const Json& message) {
+        input += frame(message);
+    }
+
+    void run() {
+        std::istringstream in(input);
+        std::ostringstream out;
+        exitCode = LanguageServer(in, out).run();
+
+        std::istringstream responses(out.str());
+        std::string line;
+        while (std::getline(responses, line)) {
+            auto length = std::stoul(line.substr(line.find(':') + 1));
+            std::getline(responses, line);
+            std::string body(length, '\0');
+            responses.read(body.data(), static_cast<std::streamsize>(length));
+            messages.push_back(Json::parse(body));
+        }
+    }
+
+    const Json& response(int id) {
+        for (const auto& message : messages)
+            if (message["id"] == Json(id))
+                return message;
+        static const Json missing;
+        ADD_FAILURE() << "no response " << id;
+        return missing;
+    }
+
+    Json lastDiagnostics() {
+        Json last;
+        for (const auto& message : messages)
+            if (message["method"] == Json("textDocument/publishDiagnostics"))
+                last = message["params"]["diagnostics"];
+        return last;
+    }
+};
+
+TEST(JsonTest, ParsesAndWritesValues) {
+    auto value = Json::parse(R"( {"a": [1, -2.5, "x\ną😀", true, null], "b": {}} )");
+    const auto& array = value["a"].asArray();
+    ASSERT_EQ(array.size(), 5);
+    EXPECT_EQ(array[0].asIndex(), 1);
+    EXPECT_DOUBLE_EQ(array[1].asNumber(), -2.5);
+    EXPECT_EQ(array[2].asString(), "x\n\xC4\x85\xF0\x9F\x98\x80");
+    EXPECT_TRUE(array[3].asBool());
+    EXPECT_TRUE(array[4].isNull());
+    EXPECT_TRUE(value["b"].asObject().empty());
+    EXPECT_TRUE(value["missing"].isNull());
+    EXPECT_EQ(Json::parse(value.dump()), value);
+    EXPECT_EQ(Json(Json::Object{{"id", 7}, {"s", "a\"b"}}).dump(), R"({"id":7,"s":"a\"b"})");
+}
+
+TEST(JsonTest, RejectsInvalidText) {
+    EXPECT_THROW(Json::parse(R"({"a":})"), MyException);
+    EXPECT_THROW(Json::parse("[1,"), MyException);
+    EXPECT_THROW(Json::parse(R"("open)"), MyException);
+    EXPECT_THROW(Json::parse("{} x"), MyException);
+    EXPECT_THROW((void)Json::parse("1").asString(), MyException);
+}
+
+TEST(DefinitionFinderTest, ResolvesLocalsGlobalsTypesAndFields) {
+    IncrementalDocument document(source);
+    ASSERT_TRUE(document.getDiagnostics().empty());
+    DefinitionFinder finder(document);
+    auto definitionOf = [&](const std::string& use, std::size_t occurrence, std::size_t skip = 0) {
+        auto offset = document.getText().find(use);
+        for (std::size_t i = 0; i < occurrence; i++)
+            offset = document.getText().find(use, offset + 1);
+        auto definition = finder.find(offset + skip);
+        return definition ? definition->begin : std::string::npos;
+    };
+    const auto& text = document.getText();
+
+    // parametr, zmienna globalna, funkcja
+    EXPECT_EQ(definitionOf("a + a", 0), text.find("int::a)") + 5);
+    EXPECT_EQ(definitionOf("base;", 0), text.find("base"));
+    EXPECT_EQ(definitionOf("twice(r", 0), text.find("twice"));
+    // typ struktury i jej pole
+    EXPECT_EQ(definitionOf("rec::r", 0), text.find("rec"));
+    EXPECT_EQ(definitionOf("first)", 0), text.find("first"));
+    // zmienna z bloku przesłania zewnętrzną, po bloku znowu widać zewnętrzną
+    EXPECT_EQ(definitionOf("print(a)", 0, 6), text.find("int::a = 5") + 5);
+    EXPECT_EQ(definitionOf("return a;", 0, 7), text.find("int::a = twice") + 5);
+    // kursor w przerwie między elementami
+    EXPECT_FALSE(finder.find(text.find("\nint::base")).has_value());
+}
+
+TEST_F(LanguageServerTest, AnswersInitializeAndShutdown) {
+    send(request(1, "initialize", Json::Object{{"capabilities", Json::Object()}}));
+    send(notification("initialized", Json::Object()));
+    send(request(2, "unknown/method", nullptr));
+    send(request(3, "shutdown", nullptr));
+    send(notification("exit", nullptr));
+    run();
+
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_EQ(response(1)["result"]["capabilities"]["textDocumentSync"]["change"].asIndex(), 2);
+    EXPECT_TRUE(response(1)["result"]["capabilities"]["definitionProvider"].asBool());
+    EXPECT_TRUE(response(2).contains("error"));
+    EXPECT_TRUE(response(3)["result"].isNull());
+}
+
+TEST_F(LanguageServerTest, RejectsMalformedContentLength) {
+    input += "Content-Length: abc\r\n\r\n{}\r\n";
+    send(request(1, "shutdown", nullptr));
+    send(notification("exit", nullptr));
+    run();
+
+    EXPECT_EQ(exitCode, 0);
+    ASSERT_FALSE(messages.empty());
+    EXPECT_EQ(messages.front()["error"]["code"].asNumber(), -32700);
+    EXPECT_TRUE(response(1)["result"].isNull());
+}
+
+TEST_F(LanguageServerTest, ExitWithoutShutdownFails) {
+    send(notification("exit", nullptr));
+    run();
+    EXPECT_EQ(exitCode, 1);
+}
+
+TEST_F(LanguageServerTest, PublishesDiagnosticsForEdits) {
+    send(openDocument(source));
+    // "return a + a + base;" -> "return a + a + missing;"
+    send(changeDocument(2, 39, 43, "missing"));
+    send(request(1, "shutdown", nullptr));
+    send(notification("exit", nullptr));
+    run();
+
+    auto diagnostics = lastDiagnostics();
+    ASSERT_EQ(diagnostics.asArray().size(), 1);
+    EXPECT_EQ(diagnostics.asArray()[0]["range"]["start"]["line"].asIndex(), 2);
+    EXPECT_EQ(diagnostics.asArray()[0]["severity"].asIndex(), 1);
+}
+
+TEST_F(LanguageServerTest, FixingAnErrorClearsDiagnostics) {
+    send(openDocument(source));
+    send(changeDocument(7, 12, 13, ""));
+    send(request(1, "shutdown", nullptr));
+    send(changeDocument(7, 12, 12, ";"));
+    send(request(2, "shutdown", nullptr));
+    send(notification("exit", nullptr));
+    run();
+
+    std::vector<std::size_t> counts;
+    for (const auto& message : messages)
+        if (message["method"] == Json("textDocument/publishDiagnostics"))
+            counts.push_back(message["params"]["diagnostics"].asArray().size());
+    // otwarcie może jeszcze opublikować stan bez błędów, zanim dotrze pierwsza zmiana
+    ASSERT_GE(counts.size(), 2);
+    EXPECT_EQ(counts[counts.size() - 2], 1);
+    EXPECT_EQ(counts.back(), 0);
+}
+
+// niedokończony tekst z edytora to błąd składni w diagnostykach, serwer odpowiada dalej
+TEST_F(LanguageServerTest, SurvivesHalfTypedText) {
+    send(openDocument(source));
+    // "int::a = twice(r.first);" -> "int::returnwhile (true) [ ] r;a = twice(r.first);"
+    send(changeDocument(5, 9, 9, "returnwhile (true) [ ] r;"));
+    send(request(1, "shutdown", nullptr));
+    send(openDocument(source));
+    send(changeDocument(5, 10, 10, "fun int::mul(ifun ::a, int::b)["));
+    send(request(2, "shutdown", nullptr));
+    // niedomknięty literał napisu
+    send(openDocument(source));
+    send(changeDocument(7, 4, 4, "print(\"abc"));
+    send(request(3, "shutdown", nullptr));
+    send(notification("exit", nullptr));
+    run();
+
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_TRUE(response(1)["result"].isNull());
+    EXPECT_TRUE(response(2)["result"].isNull());
+    EXPECT_TRUE(response(3)["result"].isNull());
+    EXPECT_FALSE(lastDiagnostics().asArray().empty());
+}
+
+TEST_F(LanguageServerTest, GoesToDefinition) {
+    send(openDocument(source));
+    // "twice" w wywołaniu w main
+    send(request(1, "textDocument/definition", Json::Object{
+            {"textDocument", Json::Object{{"uri", uri}}}, {"position", lspPosition(5, 15)}}));
+    send(request(2, "textDocument/definition", Json::Object{
+            {"textDocument", Json::Object{{"uri", "file:///closed.tk"}}}, {"position", lspPosition(0, 0)}}));
+    send(request(3, "shutdown", nullptr));
+    send(notification("exit", nullptr));
+    run();
+
+    const auto& location = response(1)["result"];
+    EXPECT_EQ(location["uri"].asString(), uri);
+    EXPECT_EQ(location["range"]["start"], lspPosition(2, 9));
+    EXPECT_EQ(location["range"]["end"], lspPosition(2, 14));
+    EXPECT_TRUE(response(2).contains("error"));
+}
+
+TEST(LanguageServerPositionTest, CountsUtf16Units) {
+    IncrementalDocument document("fun int::main()[\n    str::s = \"\xC4\x85\xF0\x9F\x98\x80\"; return 0;\n]\n");
+    auto offset = document.getText().find("; return");
+    auto position = LanguageServer::toLspPosition(document, offset);
+    // ą - jedna jednostka, emoji - dwie
+    EXPECT_EQ(position, lspPosition(1, 18));
+    EXPECT_EQ(LanguageServer::toOffset(document, position), offset);
+    // znak poza końcem linii wskazuje jej koniec
+    EXPECT_EQ(LanguageServer::toOffset(document, lspPosition(0, 100)), document.getText().find('\n'));
+}
+
+TEST(LanguageServerPositionTest, LargeDocumentEditStaysLocal) {
+    std::string text;
+    for (int i = 0; i < 8000; i++)
+        text += "fun int::f" + std::to_string(i) + "(int::a, int::b)[\n"
+                "    mut int::sum = a * 2 + b;\n"
+                "    if (sum > 10)[ sum = sum - 1; ]\n"
+                "    return sum;\n"
+                "]\n";
+    text += "fun int::main()[ return f0(1, 2); ]\n";
+    IncrementalDocument document(text);
+    ASSERT_GT(std::count(text.begin(), text.end(), '\n'), 40000);
+
+    auto offset = document.getText().find("sum - 1", document.getText().size() / 2);
+    document.applyEdit(offset, 7, "sum - 2");
+    const auto& stats = document.getLastEdit();
+    EXPECT_EQ(stats.reparsedItems, 1);
+    EXPECT_LT(stats.relexedBytes, 200);
+    EXPECT_FALSE(stats.fullSemanticCheck);
+    EXPECT_EQ(stats.checkedFunctionBodies, 1);
+    EXPECT_TRUE(document.getDiagnostics().empty());
+}
@@ -403,3 +403,32 @@ TEST(LexerTest, NumberLiteralsTest) {
     ASSERT_EQ(lexer.getNextToken().getType(), TokenTypes::EOF_TOKEN);
 }
 
+TEST(LexerTest, IntLiteralLimits) {
+    std::istringstream input("2147483647 -2147483648 99999999999.5");
+    Lexer lexer(input);
+    lexer.nextChar();
+    ASSERT_TRUE(lexer.checkAndAssignTokenNumber());
+    ASSERT_EQ(std::get<int>(lexer.currToken.getValue()), 2147483647);
+    lexer.nextChar();
+    ASSERT_TRUE(lexer.checkAndAssignTokenNumber());
+    ASSERT_EQ(std::get<int>(lexer.currToken.getValue()), -2147483648);
+    lexer.nextChar();
+    // przepełniona część całkowita nie przeszkadza literałowi float
+    ASSERT_TRUE(lexer.checkAndAssignTokenNumber());
+    ASSERT_FLOAT_EQ(std::get<float>(lexer.currToken.getValue()), 99999999999.5f);
+}
+
+TEST(LexerTest, NumberTooLongTest) {
+    std::istringstream intInput("2147483648");
+    Lexer intLexer(intInput);
+    ASSERT_THROW(intLexer.getNextToken(), MyException);
+    std::istringstream floatInput("1" + std::string(50, '0') + ".0");
+    Lexer floatLexer(floatInput);
+    ASSERT_THROW(floatLexer.getNextToken(), MyException);
+}
+
+TEST(LexerTest, UnterminatedStrLiteralTest) {
+    std::istringstream input("\"abc");
+    Lexer lexer(input);
+    ASSERT_THROW(lexer.getNextToken(), MyException);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "moduleGraph.h"
+#include "myException.h"
+#include "parser.h"
+#include "stats.h"
+
+class ModuleGraphTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() / ("tkom_modules_test_" + std::to_string(getpid()));
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory / "lib");
+        // main -> shapes -> math, main -> util -> math (romb w grafie zależności)
+        write("lib/math.tk", "fun int::square(int::a)[ return a * a; ]");
+        write("lib/shapes.tk", "import \"math.tk\";"
+                               "struct::rect(int::w; int::h;);"
+                               "fun int::area(int::w, int::h)[ return w * h + square(0); ]");
+        write("util.tk", "import \"lib/math.tk\";"
+                         "int::base = 3;"
+                         "fun int::scaled(int::a)[ return square(a) * base; ]");
+        write("main.tk", "import \"lib/shapes.tk\";\nimport \"util.tk\";\n"
+                         "fun int::main()[ mut rect::r(2, 5); print(area(r.w, r.h), \" \", scaled(2)); return 0; ]");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    void write(const std::string& name, const std::string& source) const {
+        std::ofstream(directory / name) << source;
+    }
+
+    std::string path(const std::string& name) const {
+        return ModuleGraph::canonicalPath((directory / name).string());
+    }
+
+    static std::string run(ModuleGraph& graph, const std::string& root) {
+        std::ostringstream output;
+        graph.build(root)->run({}, output);
+        return output.str();
+    }
+};
+
+TEST(ImportParsingTest, ImportsAreParsedBeforeDeclarations) {
+    std::istringstream strStream("import \"a.tk\"; import \"lib/b.tk\"; fun int::main()[ return 0; ]");
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    ASSERT_EQ(program->getImports().size(), 2);
+    EXPECT_EQ(program->getImports()[0].path, "a.tk");
+    EXPECT_EQ(program->getImports()[1].path, "lib/b.tk");
+    EXPECT_EQ(program->getFunctions().size(), 1);
+}
+
+TEST(ImportParsingTest, ImportNeedsPathAndSemicolon) {
+    std::istringstream missingPath("import main; fun int::main()[ return 0; ]");
+    EXPECT_THROW(Parser(missingPath).parseProgram(), MyException);
+    std::istringstream missingSemicolon("import \"a.tk\" fun int::main()[ return 0; ]");
+    EXPECT_THROW(Parser(missingSemicolon).parseProgram(), MyException);
+}
+
+TEST_F(ModuleGraphTest, LinksModulesAcrossTheDependencyGraph) {
+    ModuleGraph graph(4);
+    EXPECT_EQ(run(graph, path("main.tk")), "10 12");
+    EXPECT_EQ(graph.getLastBuild().parsed.size(), 4);
+    EXPECT_EQ(graph.getLastBuild().checked.size(), 4);
+}
+
+TEST_F(ModuleGraphTest, UnchangedBuildReusesEverything) {
+    ModuleGraph graph;
+    run(graph, path("main.tk"));
+    EXPECT_EQ(run(graph, path("main.tk")), "10 12");
+    EXPECT_TRUE(graph.getLastBuild().parsed.empty());
+    EXPECT_TRUE(graph.getLastBuild().checked.empty());
+}
+
+TEST_F(ModuleGraphTest, EditRechecksOnlyModuleAndDependents) {
+    ModuleGraph graph;
+    run(graph, path("main.tk"));
+
+    write("util.tk", "import \"lib/math.tk\";"
+                     "int::base = 10;"
+                     "fun int::scaled(int::a)[ return square(a) * base; ]");
+    EXPECT_EQ(run(graph, path("main.tk")), "10 40");
+    EXPECT_EQ(graph.getLastBuild().parsed, std::vector<std::string>{path("util.tk")});
+    EXPECT_EQ(graph.getLastBuild().checked, (std::vector<std::string>{path("main.tk"), path("util.tk")}));
+
+    write("lib/math.tk", "fun int::square(int::a)[ return a * a + 1; ]");
+    EXPECT_EQ(run(graph, path("main.tk")), "11 50");
+    EXPECT_EQ(graph.getLastBuild().parsed, std::vector<std::string>{path("lib/math.tk")});
+    EXPECT_EQ(graph.getLastBuild().checked.size(), 4);
+}
+
+TEST_F(ModuleGraphTest, EngineBuildsFileWithImportsThroughTheGraph) {
+    Stats::Report stats;
+    CompileOptions options;
+    options.lazyBodies = true;
+    options.pipelined = true;
+    options.threads = 2;
+    options.stats = &stats;
+    auto compiled = Engine::compileFile(path("main.tk"), options);
+    std::ostringstream output;
+    compiled->run({}, output);
+    EXPECT_EQ(output.str(), "10 12");
+    // moduły parsowane w fazie parse razem z korzeniem, analiza grafu w fazie semantic
+    ASSERT_EQ(stats.getPhases().size(), 2);
+    EXPECT_EQ(stats.getPhases()[0].name, "parse");
+    EXPECT_EQ(stats.getPhases()[1].name, "semantic");
+    EXPECT_FALSE(stats.getAstNodeCounts().empty());
+}
+
+TEST_F(ModuleGraphTest, ErrorsNameTheModule) {
+    ModuleGraph graph;
+    write("util.tk", "import \"lib/math.tk\"; fun int::scaled(int::a)[ return missing(a); ]");
+    try {
+        graph.build(path("main.tk"));
+        FAIL() << "expected semantic error";
+    } catch (MyException& e) {
+        EXPECT_NE(std::string(e.what()).find(path("util.tk")), std::string::npos) << e.what();
+    }
+
+    // nieudana analiza nie zostawia wyniku - ponowne budowanie bez zmian zgłasza ten sam błąd
+    EXPECT_THROW(graph.build(path("main.tk")), MyException);
+
+    write("util.tk", "import \"lib/math.tk\"; fun int::scaled(int::a)[ return a; ]");
+    EXPECT_EQ(run(graph, path("main.tk")), "10 2");
+}
+
+TEST_F(ModuleGraphTest, RejectsCyclesMissingModulesAndDuplicates) {
+    ModuleGraph graph;
+    write("lib/math.tk", "import \"../main.tk\"; fun int::square(int::a)[ return a * a; ]");
+    EXPECT_THROW(graph.build(path("main.tk")), MyException);
+
+    write("lib/math.tk", "import \"nowhere.tk\"; fun int::square(int::a)[ return a * a; ]");
+    EXPECT_THROW(graph.build(path("main.tk")), MyException);
+
+    write("lib/math.tk", "fun int::square(int::a)[ return a * a; ] fun int::scaled(int::a)[ return a; ]");
+    EXPECT_THROW(graph.build(path("main.tk")), MyException);
+}
@@ -294,6 +294,61 @@ TEST(ParserTest, ParsesOrExpression) {
 }
 
 
+TEST(ParserTest, BuildsLeftAssociativeChains) {
+    std::istringstream strStream("10 - 3 - 2");
+    Parser parser(strStream);
+    auto artmExpr = parser.parseArtmExpression();
+    ASSERT_NE(artmExpr, nullptr);
+
+    // (10 - 3) - 2: lewy operand to łańcuch w opakowaniu jak dla nawiasów
+    const auto* rightArtmExpr = dynamic_cast<const Nodes::ArtmExpr*>(artmExpr->getRightOperand());
+    ASSERT_NE(rightArtmExpr, nullptr);
+    EXPECT_EQ(rightArtmExpr->getRightOperand(), nullptr);
+    const auto* intLiteralRight = dynamic_cast<const Nodes::IntLiteral*>(rightArtmExpr->getLeftOperand()->getLeftOperand()->getExpression()->getExpression());
+    ASSERT_NE(intLiteralRight, nullptr);
+    EXPECT_EQ(intLiteralRight->getValue(), 2);
+
+    const auto* innerArtmExpr = dynamic_cast<const Nodes::ArtmExpr*>(artmExpr->getLeftOperand()->getLeftOperand()->getExpression()->getExpression());
+    ASSERT_NE(innerArtmExpr, nullptr);
+    const auto* intLiteralLeft = dynamic_cast<const Nodes::IntLiteral*>(innerArtmExpr->getLeftOperand()->getLeftOperand()->getExpression()->getExpression());
+    ASSERT_NE(intLiteralLeft, nullptr);
+    EXPECT_EQ(intLiteralLeft->getValue(), 10);
+}
+
+TEST(ParserTest, RespectsOperatorPrecedence) {
+    std::istringstream strStream("1 + 2 * 3 < 4 and true or false");
+    Parser parser(strStream);
+    auto orExpr = parser.parseOrExpression();
+    ASSERT_NE(orExpr, nullptr);
+    ASSERT_NE(orExpr->getRightOperand(), nullptr);
+    const auto* andExpr = orExpr->getLeftOperand();
+    ASSERT_NE(andExpr->getRightOperand(), nullptr);
+    const auto* relExpr = andExpr->getLeftOperand();
+    ASSERT_NE(relExpr->getRightOperand(), nullptr);
+    const auto* artmExpr = relExpr->getLeftOperand();
+    ASSERT_NE(artmExpr->getRightOperand(), nullptr);
+    EXPECT_EQ(artmExpr->getLeftOperand()->getRightOperand(), nullptr);
+    EXPECT_NE(artmExpr->getRightOperand()->getLeftOperand()->getRightOperand(), nullptr);
+}
+
+TEST(ParserTest, ReportsMissingOperands) {
+    std::istringstream missingRight("1 + ;");
+    EXPECT_THROW(Parser(missingRight).parseExpression(), MyException);
+    std::istringstream missingOperator("a 2");
+    EXPECT_THROW(Parser(missingOperator).parseExpression(), MyException);
+}
+
+TEST(ParserTest, ParsesLongOperatorChains) {
+    std::string source = "0";
+    for (int i = 1; i <= 2000; i++)
+        source += (i % 2 ? " + " : " - ") + std::to_string(i);
+    std::istringstream strStream(source);
+    Parser parser(strStream);
+    auto expression = parser.parseExpression();
+    ASSERT_NE(expression, nullptr);
+    EXPECT_EQ(strStream.peek(), EOF);
+}
+
 TEST(ParserTest, ParsesIdentifierv) {
     std::istringstream strStream("variableName");
     Parser parser(strStream);
@@ -439,6 +494,50 @@ TEST(ParserTest, ParsesFunctionCallWithNoArguments) {
     const auto& arguments = functionCall->getArguments();
 }
 
+TEST(ParserTest, ParsesStructFieldReference) {
+    std::istringstream strStream("myCar.model");
+    Parser parser(strStream);
+    auto functionCallOrVarRef = parser.parseFunctionCallOrVarRef();
+    ASSERT_NE(functionCallOrVarRef, nullptr);
+
+    auto fieldReference = dynamic_cast<Nodes::StructFieldReference*>(functionCallOrVarRef.get());
+    ASSERT_NE(fieldReference, nullptr);
+    EXPECT_EQ(fieldReference->getIdentifier(), "myCar");
+    EXPECT_EQ(fieldReference->getFieldName(), "model");
+    EXPECT_FALSE(fieldReference->getFieldIndex().has_value());
+}
+
+TEST(ParserTest, ParsesVariantHolding) {
+    std::istringstream strStream("status.holding()");
+    Parser parser(strStream);
+    auto functionCallOrVarRef = parser.parseFunctionCallOrVarRef();
+    ASSERT_NE(functionCallOrVarRef, nullptr);
+
+    auto holding = dynamic_cast<Nodes::VariantHolding*>(functionCallOrVarRef.get());
+    ASSERT_NE(holding, nullptr);
+    EXPECT_EQ(holding->getIdentifier(), "status");
+    EXPECT_FALSE(holding->getHeldType().has_value());
+}
+
+TEST(ParserTest, ParsesVariantHoldingTagTest) {
+    std::istringstream strStream("status.holding() != str and status.holding() == \"int\"");
+    Parser parser(strStream);
+    auto expression = parser.parseExpression();
+    ASSERT_NE(expression, nullptr);
+    auto andExpr = expression->getExpression()->getLeftOperand();
+    ASSERT_NE(andExpr, nullptr);
+    auto tagTest = dynamic_cast<const Nodes::VariantHolding*>(andExpr->getLeftOperand()->getLeftOperand()->getLeftOperand()
+                                                             ->getLeftOperand()->getExpression()->getExpression());
+    ASSERT_NE(tagTest, nullptr);
+    EXPECT_EQ(tagTest->getHeldType(), IdType::STR);
+    EXPECT_TRUE(tagTest->isNegated());
+    // porównanie z napisem zostaje zwykłym porównaniem nazwy typu
+    ASSERT_NE(andExpr->getRightOperand(), nullptr);
+    auto nameTest = andExpr->getRightOperand()->getLeftOperand();
+    ASSERT_NE(nameTest, nullptr);
+    EXPECT_NE(nameTest->getRelOp(), nullptr);
+}
+
 TEST(ParserTest, ParsesVariantTypeDefinition) {
     std::istringstream strStream("variant::Choice(int; float; str;);");
     Parser parser(strStream);
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <ctime>
+#include <sstream>
+
+#include "interpreterVisitor.h"
+#include "parser.h"
+#include "profiler.h"
+
+TEST(ProfilerTest, FoldsIdenticalStacks) {
+    std::istringstream strStream("fun int::helper()[ return 1; ] fun int::main()[ return 0; ]");
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    auto mainFunction = program->getFunctions().at("main").get();
+    auto helperFunction = program->getFunctions().at("helper").get();
+
+    Profiler profiler(1000, 64);
+    profiler.enterFunction(mainFunction, Position{1, 1});
+    profiler.setLine(Position{3, 1});
+    profiler.enterFunction(helperFunction, Position{7, 1});
+    profiler.takeSample();
+    profiler.takeSample();
+    profiler.leaveFunction();
+    profiler.takeSample();
+    profiler.leaveFunction();
+    profiler.takeSample();
+
+    std::ostringstream output;
+    profiler.writeFoldedStacks(output);
+    EXPECT_EQ(profiler.getSampleCount(), 3);
+    EXPECT_EQ(output.str(), "main:3 1\nmain:3;helper:7 2\n");
+}
+
+TEST(ProfilerTest, DropsSamplesWhenBufferIsFull) {
+    Profiler profiler(1000, 4);
+    profiler.enterFunction(nullptr, Position{1, 1});
+    profiler.enterFunction(nullptr, Position{2, 1});
+    profiler.takeSample();
+    profiler.takeSample();
+    EXPECT_EQ(profiler.getSampleCount(), 1);
+    EXPECT_EQ(profiler.getDroppedSamples(), 1);
+}
+
+TEST(ProfilerTest, SamplesRunningInterpreter) {
+    std::istringstream strStream("fun int::work(int::n)[ mut int::i = 0; mut int::sum = 0; while(i < n)[ sum = sum + i; i = i + 1; ] return sum; ]"
+                                 "fun int::main()[ int::result = work(20000); return 0; ]");
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    Profiler profiler(100);
+    profiler.start();
+    // SIGPROF przychodzi co tyknięcie planisty, a jedno wykonanie trwa kilka ms - powtarzane aż do
+    // pierwszej próbki, z limitem czasu CPU
+    auto cpuLimit = std::clock() + 5 * CLOCKS_PER_SEC;
+    while (profiler.getSampleCount() == 0 && std::clock() < cpuLimit) {
+        InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+        interpreterVisitor.setProfiler(&profiler);
+        program->accept(interpreterVisitor);
+    }
+    profiler.stop();
+
+    std::ostringstream output;
+    profiler.writeFoldedStacks(output);
+    ASSERT_GT(profiler.getSampleCount(), 0);
+    std::istringstream lines(output.str());
+    std::string line;
+    while (std::getline(lines, line))
+        EXPECT_EQ(line.rfind("main:", 0), 0) << line;
+}
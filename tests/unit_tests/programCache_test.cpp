@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "astSerializer.h"
+#include "Generator/programGenerator.h"
+#include "interpreterVisitor.h"
+#include "myException.h"
+#include "parser.h"
+#include "programCache.h"
+#include "scopeResolver.h"
+#include "semanticVisitor.h"
+
+static const std::string records = "struct::rec(int::first; str::label;);"
+                                   "variant::alt(int; str;);"
+                                   "fun int::twice(int::a)[ return a + a; ]"
+                                   "fun int::main()[ mut rec::r(4, \"x\"); mut alt::w = 5; r.first = twice(r.first);"
+                                   " if (r.first > 3)[ print(w.holding(), \" \", r.label, \" \", r.first); ] w = \"s\";"
+                                   " mut int::i = 0; while(i < 3)[ i = i + 1; ] return r.first + i; ]";
+
+static std::unique_ptr<Nodes::Program> checkedProgram(const std::string& source) {
+    std::istringstream strStream(source);
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(semanticVisitor);
+    ScopeResolver scopeResolver;
+    program->accept(scopeResolver);
+    return program;
+}
+
+static std::string runProgram(Nodes::Program& program) {
+    std::ostringstream output;
+    InterpreterVisitor interpreterVisitor(program.getStructTypes(), program.getVariantTypes());
+    interpreterVisitor.setOutput(output);
+    program.accept(interpreterVisitor);
+    return output.str();
+}
+
+class ProgramCacheTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() / ("tkom_cache_test_" + std::to_string(getpid()));
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST(AstSerializerTest, RoundTripKeepsBehaviourAndAnnotations) {
+    auto program = checkedProgram(records);
+    auto data = AstWriter::serialize(*program);
+    auto restored = AstReader::deserialize(data.data(), data.size());
+
+    EXPECT_TRUE(restored->areScopesResolved());
+    EXPECT_EQ(restored->getStructTypes().size(), 1);
+    EXPECT_EQ(restored->getVariantTypes().size(), 1);
+    EXPECT_EQ(runProgram(*restored), runProgram(*program));
+    // zapis odtworzonego drzewa jest identyczny
+    EXPECT_EQ(AstWriter::serialize(*restored), data);
+}
+
+TEST(AstSerializerTest, RoundTripsDeeplyNestedPrograms) {
+    // zapis i odczyt idą po jawnym stosie - tysiące poziomów bloków i nawiasów
+    std::string source = "fun int::main()[ mut int::x = 0; ";
+    for (int i = 0; i < 20000; i++)
+        source += "if (x >= 0)[ x = x + 1; ";
+    source += std::string(20000, ']') + " x = " + std::string(20000, '(') + "x";
+    for (int i = 0; i < 20000; i++)
+        source += " - 1)";
+    source += "; print(x); return 0; ]";
+    auto program = checkedProgram(source);
+    auto data = AstWriter::serialize(*program);
+    auto restored = AstReader::deserialize(data.data(), data.size());
+
+    EXPECT_EQ(runProgram(*restored), "0");
+    EXPECT_EQ(AstWriter::serialize(*restored), data);
+}
+
+TEST(AstSerializerTest, RoundTripsGeneratedPrograms) {
+    for (std::uint32_t seed = 1; seed <= 10; seed++) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.structCount = 2;
+        options.variantCount = 2;
+        auto source = ProgramGenerator(options).generate();
+        auto program = checkedProgram(source);
+        auto data = AstWriter::serialize(*program);
+        auto restored = AstReader::deserialize(data.data(), data.size());
+        EXPECT_EQ(runProgram(*restored), runProgram(*program)) << source;
+    }
+}
+
+TEST(AstSerializerTest, RejectsDamagedData) {
+    auto data = AstWriter::serialize(*checkedProgram(records), "stamp");
+    EXPECT_THROW(AstReader::deserialize(data.data(), data.size(), "other"), MyException);
+    EXPECT_THROW(AstReader::deserialize(data.data(), data.size() / 2, "stamp"), MyException);
+    auto extended = data + "x";
+    EXPECT_THROW(AstReader::deserialize(extended.data(), extended.size(), "stamp"), MyException);
+    auto wrongMagic = data;
+    wrongMagic[0] ^= 0x55;
+    EXPECT_THROW(AstReader::deserialize(wrongMagic.data(), wrongMagic.size(), "stamp"), MyException);
+}
+
+TEST(AstSerializerTest, RejectsEveryFlippedByte) {
+    auto data = AstWriter::serialize(*checkedProgram(records), "stamp");
+    for (std::size_t i = 0; i < data.size(); i++) {
+        auto damaged = data;
+        damaged[i] ^= 0x20;
+        EXPECT_THROW(AstReader::deserialize(damaged.data(), damaged.size(), "stamp"), MyException) << i;
+    }
+}
+
+TEST(AstSerializerTest, ChecksAnnotationsAgainstTables) {
+    auto program = checkedProgram(records);
+    auto& main = program->getFunctions().at("main");
+    auto fieldAssignment = dynamic_cast<Nodes::StructFieldAssignment*>(main->getBlock()->getStatements()[2].get());
+    ASSERT_NE(fieldAssignment, nullptr);
+    fieldAssignment->setFieldIndex(2);
+    auto data = AstWriter::serialize(*program);
+    EXPECT_THROW(AstReader::deserialize(data.data(), data.size()), MyException);
+
+    program = checkedProgram(records);
+    program->getFunctions().at("twice")->setFrameSize(0);
+    data = AstWriter::serialize(*program);
+    EXPECT_THROW(AstReader::deserialize(data.data(), data.size()), MyException);
+}
+
+TEST_F(ProgramCacheTest, StoresOnMissAndLoadsOnHit) {
+    ProgramCache cache(directory.string());
+    EXPECT_EQ(cache.load(records), nullptr);
+
+    auto compiled = cache.compile(records);
+    EXPECT_TRUE(std::filesystem::exists(cache.entryPath(records)));
+
+    auto loaded = cache.load(records);
+    ASSERT_NE(loaded, nullptr);
+    std::ostringstream fresh, cached;
+    auto expected = compiled->run({}, fresh);
+    auto result = cache.compile(records)->run({}, cached);
+    EXPECT_EQ(cached.str(), fresh.str());
+    EXPECT_EQ(std::get<int>(result), std::get<int>(expected));
+}
+
+TEST_F(ProgramCacheTest, DifferentSourcesUseDifferentEntries) {
+    ProgramCache cache(directory.string());
+    std::string changed = records + " ";
+    EXPECT_NE(cache.entryPath(records), cache.entryPath(changed));
+    cache.compile(records);
+    EXPECT_EQ(cache.load(changed), nullptr);
+}
+
+TEST_F(ProgramCacheTest, DamagedEntryIsAMiss) {
+    ProgramCache cache(directory.string());
+    cache.compile(records);
+    auto path = cache.entryPath(records);
+    auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size / 2);
+    EXPECT_EQ(cache.load(records), nullptr);
+
+    // kolejna kompilacja nadpisuje uszkodzony wpis
+    std::ostringstream output;
+    cache.compile(records)->run({}, output);
+    EXPECT_NE(cache.load(records), nullptr);
+}
+
+TEST_F(ProgramCacheTest, CorruptedEntryIsRemovedAndRebuilt) {
+    ProgramCache cache(directory.string());
+    cache.compile(records);
+    auto path = cache.entryPath(records);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(std::filesystem::file_size(path) / 2));
+        char byte = 0;
+        file.read(&byte, 1);
+        file.seekp(static_cast<std::streamoff>(std::filesystem::file_size(path) / 2));
+        byte ^= 0x7f;
+        file.write(&byte, 1);
+    }
+    EXPECT_EQ(cache.load(records), nullptr);
+    EXPECT_FALSE(std::filesystem::exists(path));
+
+    std::ostringstream output;
+    cache.compile(records)->run({}, output);
+    EXPECT_NE(cache.load(records), nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "Generator/programGenerator.h"
+#include "interpreterVisitor.h"
+#include "parser.h"
+#include "semanticVisitor.h"
+#include "traversal.h"
+
+static void checkAndRun(const std::string& source) {
+    std::istringstream strStream(source);
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    EXPECT_NO_THROW(program->accept(semanticVisitor)) << source;
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    EXPECT_NO_THROW(program->accept(interpreterVisitor)) << source;
+}
+
+TEST(ProgramGeneratorTest, GeneratedProgramsPassSemanticAnalysis) {
+    for (std::uint32_t seed = 1; seed <= 20; seed++) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.functions = 5;
+        options.statementsPerBlock = 4;
+        options.nestingDepth = 3;
+        options.structCount = 2;
+        options.variantCount = 2;
+        checkAndRun(ProgramGenerator(options).generate());
+    }
+}
+
+TEST(ProgramGeneratorTest, HandlesDegenerateOptions) {
+    GeneratorOptions options;
+    options.functions = 1;
+    options.statementsPerBlock = 0;
+    options.nestingDepth = 0;
+    options.expressionLength = 0;
+    options.structCount = 0;
+    options.variantCount = 0;
+    options.callFanOut = 0;
+    checkAndRun(ProgramGenerator(options).generate());
+}
+
+TEST(ProgramGeneratorTest, SameSeedGivesSameProgram) {
+    GeneratorOptions options;
+    options.seed = 7;
+    EXPECT_EQ(ProgramGenerator(options).generate(), ProgramGenerator(options).generate());
+    options.seed = 8;
+    EXPECT_NE(ProgramGenerator(options).generate(), ProgramGenerator(GeneratorOptions{}).generate());
+}
+
+TEST(ProgramGeneratorTest, SizeGrowsWithParameters) {
+    GeneratorOptions small;
+    GeneratorOptions large;
+    large.functions = small.functions * 10;
+    EXPECT_GT(ProgramGenerator(large).generate().size(), ProgramGenerator(small).generate().size() * 5);
+}
+
+TEST(ProgramGeneratorTest, DepthIsExactNestingChain) {
+    for (int depth : {0, 1, 4, 12}) {
+        GeneratorOptions options;
+        options.seed = static_cast<std::uint32_t>(depth) + 3;
+        options.functions = 4;
+        options.statementsPerBlock = 3;
+        options.nestingDepth = depth;
+        options.callFanOut = 0;
+        std::istringstream strStream(ProgramGenerator(options).generate());
+        Parser parser(strStream);
+        auto program = parser.parseProgram();
+
+        for (const auto& [name, function] : program->getFunctions()) {
+            if (name == "main")
+                continue;
+            // ciało funkcji to poziom 0; każdy if/while to jedno ogniwo łańcucha
+            int blocks = -1;
+            int deepest = 0;
+            int nested = 0;
+            Traversal::walk(function->getBlock(), [&](Node* node) {
+                if (node->getKind() == NodeKind::BLOCK)
+                    deepest = std::max(deepest, ++blocks);
+                if (node->getKind() == NodeKind::IF_STATEMENT || node->getKind() == NodeKind::WHILE_STATEMENT)
+                    nested++;
+            }, [&](Node* node) {
+                if (node->getKind() == NodeKind::BLOCK)
+                    blocks--;
+            });
+            EXPECT_EQ(deepest, depth) << name;
+            EXPECT_EQ(nested, depth) << name;
+        }
+    }
+}
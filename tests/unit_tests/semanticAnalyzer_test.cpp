@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <set>
 #include <sstream>
 
 #include "interpreterVisitor.h"
@@ -65,3 +66,56 @@ TEST(SemanticAnalyzerTest, TypeMismatch) {
     //ASSERT_THROW({}, MyException);
 }
 
+
+// funkcje z błędami w podanych liniach; nazwy w odwrotnej kolejności niż w źródle
+static std::string manyFunctionsWithErrors(const std::set<int>& failingLines) {
+    std::string source = "struct::pair(int::first; str::second;);\n";
+    for (int line = 2; line < 202; line++) {
+        auto name = "f" + std::to_string(1000 - line);
+        if (failingLines.count(line) > 0)
+            source += "fun int::" + name + "(int::a)[ return missing" + std::to_string(line) + "; ]\n";
+        else
+            source += "fun int::" + name + "(int::a)[ mut pair::p(a, \"x\"); return p.first + a; ]\n";
+    }
+    source += "fun int::main()[ return f990(1); ]\n";
+    return source;
+}
+
+TEST(SemanticAnalyzerTest, ParallelCheckMergesErrorsInSourceOrder) {
+    std::set<int> failingLines{7, 120, 180};
+    for (std::size_t threads : {1, 4}) {
+        std::istringstream strStream(manyFunctionsWithErrors(failingLines));
+        Parser parser(strStream);
+        auto program = parser.parseProgram();
+        SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+        semanticVisitor.setThreads(threads);
+        try {
+            program->accept(semanticVisitor);
+            FAIL() << "expected error, threads " << threads;
+        } catch (MyException& e) {
+            EXPECT_EQ(e.getMessage(), "Variable missing7 not declared");
+        }
+        std::vector<unsigned int> lines;
+        for (const auto& error : semanticVisitor.getErrors())
+            lines.push_back(error.getPosition().line);
+        EXPECT_EQ(lines, std::vector<unsigned int>(failingLines.begin(), failingLines.end())) << "threads " << threads;
+        EXPECT_EQ(semanticVisitor.getCurrentTopLevelNode(), program->getFunctions().at("f993").get());
+    }
+}
+
+TEST(SemanticAnalyzerTest, ParallelCheckMatchesSerialResult) {
+    std::istringstream strStream(manyFunctionsWithErrors({}));
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    semanticVisitor.setThreads(4);
+    program->accept(semanticVisitor);
+    EXPECT_TRUE(semanticVisitor.getErrors().empty());
+
+    // indeksy pól ustawione przez wątki analizy są widoczne w interpreterze
+    std::ostringstream output;
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    interpreterVisitor.setOutput(output);
+    program->accept(interpreterVisitor);
+    EXPECT_EQ(std::get<int>(interpreterVisitor.getResult()), 2);
+}
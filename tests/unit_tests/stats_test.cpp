@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+#include "interpreterVisitor.h"
+#include "nodeCounter.h"
+#include "parser.h"
+#include "stats.h"
+
+TEST(StatsTest, NodeCounterCountsByKind) {
+    std::istringstream strStream("fun int::main()[ int::a = 1; int::b = a; print(b); return 0; ]");
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    NodeCounter nodeCounter;
+    program->accept(nodeCounter);
+    const auto& counts = nodeCounter.getCounts();
+    EXPECT_EQ(counts.at("Program"), 1);
+    EXPECT_EQ(counts.at("FunctionDeclaration"), 1);
+    EXPECT_EQ(counts.at("VariableDeclaration"), 2);
+    EXPECT_EQ(counts.at("VarReference"), 2);
+    EXPECT_EQ(counts.at("FunctionCallStatement"), 1);
+}
+
+TEST(StatsTest, PhaseCountersAreDeltas) {
+    Stats::Report report;
+    std::istringstream strStream("fun int::f()[ return 1; ] fun int::main()[ mut int::i = 0; while(i < 3)[ i = i + 1; ] return 0; ]");
+    report.beginPhase("parse");
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+    report.endPhase();
+    report.beginPhase("interpret");
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(interpreterVisitor);
+    report.endPhase();
+
+    const auto& phases = report.getPhases();
+    ASSERT_EQ(phases.size(), 2);
+    EXPECT_EQ(phases[0].name, "parse");
+    EXPECT_GE(phases[1].wallMs, 0.0);
+    EXPECT_GT(phases[1].peakRssKb, 0);
+    if (Stats::countersEnabled()) {
+        auto index = [](Stats::Counter counter) { return static_cast<std::size_t>(counter); };
+        EXPECT_GT(phases[0].counters[index(Stats::Counter::TOKENS)], 0);
+        EXPECT_EQ(phases[1].counters[index(Stats::Counter::TOKENS)], 0);
+        EXPECT_EQ(phases[1].counters[index(Stats::Counter::FUNCTION_CALLS)], 1);
+        // 2 instrukcje main + 3 iteracje pętli + return
+        EXPECT_EQ(phases[1].counters[index(Stats::Counter::STATEMENTS)], 6);
+    }
+}
+
+TEST(StatsTest, SnapshotSumsCountersOfAllThreads) {
+    auto index = static_cast<std::size_t>(Stats::Counter::FUNCTION_CALLS);
+    auto before = Stats::snapshot()[index];
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([]() {
+            for (int i = 0; i < 1000; i++)
+                Stats::increment(Stats::Counter::FUNCTION_CALLS);
+        });
+    }
+    for (int i = 0; i < 10; i++)
+        Stats::increment(Stats::Counter::FUNCTION_CALLS);
+    for (auto& worker : workers)
+        worker.join();
+    // wątki już zakończone - ich liczniki są w sumie
+    EXPECT_EQ(Stats::snapshot()[index] - before, 4010);
+}
+
+TEST(StatsTest, JsonReportContainsPhasesAndNodes) {
+    Stats::Report report;
+    report.beginPhase("parse");
+    report.endPhase();
+    report.setAstNodeCounts({{"Program", 1}});
+    std::ostringstream output;
+    report.writeJson(output);
+    EXPECT_NE(output.str().find("\"phases\":[{\"name\":\"parse\""), std::string::npos);
+    EXPECT_NE(output.str().find("\"ast_nodes\":{\"Program\":1}"), std::string::npos);
+}
@@ -1,5 +1,13 @@
 #include <gtest/gtest.h>
+#include <map>
+#include <set>
+#include <sstream>
+#include <typeindex>
+#include "parser.h"
 #include "syntaxTree.h"
+#include "traversal.h"
+#include "typeLayout.h"
+#include "visitorTemplate.h"
 
 TEST(NodeTest, RelOpTest) {
     Position pos({});
@@ -287,6 +295,51 @@ TEST(SyntaxTreeTest, StructTypeDefinitionTest) {
     EXPECT_EQ(structDef.getStructName(), structName);
 }
 
+TEST(SyntaxTreeTest, StructTypeDefinitionLayoutTest) {
+    Position pos{1, 2};
+    std::vector<std::unique_ptr<Nodes::TypeDecl>> fields;
+    fields.push_back(std::make_unique<Nodes::TypeDecl>(std::make_unique<Nodes::Type>(IdType::BOOLEAN, pos), "flag", pos));
+    fields.push_back(std::make_unique<Nodes::TypeDecl>(std::make_unique<Nodes::Type>(IdType::INT, pos), "count", pos));
+    fields.push_back(std::make_unique<Nodes::TypeDecl>(std::make_unique<Nodes::Type>(IdType::STR, pos), "name", pos));
+
+    Nodes::StructTypeDefinition structDef("myStruct", std::move(fields), pos);
+    auto layout = structDef.getLayout();
+    ASSERT_NE(layout, nullptr);
+    ASSERT_EQ(layout->getFieldCount(), 3);
+    EXPECT_EQ(layout->getFieldIndex("count"), 1);
+    EXPECT_FALSE(layout->getFieldIndex("missing").has_value());
+    EXPECT_EQ(layout->getField(2).name, "name");
+    EXPECT_EQ(layout->getField(2).type, IdType::STR);
+    EXPECT_EQ(layout->getField(2).index, 2);
+}
+
+TEST(SyntaxTreeTest, StructTypeDefinitionUserTypeHasNoLayout) {
+    Position pos{1, 2};
+    std::vector<std::unique_ptr<Nodes::TypeDecl>> fields;
+    fields.push_back(std::make_unique<Nodes::TypeDecl>(std::make_unique<Nodes::Type>("other", pos), "nested", pos));
+
+    Nodes::StructTypeDefinition structDef("myStruct", std::move(fields), pos);
+    EXPECT_EQ(structDef.getLayout(), nullptr);
+}
+
+TEST(SyntaxTreeTest, VariantTypeDefinitionLayoutTest) {
+    Position pos{1, 2};
+    std::vector<std::unique_ptr<Nodes::Type>> fields;
+    fields.push_back(std::make_unique<Nodes::Type>(IdType::STR, pos));
+    fields.push_back(std::make_unique<Nodes::Type>(IdType::INT, pos));
+
+    Nodes::VariantTypeDefinition variantDef("event", std::move(fields), pos);
+    auto layout = variantDef.getLayout();
+    ASSERT_NE(layout, nullptr);
+    EXPECT_EQ(layout->getAlternativeCount(), 2);
+    EXPECT_EQ(layout->getTag(IdType::STR), 0);
+    EXPECT_EQ(layout->getTag(IdType::INT), 1);
+    EXPECT_EQ(layout->getTag(IdType::FLOAT), VariantLayout::NO_TAG);
+    EXPECT_EQ(layout->getTagForValue(VariantLayout::Value(7)), 1);
+    EXPECT_EQ(layout->getTypeName(1), "int");
+    EXPECT_EQ(layout->getVariantName(), "event");
+}
+
 TEST(SyntaxTreeTest, StructVarDeclarationTest) {
     Position pos{1, 2};
     bool mut = false;
@@ -353,3 +406,86 @@ TEST(SyntaxTreeTest, ReturnStatementTest) {
     Nodes::ReturnStatement returnStmt(std::move(expression), pos);
     EXPECT_EQ(returnStmt.getNodeName(), "ReturnStatement");
 }
+
+static const std::string everyKind = "struct::rec(int::a; str::b;);\n"
+                                     "variant::event(int; str;);\n"
+                                     "int::g = 2;\n"
+                                     "fun int::twice(int::v)[ return v * 2; ]\n"
+                                     "fun int::main()[\n"
+                                     "    mut rec::r(1, \"x\");\n"
+                                     "    mut event::e = 5;\n"
+                                     "    mut float::f = 1.5;\n"
+                                     "    mut bool::ok = true and !false or g > 1;\n"
+                                     "    r.a = twice(r.a) - (-1 as [float]) as [int];\n"
+                                     "    while (ok)[ ok = false; ]\n"
+                                     "    if (e.holding() == \"int\")[ print(e); ] else [ f = f / 2.0; ]\n"
+                                     "    return r.a;\n"
+                                     "]\n";
+
+TEST(NodeKindTest, KindMatchesNodeClass) {
+    std::map<NodeKind, std::type_index> classes{
+            {NodeKind::BOOL_LITERAL, typeid(Nodes::BooleanLiteral)}, {NodeKind::INT_LITERAL, typeid(Nodes::IntLiteral)},
+            {NodeKind::FLOAT_LITERAL, typeid(Nodes::FloatLiteral)}, {NodeKind::STRING_LITERAL, typeid(Nodes::StringLiteral)},
+            {NodeKind::IDENTIFIER, typeid(Nodes::Identifier)}, {NodeKind::REL_OP, typeid(Nodes::RelOp)},
+            {NodeKind::ARTM_OP, typeid(Nodes::ArtmOp)}, {NodeKind::FACTOR_OP, typeid(Nodes::FactorOp)},
+            {NodeKind::UNARY_OP, typeid(Nodes::UnaryOp)}, {NodeKind::CAST_OP, typeid(Nodes::CastOp)},
+            {NodeKind::CASTING_EXPR, typeid(Nodes::CastingExpr)}, {NodeKind::UNARY_EXPR, typeid(Nodes::UnaryExpr)},
+            {NodeKind::MUL_EXPR, typeid(Nodes::MulExpr)}, {NodeKind::ARTM_EXPR, typeid(Nodes::ArtmExpr)},
+            {NodeKind::REL_EXPR, typeid(Nodes::RelExpr)}, {NodeKind::AND_EXPR, typeid(Nodes::AndExpr)},
+            {NodeKind::OR_EXPR, typeid(Nodes::OrExpr)}, {NodeKind::EXPRESSION, typeid(Nodes::Expression)},
+            {NodeKind::FUN_CALL, typeid(Nodes::FunCall)}, {NodeKind::VAR_REFERENCE, typeid(Nodes::VarReference)},
+            {NodeKind::STRUCT_FIELD_REFERENCE, typeid(Nodes::StructFieldReference)},
+            {NodeKind::VARIANT_HOLDING, typeid(Nodes::VariantHolding)}, {NodeKind::TYPE, typeid(Nodes::Type)},
+            {NodeKind::TYPE_DECL, typeid(Nodes::TypeDecl)}, {NodeKind::VARIABLE_DECLARATION, typeid(Nodes::VariableDeclaration)},
+            {NodeKind::STRUCT_TYPE_DEFINITION, typeid(Nodes::StructTypeDefinition)},
+            {NodeKind::STRUCT_VAR_DECLARATION, typeid(Nodes::StructVarDeclaration)},
+            {NodeKind::VARIANT_TYPE_DEFINITION, typeid(Nodes::VariantTypeDefinition)},
+            {NodeKind::VARIANT_VAR_DECLARATION, typeid(Nodes::VariantVarDeclaration)},
+            {NodeKind::ASSIGNMENT, typeid(Nodes::Assignment)}, {NodeKind::STRUCT_FIELD_ASSIGNMENT, typeid(Nodes::StructFieldAssignment)},
+            {NodeKind::RETURN_STATEMENT, typeid(Nodes::ReturnStatement)}, {NodeKind::BLOCK, typeid(Nodes::Block)},
+            {NodeKind::IF_STATEMENT, typeid(Nodes::IfStatement)}, {NodeKind::WHILE_STATEMENT, typeid(Nodes::WhileStatement)},
+            {NodeKind::FUNCTION_CALL_STATEMENT, typeid(Nodes::FunctionCallStatement)},
+            {NodeKind::FUNCTION_DECLARATION, typeid(Nodes::FunctionDeclaration)}, {NodeKind::PROGRAM, typeid(Nodes::Program)}};
+    std::istringstream strStream(everyKind);
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+
+    std::set<NodeKind> seen;
+    for (auto node : Traversal::PreOrder(program.get())) {
+        EXPECT_EQ(std::type_index(typeid(*node)), classes.at(node->getKind())) << node->getNodeName();
+        seen.insert(node->getKind());
+    }
+    // program używa każdego rodzaju węzła poza Identifier (parser go nie tworzy)
+    EXPECT_EQ(seen.size(), classes.size() - 1);
+}
+
+namespace {
+    class ArithmeticCounter : public VisitorTemplate<ArithmeticCounter>
+    {
+    public:
+        std::size_t products = 0; // mnożenia i dzielenia
+        std::size_t literals = 0;
+        void visitMulExpr(Nodes::MulExpr *mulExpr) override {
+            if (mulExpr->getRightOperand())
+                products++;
+        }
+        void visitIntLiteral(Nodes::IntLiteral *) override { literals++; }
+    };
+}
+
+TEST(VisitorTemplateTest, StaticAndVirtualDispatchAgree) {
+    std::istringstream strStream(everyKind);
+    Parser parser(strStream);
+    auto program = parser.parseProgram();
+
+    ArithmeticCounter bySwitch;
+    ArithmeticCounter byAccept;
+    for (auto node : Traversal::PreOrder(program.get())) {
+        bySwitch.visit(node);
+        node->accept(byAccept);
+    }
+    EXPECT_EQ(bySwitch.products, 2);
+    EXPECT_EQ(bySwitch.literals, 6);
+    EXPECT_EQ(bySwitch.products, byAccept.products);
+    EXPECT_EQ(bySwitch.literals, byAccept.literals);
+}
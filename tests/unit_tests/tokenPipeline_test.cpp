@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <ctime>
+#include <sstream>
+#include <thread>
+
+#include "nodeCounter.h"
+#include "parser.h"
+#include "tokenPipeline.h"
+
+// więcej tokenów niż mieści kolejka (QUEUE_CAPACITY paczek po BATCH_SIZE), z komentarzami
+static std::string manyFunctions(int count) {
+    std::string source;
+    for (int i = 0; i < count; i++) {
+        source += "# funkcja " + std::to_string(i) + "\n"
+                  "fun int::f" + std::to_string(i) + "(int::a, int::b)[\n"
+                  "    mut int::sum = a * 2 + b; /# komentarz #/\n"
+                  "    if (sum > 10 and a != b)[ sum = sum - 1; ] else [ sum = sum + 1; ]\n"
+                  "    return sum;\n"
+                  "]\n";
+    }
+    source += "fun int::main()[ return 0; ]\n";
+    return source;
+}
+
+static std::map<std::string, std::size_t> countNodes(Nodes::Program* program) {
+    NodeCounter nodeCounter;
+    program->accept(nodeCounter);
+    return nodeCounter.getCounts();
+}
+
+TEST(SpscQueueTest, KeepsOrderAcrossThreads) {
+    SpscQueue<int, 8> queue;
+    const int count = 100000;
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; i++) {
+            int value = i;
+            while (!queue.tryPush(value))
+                std::this_thread::yield();
+        }
+    });
+    int expected = 0;
+    while (expected < count) {
+        int value;
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(value, expected);
+        expected++;
+    }
+    producer.join();
+    int value;
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// źródło w dwóch częściach; druga dostępna dopiero po opóźnieniu, jak przy wolnym wejściu
+class DelayedBuffer : public std::streambuf
+{
+private:
+    std::string parts[2];
+    std::chrono::milliseconds delay;
+    int next = 0;
+
+protected:
+    int_type underflow() override {
+        if (next == 2)
+            return traits_type::eof();
+        if (next == 1)
+            std::this_thread::sleep_for(delay);
+        auto& part = parts[next++];
+        setg(part.data(), part.data(), part.data() + part.size());
+        return traits_type::to_int_type(part[0]);
+    }
+
+public:
+    DelayedBuffer(std::string first, std::string second, std::chrono::milliseconds delay)
+            : parts{std::move(first), std::move(second)}, delay(delay) {}
+};
+
+static double threadCpuMs() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1e6;
+}
+
+TEST(TokenPipelineTest, ConsumerSleepsWhileLexerWaitsForInput) {
+    DelayedBuffer buffer("fun int::main()[ ", "return 0; ]", std::chrono::milliseconds(300));
+    std::istream stream(&buffer);
+    TokenPipeline pipeline(stream);
+    auto start = threadCpuMs();
+    // pierwsza paczka (cały program do EOF) gotowa dopiero po opóźnieniu
+    EXPECT_EQ(pipeline.next().getType(), TokenTypes::FUN_KW);
+    EXPECT_LT(threadCpuMs() - start, 100.0);
+}
+
+TEST(TokenPipelineTest, MatchesLexerWithoutComments) {
+    auto source = manyFunctions(500);
+    std::istringstream lexerStream(source);
+    Lexer lexer(lexerStream);
+    std::istringstream pipelineStream(source);
+    TokenPipeline pipeline(pipelineStream);
+    std::size_t tokens = 0;
+    while (true) {
+        auto expected = lexer.getNextToken();
+        if (expected.getType() == TokenTypes::SINGLE_COMMENT || expected.getType() == TokenTypes::MULTILINE_COMMENT_START)
+            continue;
+        auto token = pipeline.next();
+        ASSERT_EQ(token.getType(), expected.getType());
+        ASSERT_EQ(token.getPosition().line, expected.getPosition().line);
+        ASSERT_EQ(token.getPosition().column, expected.getPosition().column);
+        tokens++;
+        if (expected.getType() == TokenTypes::EOF_TOKEN)
+            break;
+    }
+    EXPECT_GT(tokens, TokenPipeline::BATCH_SIZE * TokenPipeline::QUEUE_CAPACITY);
+    EXPECT_EQ(pipeline.next().getType(), TokenTypes::EOF_TOKEN);
+}
+
+TEST(TokenPipelineTest, PipelinedParserBuildsSameProgram) {
+    auto source = manyFunctions(500);
+    std::istringstream sequentialStream(source);
+    Parser sequential(sequentialStream);
+    auto expected = sequential.parseProgram();
+    std::istringstream pipelinedStream(source);
+    Parser pipelined(pipelinedStream, Parser::Pipelined{});
+    auto program = pipelined.parseProgram();
+    EXPECT_EQ(program->getFunctions().size(), expected->getFunctions().size());
+    EXPECT_EQ(countNodes(program.get()), countNodes(expected.get()));
+}
+
+TEST(TokenPipelineTest, LexerErrorReachesParserInOrder) {
+    auto source = manyFunctions(100) + "fun int::g()[ int::x = 007; return x; ]";
+    std::istringstream sequentialStream(source);
+    Parser sequential(sequentialStream);
+    std::string expected;
+    try {
+        sequential.parseProgram();
+    } catch (MyException& e) {
+        expected = e.what();
+    }
+    ASSERT_FALSE(expected.empty());
+    std::istringstream pipelinedStream(source);
+    Parser pipelined(pipelinedStream, Parser::Pipelined{});
+    try {
+        pipelined.parseProgram();
+        FAIL() << "Expected lexer error";
+    } catch (MyException& e) {
+        EXPECT_EQ(std::string(e.what()), expected);
+    }
+}
+
+TEST(TokenPipelineTest, ParserErrorStopsProducer) {
+    // błąd składni na początku, lexer ma przed sobą dużo więcej tokenów niż mieści kolejka
+    auto source = "fun int::broken( [ ]\n" + manyFunctions(2000);
+    std::istringstream strStream(source);
+    {
+        Parser parser(strStream, Parser::Pipelined{});
+        EXPECT_THROW(parser.parseProgram(), MyException);
+    }
+    SUCCEED();
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+#include "interpreterVisitor.h"
+#include "nodeCounter.h"
+#include "parser.h"
+#include "semanticVisitor.h"
+#include "traversal.h"
+
+static std::unique_ptr<Nodes::Program> parse(const std::string& source) {
+    std::istringstream strStream(source);
+    Parser parser(strStream);
+    return parser.parseProgram();
+}
+
+static std::size_t countNodes(Nodes::Program* program) {
+    NodeCounter nodeCounter;
+    program->accept(nodeCounter);
+    std::size_t total = 0;
+    for (const auto& count : nodeCounter.getCounts())
+        total += count.second;
+    return total;
+}
+
+// x = (((1 + 1) + 1) ... + 1) - każdy nawias to kolejny poziom wyrażenia
+static std::string nestedParentheses(int depth) {
+    std::string source = "fun int::main()[ mut int::x = 0; x = ";
+    source += std::string(depth, '(') + "1";
+    for (int i = 0; i < depth; i++)
+        source += " + 1)";
+    return source + "; return x; ]";
+}
+
+// x = 1 + 1 + ... + 1 - łańcuch lewostronny, parser buduje go bez rekurencji, a drzewo ma głębokość 'terms'
+static std::string longChain(int terms) {
+    std::string source = "fun int::main()[ mut int::x = 0; x = 1";
+    for (int i = 1; i < terms; i++)
+        source += " + 1";
+    return source + "; return x; ]";
+}
+
+// if w if ... na 'depth' poziomów, co drugi z gałęzią else; całość w pętli wykonywanej dwa razy
+static std::string nestedBlocks(int depth) {
+    std::string source = "fun int::main()[ mut int::x = 0; mut int::n = 0; while (n < 2)[ n = n + 1; ";
+    for (int i = 0; i < depth; i++)
+        source += i % 2 ? "if (x < 0)[ x = 0; ] else [ x = x + 1; " : "if (x >= 0)[ x = x + 1; ";
+    return source + std::string(depth, ']') + " ] return x; ]";
+}
+
+static int run(Nodes::Program* program) {
+    SemanticVisitor semanticVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(semanticVisitor);
+    InterpreterVisitor interpreterVisitor(program->getStructTypes(), program->getVariantTypes());
+    program->accept(interpreterVisitor);
+    return std::get<int>(interpreterVisitor.getResult());
+}
+
+TEST(TraversalTest, PreAndPostOrderVisitEveryNodeOnce) {
+    auto program = parse("int::g = 2; fun int::main()[ int::a = g * (3 + 4); if (a > 1)[ print(a); ] return a; ]");
+    std::vector<Node*> preOrder(Traversal::PreOrder(program.get()).begin(), Traversal::PreOrder(program.get()).end());
+    std::vector<Node*> postOrder;
+    for (auto node : Traversal::PostOrder(program.get()))
+        postOrder.push_back(node);
+
+    ASSERT_EQ(preOrder.size(), countNodes(program.get()));
+    EXPECT_EQ(preOrder.front(), program.get());
+    EXPECT_EQ(postOrder.back(), program.get());
+    auto sorted = [](std::vector<Node*> nodes) { std::sort(nodes.begin(), nodes.end()); return nodes; };
+    EXPECT_EQ(sorted(preOrder), sorted(postOrder));
+
+    // dzieci zaraz po rodzicu (pre-order) i tuż przed nim (post-order), w kolejności ze źródła
+    std::vector<Node*> children;
+    Traversal::appendChildren(program.get(), children);
+    ASSERT_EQ(children.size(), 2);
+    EXPECT_EQ(preOrder[1], children.front());
+    std::vector<Node*> functionChildren;
+    Traversal::appendChildren(children.back(), functionChildren);
+    EXPECT_EQ(postOrder[postOrder.size() - 2], children.back());
+    EXPECT_EQ(postOrder[postOrder.size() - 3], functionChildren.back());
+}
+
+TEST(TraversalTest, EvaluatesPostOrderWithoutRecursion) {
+    auto program = parse(nestedParentheses(40));
+    // rozmiar i wysokość drzewa liczone przez sterownik
+    auto size = Traversal::evaluatePostOrder<std::size_t>(program.get(), [](Node*, const Traversal::Operand<std::size_t>* first,
+                                                                            const Traversal::Operand<std::size_t>* last) {
+        return std::accumulate(first, last, std::size_t{1}, [](std::size_t sum, const auto& operand) { return sum + operand.value; });
+    });
+    auto height = Traversal::evaluatePostOrder<std::size_t>(program.get(), [](Node*, const Traversal::Operand<std::size_t>* first,
+                                                                              const Traversal::Operand<std::size_t>* last) {
+        std::size_t deepest = 0;
+        for (auto operand = first; operand != last; ++operand)
+            deepest = std::max(deepest, operand->value);
+        return deepest + 1;
+    });
+    EXPECT_EQ(size, countNodes(program.get()));
+    EXPECT_GT(height, 40 * 5);
+}
+
+TEST(TraversalTest, DeeplyNestedExpressionsDoNotExhaustStack) {
+    auto program = parse(nestedParentheses(20000));
+    EXPECT_GT(countNodes(program.get()), 20000 * 8);
+    EXPECT_EQ(run(program.get()), 20001);
+}
+
+TEST(TraversalTest, LongOperatorChainsDoNotExhaustStack) {
+    auto program = parse(longChain(20000));
+    EXPECT_EQ(run(program.get()), 20000);
+}
+
+TEST(TraversalTest, DeeplyNestedBlocksDoNotExhaustStack) {
+    auto program = parse(nestedBlocks(20000));
+    EXPECT_EQ(run(program.get()), 40000);
+    // return z najgłębszego bloku kończy wszystkie bloki funkcji
+    std::string nested;
+    for (int i = 0; i < 3000; i++)
+        nested += "if (x >= 0)[ ";
+    auto early = parse("fun int::main()[ mut int::x = 0; " + nested + "return 7; " + std::string(3000, ']') + " return 1; ]");
+    EXPECT_EQ(run(early.get()), 7);
+}
+
+TEST(TraversalTest, DeepEvaluationMatchesRecursiveResult) {
+    // wywołania, rzutowania i porównania w głębokim poddrzewie liczone przez sterownik
+    std::string body = "fun int::inc(int::v)[ return v + 1; ]\nfun int::main()[ mut int::x = 0; x = ";
+    std::string expression = "1";
+    for (int i = 0; i < 600; i++)
+        expression = "inc(((" + expression + ") as [float]) as [int]) - " + (i % 2 ? "0" : "(1 - 1)");
+    auto program = parse(body + expression + "; if (" + std::string(400, '(') + "x" + std::string(400, ')') +
+                         " == 601)[ x = x + 1; ] return x; ]");
+    EXPECT_EQ(run(program.get()), 602);
+
+    auto broken = parse("fun int::main()[ mut int::x = 0; x = " + std::string(600, '(') + "1 + \"s\"" +
+                        std::string(600, ')') + "; return x; ]");
+    SemanticVisitor semanticVisitor(broken->getStructTypes(), broken->getVariantTypes());
+    EXPECT_THROW(broken->accept(semanticVisitor), MyException);
+}